@@ -0,0 +1,312 @@
+/*
+  ==============================================================================
+
+    AudioThreadProfiler.h
+
+    Laufzeitmessung von processBlock für Dropout-Berichte.
+
+    Der Audio-Thread misst jeden Block und seine Abschnitte (Host-Sync,
+    Audio-to-MIDI, Live-MIDI, Bend-Schleife, Noten-Ausgabe) mit der
+    hochauflösenden Uhr und zählt die Dauer in logarithmische Histogramme
+    (4 Stufen pro Oktave, ~19% Auflösung). Er ist der einzige Schreiber:
+    relaxed load/store, kein Lock, keine Allokation. Der Message-Thread liest
+    p50/p99/max und die Überläufe gegen die Block-Deadline
+    (Blocklänge / Samplerate aus prepareToPlay) zur Anzeige oder als Report.
+
+    Verschachtelte Abschnitte zählen exklusiv: die Bend-Schleife wird aus der
+    Noten-Ausgabe herausgerechnet. Ein Überlauf wird zusätzlich dem Abschnitt
+    zugeschrieben, der in diesem Block am längsten lief. Bei laufendem
+    TraceRecorder gehen Block und Abschnitte zusätzlich in den Trace.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+class AudioThreadProfiler
+{
+public:
+    enum Section
+    {
+        hostSync = 0,
+        audioToMidi,
+        liveMidi,
+        bendLoop,
+        noteOutput,
+        numSections,
+        total = numSections,   // ganzer Block (nur für getStats)
+        noSection = -1
+    };
+
+    static const char* getSectionName(int section)
+    {
+        static const char* names[] = { "host sync", "audio-to-MIDI", "live MIDI", "bend loop", "note output", "total" };
+        return (section >= 0 && section <= total) ? names[section] : "";
+    }
+
+    struct Stats
+    {
+        uint64_t blocks = 0;      // Blöcke, in denen der Abschnitt lief
+        double p50Micros = 0.0;   // obere Bucket-Grenze (konservativ), höchstens max
+        double p99Micros = 0.0;
+        double maxMicros = 0.0;
+        uint64_t overruns = 0;    // total: Blöcke über der Deadline, Abschnitt: davon hauptverantwortlich
+    };
+
+    struct SectionToken
+    {
+        Section section = noSection;
+        Section parent = noSection;
+        juce::int64 startTicks = 0;
+    };
+
+    //==========================================================================
+    // Message-Thread
+
+    void prepare(double newSampleRate, int maximumBlockSize)
+    {
+        sampleRate.store(newSampleRate > 0.0 ? newSampleRate : 44100.0);
+        maxBlockSize.store(maximumBlockSize);
+    }
+
+    /** Der Audio-Thread setzt beim nächsten Block alle Zähler zurück (er bleibt einziger Schreiber). */
+    void requestReset() noexcept { resetRequested.store(true); }
+
+    Stats getStats(int section) const
+    {
+        Stats stats;
+        if (section < 0 || section > total)
+            return stats;
+
+        const auto& h = histograms[(size_t) section];
+        std::array<uint32_t, numBuckets> counts;
+        for (size_t i = 0; i < numBuckets; ++i)
+        {
+            counts[i] = h.counts[i].load(std::memory_order_relaxed);
+            stats.blocks += counts[i];
+        }
+        stats.maxMicros = (double) h.maxNanos.load(std::memory_order_relaxed) / 1000.0;
+        stats.overruns = h.overruns.load(std::memory_order_relaxed);
+        stats.p50Micros = std::min(percentileMicros(counts, stats.blocks, 0.50), stats.maxMicros);
+        stats.p99Micros = std::min(percentileMicros(counts, stats.blocks, 0.99), stats.maxMicros);
+        return stats;
+    }
+
+    double getDeadlineMicros() const
+    {
+        return 1.0e6 * maxBlockSize.load() / sampleRate.load();
+    }
+
+    /** Text-Tabelle für HUD und Bug-Report. */
+    juce::String createReport() const
+    {
+        juce::String report;
+        report << "processBlock timing (" << juce::String(sampleRate.load(), 0) << " Hz, "
+               << maxBlockSize.load() << " samples = " << juce::String(getDeadlineMicros(), 0) << " us deadline)\n";
+        report << juce::String("section").paddedRight(' ', 15)
+               << juce::String("blocks").paddedLeft(' ', 10)
+               << juce::String("p50 us").paddedLeft(' ', 10)
+               << juce::String("p99 us").paddedLeft(' ', 10)
+               << juce::String("max us").paddedLeft(' ', 10)
+               << juce::String("overruns").paddedLeft(' ', 10) << "\n";
+
+        for (int section : { (int) total, (int) hostSync, (int) audioToMidi, (int) liveMidi, (int) bendLoop, (int) noteOutput })
+        {
+            const auto s = getStats(section);
+            report << juce::String(getSectionName(section)).paddedRight(' ', 15)
+                   << juce::String((juce::int64) s.blocks).paddedLeft(' ', 10)
+                   << juce::String(s.p50Micros, 1).paddedLeft(' ', 10)
+                   << juce::String(s.p99Micros, 1).paddedLeft(' ', 10)
+                   << juce::String(s.maxMicros, 1).paddedLeft(' ', 10)
+                   << juce::String((juce::int64) s.overruns).paddedLeft(' ', 10) << "\n";
+        }
+        return report;
+    }
+
+    //==========================================================================
+    // Audio-Thread
+
+    /** Blockbeginn. Offline-Blöcke (Bounce) haben keine Deadline und werden nicht gezählt. */
+    void beginBlock(int numSamples, bool isRealtime) noexcept
+    {
+        if (resetRequested.exchange(false))
+            clearAll();
+
+        blockActive = isRealtime;
+        if (!blockActive)
+            return;
+
+        TraceRecorder::nameCurrentThread("audio");
+
+        blockTicks.fill(0);
+        ranMask = 0;
+        currentSection = noSection;
+        deadlineNanos = (uint64_t) (1.0e9 * numSamples / sampleRate.load(std::memory_order_relaxed));
+        blockStartTicks = juce::Time::getHighResolutionTicks();
+    }
+
+    SectionToken beginSection(Section section) noexcept
+    {
+        SectionToken token;
+        if (!blockActive)
+            return token;
+
+        token.section = section;
+        token.parent = currentSection;
+        currentSection = section;
+        token.startTicks = juce::Time::getHighResolutionTicks();
+        return token;
+    }
+
+    void endSection(const SectionToken& token) noexcept
+    {
+        if (!blockActive || token.section == noSection)
+            return;
+
+        const auto elapsed = juce::Time::getHighResolutionTicks() - token.startTicks;
+        TraceRecorder::getInstance().addComplete(getSectionName(token.section), "audio", token.startTicks, elapsed);
+        blockTicks[(size_t) token.section] += elapsed;
+        ranMask |= 1u << token.section;
+        if (token.parent != noSection)
+            blockTicks[(size_t) token.parent] -= elapsed;   // exklusiv zählen
+        currentSection = token.parent;
+    }
+
+    struct ScopedSection
+    {
+        ScopedSection(AudioThreadProfiler& p, Section section) noexcept : profiler(p), token(p.beginSection(section)) {}
+        ~ScopedSection() noexcept { profiler.endSection(token); }
+
+        AudioThreadProfiler& profiler;
+        const SectionToken token;
+    };
+
+    void endBlock() noexcept
+    {
+        if (!blockActive)
+            return;
+        blockActive = false;
+
+        const auto totalTicks = juce::Time::getHighResolutionTicks() - blockStartTicks;
+        TraceRecorder::getInstance().addComplete("processBlock", "audio", blockStartTicks, totalTicks);
+        const auto totalNanos = ticksToNanos(totalTicks);
+        const bool overrun = totalNanos > deadlineNanos;
+        record(histograms[total], totalNanos, overrun);
+
+        int worst = noSection;
+        uint64_t worstNanos = 0;
+        for (int s = 0; s < numSections; ++s)
+        {
+            if ((ranMask & (1u << s)) == 0)
+                continue;
+            const auto nanos = ticksToNanos(blockTicks[(size_t) s]);
+            record(histograms[(size_t) s], nanos, false);
+            if (nanos >= worstNanos)
+            {
+                worst = s;
+                worstNanos = nanos;
+            }
+        }
+
+        if (overrun && worst != noSection)
+            bump(histograms[(size_t) worst].overruns);
+    }
+
+private:
+    // Bucket 0..3 = 0..3 ns, danach 4 Stufen pro Zweierpotenz bis ~4 s
+    static constexpr size_t numBuckets = 4 * 31;
+
+    struct Histogram
+    {
+        std::array<std::atomic<uint32_t>, numBuckets> counts {};
+        std::atomic<uint64_t> maxNanos { 0 };
+        std::atomic<uint64_t> overruns { 0 };
+    };
+
+    static size_t bucketFor(uint64_t nanos) noexcept
+    {
+        const auto v = (uint32_t) std::min<uint64_t>(nanos, 0xffffffffu);
+        if (v < 4)
+            return v;
+        const int e = juce::findHighestSetBit(v);
+        return (size_t) std::min<int>(4 * (e - 1) + (int) ((v >> (e - 2)) & 3u), (int) numBuckets - 1);
+    }
+
+    static double bucketUpperMicros(size_t bucket) noexcept
+    {
+        if (bucket < 4)
+            return (bucket + 1) / 1000.0;
+        const int e = (int) bucket / 4 + 1;
+        const uint64_t upper = (uint64_t) (5 + bucket % 4) << (e - 2);
+        return (double) upper / 1000.0;
+    }
+
+    static double percentileMicros(const std::array<uint32_t, numBuckets>& counts, uint64_t totalCount, double p)
+    {
+        if (totalCount == 0)
+            return 0.0;
+        const auto rank = (uint64_t) std::ceil(p * (double) totalCount);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < numBuckets; ++i)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+                return bucketUpperMicros(i);
+        }
+        return bucketUpperMicros(numBuckets - 1);
+    }
+
+    // Einziger Schreiber: kein RMW nötig
+    template <typename T>
+    static void bump(std::atomic<T>& counter) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static void record(Histogram& h, uint64_t nanos, bool overrun) noexcept
+    {
+        bump(h.counts[bucketFor(nanos)]);
+        if (nanos > h.maxNanos.load(std::memory_order_relaxed))
+            h.maxNanos.store(nanos, std::memory_order_relaxed);
+        if (overrun)
+            bump(h.overruns);
+    }
+
+    uint64_t ticksToNanos(juce::int64 ticks) const noexcept
+    {
+        return ticks <= 0 ? 0 : (uint64_t) (1.0e9 * (double) ticks / ticksPerSecond);
+    }
+
+    void clearAll() noexcept
+    {
+        for (auto& h : histograms)
+        {
+            for (auto& c : h.counts)
+                c.store(0, std::memory_order_relaxed);
+            h.maxNanos.store(0, std::memory_order_relaxed);
+            h.overruns.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::array<Histogram, numSections + 1> histograms;
+    std::atomic<double> sampleRate { 44100.0 };
+    std::atomic<int> maxBlockSize { 512 };
+    std::atomic<bool> resetRequested { false };
+    const double ticksPerSecond = (double) juce::Time::getHighResolutionTicksPerSecond();
+
+    // Nur Audio-Thread
+    bool blockActive = false;
+    juce::int64 blockStartTicks = 0;
+    uint64_t deadlineNanos = 0;
+    std::array<juce::int64, numSections> blockTicks {};
+    uint32_t ranMask = 0;
+    Section currentSection = noSection;
+};
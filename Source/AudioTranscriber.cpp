@@ -9,11 +9,13 @@
 */
 
 #include "AudioTranscriber.h"
+#include "TraceRecorder.h"
 
 AudioTranscriber::AudioTranscriber()
     : juce::Thread("BasicPitchTranscriber")
 {
     mAccumulationBuffer.resize(kMaxAccumulationSamples, 0.0f);
+    updateMemoryAccounts();
 }
 
 AudioTranscriber::~AudioTranscriber()
@@ -62,6 +64,7 @@ void AudioTranscriber::reset()
     }
 
     mBasicPitch.reset();
+    updateMemoryAccounts();
 }
 
 //==============================================================================
@@ -232,6 +235,12 @@ void AudioTranscriber::run()
 
     mTranscriptionRequested.store(false);
 
+    // Eingangspuffer hier buchen, nicht in startTranscription (Audio-Thread)
+    updateMemoryAccounts();
+
+    TraceRecorder::nameCurrentThread("BasicPitch transcriber");
+    TraceScope trace("transcription", "transcriber");
+
     DBG("AudioTranscriber: Starting transcription of "
         + juce::String(mTranscriptionInputSize) + " samples ("
         + juce::String(static_cast<double>(mTranscriptionInputSize) / BASIC_PITCH_SAMPLE_RATE, 1) + "s)");
@@ -268,6 +277,8 @@ void AudioTranscriber::run()
         mNoteEvents = mBasicPitch.getNoteEvents();
     }
 
+    updateMemoryAccounts();
+
     auto elapsed = juce::Time::getMillisecondCounterHiRes() - startTime;
 
     DBG("AudioTranscriber: Transcription complete - "
@@ -277,3 +288,27 @@ void AudioTranscriber::run()
     resultsAvailable.store(true);
     transcriptionInProgress.store(false);
 }
+
+//==============================================================================
+// Memory Accounting
+//==============================================================================
+
+void AudioTranscriber::updateMemoryAccounts()
+{
+    mCaptureMemory.setBytes(MemoryAccounting::bytesOf(mAccumulationBuffer)
+                            + MemoryAccounting::bytesOf(mResampleOutputBuffer)
+                            + MemoryAccounting::bytesOf(mTranscriptionInput));
+
+    size_t resultBytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(mResultsMutex);
+        resultBytes = MemoryAccounting::bytesOf(mNoteEvents);
+        for (const auto& event : mNoteEvents)
+            resultBytes += MemoryAccounting::bytesOf(event.bends);
+    }
+
+    mFeatureMemory.setBytes(mBasicPitch.getFeatureBytes());
+    mPosteriorgramMemory.setBytes(mBasicPitch.getPosteriorgramBytes() + resultBytes);
+    mNoteExtractionMemory.setBytes(mBasicPitch.getNoteExtractionBytes());
+    mModelMemory.setBytes(BasicPitch::getModelBytes());
+}
@@ -23,6 +23,7 @@
 #include "BasicPitchConstants.h"
 #include "Resampler.h"
 #include "Notes.h"
+#include "MemoryAccounting.h"
 
 #include <atomic>
 #include <mutex>
@@ -114,6 +115,10 @@ public:
     /** True while transcription is running in background. */
     bool isTranscribing() const { return transcriptionInProgress.load(); }
 
+    /** Belegung von Aufnahmepuffern und BasicPitch-Pipeline melden (nie im Audio-Thread;
+        von außen nur, wenn keine Transkription läuft - run() bucht selbst). */
+    void updateMemoryAccounts();
+
     /** True when transcription results are available. */
     bool hasResults() const { return resultsAvailable.load(); }
 
@@ -187,5 +192,12 @@ private:
 
     double mHostSampleRate = 44100.0;
 
+    // Speicherbuchhaltung (Debug-Panel, Report)
+    MemoryAccount mCaptureMemory { MemoryAccounting::audioCapture };
+    MemoryAccount mFeatureMemory { MemoryAccounting::featureTensors };
+    MemoryAccount mPosteriorgramMemory { MemoryAccounting::posteriorgrams };
+    MemoryAccount mNoteExtractionMemory { MemoryAccounting::noteExtraction };
+    MemoryAccount mModelMemory { MemoryAccounting::transcriptionModel };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioTranscriber)
 };
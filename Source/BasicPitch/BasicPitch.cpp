@@ -3,6 +3,9 @@
 //
 
 #include "BasicPitch.h"
+#include "../TraceRecorder.h"
+
+#include <optional>
 
 void BasicPitch::reset()
 {
@@ -36,6 +39,8 @@ void BasicPitch::setParameters(float inNoteSensitivity, float inSplitSensitivity
 
 void BasicPitch::transcribeToMIDI(float* inAudio, int inNumSamples)
 {
+    TraceScope trace("transcribeToMIDI", "transcriber");
+
     // To test if downsampling works as expected
 #if SAVE_DOWNSAMPLED_AUDIO
     auto file = juce::File::getSpecialLocation(juce::File::userDesktopDirectory).getChildFile("Test_Downsampled.wav");
@@ -56,7 +61,11 @@ void BasicPitch::transcribeToMIDI(float* inAudio, int inNumSamples)
     }
 #endif
 
-    const float* stacked_cqt = mFeaturesCalculator.computeFeatures(inAudio, inNumSamples, mNumFrames);
+    const float* stacked_cqt = nullptr;
+    {
+        TraceScope traceFeatures("computeFeatures", "transcriber");
+        stacked_cqt = mFeaturesCalculator.computeFeatures(inAudio, inNumSamples, mNumFrames);
+    }
 
     mOnsetsPG.resize(mNumFrames, std::vector<float>(static_cast<size_t>(NUM_FREQ_OUT), 0.0f));
     mNotesPG.resize(mNumFrames, std::vector<float>(static_cast<size_t>(NUM_FREQ_OUT), 0.0f));
@@ -68,6 +77,9 @@ void BasicPitch::transcribeToMIDI(float* inAudio, int inNumSamples)
 
     mBasicPitchCNN.reset();
 
+    std::optional<TraceScope> traceCnn;
+    traceCnn.emplace("CNN inference", "transcriber");
+
     const size_t num_lh_frames = BasicPitchCNN::getNumFramesLookahead();
 
     std::vector<float> zero_stacked_cqt(NUM_HARMONICS * NUM_FREQ_IN, 0.0f);
@@ -99,11 +111,15 @@ void BasicPitch::transcribeToMIDI(float* inAudio, int inNumSamples)
                                       mOnsetsPG[frame_idx - num_lh_frames]);
     }
 
+    traceCnn.reset();
+
+    TraceScope traceNotes("Notes::convert", "transcriber");
     mNoteEvents = mNotesCreator.convert(mNotesPG, mOnsetsPG, mContoursPG, mParams, true);
 }
 
 void BasicPitch::updateMIDI()
 {
+    TraceScope trace("Notes::convert", "transcriber");
     mNoteEvents = mNotesCreator.convert(mNotesPG, mOnsetsPG, mContoursPG, mParams, false);
 }
 
@@ -111,3 +127,17 @@ const std::vector<Notes::Event>& BasicPitch::getNoteEvents() const
 {
     return mNoteEvents;
 }
+
+size_t BasicPitch::getPosteriorgramBytes() const
+{
+    size_t bytes = mNoteEvents.capacity() * sizeof(Notes::Event);
+    for (const auto& event: mNoteEvents)
+        bytes += event.bends.capacity() * sizeof(int);
+
+    for (const auto* pg: {&mContoursPG, &mNotesPG, &mOnsetsPG}) {
+        bytes += pg->capacity() * sizeof(std::vector<float>);
+        for (const auto& frame: *pg)
+            bytes += frame.capacity() * sizeof(float);
+    }
+    return bytes;
+}
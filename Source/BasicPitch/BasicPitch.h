@@ -49,6 +49,27 @@ public:
      */
     const std::vector<Notes::Event>& getNoteEvents() const;
 
+    /**
+     * @return Bytes held by the posteriorgrams and the note event vector.
+     */
+    size_t getPosteriorgramBytes() const;
+
+    /**
+     * @return Bytes held by the feature tensor of the last transcription.
+     */
+    size_t getFeatureBytes() const { return mFeaturesCalculator.getAllocatedBytes(); }
+
+    /**
+     * @return Bytes held by the note extraction (Notes) buffers.
+     */
+    size_t getNoteExtractionBytes() const { return mNotesCreator.getAllocatedBytes(); }
+
+    /**
+     * @return Estimated model memory: CNN weights and state (inline) plus the ONNX session,
+     * which keeps roughly one copy of the serialized features model.
+     */
+    static size_t getModelBytes() { return sizeof(BasicPitchCNN) + static_cast<size_t>(BinaryData::features_model_onnxSize); }
+
 private:
     // Posteriorgrams vector
     std::vector<std::vector<float>> mContoursPG;
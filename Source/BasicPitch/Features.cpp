@@ -37,3 +37,11 @@ const float* Features::computeFeatures(float* inAudio, size_t inNumSamples, size
 
     return mOutput[0].GetTensorData<float>();
 }
+
+size_t Features::getAllocatedBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& value: mOutput)
+        bytes += value.GetTensorTypeAndShapeInfo().GetElementCount() * sizeof(float);
+    return bytes;
+}
@@ -30,6 +30,11 @@ public:
      */
     const float* computeFeatures(float* inAudio, size_t inNumSamples, size_t& outNumFrames);
 
+    /**
+     * @return Bytes held by the output tensor of the last computeFeatures call.
+     */
+    size_t getAllocatedBytes() const;
+
 private:
     // ONNX Runtime Data
     std::vector<Ort::Value> mInput;
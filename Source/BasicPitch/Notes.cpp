@@ -243,6 +243,15 @@ void Notes::clear()
     mRemainingEnergyIndex.shrink_to_fit();
 }
 
+size_t Notes::getAllocatedBytes() const
+{
+    size_t bytes = mRemainingEnergy.capacity() * sizeof(std::vector<float>)
+                   + mRemainingEnergyIndex.capacity() * sizeof(_pg_index);
+    for (const auto& frame: mRemainingEnergy)
+        bytes += frame.capacity() * sizeof(float);
+    return bytes;
+}
+
 void Notes::_addPitchBends(std::vector<Event>& inOutEvents,
                            const std::vector<std::vector<float>>& inContoursPG,
                            int inNumBinsTolerance)
@@ -68,6 +68,11 @@ public:
      */
     void clear();
 
+    /**
+     * @return Bytes currently allocated by the class (remaining energy and its sorted index).
+     */
+    size_t getAllocatedBytes() const;
+
     /**
      * Inplace sort of note events.
      * @param inOutEvents
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    ChannelWorkerPool.h
+
+    Kleiner Worker-Pool für unabhängige Aufgaben pro MIDI-Kanal
+    (Re-Optimierung, Track-Aufbau). runAll() verteilt die Jobs auf die
+    Worker-Threads und kehrt erst zurück, wenn alle fertig sind.
+
+    Jobs arbeiten auf Snapshots und schreiben nur in ihren eigenen
+    Ergebnis-Slot; das Zusammenführen übernimmt der Aufrufer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <functional>
+
+//==============================================================================
+/**
+ * ChannelWorkerPool
+ */
+class ChannelWorkerPool
+{
+public:
+    explicit ChannelWorkerPool(int numThreads = defaultThreadCount())
+        : pool(juce::jmax(1, numThreads))
+    {
+    }
+
+    ~ChannelWorkerPool()
+    {
+        pool.removeAllJobs(true, 2000);
+    }
+
+    /** Anzahl Worker: alle Kerne bis auf einen (Audio-Thread), max. 8. */
+    static int defaultThreadCount()
+    {
+        return juce::jlimit(1, 8, juce::SystemStats::getNumCpus() - 1);
+    }
+
+    /**
+     * Führt job(0..numJobs-1) parallel aus und wartet auf alle.
+     * Ein einzelner Job läuft direkt im aufrufenden Thread.
+     * Ist cancelled gesetzt, starten noch wartende Jobs nicht mehr - so kann der
+     * Besitzer eines Hintergrund-Threads ohne Timeout auf dessen Ende warten.
+     */
+    void runAll(int numJobs, const std::function<void(int)>& job,
+                const std::atomic<bool>* cancelled = nullptr)
+    {
+        if (numJobs <= 0)
+            return;
+
+        if (numJobs == 1)
+        {
+            if (cancelled == nullptr || ! cancelled->load(std::memory_order_acquire))
+                job(0);
+            return;
+        }
+
+        std::atomic<int> remaining { numJobs };
+        juce::WaitableEvent allDone;
+
+        for (int i = 0; i < numJobs; ++i)
+        {
+            pool.addJob([&job, &remaining, &allDone, cancelled, i]
+            {
+                if (cancelled == nullptr || ! cancelled->load(std::memory_order_acquire))
+                    job(i);
+                if (remaining.fetch_sub(1) == 1)
+                    allDone.signal();
+            });
+        }
+
+        allDone.wait(-1);
+    }
+
+private:
+    juce::ThreadPool pool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChannelWorkerPool)
+};
@@ -3,8 +3,10 @@
 
     ChordFingerDB.h
     
-    Datenbank für Akkord-Fingersätze. Lädt Fingerpositionen aus einer CSV-Datei
-    und ordnet erkannten Akkorden die optimalen Fingersätze zu.
+    Datenbank für Akkord-Fingersätze. Ordnet erkannten Akkorden die optimalen
+    Fingersätze zu. Die Daten (resources/chord-fingers.csv) werden beim Build
+    von ChordFingerDBGen in sortierte constexpr-Arrays übersetzt
+    (ChordFingerData.h) - kein Parsen und keine Allokation zur Laufzeit.
     
     Basierend auf den Erkenntnissen aus:
     "Putting a Finger on Guitars and Algorithms" (Ilczuk & Sköld, KTH 2013)
@@ -22,31 +24,12 @@
 #pragma once
 
 #include <juce_core/juce_core.h>
+#include "ChordFingerData.h"  // generiert (siehe CMakeLists.txt)
 #include <vector>
-#include <map>
+#include <cstring>
 #include <array>
-#include <string>
-#include <set>
 #include <algorithm>
-
-//==============================================================================
-/**
- * ChordFingerEntry
- * 
- * Ein einzelner Eintrag aus der Datenbank: ein Akkord-Griffbild mit Fingern.
- */
-struct ChordFingerEntry
-{
-    juce::String root;           // z.B. "C", "A#", "Gb"
-    juce::String type;           // z.B. "maj", "m", "7", "dim7"
-    juce::String structure;      // z.B. "1;3;5"
-    
-    // Finger pro Saite: -1 = nicht gespielt (x), 0 = Leersaite, 1-4 = Finger
-    std::array<int, 6> fingers = { -1, -1, -1, -1, -1, -1 };
-    
-    // Notennamen pro Saite
-    std::vector<juce::String> noteNames;
-};
+#include <cctype>
 
 //==============================================================================
 /**
@@ -59,100 +42,9 @@ class ChordFingerDB
 public:
     ChordFingerDB() = default;
     
-    //==========================================================================
-    // Laden der Datenbank
-    //==========================================================================
-    
-    /**
-     * Lädt die Datenbank aus einer CSV-Datei.
-     * Format: CHORD_ROOT;CHORD_TYPE;CHORD_STRUCTURE;FINGER_POSITIONS;NOTE_NAMES
-     * 
-     * @param csvFile Pfad zur CSV-Datei
-     * @return true wenn erfolgreich geladen
-     */
-    bool loadFromFile(const juce::File& csvFile)
-    {
-        entries.clear();
-        
-        if (!csvFile.existsAsFile())
-            return false;
-        
-        juce::StringArray lines;
-        csvFile.readLines(lines);
-        
-        if (lines.size() < 2)
-            return false;
-        
-        // Überspringe Header
-        for (int i = 1; i < lines.size(); ++i)
-        {
-            auto line = lines[i].trim();
-            if (line.isEmpty())
-                continue;
-            
-            auto entry = parseLine(line);
-            if (entry.root.isNotEmpty())
-            {
-                entries.push_back(entry);
-                
-                // Index aufbauen
-                juce::String key = (entry.root + ";" + entry.type).toLowerCase();
-                entryIndex[key.toStdString()].push_back(entries.size() - 1);
-            }
-        }
-        
-        DBG("ChordFingerDB: " << entries.size() << " entries loaded from " << csvFile.getFileName());
-        loaded = true;
-        return true;
-    }
-    
-    bool isLoaded() const { return loaded; }
-    int getEntryCount() const { return (int)entries.size(); }
-    
-    /**
-     * Lädt die Datenbank aus BinaryData (eingebettet im Plugin).
-     * 
-     * @param data Zeiger auf die CSV-Daten
-     * @param dataSize Größe der Daten in Bytes
-     * @return true wenn erfolgreich geladen
-     */
-    bool loadFromBinaryData(const char* data, int dataSize)
-    {
-        entries.clear();
-        entryIndex.clear();
-        
-        if (data == nullptr || dataSize <= 0)
-            return false;
-        
-        juce::String csvContent(data, (size_t)dataSize);
-        juce::StringArray lines;
-        lines.addLines(csvContent);
-        
-        if (lines.size() < 2)
-            return false;
-        
-        // Überspringe Header
-        for (int i = 1; i < lines.size(); ++i)
-        {
-            auto line = lines[i].trim();
-            if (line.isEmpty())
-                continue;
-            
-            auto entry = parseLine(line);
-            if (entry.root.isNotEmpty())
-            {
-                entries.push_back(entry);
-                
-                // Index aufbauen
-                juce::String key = (entry.root + ";" + entry.type).toLowerCase();
-                entryIndex[key.toStdString()].push_back(entries.size() - 1);
-            }
-        }
-        
-        DBG("ChordFingerDB: " << entries.size() << " entries loaded from BinaryData");
-        loaded = true;
-        return true;
-    }
+    // Die Datenbank ist einkompiliert und immer verfügbar
+    bool isLoaded() const { return ChordFingerData::numEntries > 0; }
+    int getEntryCount() const { return ChordFingerData::numEntries; }
     
     //==========================================================================
     // Akkord-Fingersatz finden
@@ -163,43 +55,42 @@ public:
      * 
      * @param chordName Der erkannte Akkordname (z.B. "Cmaj", "Am7")
      * @param frets Die aktuellen Bundpositionen pro Saite (-1 = nicht gespielt)
-     * @param tuning Das Tuning des Instruments
      * @return Array von Fingernummern pro Saite (-1=nicht, 0=leer, 1-4=Finger)
      */
     std::array<int, 6> findFingers(const juce::String& chordName,
-                                    const std::array<int, 6>& frets,
-                                    const std::array<int, 6>& tuning) const
+                                    const std::array<int, 6>& frets) const
     {
         std::array<int, 6> result = { -1, -1, -1, -1, -1, -1 };
         
-        if (!loaded)
+        // Parse den Akkordnamen in Root + Type (ohne Allokation)
+        int rootPitchClass = -1, typeId = -1;
+        if (!parseChordName(chordName, rootPitchClass, typeId))
             return result;
         
-        // Parse den Akkordnamen in Root + Type
-        auto [root, type] = parseChordName(chordName);
-        if (root.isEmpty())
-            return result;
+        // Suche im Index; unbekannter Typ -> Dur-Griffe als Annäherung
+        auto rangeFor = [rootPitchClass](int type, int& first, int& last) {
+            const int key = rootPitchClass * ChordFingerData::numTypes + type;
+            first = ChordFingerData::keyOffsets[key];
+            last = ChordFingerData::keyOffsets[key + 1];
+            return first < last;
+        };
         
-        // Suche im Index
-        juce::String key = (root + ";" + type).toLowerCase();
-        auto it = entryIndex.find(key.toStdString());
-        if (it == entryIndex.end())
+        int first = 0, last = 0;
+        if (typeId < 0 || !rangeFor(typeId, first, last))
         {
-            // Versuche alternative Schreibweisen
-            key = (root + ";maj").toLowerCase();
-            it = entryIndex.find(key.toStdString());
-            if (it == entryIndex.end())
+            const int majorTypeId = findTypeId("maj", 3);
+            if (majorTypeId < 0 || !rangeFor(majorTypeId, first, last))
                 return result;
         }
         
         // Finde den Eintrag der am besten zu den aktuellen Fret-Positionen passt
         int bestScore = -1000;
-        const ChordFingerEntry* bestEntry = nullptr;
+        const ChordFingerData::Entry* bestEntry = nullptr;
         
-        for (size_t idx : it->second)
+        for (int idx = first; idx < last; ++idx)
         {
-            const auto& entry = entries[idx];
-            int score = matchScore(entry, frets, tuning);
+            const auto& entry = ChordFingerData::entries[idx];
+            int score = matchScore(entry, frets);
             if (score > bestScore)
             {
                 bestScore = score;
@@ -209,7 +100,8 @@ public:
         
         if (bestEntry != nullptr && bestScore > -100)
         {
-            result = bestEntry->fingers;
+            for (int s = 0; s < 6; ++s)
+                result[(size_t) s] = bestEntry->fingers[s];
         }
         
         return result;
@@ -273,21 +165,55 @@ public:
         return idealFinger;
     }
     
+    /**
+     * Fingersatz für einen Griff auf bis zu numStrings Saiten: aus der DB, wenn ein
+     * Akkordname da ist und nur die sechs hohen Saiten einer Gitarre (stringCount >= 6)
+     * belegt sind - die DB kennt nur 6-saitige Griffe. Sonst algorithmisch.
+     */
+    template <size_t numStrings>
+    std::array<int, numStrings> findOrCalculateFingers(const juce::String& chordName,
+                                                       const std::array<int, numStrings>& frets,
+                                                       int stringCount) const
+    {
+        static_assert(numStrings >= 6, "DB-Griffe haben sechs Saiten");
+        
+        const bool onlyHighSixStrings = stringCount >= 6
+            && std::all_of(frets.begin() + 6, frets.end(), [](int fret) { return fret < 0; });
+        if (isLoaded() && chordName.isNotEmpty() && onlyHighSixStrings)
+        {
+            std::array<int, 6> dbFrets;
+            std::copy_n(frets.begin(), 6, dbFrets.begin());
+            const auto dbFingers = findFingers(chordName, dbFrets);
+            
+            if (std::any_of(dbFingers.begin(), dbFingers.end(), [](int f) { return f >= 0; }))
+            {
+                std::array<int, numStrings> fingers;
+                fingers.fill(-1);
+                std::copy(dbFingers.begin(), dbFingers.end(), fingers.begin());
+                return fingers;
+            }
+        }
+        return calculateFingersForChord(frets);
+    }
+    
     /**
      * Berechnet Finger für eine Gruppe gleichzeitiger Noten (Akkord)
      * ohne DB-Matching, rein algorithmisch.
      * 
-     * @param frets Array von Fret-Positionen (6 Saiten, -1 = nicht gespielt)
+     * @param frets Array von Fret-Positionen (eine pro Saite, -1 = nicht gespielt;
+     *              auch für 7/8-Saiter und Bass)
      * @return Array von Fingernummern pro Saite
      */
-    static std::array<int, 6> calculateFingersForChord(const std::array<int, 6>& frets)
+    template <size_t numStrings>
+    static std::array<int, numStrings> calculateFingersForChord(const std::array<int, numStrings>& frets)
     {
-        std::array<int, 6> fingers = { -1, -1, -1, -1, -1, -1 };
+        std::array<int, numStrings> fingers;
+        fingers.fill(-1);
         
         // Sammle gespielte Noten (sortiert nach Bund)
         struct PlayedNote { int string; int fret; };
         std::vector<PlayedNote> played;
-        for (int s = 0; s < 6; ++s)
+        for (int s = 0; s < (int) numStrings; ++s)
         {
             if (frets[s] >= 0)
             {
@@ -375,10 +301,6 @@ public:
     }
 
 private:
-    std::vector<ChordFingerEntry> entries;
-    std::map<std::string, std::vector<size_t>> entryIndex;  // "root;type" -> indices
-    bool loaded = false;
-    
     /**
      * Default-Finger basierend auf Bundposition.
      * Position 1-4: Finger 1 greift Bund 1, Finger 2 Bund 2, etc.
@@ -394,69 +316,12 @@ private:
         return juce::jlimit(1, 4, fingerInPosition);
     }
     
-    /**
-     * Parsed eine CSV-Zeile.
-     * Format: ROOT;TYPE;"STRUCTURE";FINGERS;NOTES
-     */
-    ChordFingerEntry parseLine(const juce::String& line) const
-    {
-        ChordFingerEntry entry;
-        
-        // Finde die erste und zweite Anführungszeichen für STRUCTURE
-        int q1 = line.indexOf("\"");
-        int q2 = (q1 >= 0) ? line.indexOf(q1 + 1, "\"") : -1;
-        
-        if (q1 < 0 || q2 < 0)
-            return entry;  // Ungültige Zeile
-        
-        // Vor dem ersten Quote: ROOT;TYPE;
-        juce::String prefix = line.substring(0, q1);
-        juce::StringArray prefixParts;
-        prefixParts.addTokens(prefix, ";", "");
-        
-        if (prefixParts.size() < 2)
-            return entry;
-        
-        entry.root = prefixParts[0].trim();
-        entry.type = prefixParts[1].trim();
-        entry.structure = line.substring(q1 + 1, q2).trim();
-        
-        // Nach dem zweiten Quote: ;FINGERS;NOTES
-        juce::String suffix = line.substring(q2 + 2);  // Skip quote and ;
-        int semicolonPos = suffix.indexOf(";");
-        
-        juce::String fingerStr = (semicolonPos >= 0) ? suffix.substring(0, semicolonPos) : suffix;
-        juce::String noteStr = (semicolonPos >= 0) ? suffix.substring(semicolonPos + 1) : "";
-        
-        // Parse Finger-Positionen (kommagetrennt)
-        juce::StringArray fingerParts;
-        fingerParts.addTokens(fingerStr, ",", "");
-        
-        for (int i = 0; i < juce::jmin(6, fingerParts.size()); ++i)
-        {
-            auto f = fingerParts[i].trim();
-            if (f == "x" || f == "X")
-                entry.fingers[i] = -1;
-            else
-                entry.fingers[i] = f.getIntValue();
-        }
-        
-        // Parse Notennamen
-        juce::StringArray noteParts;
-        noteParts.addTokens(noteStr, ",", "");
-        for (const auto& n : noteParts)
-            entry.noteNames.push_back(n.trim());
-        
-        return entry;
-    }
-    
     /**
      * Berechnet wie gut ein DB-Eintrag zu den aktuellen Fret-Positionen passt.
      * Höherer Score = bessere Übereinstimmung.
      */
-    int matchScore(const ChordFingerEntry& entry,
-                   const std::array<int, 6>& frets,
-                   const std::array<int, 6>& /*tuning*/) const
+    static int matchScore(const ChordFingerData::Entry& entry,
+                          const std::array<int, 6>& frets)
     {
         int score = 0;
         
@@ -493,35 +358,85 @@ private:
     }
     
     /**
-     * Parsed einen Akkordnamen in Root und Type.
-     * z.B. "Cmaj7" -> ("C", "maj7"), "Am" -> ("A", "m"), "F#m7" -> ("F#", "m7")
+     * Parsed einen Akkordnamen in Grundton-Tonklasse und Typ-Index.
+     * z.B. "Cmaj7" -> (0, "maj7"), "Am" -> (9, "m"), "F#m7/E" -> (6, "m7")
+     * typeId = -1 wenn der Typ nicht in der Datenbank ist.
      */
-    std::pair<juce::String, juce::String> parseChordName(const juce::String& name) const
+    static bool parseChordName(const juce::String& name, int& rootPitchClass, int& typeId)
     {
-        if (name.isEmpty())
-            return {"", ""};
-        
-        juce::String root;
-        juce::String type;
+        const char* text = name.toRawUTF8();
+        size_t length = std::strlen(text);
+        if (length == 0)
+            return false;
         
         // Root ist 1-2 Zeichen: Buchstabe + optional # oder b
-        int pos = 1;
-        if (name.length() > 1)
+        static const int letterPitchClass[] = { 9, 11, 0, 2, 4, 5, 7 };  // A B C D E F G
+        char letter = (char) (text[0] & ~0x20);  // toupper
+        if (letter < 'A' || letter > 'G')
+            return false;
+        
+        rootPitchClass = letterPitchClass[letter - 'A'];
+        size_t pos = 1;
+        if (length > 1 && (text[1] == '#' || text[1] == 'b'))
         {
-            juce::juce_wchar second = name[1];
-            if (second == '#' || second == 'b')
-                pos = 2;
+            rootPitchClass += (text[1] == '#') ? 1 : -1;
+            pos = 2;
         }
+        rootPitchClass = (rootPitchClass + 12) % 12;
+        
+        const char* type = text + pos;
+        size_t typeLength = length - pos;
         
-        root = name.substring(0, pos);
-        type = name.substring(pos);
+        // Slash-Bass ("Am7/E") ignorieren - die DB kennt nur Grundstellungen.
+        // Ausnahme: "6/9" ist ein Akkordtyp, kein Slash-Akkord.
+        if (!(typeLength == 3 && std::strncmp(type, "6/9", 3) == 0))
+        {
+            if (const char* slash = std::strchr(type, '/'))
+                typeLength = (size_t) (slash - type);
+        }
         
         // Normalisiere Type
-        if (type.isEmpty() || type.equalsIgnoreCase("major"))
-            type = "maj";
-        else if (type.equalsIgnoreCase("minor"))
-            type = "m";
+        if (typeLength == 0 || equalsIgnoreCase(type, typeLength, "major"))
+            typeId = findTypeId("maj", 3);
+        else if (equalsIgnoreCase(type, typeLength, "minor"))
+            typeId = findTypeId("m", 1);
+        else
+            typeId = findTypeId(type, typeLength);
         
-        return {root, type};
+        return true;
+    }
+    
+    /** Binäre Suche in den (lowercase, sortierten) Typnamen. */
+    static int findTypeId(const char* type, size_t length)
+    {
+        int lo = 0, hi = ChordFingerData::numTypes - 1;
+        while (lo <= hi)
+        {
+            int mid = (lo + hi) / 2;
+            int cmp = compareLowercase(type, length, ChordFingerData::typeNames[mid]);
+            if (cmp == 0)
+                return mid;
+            if (cmp < 0)
+                hi = mid - 1;
+            else
+                lo = mid + 1;
+        }
+        return -1;
+    }
+    
+    static int compareLowercase(const char* a, size_t length, const char* b)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            char ca = (char) std::tolower((unsigned char) a[i]);
+            if (b[i] == 0 || ca > b[i]) return 1;
+            if (ca < b[i]) return -1;
+        }
+        return (b[length] == 0) ? 0 : -1;
+    }
+    
+    static bool equalsIgnoreCase(const char* a, size_t length, const char* b)
+    {
+        return std::strlen(b) == length && compareLowercase(a, length, b) == 0;
     }
 };
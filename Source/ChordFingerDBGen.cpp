@@ -0,0 +1,190 @@
+// ChordFingerDB Generator - Standalone build tool
+// Wandelt resources/chord-fingers.csv in einen Header mit sortierten constexpr-Arrays um,
+// damit das Plugin die Datenbank nicht bei jedem Start parsen muss.
+// Wird von CMake automatisch ausgeführt (Target ChordFingerDBGen).
+// Usage: ChordFingerDBGen <chord-fingers.csv> <ChordFingerData.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Row
+    {
+        int rootPitchClass;
+        std::string type;                 // lowercase
+        std::array<int, 6> fingers;
+    };
+
+    std::string trim(const std::string& s)
+    {
+        size_t a = s.find_first_not_of(" \t\r\n");
+        size_t b = s.find_last_not_of(" \t\r\n");
+        return (a == std::string::npos) ? std::string() : s.substr(a, b - a + 1);
+    }
+
+    std::string toLower(std::string s)
+    {
+        for (auto& c : s)
+            c = (char) std::tolower((unsigned char) c);
+        return s;
+    }
+
+    // "C", "C#", "Db", "Cb" ... -> 0..11, -1 bei Fehler
+    int rootToPitchClass(const std::string& root)
+    {
+        static const int base[] = { 9, 11, 0, 2, 4, 5, 7 };  // A B C D E F G
+        if (root.empty())
+            return -1;
+
+        char letter = (char) std::toupper((unsigned char) root[0]);
+        if (letter < 'A' || letter > 'G')
+            return -1;
+
+        int pc = base[letter - 'A'];
+        for (size_t i = 1; i < root.size(); ++i)
+        {
+            if (root[i] == '#') pc += 1;
+            else if (root[i] == 'b') pc -= 1;
+            else return -1;
+        }
+        return (pc + 12) % 12;
+    }
+
+    // Format: ROOT;TYPE;"STRUCTURE";FINGERS;NOTES (wie ChordFingerDB::parseLine bisher)
+    bool parseLine(const std::string& line, Row& row)
+    {
+        size_t q1 = line.find('"');
+        size_t q2 = (q1 != std::string::npos) ? line.find('"', q1 + 1) : std::string::npos;
+        if (q2 == std::string::npos)
+            return false;
+
+        std::string prefix = line.substr(0, q1);
+        size_t sep = prefix.find(';');
+        if (sep == std::string::npos)
+            return false;
+
+        row.rootPitchClass = rootToPitchClass(trim(prefix.substr(0, sep)));
+        std::string rest = prefix.substr(sep + 1);
+        row.type = toLower(trim(rest.substr(0, rest.find(';'))));
+        if (row.rootPitchClass < 0)
+            return false;
+
+        std::string suffix = (q2 + 2 <= line.size()) ? line.substr(q2 + 2) : std::string();
+        std::string fingerStr = suffix.substr(0, suffix.find(';'));
+
+        row.fingers.fill(-1);
+        std::stringstream ss(fingerStr);
+        std::string token;
+        for (int i = 0; i < 6 && std::getline(ss, token, ','); ++i)
+        {
+            token = trim(token);
+            row.fingers[(size_t) i] = (token == "x" || token == "X" || token.empty()) ? -1 : std::stoi(token);
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: ChordFingerDBGen <chord-fingers.csv> <ChordFingerData.h>\n";
+        return 1;
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in)
+    {
+        std::cerr << "ChordFingerDBGen: cannot open " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::vector<Row> rows;
+    std::string line;
+    std::getline(in, line);  // Header überspringen
+    while (std::getline(in, line))
+    {
+        line = trim(line);
+        if (line.empty())
+            continue;
+
+        Row row;
+        if (parseLine(line, row))
+            rows.push_back(row);
+        else
+            std::cerr << "ChordFingerDBGen: skipping invalid line: " << line << "\n";
+    }
+
+    // Typ-Tabelle (sortiert, für binäre Suche)
+    std::vector<std::string> types;
+    for (const auto& r : rows)
+        types.push_back(r.type);
+    std::sort(types.begin(), types.end());
+    types.erase(std::unique(types.begin(), types.end()), types.end());
+
+    auto typeId = [&types](const std::string& t) {
+        return (int) (std::lower_bound(types.begin(), types.end(), t) - types.begin());
+    };
+
+    // Stabil nach (Grundton, Typ) sortieren - CSV-Reihenfolge innerhalb eines Schlüssels bleibt
+    std::stable_sort(rows.begin(), rows.end(), [&](const Row& a, const Row& b) {
+        if (a.rootPitchClass != b.rootPitchClass) return a.rootPitchClass < b.rootPitchClass;
+        return typeId(a.type) < typeId(b.type);
+    });
+
+    // Direkter Index: key = root * numTypes + typeId -> [offsets[key], offsets[key+1])
+    const size_t numKeys = 12 * types.size();
+    std::vector<size_t> offsets(numKeys + 1, 0);
+    for (const auto& r : rows)
+        offsets[(size_t) r.rootPitchClass * types.size() + (size_t) typeId(r.type) + 1]++;
+    for (size_t k = 0; k < numKeys; ++k)
+        offsets[k + 1] += offsets[k];
+
+    std::ofstream out(argv[2]);
+    if (!out)
+    {
+        std::cerr << "ChordFingerDBGen: cannot write " << argv[2] << "\n";
+        return 1;
+    }
+
+    out << "// Generated by ChordFingerDBGen from chord-fingers.csv - do not edit.\n\n"
+        << "#pragma once\n\n"
+        << "#include <cstdint>\n\n"
+        << "namespace ChordFingerData\n{\n"
+        << "    struct Entry\n    {\n"
+        << "        int8_t fingers[6];   // -1 = nicht gespielt, 0 = Leersaite, 1-4 = Finger\n"
+        << "    };\n\n"
+        << "    inline constexpr int numTypes = " << types.size() << ";\n"
+        << "    inline constexpr int numEntries = " << rows.size() << ";\n\n"
+        << "    // Akkordtypen (lowercase, sortiert)\n"
+        << "    inline constexpr const char* typeNames[numTypes] = {\n";
+    for (const auto& t : types)
+        out << "        \"" << t << "\",\n";
+    out << "    };\n\n"
+        << "    // Eintragsbereich pro (Grundton-Tonklasse * numTypes + Typ)\n"
+        << "    inline constexpr uint16_t keyOffsets[12 * numTypes + 1] = {";
+    for (size_t k = 0; k <= numKeys; ++k)
+        out << ((k % 16 == 0) ? "\n        " : " ") << offsets[k] << ",";
+    out << "\n    };\n\n"
+        << "    inline constexpr Entry entries[numEntries] = {\n";
+    for (const auto& r : rows)
+    {
+        out << "        {{ ";
+        for (size_t i = 0; i < 6; ++i)
+            out << r.fingers[i] << (i < 5 ? ", " : "");
+        out << " }},\n";
+    }
+    out << "    };\n}\n";
+
+    std::cout << "ChordFingerDBGen: " << rows.size() << " entries, " << types.size() << " chord types\n";
+    return 0;
+}
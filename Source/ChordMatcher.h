@@ -19,11 +19,13 @@
 #pragma once
 
 #include <juce_core/juce_core.h>
+#include "PlayabilityCostModel.h"
 #include <vector>
 #include <array>
 #include <map>
 #include <set>
 #include <string>
+#include <cstdint>
 
 //==============================================================================
 /**
@@ -50,6 +52,11 @@ struct ChordShape
     // Tiefste klingende Note (für Bass-Matching)
     int bassMidiNote = 0;
     
+    // Pitch-Class-Set als 12-Bit-Maske (Bit n = Tonklasse n, C = Bit 0)
+    // und Tonklasse des Basstons - für Lookups ohne Allokation
+    uint16_t pitchClassMask = 0;
+    int bassPitchClass = 0;
+    
     // Basis-Bund-Position (für Barre-Akkorde)
     int baseFret = 0;
     
@@ -84,8 +91,16 @@ struct ChordShape
         
         // Sortiere für einfachen Vergleich
         std::sort(midiNotes.begin(), midiNotes.end());
+        
+        pitchClassMask = 0;
+        for (int note : midiNotes)
+            pitchClassMask |= (uint16_t) (1u << (note % 12));
+        bassPitchClass = bassMidiNote % 12;
     }
     
+    // Enthält dieses Shape alle Tonklassen der Maske?
+    bool containsPitchClasses(uint16_t mask) const { return (pitchClassMask & mask) == mask; }
+    
     // Berechne die Anzahl gedämpfter Saiten "innerhalb" des Griffs
     void calculateMutedInside()
     {
@@ -172,14 +187,15 @@ public:
     // Alle verfügbaren Shapes
     const std::vector<ChordShape>& getAllShapes() const { return shapes; }
     
-    // Shapes für einen bestimmten Akkordnamen finden
+    // Shapes für einen bestimmten Akkordnamen finden (Index, case-insensitive)
     std::vector<const ChordShape*> findShapesByName(const juce::String& name) const
     {
         std::vector<const ChordShape*> result;
-        for (const auto& shape : shapes)
+        auto it = nameIndex.find(name.toLowerCase());
+        if (it != nameIndex.end())
         {
-            if (shape.name.equalsIgnoreCase(name))
-                result.push_back(&shape);
+            for (uint16_t idx : it->second)
+                result.push_back(&shapes[idx]);
         }
         return result;
     }
@@ -189,43 +205,60 @@ public:
     {
         std::vector<const ChordShape*> result;
         
-        // Extrahiere Pitch Classes (0-11) aus MIDI-Noten
-        std::set<int> targetPitchClasses;
-        for (int note : midiNotes)
-        {
-            targetPitchClasses.insert(note % 12);
-        }
-        
-        for (const auto& shape : shapes)
-        {
-            // Prüfe ob Shape die gleichen Pitch Classes enthält
-            std::set<int> shapePitchClasses;
-            for (int note : shape.midiNotes)
-            {
-                shapePitchClasses.insert(note % 12);
-            }
-            
-            // Shape muss alle Target-Noten enthalten
-            bool matches = true;
-            for (int pc : targetPitchClasses)
-            {
-                if (shapePitchClasses.find(pc) == shapePitchClasses.end())
-                {
-                    matches = false;
-                    break;
-                }
-            }
-            
-            if (matches)
-                result.push_back(&shape);
-        }
+        // Shape muss alle Target-Noten enthalten
+        for (uint16_t idx : getCandidates(pitchClassMaskFor(midiNotes)))
+            result.push_back(&shapes[idx]);
         
         return result;
     }
+    
+    //==========================================================================
+    // Pitch-Class-Index
+    //==========================================================================
+    
+    /** Leichtgewichtiger Bereich über Shape-Indizes (kein Allokieren). */
+    struct CandidateRange
+    {
+        const uint16_t* first = nullptr;
+        const uint16_t* last = nullptr;
+        
+        const uint16_t* begin() const { return first; }
+        const uint16_t* end() const { return last; }
+        size_t size() const { return (size_t) (last - first); }
+        bool empty() const { return first == last; }
+    };
+    
+    /** 12-Bit-Maske der Tonklassen (C = Bit 0). */
+    static uint16_t pitchClassMaskFor(const std::vector<int>& midiNotes)
+    {
+        uint16_t mask = 0;
+        for (int note : midiNotes)
+            mask |= (uint16_t) (1u << (note % 12));
+        return mask;
+    }
+    
+    /**
+     * Alle Shapes, deren Tonklassen eine Obermenge von mask sind,
+     * in Bibliotheks-Reihenfolge. O(1) Zugriff über vorberechneten Index.
+     */
+    CandidateRange getCandidates(uint16_t mask) const
+    {
+        mask &= 0x0FFF;
+        const uint16_t* base = supersetShapes.data();
+        return { base + supersetOffsets[mask], base + supersetOffsets[(size_t) mask + 1] };
+    }
 
 private:
     std::vector<ChordShape> shapes;
     
+    // Obermengen-Index: für jede der 4096 Masken ein Bereich in supersetShapes
+    // (CSR-Layout: Offsets + flache Liste von Shape-Indizes)
+    std::array<uint32_t, 4097> supersetOffsets {};
+    std::vector<uint16_t> supersetShapes;
+    
+    // Kleingeschriebener Name -> Shape-Indizes
+    std::map<juce::String, std::vector<uint16_t>> nameIndex;
+    
     // Standard-Tuning (E2, A2, D3, G3, B3, E4)
     const std::array<int, 6> standardTuning = { 40, 45, 50, 55, 59, 64 };
     
@@ -355,6 +388,46 @@ private:
             shape.calculateMutedInside();
             shape.calculateBaseCost();
         }
+        
+        buildPitchClassIndex();
+        
+        nameIndex.clear();
+        for (size_t i = 0; i < shapes.size(); ++i)
+            nameIndex[shapes[i].name.toLowerCase()].push_back((uint16_t) i);
+    }
+    
+    // Jedes Shape wird bei allen Teilmengen seiner Maske eingetragen, so dass
+    // getCandidates() nur noch passende Shapes liefert (~16 Einträge pro Shape)
+    void buildPitchClassIndex()
+    {
+        std::array<uint32_t, 4096> counts {};
+        for (const auto& shape : shapes)
+        {
+            const uint16_t full = shape.pitchClassMask;
+            for (uint16_t sub = full;; sub = (uint16_t) ((sub - 1) & full))
+            {
+                counts[sub]++;
+                if (sub == 0)
+                    break;
+            }
+        }
+        
+        supersetOffsets[0] = 0;
+        for (size_t m = 0; m < 4096; ++m)
+            supersetOffsets[m + 1] = supersetOffsets[m] + counts[m];
+        
+        supersetShapes.assign(supersetOffsets[4096], 0);
+        std::array<uint32_t, 4096> fill {};
+        for (size_t i = 0; i < shapes.size(); ++i)
+        {
+            const uint16_t full = shapes[i].pitchClassMask;
+            for (uint16_t sub = full;; sub = (uint16_t) ((sub - 1) & full))
+            {
+                supersetShapes[supersetOffsets[sub] + fill[sub]++] = (uint16_t) i;
+                if (sub == 0)
+                    break;
+            }
+        }
     }
     
     void addOpenChord(const juce::String& name, std::array<int, 6> frets,
@@ -467,26 +540,24 @@ public:
      * @param midiNotes Die zu matchenden MIDI-Noten
      * @param currentFretPosition Aktuelle Handposition (für Transition-Kosten)
      * @param requireExactBass Wenn true, muss der Bass-Ton exakt übereinstimmen
-     * @param preferredMinFret Bevorzugter minimaler Bund (Low=0, Mid=5, High=9)
-     * @param preferredMaxFret Bevorzugter maximaler Bund (Low=4, Mid=8, High=12)
+     * @param costModel Kostenmodell mit bevorzugtem Bundbereich (Standard: Low)
      * @return Das beste Match mit Kosteninformationen
      */
     MatchResult findBestChord(const std::vector<int>& midiNotes, 
                               int currentFretPosition = 0,
                               bool requireExactBass = true,
-                              int preferredMinFret = 0,
-                              int preferredMaxFret = 4) const
+                              const PlayabilityCostModel& costModel = PlayabilityCostModel::forPreference(0)) const
     {
         if (midiNotes.size() < 2)
             return {};  // Mindestens 2 Noten für einen Akkord
         
-        // Extrahiere Pitch Classes und finde Bass-Note
-        std::set<int> targetPitchClasses;
+        // Extrahiere Pitch Classes (Bitmaske) und finde Bass-Note
+        uint16_t targetMask = 0;
         int lowestNote = 127;
         
         for (int note : midiNotes)
         {
-            targetPitchClasses.insert(note % 12);
+            targetMask |= (uint16_t) (1u << (note % 12));
             lowestNote = std::min(lowestNote, note);
         }
         
@@ -495,36 +566,16 @@ public:
         MatchResult bestResult;
         bestResult.totalCost = std::numeric_limits<float>::max();
         
-        for (const auto& shape : library.getAllShapes())
+        const auto& shapes = library.getAllShapes();
+        
+        // 1. Pitch Class Matching: Index liefert nur Shapes die alle Target-Pitch-Classes enthalten
+        for (uint16_t shapeIdx : library.getCandidates(targetMask))
         {
-            // 1. Pitch Class Matching
-            std::set<int> shapePitchClasses;
-            for (int note : shape.midiNotes)
-            {
-                shapePitchClasses.insert(note % 12);
-            }
-            
-            // Prüfe ob Shape alle Target-Pitch-Classes enthält
-            bool pitchMatch = true;
-            for (int pc : targetPitchClasses)
-            {
-                if (shapePitchClasses.find(pc) == shapePitchClasses.end())
-                {
-                    pitchMatch = false;
-                    break;
-                }
-            }
-            
-            if (!pitchMatch)
-                continue;
+            const auto& shape = shapes[shapeIdx];
             
             // 2. Bass-Matching (für Inversionen)
-            if (requireExactBass)
-            {
-                int shapeBassPitchClass = shape.bassMidiNote % 12;
-                if (shapeBassPitchClass != targetBassPitchClass)
-                    continue;
-            }
+            if (requireExactBass && shape.bassPitchClass != targetBassPitchClass)
+                continue;
             
             // 3. Kosten berechnen
             float shapeCost = shape.baseCost;
@@ -534,31 +585,11 @@ public:
             if (shape.isOpenChord)
                 shapePosition = 0;
             
-            float transitionCost = std::abs(shapePosition - currentFretPosition) * 1.5f;
-            
-            // Bonus für Open Chords wenn wir am Sattel sind
-            if (currentFretPosition <= 3 && shape.isOpenChord)
-            {
-                transitionCost = 0.0f;
-            }
+            float transitionCost = PlayabilityCostModel::chordShapeTransitionCost(shapePosition, currentFretPosition,
+                                                                                  shape.isOpenChord);
             
             // Fret-Präferenz-Kosten: Starker Bonus/Malus basierend auf bevorzugtem Bereich
-            float fretPreferenceCost = 0.0f;
-            if (shapePosition >= preferredMinFret && shapePosition <= preferredMaxFret)
-            {
-                // Bonus: Shape ist im bevorzugten Bereich
-                fretPreferenceCost = -15.0f;
-            }
-            else
-            {
-                // Strafe: Shape ist außerhalb des bevorzugten Bereichs
-                int distFromPreferred = 0;
-                if (shapePosition < preferredMinFret)
-                    distFromPreferred = preferredMinFret - shapePosition;
-                else
-                    distFromPreferred = shapePosition - preferredMaxFret;
-                fretPreferenceCost = distFromPreferred * 4.0f;
-            }
+            float fretPreferenceCost = costModel.chordShapePreferenceCost(shapePosition);
 
             float totalCost = shapeCost + transitionCost + fretPreferenceCost;
             
@@ -598,43 +629,20 @@ public:
         if (midiNotes.size() < 2)
             return results;
         
-        std::set<int> targetPitchClasses;
-        int lowestNote = 127;
+        const auto& shapes = library.getAllShapes();
+        const auto candidates = library.getCandidates(ChordLibrary::pitchClassMaskFor(midiNotes));
+        results.reserve(candidates.size());
         
-        for (int note : midiNotes)
+        for (uint16_t shapeIdx : candidates)
         {
-            targetPitchClasses.insert(note % 12);
-            lowestNote = std::min(lowestNote, note);
-        }
-        
-        for (const auto& shape : library.getAllShapes())
-        {
-            std::set<int> shapePitchClasses;
-            for (int note : shape.midiNotes)
-            {
-                shapePitchClasses.insert(note % 12);
-            }
-            
-            bool pitchMatch = true;
-            for (int pc : targetPitchClasses)
-            {
-                if (shapePitchClasses.find(pc) == shapePitchClasses.end())
-                {
-                    pitchMatch = false;
-                    break;
-                }
-            }
-            
-            if (pitchMatch)
-            {
-                MatchResult result;
-                result.shape = &shape;
-                result.shapeCost = shape.baseCost;
-                result.transitionCost = std::abs(shape.baseFret - currentFretPosition) * 1.5f;
-                result.totalCost = result.shapeCost + result.transitionCost;
-                result.isMatch = true;
-                results.push_back(result);
-            }
+            const auto& shape = shapes[shapeIdx];
+            MatchResult result;
+            result.shape = &shape;
+            result.shapeCost = shape.baseCost;
+            result.transitionCost = PlayabilityCostModel::handShiftCost(currentFretPosition, shape.baseFret);
+            result.totalCost = result.shapeCost + result.transitionCost;
+            result.isMatch = true;
+            results.push_back(result);
         }
         
         // Sortiere nach Kosten
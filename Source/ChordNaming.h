@@ -0,0 +1,233 @@
+/*
+  ==============================================================================
+
+    ChordNaming.h
+
+    Akkord-Benennung über eine zur Compile-Zeit erzeugte Tabelle aller
+    4096 Pitch-Class-Sets (12-Bit-Masken, C = Bit 0).
+
+    - qualityByIntervals: Maske relativ zum Grundton -> Akkordqualität
+    - bestInterpretation: absolute Maske -> bevorzugter Grundton + Qualität
+
+    Benennung eines Akkords = max. zwei Tabellenzugriffe: zuerst wird der
+    Basston als Grundton versucht, sonst die beste Interpretation mit
+    Slash-Bass ("Am7/E"). Unabhängig von der Größe der Shape-Bibliothek.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <initializer_list>
+
+namespace ChordNaming
+{
+    //==========================================================================
+    /** Akkordqualität: Intervalle relativ zum Grundton + Namens-Suffix. */
+    struct Quality
+    {
+        uint16_t intervals;
+        const char* suffix;     // Schreibweise wie in chord-fingers.csv ("" = Dur)
+    };
+
+    constexpr uint16_t intervalMask(std::initializer_list<int> semitones)
+    {
+        uint16_t mask = 0;
+        for (int s : semitones)
+            mask = (uint16_t) (mask | (1u << s));
+        return mask;
+    }
+
+    // Reihenfolge = Priorität bei mehrdeutigen Sets (z.B. Am7 vor C6)
+    inline constexpr Quality qualities[] = {
+        { intervalMask({ 0, 4, 7 }),            ""        },
+        { intervalMask({ 0, 3, 7 }),            "m"       },
+        { intervalMask({ 0, 4, 7, 10 }),        "7"       },
+        { intervalMask({ 0, 3, 7, 10 }),        "m7"      },
+        { intervalMask({ 0, 4, 7, 11 }),        "maj7"    },
+        { intervalMask({ 0, 7 }),               "5"       },
+        { intervalMask({ 0, 5, 7 }),            "sus4"    },
+        { intervalMask({ 0, 2, 7 }),            "sus2"    },
+        { intervalMask({ 0, 3, 6 }),            "dim"     },
+        { intervalMask({ 0, 4, 8 }),            "aug"     },
+        { intervalMask({ 0, 4, 7, 9 }),         "6"       },
+        { intervalMask({ 0, 3, 7, 9 }),         "m6"      },
+        { intervalMask({ 0, 3, 6, 9 }),         "dim7"    },
+        { intervalMask({ 0, 3, 6, 10 }),        "m7b5"    },
+        { intervalMask({ 0, 5, 7, 10 }),        "7sus4"   },
+        { intervalMask({ 0, 2, 4, 7 }),         "add9"    },
+        { intervalMask({ 0, 2, 4, 7, 10 }),     "9"       },
+        { intervalMask({ 0, 2, 3, 7, 10 }),     "m9"      },
+        { intervalMask({ 0, 2, 4, 7, 11 }),     "maj9"    },
+        { intervalMask({ 0, 3, 7, 11 }),        "m(maj7)" },
+        { intervalMask({ 0, 2, 4, 7, 9 }),      "6/9"     },
+        { intervalMask({ 0, 4, 6, 10 }),        "7b5"     },
+        { intervalMask({ 0, 4, 8, 10 }),        "7(#5)"   },
+        { intervalMask({ 0, 1, 4, 7, 10 }),     "7(b9)"   },
+        { intervalMask({ 0, 3, 4, 7, 10 }),     "7(#9)"   },
+        { intervalMask({ 0, 2, 4, 5, 7, 10 }),  "11"      },
+        { intervalMask({ 0, 2, 3, 5, 7, 10 }),  "m11"     },
+        { intervalMask({ 0, 2, 4, 7, 9, 10 }),  "13"      },
+        { intervalMask({ 0, 2, 4, 7, 9, 11 }),  "maj13"   },
+        // Gitarren-typische Voicings ohne Quinte
+        { intervalMask({ 0, 4, 10 }),           "7"       },
+        { intervalMask({ 0, 3, 10 }),           "m7"      },
+        { intervalMask({ 0, 4, 11 }),           "maj7"    },
+        { intervalMask({ 0, 2, 4, 10 }),        "9"       },
+    };
+
+    inline constexpr int numQualities = (int) (sizeof(qualities) / sizeof(qualities[0]));
+    inline constexpr uint8_t noQuality = 0xFF;
+
+    /** Transponiert eine Maske um semitones nach oben (Rotation in 12 Bit). */
+    constexpr uint16_t rotateUp(uint16_t mask, int semitones)
+    {
+        semitones %= 12;
+        return (uint16_t) (((mask << semitones) | (mask >> (12 - semitones))) & 0x0FFF);
+    }
+
+    /** Maske relativ zum Grundton root (Grundton landet auf Bit 0). */
+    constexpr uint16_t relativeTo(uint16_t mask, int root)
+    {
+        return rotateUp(mask, (12 - root % 12) % 12);
+    }
+
+    //==========================================================================
+    // Tabellen (Aufbau über Qualitäten x Grundtöne - nur ~400 Schreibzugriffe,
+    // bleibt weit unter den constexpr-Schrittlimits von MSVC/Clang)
+    //==========================================================================
+
+    struct Interpretation
+    {
+        uint8_t root = 0;
+        uint8_t quality = noQuality;
+    };
+
+    constexpr std::array<uint8_t, 4096> buildQualityTable()
+    {
+        std::array<uint8_t, 4096> table {};
+        for (auto& q : table)
+            q = noQuality;
+
+        for (int q = 0; q < numQualities; ++q)
+            if (table[qualities[q].intervals] == noQuality)
+                table[qualities[q].intervals] = (uint8_t) q;
+
+        return table;
+    }
+
+    constexpr std::array<Interpretation, 4096> buildInterpretationTable()
+    {
+        std::array<Interpretation, 4096> table {};
+
+        for (int q = 0; q < numQualities; ++q)
+        {
+            for (int root = 0; root < 12; ++root)
+            {
+                auto& entry = table[rotateUp(qualities[q].intervals, root)];
+                if (entry.quality == noQuality)
+                {
+                    entry.root = (uint8_t) root;
+                    entry.quality = (uint8_t) q;
+                }
+            }
+        }
+
+        return table;
+    }
+
+    inline constexpr auto qualityByIntervals = buildQualityTable();
+    inline constexpr auto bestInterpretation = buildInterpretationTable();
+
+    static_assert(bestInterpretation[intervalMask({ 0, 4, 7 })].quality == 0, "C major");
+    static_assert(bestInterpretation[intervalMask({ 9, 0, 4 })].root == 9, "A minor");
+    static_assert(qualityByIntervals[relativeTo(intervalMask({ 9, 0, 4, 7 }), 0)] == 10, "C6 with C bass");
+
+    //==========================================================================
+    /** Ergebnis einer Benennung (root/bass als Tonklasse 0-11, -1 = keiner). */
+    struct ChordName
+    {
+        int root = -1;
+        int quality = -1;
+        int bass = -1;          // nur gesetzt wenn Bass != Grundton (Slash-Akkord)
+
+        bool isValid() const { return root >= 0 && quality >= 0; }
+        bool isSlashChord() const { return bass >= 0; }
+
+        juce::String getSuffix() const { return isValid() ? juce::String(qualities[quality].suffix) : juce::String(); }
+
+        juce::String toString() const
+        {
+            if (! isValid())
+                return {};
+
+            juce::String name = pitchClassName(root) + qualities[quality].suffix;
+            if (isSlashChord())
+                name << "/" << pitchClassName(bass);
+            return name;
+        }
+
+        static juce::String pitchClassName(int pitchClass)
+        {
+            static const char* names[] = { "C", "C#", "D", "D#", "E", "F",
+                                           "F#", "G", "G#", "A", "A#", "B" };
+            return names[((pitchClass % 12) + 12) % 12];
+        }
+    };
+
+    /** Benennt ein Pitch-Class-Set mit gegebener Bass-Tonklasse. */
+    inline ChordName identify(uint16_t mask, int bassPitchClass)
+    {
+        ChordName result;
+        mask &= 0x0FFF;
+
+        // 1. Basston als Grundton (Grundstellung)
+        if (bassPitchClass >= 0)
+        {
+            uint8_t q = qualityByIntervals[relativeTo(mask, bassPitchClass)];
+            if (q != noQuality)
+            {
+                result.root = bassPitchClass;
+                result.quality = q;
+                return result;
+            }
+        }
+
+        // 2. Beste Interpretation, Bass als Slash-Note
+        const auto& entry = bestInterpretation[mask];
+        if (entry.quality == noQuality)
+            return result;
+
+        result.root = entry.root;
+        result.quality = entry.quality;
+        if (bassPitchClass >= 0 && bassPitchClass != entry.root)
+            result.bass = bassPitchClass;
+        return result;
+    }
+
+    /** Benennt beliebige MIDI-Noten (tiefste Note = Bass). */
+    inline ChordName identify(const std::vector<int>& midiNotes)
+    {
+        if (midiNotes.empty())
+            return {};
+
+        uint16_t mask = 0;
+        int lowest = 127;
+        for (int note : midiNotes)
+        {
+            mask = (uint16_t) (mask | (1u << (note % 12)));
+            lowest = std::min(lowest, note);
+        }
+        return identify(mask, lowest % 12);
+    }
+
+    /** Kurzform: Akkordname oder leerer String. */
+    inline juce::String nameFor(const std::vector<int>& midiNotes)
+    {
+        return identify(midiNotes).toString();
+    }
+}
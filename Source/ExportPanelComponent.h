@@ -195,6 +195,9 @@ public:
         exportButton.onClick = [this]() { doExport(); };
         addAndMakeVisible(exportButton);
         
+        addChildComponent(progressBar);
+        progressBar.setTextToDisplay("Exporting...");
+        
         cancelButton.setButtonText("Cancel");
         cancelButton.onClick = [this]() { 
             if (cancelCallback) cancelCallback(); 
@@ -259,6 +262,26 @@ public:
         cancelButton.setBounds(buttonArea.getX() + buttonX + 130, buttonArea.getY() + 8, 100, 34);
     }
     
+    // Export läuft im Hintergrund: Eingaben sperren, Fortschritt statt Export-Button
+    void setExporting(const juce::String& fileName)
+    {
+        titleEditor.setEnabled(false);
+        for (auto& row : trackRows)
+            row->setEnabled(false);
+        
+        exportButton.setVisible(false);
+        progressBar.setTextToDisplay("Exporting " + fileName + "...");
+        progressBar.setBounds(exportButton.getBounds().withLeft(getLocalBounds().reduced(10).getX())
+                                                   .withRight(exportButton.getRight()));
+        progressBar.setVisible(true);
+        progress = 0.0;
+    }
+    
+    // 0..1, der ProgressBar liest den Wert selbst (eigener Timer)
+    void setProgress(double newProgress) { progress = newProgress; }
+    
+    bool isExporting() const { return progressBar.isVisible(); }
+    
 private:
     void doExport()
     {
@@ -282,6 +305,9 @@ private:
     juce::TextButton exportButton;
     juce::TextButton cancelButton;
     
+    double progress = 0.0;
+    juce::ProgressBar progressBar { progress };
+    
     std::function<void(const juce::String&, const std::vector<std::pair<juce::String, int>>&)> exportCallback;
     std::function<void()> cancelCallback;
 };
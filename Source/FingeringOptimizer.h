@@ -0,0 +1,370 @@
+/*
+  ==============================================================================
+
+    FingeringOptimizer.h
+
+    Globale Saiten/Bund-Zuordnung für eine komplette Phrase (Viterbi).
+
+    Statt jede Note gierig relativ zu einer Referenzposition zu setzen, wird
+    die gesamte Folge von Noten-Gruppen (Einzelnoten und Akkorde) als
+    Zustandsgraph betrachtet: jeder Zustand ist eine vollständige Griffwahl
+    für eine Gruppe, die Übergangskosten kommen aus demselben
+    PlayabilityCostModel wie die Live-Eingabe. Pro Gruppe werden nur
+    die k günstigsten Griffe behalten (Beam), dadurch bleibt der Aufwand bei
+    O(n * k^2) und ist auch für 10k-Noten-Aufnahmen interaktiv.
+
+    Bewusst ohne JUCE-Abhängigkeit, damit der Benchmark eigenständig baut.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "GuitarTuning.h"
+#include "PlayabilityCostModel.h"
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+
+//==============================================================================
+/**
+ * FingeringOptimizer
+ *
+ * Viterbi-Suche über Noten-Gruppen. Ein Zustand ist die komplette Griffwahl
+ * einer Gruppe; seine "Handposition" (tiefster gegriffener Bund, Bass-Saite)
+ * dient als Bezugspunkt für die Bewegungskosten zur nächsten Gruppe.
+ *
+ * Der Richtungsterm (9) hängt eigentlich von zwei Vorgängern ab; er wird über
+ * den jeweils besten Vorgänger (Backpointer) mitgeführt, was den Zustandsraum
+ * nicht vergrößert.
+ */
+class FingeringOptimizer
+{
+public:
+    struct NoteGroup
+    {
+        std::vector<int> midiNotes;     // Reihenfolge bleibt im Ergebnis erhalten
+        double beatsToNext = 1.0;       // Abstand zur nächsten Gruppe (für Term 8)
+    };
+
+    /** Ergebnis pro Gruppe: eine Position pro Eingangsnote (gleiche Reihenfolge). */
+    using Assignment = std::vector<FretChoice>;
+
+    FingeringOptimizer() = default;
+
+    //==========================================================================
+    // Konfiguration
+    //==========================================================================
+
+    /** Stimmung inkl. Capo/Max-Bund; Kandidaten kommen aus deren Positionstabelle. */
+    void setTuning(const GuitarTuning& newTuning) { tuning = newTuning; }
+    const GuitarTuning& getTuning() const { return tuning; }
+    void setCostModel(const PlayabilityCostModel& model) { costModel = model; }
+    const PlayabilityCostModel& getCostModel() const { return costModel; }
+
+    /** Anzahl der pro Gruppe behaltenen Griffe (k). */
+    void setBeamWidth(int k) { beamWidth = std::max(1, k); }
+
+    /** Gewichtung der Bewegungskosten (höher = Hand bleibt länger in einer Lage). */
+    void setHandInertia(float inertia) { handInertia = std::max(0.1f, inertia); }
+
+    //==========================================================================
+    // Optimierung
+    //==========================================================================
+
+    std::vector<Assignment> optimise(const std::vector<NoteGroup>& groups) const
+    {
+        std::vector<Assignment> result(groups.size());
+        if (groups.empty() || tuning.getStringCount() == 0)
+            return result;
+
+        // Kandidaten pro Gruppe erzeugen (lokale Kosten, Beam-begrenzt)
+        std::vector<std::vector<State>> layers(groups.size());
+        for (size_t g = 0; g < groups.size(); ++g)
+            layers[g] = buildCandidates(groups[g].midiNotes);
+
+        // Vorwärtsdurchlauf
+        for (auto& s : layers[0])
+        {
+            s.total = s.local;
+            s.back = -1;
+            s.direction = 0;
+        }
+
+        // Vorgänger-Schicht im SoA-Layout für den Batch-Kernel
+        std::vector<int> prevStrings, prevFrets, prevDirections;
+        std::vector<float> moves;
+
+        for (size_t g = 1; g < layers.size(); ++g)
+        {
+            const auto& prevLayer = layers[g - 1];
+            const int numPrev = (int) prevLayer.size();
+            float fastFactor = FingeringCost::fastPassageFactorForBeats(groups[g - 1].beatsToNext);
+
+            prevStrings.resize((size_t) numPrev);
+            prevFrets.resize((size_t) numPrev);
+            prevDirections.resize((size_t) numPrev);
+            moves.resize((size_t) numPrev);
+            for (int p = 0; p < numPrev; ++p)
+            {
+                prevStrings[(size_t) p] = prevLayer[(size_t) p].anchor.string;
+                prevFrets[(size_t) p] = prevLayer[(size_t) p].anchor.fret;
+                prevDirections[(size_t) p] = prevLayer[(size_t) p].direction;
+            }
+
+            for (auto& s : layers[g])
+            {
+                float best = std::numeric_limits<float>::max();
+                int bestIdx = -1;
+
+                // Unspielbare Gruppen unterbrechen die Bewegungskette nicht
+                const bool anchorValid = s.anchor.isValid();
+                if (anchorValid)
+                    costModel.scoreMovementFrom(prevStrings.data(), prevFrets.data(), prevDirections.data(),
+                                                numPrev, s.anchor, fastFactor, moves.data());
+
+                for (int p = 0; p < numPrev; ++p)
+                {
+                    const auto& prev = prevLayer[(size_t) p];
+                    float c = prev.total;
+
+                    if (anchorValid && prev.anchor.isValid())
+                        c += handInertia * moves[(size_t) p];
+
+                    if (c < best)
+                    {
+                        best = c;
+                        bestIdx = p;
+                    }
+                }
+
+                s.total = best + s.local;
+                s.back = bestIdx;
+
+                const auto& pred = prevLayer[(size_t) bestIdx];
+                s.direction = (pred.anchor.isValid() && s.anchor.isValid())
+                                  ? FingeringCost::nextDirection(s.anchor, pred.anchor, pred.direction)
+                                  : pred.direction;
+            }
+        }
+
+        // Rückverfolgung
+        const auto& lastLayer = layers.back();
+        int idx = 0;
+        for (int i = 1; i < (int) lastLayer.size(); ++i)
+            if (lastLayer[(size_t) i].total < lastLayer[(size_t) idx].total)
+                idx = i;
+
+        for (size_t g = layers.size(); g-- > 0;)
+        {
+            const auto& s = layers[g][(size_t) idx];
+            result[g] = s.choices;
+            idx = s.back;
+        }
+
+        return result;
+    }
+
+    /** Bequemlichkeit: einzelne Gruppe ohne Kontext (z.B. für Live-Akkorde). */
+    Assignment optimiseGroup(const std::vector<int>& midiNotes) const
+    {
+        auto states = buildCandidates(midiNotes);
+        auto best = std::min_element(states.begin(), states.end(),
+            [](const State& a, const State& b) { return a.local < b.local; });
+        return best->choices;
+    }
+
+private:
+    struct State
+    {
+        Assignment choices;
+        FretChoice anchor;      // Handposition für Bewegungskosten
+        float local = 0.0f;     // Platzierung + Akkord-Spannweite
+        float total = 0.0f;     // Viterbi-Kosten bis hier
+        int back = -1;          // bester Vorgänger
+        int direction = 0;      // Bundrichtung am Ende des besten Pfades
+    };
+
+    GuitarTuning tuning;
+    int beamWidth = 16;
+    float handInertia = 1.0f;
+    PlayabilityCostModel costModel;
+
+    static constexpr int minChordSpan = 3;
+    static constexpr int maxChordSpan = 7;
+
+    /** Nicht spielbare Note: nächstgelegene Saite, Bund begrenzt (wie bisher). */
+    FretChoice closestFallback(int midiNote) const
+    {
+        auto pos = tuning.getClosestPosition(midiNote);
+        return { pos.string, pos.fret };
+    }
+
+    /** Handposition eines Griffs: tiefster gegriffener Bund, Saite der tiefsten Note. */
+    static FretChoice anchorFor(const Assignment& choices, const std::vector<int>& midiNotes)
+    {
+        FretChoice anchor;
+        int lowestNote = std::numeric_limits<int>::max();
+        int minFretted = std::numeric_limits<int>::max();
+        bool anyValid = false;
+
+        for (size_t i = 0; i < choices.size(); ++i)
+        {
+            if (! choices[i].isValid())
+                continue;
+            anyValid = true;
+            if (midiNotes[i] < lowestNote)
+            {
+                lowestNote = midiNotes[i];
+                anchor.string = choices[i].string;
+            }
+            if (choices[i].fret > 0)
+                minFretted = std::min(minFretted, choices[i].fret);
+        }
+
+        if (! anyValid)
+            return {};
+
+        anchor.fret = (minFretted == std::numeric_limits<int>::max()) ? 0 : minFretted;
+        return anchor;
+    }
+
+    std::vector<State> buildCandidates(const std::vector<int>& midiNotes) const
+    {
+        std::vector<State> states;
+        const size_t numNotes = midiNotes.size();
+
+        if (numNotes == 0)
+        {
+            states.push_back({});
+            return states;
+        }
+
+        // Positionen pro Note, nach Platzierungskosten sortiert
+        struct Option { FretChoice pos; float cost; };
+        std::vector<std::vector<Option>> options(numNotes);
+        for (size_t n = 0; n < numNotes; ++n)
+        {
+            const auto batch = PlayabilityCostModel::CandidateBatch::fromPositions(tuning.getPositions(midiNotes[n]));
+            float costs[PlayabilityCostModel::maxCandidates];
+            costModel.scorePlacement(batch, costs);
+
+            options[n].reserve((size_t) batch.count);
+            for (int i = 0; i < batch.count; ++i)
+                options[n].push_back({ batch[i], costs[i] });
+            std::sort(options[n].begin(), options[n].end(),
+                [](const Option& a, const Option& b) { return a.cost < b.cost; });
+        }
+
+        if (numNotes == 1)
+        {
+            for (const auto& o : options[0])
+            {
+                State st;
+                st.choices = { o.pos };
+                st.anchor = o.pos;
+                st.local = o.cost;
+                states.push_back(std::move(st));
+            }
+            if (states.empty())
+            {
+                State st;
+                st.choices = { closestFallback(midiNotes[0]) };
+                st.anchor = st.choices[0];
+                states.push_back(std::move(st));
+            }
+            trimToBeam(states);
+            return states;
+        }
+
+        // Akkord: Tiefensuche über eindeutige Saiten, Spannweite progressiv lockern
+        Assignment current(numNotes);
+        for (int allowedSpan = minChordSpan; allowedSpan <= maxChordSpan && states.empty(); ++allowedSpan)
+        {
+            uint32_t usedStrings = 0;
+            searchChord(options, 0, current, usedStrings, 0.0f,
+                        std::numeric_limits<int>::max(), 0, allowedSpan, midiNotes, states);
+        }
+
+        // Notfall: beste Option pro Note mit eindeutigen Saiten, Rest unspielbar
+        if (states.empty())
+        {
+            State st;
+            st.choices.assign(numNotes, FretChoice {});
+            uint32_t usedStrings = 0;
+            for (size_t n = 0; n < numNotes; ++n)
+            {
+                for (const auto& o : options[n])
+                {
+                    if ((usedStrings & (1u << o.pos.string)) == 0)
+                    {
+                        st.choices[n] = o.pos;
+                        st.local += o.cost;
+                        usedStrings |= (1u << o.pos.string);
+                        break;
+                    }
+                }
+            }
+            st.anchor = anchorFor(st.choices, midiNotes);
+            states.push_back(std::move(st));
+        }
+
+        trimToBeam(states);
+        return states;
+    }
+
+    template <typename OptionList>
+    void searchChord(const OptionList& options, size_t noteIdx, Assignment& current,
+                     uint32_t& usedStrings, float costSoFar, int minF, int maxF,
+                     int allowedSpan, const std::vector<int>& midiNotes,
+                     std::vector<State>& out) const
+    {
+        if (noteIdx >= options.size())
+        {
+            int span = (minF <= maxF) ? (maxF - minF) : 0;
+
+            State st;
+            st.choices = current;
+            st.anchor = anchorFor(current, midiNotes);
+            // Quadratische Strafe für die Spannweite, kleine Griffe bevorzugt
+            st.local = costSoFar + span * span * 1.5f - (span <= 2 ? 2.0f : (span <= 3 ? 1.0f : 0.0f));
+            out.push_back(std::move(st));
+            return;
+        }
+
+        for (const auto& opt : options[noteIdx])
+        {
+            const uint32_t bit = 1u << opt.pos.string;
+            if (usedStrings & bit)
+                continue;
+
+            int newMin = minF, newMax = maxF;
+            if (opt.pos.fret > 0)
+            {
+                newMin = std::min(minF, opt.pos.fret);
+                newMax = std::max(maxF, opt.pos.fret);
+                if (newMax - newMin > allowedSpan)
+                    continue;
+            }
+
+            current[noteIdx] = opt.pos;
+            usedStrings |= bit;
+            searchChord(options, noteIdx + 1, current, usedStrings, costSoFar + opt.cost,
+                        newMin, newMax, allowedSpan, midiNotes, out);
+            usedStrings &= ~bit;
+        }
+    }
+
+    void trimToBeam(std::vector<State>& states) const
+    {
+        if ((int) states.size() <= beamWidth)
+            return;
+
+        std::nth_element(states.begin(), states.begin() + beamWidth, states.end(),
+            [](const State& a, const State& b) { return a.local < b.local; });
+        states.resize((size_t) beamWidth);
+    }
+};
@@ -12,11 +12,13 @@
 #pragma once
 
 #include "TabModels.h"
+#include "GuitarTuning.h"
+#include "PlayabilityCostModel.h"
 #include <juce_core/juce_core.h>
 #include <vector>
 #include <algorithm>
-#include <set>
-#include <functional>
+#include <limits>
+#include <cstdint>
 
 //==============================================================================
 /**
@@ -49,9 +51,20 @@ public:
     // Konfiguration
     //==========================================================================
     
-    void setTuning(const juce::Array<int>& newTuning) { tuning = newTuning; }
-    void setCapo(int fret) { capoFret = juce::jmax(0, fret); }
-    void setMaxFret(int fret) { maxFret = juce::jmax(1, fret); }
+    // Die Positionstabelle wird nur neu aufgebaut, wenn sich Stimmung/Capo/Max-Bund ändern
+    void setTuning(const juce::Array<int>& newTuning)
+    {
+        std::vector<int> strings;
+        for (int note : newTuning)
+            if (note > 0)
+                strings.push_back(note);
+        if (! strings.empty())
+            updateTuning(std::move(strings), tuning.getCapo(), tuning.getMaxFret());
+    }
+    void setTuning(const GuitarTuning& newTuning) { if (newTuning != tuning) tuning = newTuning; }
+    void setCapo(int fret) { updateTuning(tuning.getOpenStrings(), juce::jmax(0, fret), tuning.getMaxFret()); }
+    void setMaxFret(int fret) { updateTuning(tuning.getOpenStrings(), tuning.getCapo(), juce::jmax(1, fret)); }
+    const GuitarTuning& getTuning() const { return tuning; }
     void setPreferredPosition(int fret) { preferredFret = juce::jmax(0, fret); }
     
     //==========================================================================
@@ -66,22 +79,16 @@ public:
     {
         juce::Array<AlternatePosition> positions;
         
-        if (tuning.isEmpty())
-            return positions;
+        const auto& candidates = tuning.getPositions(midiNote);
+        positions.ensureStorageAllocated(candidates.size());
         
-        for (int stringIdx = 0; stringIdx < tuning.size(); ++stringIdx)
+        for (const auto& candidate : candidates)
         {
-            int openStringNote = tuning[stringIdx] + capoFret;
-            int requiredFret = midiNote - openStringNote;
-            
-            if (requiredFret >= 0 && requiredFret <= maxFret)
-            {
-                AlternatePosition pos;
-                pos.string = stringIdx;
-                pos.fret = requiredFret;
-                pos.cost = calculatePositionCost(stringIdx, requiredFret, midiNote);
-                positions.add(pos);
-            }
+            AlternatePosition pos;
+            pos.string = candidate.string;
+            pos.fret = candidate.fret;
+            pos.cost = calculatePositionCost(pos.string, pos.fret, midiNote);
+            positions.add(pos);
         }
         
         std::sort(positions.begin(), positions.end());
@@ -112,9 +119,7 @@ public:
      */
     int getMidiNote(int stringIdx, int fret) const
     {
-        if (stringIdx < 0 || stringIdx >= tuning.size() || fret < 0)
-            return -1;
-        return tuning[stringIdx] + capoFret + fret;
+        return tuning.getMidiNote(stringIdx, fret);
     }
     
     /**
@@ -130,34 +135,18 @@ public:
     }
     
 private:
-    juce::Array<int> tuning = { 64, 59, 55, 50, 45, 40 };  // Standard E-Tuning
-    int capoFret = 0;
-    int maxFret = 24;
+    GuitarTuning tuning;  // Standard E-Tuning
     int preferredFret = 0;
     
+    void updateTuning(std::vector<int> strings, int capo, int maxFret)
+    {
+        if (strings != tuning.getOpenStrings() || capo != tuning.getCapo() || maxFret != tuning.getMaxFret())
+            tuning = GuitarTuning(std::move(strings), capo, maxFret);
+    }
+    
     float calculatePositionCost(int stringIdx, int fret, int /*midiNote*/) const
     {
-        float cost = 0.0f;
-        
-        // Leersaiten bevorzugt
-        if (fret == 0) cost -= 2.0f;
-        
-        // Niedrige Bünde einfacher
-        cost += fret * 0.1f;
-        
-        // Hohe Bünde schwieriger
-        if (fret > 12) cost += (fret - 12) * 0.3f;
-        
-        // Mittlere Saiten bevorzugt
-        int stringCount = tuning.size();
-        float middleString = (stringCount - 1) / 2.0f;
-        cost += std::abs(stringIdx - middleString) * 0.2f;
-        
-        // Abstand von bevorzugter Position
-        if (preferredFret > 0)
-            cost += std::abs(fret - preferredFret) * 0.5f;
-        
-        return cost;
+        return PlayabilityCostModel::alternativeCost(stringIdx, fret, tuning.getStringCount(), preferredFret);
     }
     
 public:
@@ -202,179 +191,287 @@ public:
      * Findet bis zu maxAlternatives sinnvolle Alternativen, die alle Noten
      * in einer spielbaren Griffposition halten.
      * 
+     * Pro Anker-Bund wird die günstigste Kombination per Branch-and-Bound
+     * gesucht (keine doppelten Saiten, max. 3 Bünde Spannweite). Anker werden
+     * nach ihrer unteren Kostenschranke abgearbeitet (best-first); sobald die
+     * Schranke schlechter ist als die K-beste gefundene Alternative, ist die
+     * Suche fertig. Das Zeitbudget begrenzt die Suche hart - das Popup bekommt
+     * dann die bis dahin besten Alternativen.
+     * 
      * @param notes Die Noten der Gruppe mit ihren aktuellen Positionen
      * @param maxAlternatives Maximale Anzahl der Alternativen (default: 5)
+     * @param timeBudgetMs Maximale Suchzeit in Millisekunden
      * @return Sortierte Liste von Gruppen-Alternativen (niedrigste Kosten zuerst)
      */
     juce::Array<GroupAlternative> calculateGroupAlternatives(
         const juce::Array<GroupNoteInfo>& notes,
-        int maxAlternatives = 5) const
+        int maxAlternatives = 5,
+        double timeBudgetMs = 30.0) const
     {
         juce::Array<GroupAlternative> alternatives;
         
-        if (notes.isEmpty() || tuning.isEmpty())
+        if (notes.isEmpty() || maxAlternatives <= 0 || tuning.getStringCount() == 0)
+            return alternatives;
+        
+        // Mehr Noten als Saiten: keine Kombination ohne doppelte Saite möglich
+        if (notes.size() > tuning.getStringCount())
             return alternatives;
         
-        // Schritt 1: Berechne für jede Note alle möglichen Positionen
-        std::vector<juce::Array<AlternatePosition>> allPositions;
-        for (const auto& note : notes)
+        GroupSearch search(*this, notes, maxAlternatives, timeBudgetMs);
+        search.run();
+        
+        for (auto& alt : search.results)
+            alternatives.add(std::move(alt));
+        
+        return alternatives;
+    }
+    
+private:
+    //==========================================================================
+    // Branch-and-Bound-Suche für calculateGroupAlternatives
+    //==========================================================================
+    
+    struct GroupSearch
+    {
+        // Maximaler Fret-Abstand für gleichzeitige Noten: 3 Bünde!
+        static constexpr int maxChordFretSpan = 3;
+        static constexpr float distanceWeight = 2.0f;
+        static constexpr float spanWeight = 1.5f;
+        static constexpr int nodesPerTimeCheck = 256;
+        
+        struct Option
         {
-            auto positions = calculatePositions(note.midiNote);
-            if (positions.isEmpty())
-                return alternatives;  // Eine Note kann nicht gespielt werden
-            allPositions.push_back(positions);
+            int string = 0;
+            int fret = 0;
+            float cost = 0.0f;      // Positionskosten + Abstand zum Anker
+        };
+        
+        const juce::Array<GroupNoteInfo>& notes;
+        const int maxAlternatives;
+        const double deadline;
+        
+        std::vector<juce::Array<AlternatePosition>> allPositions;  // pro Note
+        std::vector<int> order;                                     // Suchreihenfolge (wenigste Optionen zuerst)
+        std::vector<std::vector<Option>> options;                   // pro Suchtiefe, für aktuellen Anker
+        std::vector<float> remainingBound;                          // Summe der Mindestkosten ab Tiefe d
+        
+        std::vector<Option> current;
+        std::vector<Option> best;
+        float bestCost = 0.0f;
+        int anchorFret = 0;
+        int nodeCounter = 0;
+        bool timedOut = false;
+        
+        std::vector<GroupAlternative> results;                      // sortiert, max. maxAlternatives
+        
+        GroupSearch(const FretPositionCalculator& calc, const juce::Array<GroupNoteInfo>& groupNotes,
+                    int maxAlts, double budgetMs)
+            : notes(groupNotes),
+              maxAlternatives(maxAlts),
+              deadline(juce::Time::getMillisecondCounterHiRes() + budgetMs)
+        {
+            for (const auto& note : notes)
+                allPositions.push_back(calc.calculatePositions(note.midiNote));
+            
+            order.resize((size_t) notes.size());
+            for (int i = 0; i < notes.size(); ++i)
+                order[(size_t) i] = i;
+            std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+                return allPositions[(size_t) a].size() < allPositions[(size_t) b].size();
+            });
+            
+            options.resize(order.size());
+            remainingBound.resize(order.size() + 1);
+            current.resize(order.size());
         }
         
-        // Schritt 2: Finde verschiedene Fret-Regionen
-        // Sammle alle möglichen Fret-Positionen
-        std::set<int> allFrets;
-        for (const auto& positions : allPositions)
+        void run()
         {
-            for (const auto& pos : positions)
+            for (const auto& positions : allPositions)
+                if (positions.isEmpty())
+                    return;  // Eine Note kann nicht gespielt werden
+            
+            // Anker-Regionen: alle vorkommenden Bünde, sortiert nach unterer Schranke
+            std::vector<std::pair<float, int>> anchors;
+            {
+                std::vector<int> frets;
+                for (const auto& positions : allPositions)
+                    for (const auto& pos : positions)
+                        frets.push_back(pos.fret);
+                std::sort(frets.begin(), frets.end());
+                frets.erase(std::unique(frets.begin(), frets.end()), frets.end());
+                
+                for (int fret : frets)
+                    anchors.push_back({ prepareAnchor(fret), fret });
+                std::sort(anchors.begin(), anchors.end());
+            }
+            
+            for (const auto& [lowerBound, fret] : anchors)
             {
-                allFrets.insert(pos.fret);
+                if (lowerBound >= cutoff() || timedOut)
+                    break;  // Kein weiterer Anker kann die Top-K noch verbessern
+                
+                prepareAnchor(fret);
+                bestCost = cutoff();
+                best.clear();
+                search(0, 0u, 999, 0, 0.0f);
+                
+                if (! best.empty())
+                    offer(makeAlternative());
             }
         }
         
-        // Schritt 3: Für jede "Anker-Fret-Region" berechne die beste Gruppenposition
-        std::vector<GroupAlternative> candidateAlternatives;
-        
-        // Maximaler Fret-Abstand für gleichzeitige Noten: 3 Bünde!
-        const int maxChordFretSpan = 3;
+        /** Obere Schranke: Kosten der K-besten bisherigen Alternative. */
+        float cutoff() const
+        {
+            return ((int) results.size() >= maxAlternatives) ? results.back().totalCost
+                                                             : std::numeric_limits<float>::max();
+        }
         
-        for (int anchorFret : allFrets)
+        /** Optionen für einen Anker aufbauen; liefert die untere Kostenschranke. */
+        float prepareAnchor(int fret)
         {
-            // Versuche die Gruppe um diese Fret-Region zu positionieren
-            // Verwende Backtracking um sicherzustellen: keine doppelten Saiten, max 3 Frets Spannweite
+            anchorFret = fret;
+            remainingBound.back() = 0.0f;
             
-            GroupAlternative bestAlt;
-            bestAlt.totalCost = 999999.0f;
-            bool foundValid = false;
+            for (size_t d = order.size(); d-- > 0;)
+            {
+                auto& opts = options[d];
+                opts.clear();
+                for (const auto& pos : allPositions[(size_t) order[d]])
+                    opts.push_back({ pos.string, pos.fret,
+                                     pos.cost + std::abs(pos.fret - anchorFret) * distanceWeight });
+                
+                std::sort(opts.begin(), opts.end(),
+                          [](const Option& a, const Option& b) { return a.cost < b.cost; });
+                remainingBound[d] = remainingBound[d + 1] + opts.front().cost;
+            }
+            return remainingBound[0];
+        }
+        
+        void search(size_t depth, uint32_t usedStrings, int minFret, int maxFret, float costSoFar)
+        {
+            if (timedOut)
+                return;
             
-            // Rekursive Suche über alle Noten
-            std::function<void(int, GroupAlternative&, std::set<int>&, int, int)> searchPositions;
-            searchPositions = [&](int noteIdx, GroupAlternative& current, std::set<int>& usedStrings,
-                                  int currentMinFret, int currentMaxFret) {
-                if (noteIdx >= (int)notes.size())
+            if (++nodeCounter >= nodesPerTimeCheck)
+            {
+                nodeCounter = 0;
+                if (juce::Time::getMillisecondCounterHiRes() > deadline)
                 {
-                    // Gültige Kombination gefunden - berechne Kosten
-                    int span = (currentMinFret <= currentMaxFret) ? (currentMaxFret - currentMinFret) : 0;
-                    float totalCost = 0.0f;
-                    int fretSum = 0;
-                    
-                    for (int i = 0; i < current.positions.size(); ++i)
-                    {
-                        float distanceCost = std::abs(current.positions[i].fret - anchorFret) * 2.0f;
-                        // Finde die Positionskosten für diese Note
-                        for (const auto& pos : allPositions[i])
-                        {
-                            if (pos.string == current.positions[i].string && pos.fret == current.positions[i].fret)
-                            {
-                                totalCost += pos.cost + distanceCost;
-                                break;
-                            }
-                        }
-                        fretSum += current.positions[i].fret;
-                    }
-                    totalCost += span * 1.5f;
-                    
-                    if (totalCost < bestAlt.totalCost)
-                    {
-                        bestAlt = current;
-                        bestAlt.totalCost = totalCost;
-                        bestAlt.fretSpan = span;
-                        bestAlt.averageFret = fretSum / (int)notes.size();
-                        foundValid = true;
-                    }
+                    timedOut = true;
                     return;
                 }
-                
-                for (const auto& pos : allPositions[noteIdx])
-                {
-                    // Saite darf NICHT doppelt belegt sein!
-                    if (usedStrings.count(pos.string) > 0)
-                        continue;
-                    
-                    // Fret-Spannweite prüfen (Leersaiten ausgenommen)
-                    int newMin = currentMinFret;
-                    int newMax = currentMaxFret;
-                    if (pos.fret > 0)
-                    {
-                        newMin = (currentMinFret <= currentMaxFret) ? juce::jmin(currentMinFret, pos.fret) : pos.fret;
-                        newMax = (currentMinFret <= currentMaxFret) ? juce::jmax(currentMaxFret, pos.fret) : pos.fret;
-                        if (newMax - newMin > maxChordFretSpan)
-                            continue;  // > 3 Bünde = ungültig!
-                    }
-                    
-                    GroupAlternative::NotePosition notePos;
-                    notePos.string = pos.string;
-                    notePos.fret = pos.fret;
-                    current.positions.add(notePos);
-                    usedStrings.insert(pos.string);
-                    
-                    searchPositions(noteIdx + 1, current, usedStrings, newMin, newMax);
-                    
-                    usedStrings.erase(pos.string);
-                    current.positions.removeLast();
-                }
-            };
-            
-            GroupAlternative current;
-            std::set<int> usedStrings;
-            searchPositions(0, current, usedStrings, 999, 0);
+            }
             
-            if (!foundValid)
-                continue;
+            const int span = (minFret <= maxFret) ? (maxFret - minFret) : 0;
             
-            // Prüfe ob diese Alternative sich von der aktuellen Position unterscheidet
-            bool isDifferent = false;
-            for (int i = 0; i < notes.size(); ++i)
+            if (depth >= order.size())
             {
-                if (bestAlt.positions[i].string != notes[i].currentString ||
-                    bestAlt.positions[i].fret != notes[i].currentFret)
+                float total = costSoFar + span * spanWeight;
+                if (total < bestCost)
                 {
-                    isDifferent = true;
-                    break;
+                    bestCost = total;
+                    best = current;
                 }
+                return;
             }
             
-            if (isDifferent)
+            for (const auto& opt : options[depth])
             {
-                candidateAlternatives.push_back(bestAlt);
+                // Optionen sind nach Kosten sortiert: ab hier kann nichts mehr besser werden
+                if (costSoFar + opt.cost + remainingBound[depth + 1] + span * spanWeight >= bestCost)
+                    break;
+                
+                // Saite darf NICHT doppelt belegt sein!
+                const uint32_t bit = 1u << opt.string;
+                if (usedStrings & bit)
+                    continue;
+                
+                // Fret-Spannweite prüfen (Leersaiten ausgenommen)
+                int newMin = minFret;
+                int newMax = maxFret;
+                if (opt.fret > 0)
+                {
+                    newMin = (minFret <= maxFret) ? juce::jmin(minFret, opt.fret) : opt.fret;
+                    newMax = (minFret <= maxFret) ? juce::jmax(maxFret, opt.fret) : opt.fret;
+                    if (newMax - newMin > maxChordFretSpan)
+                        continue;  // > 3 Bünde = ungültig!
+                }
+                
+                current[depth] = opt;
+                search(depth + 1, usedStrings | bit, newMin, newMax, costSoFar + opt.cost);
+                
+                if (timedOut)
+                    return;
             }
         }
         
-        // Schritt 4: Sortiere und entferne Duplikate
-        std::sort(candidateAlternatives.begin(), candidateAlternatives.end());
-        
-        // Entferne identische Alternativen
-        for (size_t i = 0; i < candidateAlternatives.size(); ++i)
+        GroupAlternative makeAlternative() const
         {
-            bool isDuplicate = false;
-            for (int j = 0; j < alternatives.size(); ++j)
+            GroupAlternative alt;
+            alt.positions.resize(notes.size());
+            
+            int minFret = 999, maxFret = 0, fretSum = 0;
+            for (size_t d = 0; d < order.size(); ++d)
             {
-                bool same = true;
+                auto& pos = alt.positions.getReference(order[d]);
+                pos.string = best[d].string;
+                pos.fret = best[d].fret;
+                fretSum += pos.fret;
+                if (pos.fret > 0)
+                {
+                    minFret = juce::jmin(minFret, pos.fret);
+                    maxFret = juce::jmax(maxFret, pos.fret);
+                }
+            }
+            
+            alt.totalCost = bestCost;
+            alt.fretSpan = (minFret <= maxFret) ? (maxFret - minFret) : 0;
+            alt.averageFret = fretSum / notes.size();
+            return alt;
+        }
+        
+        /** Alternative in die Top-K aufnehmen (ohne aktuelle Position, Duplikate zusammengefasst). */
+        void offer(GroupAlternative alt)
+        {
+            auto samePositions = [this](const GroupAlternative& a, const GroupAlternative& b) {
                 for (int k = 0; k < notes.size(); ++k)
+                    if (a.positions[k].string != b.positions[k].string || a.positions[k].fret != b.positions[k].fret)
+                        return false;
+                return true;
+            };
+            
+            // Prüfe ob diese Alternative sich von der aktuellen Position unterscheidet
+            bool isDifferent = false;
+            for (int i = 0; i < notes.size(); ++i)
+            {
+                if (alt.positions[i].string != notes[i].currentString || alt.positions[i].fret != notes[i].currentFret)
                 {
-                    if (candidateAlternatives[i].positions[k].string != alternatives[j].positions[k].string ||
-                        candidateAlternatives[i].positions[k].fret != alternatives[j].positions[k].fret)
-                    {
-                        same = false;
-                        break;
-                    }
+                    isDifferent = true;
+                    break;
                 }
-                if (same) { isDuplicate = true; break; }
             }
+            if (! isDifferent)
+                return;
             
-            if (!isDuplicate)
+            // Gleicher Griff über einen anderen Anker: nur die günstigere Bewertung behalten
+            for (auto it = results.begin(); it != results.end(); ++it)
             {
-                alternatives.add(candidateAlternatives[i]);
-                if (alternatives.size() >= maxAlternatives)
+                if (samePositions(*it, alt))
+                {
+                    if (it->totalCost <= alt.totalCost)
+                        return;
+                    results.erase(it);
                     break;
+                }
             }
+            
+            auto insertAt = std::upper_bound(results.begin(), results.end(), alt);
+            results.insert(insertAt, std::move(alt));
+            if ((int) results.size() > maxAlternatives)
+                results.pop_back();
         }
-        
-        return alternatives;
-    }
+    };
 };
 
@@ -0,0 +1,451 @@
+// GP5Bench - Micro-Benchmarks der Hot Paths (Standalone-Konsolenprogramm)
+// Parser (GP3/4/5, GP7, MIDI), Tab-Aufbau, Layout, Akkord-Matching, Fingersatz-
+// Optimierung, BasicPitch (Notes::convert, CNN) und GP5Writer. Eingaben sind die
+// Beispieldateien im Repo bzw. deterministisch erzeugte Daten (feste Seeds).
+// Build: cmake -DGP5_BUILD_BENCHMARKS=ON ... (Target GP5Bench)
+// Usage: GP5Bench [--data <dir>] [--json <file>] [--filter <text>] [--samples <n>] [--list]
+//
+// Jede Messung wird so oft wiederholt, dass eine Probe >= 5 ms dauert; berichtet
+// werden min/median/mean/max pro Durchlauf. Die Checksumme verhindert, dass der
+// Compiler Arbeit wegoptimiert, und zeigt Verhaltensänderungen zwischen Läufen.
+// Exit-Code 1, wenn ein Benchmark sein Zeitbudget (budgetMs) überschreitet.
+
+#include <juce_core/juce_core.h>
+
+#include "GP5Parser.h"
+#include "GP7Parser.h"
+#include "GP5Writer.h"
+#include "MidiImporter.h"
+#include "TabLayoutEngine.h"
+#include "ChordMatcher.h"
+#include "FingeringOptimizer.h"
+#include "BasicPitch/Notes.h"
+#include "BasicPitch/BasicPitchCNN.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+
+#ifndef GP5_BENCH_DATA_DIR
+ #define GP5_BENCH_DATA_DIR "."
+#endif
+
+namespace
+{
+    struct Benchmark
+    {
+        juce::String name;
+        juce::String input;
+        double budgetMs = 0.0;                 // 0 = kein Budget
+        std::function<size_t()> run;           // ein Durchlauf, liefert Checksumme
+    };
+
+    struct Result
+    {
+        int iterations = 0;
+        int samples = 0;
+        double minNs = 0.0, medianNs = 0.0, meanNs = 0.0, maxNs = 0.0;
+        size_t checksum = 0;
+    };
+
+    double elapsedNs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    Result measure(const Benchmark& bench, int numSamples)
+    {
+        Result result;
+        result.samples = numSamples;
+
+        // Aufwärmen und Wiederholungen pro Probe bestimmen (Probe >= 5 ms)
+        int iterations = 1;
+        for (;;)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i)
+                result.checksum = bench.run();
+            if (elapsedNs(start) >= 5.0e6 || iterations >= (1 << 20))
+                break;
+            iterations *= 2;
+        }
+        result.iterations = iterations;
+
+        std::vector<double> perRun;
+        for (int s = 0; s < numSamples; ++s)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i)
+                result.checksum = bench.run();
+            perRun.push_back(elapsedNs(start) / iterations);
+        }
+
+        std::sort(perRun.begin(), perRun.end());
+        result.minNs = perRun.front();
+        result.maxNs = perRun.back();
+        result.medianNs = perRun[perRun.size() / 2];
+        for (double ns : perRun)
+            result.meanNs += ns / (double) perRun.size();
+        return result;
+    }
+
+    //==========================================================================
+    // Checksummen
+
+    size_t checksumTrack(const TabTrack& track)
+    {
+        size_t sum = (size_t) track.measures.size();
+        for (const auto& measure : track.measures)
+            for (const auto& beat : measure.beats)
+                for (const auto& note : beat.notes)
+                    sum = sum * 31 + (size_t) (note.string * 32 + note.fret);
+        return sum;
+    }
+
+    template <typename Parser>
+    size_t checksumParser(const Parser& parser)
+    {
+        size_t sum = (size_t) parser.getMeasureHeaders().size();
+        for (const auto& track : parser.getTracks())
+            sum = sum * 31 + (size_t) track.measures.size();
+        return sum;
+    }
+
+    //==========================================================================
+    // Deterministische Eingaben
+
+    // Pseudo-musikalische Phrase: Läufe in Tonleiterschritten, ab und zu Sprünge
+    // und 3-4-stimmige Akkorde - ähnlich einer echten Aufnahme
+    std::vector<FingeringOptimizer::NoteGroup> makePhrase(int numNotes, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> step(-2, 2);
+        std::uniform_int_distribution<int> percent(0, 99);
+        const double durations[] = { 0.125, 0.25, 0.5, 1.0 };
+
+        std::vector<FingeringOptimizer::NoteGroup> groups;
+        int pitch = 57;
+        int notes = 0;
+
+        while (notes < numNotes)
+        {
+            FingeringOptimizer::NoteGroup group;
+            group.beatsToNext = durations[percent(rng) % 4];
+
+            int roll = percent(rng);
+            if (roll < 10)
+            {
+                // Akkord (Dur/Moll-Dreiklang + Oktave)
+                int third = (roll % 2) ? 4 : 3;
+                group.midiNotes = { pitch - 12, pitch - 12 + third, pitch - 5, pitch };
+                if (roll < 5)
+                    group.midiNotes.pop_back();
+            }
+            else
+            {
+                if (roll > 95)
+                    pitch += (roll % 2) ? 7 : -7;
+                pitch += step(rng);
+                group.midiNotes = { pitch };
+            }
+
+            pitch = std::max(45, std::min(81, pitch));
+            notes += (int) group.midiNotes.size();
+            groups.push_back(std::move(group));
+        }
+        return groups;
+    }
+
+    // Posteriorgramme wie aus der CNN: gehaltene Noten mit Onset-Spitze, leichtes Rauschen
+    struct Posteriorgrams
+    {
+        std::vector<std::vector<float>> notes, onsets, contours;
+    };
+
+    Posteriorgrams makePosteriorgrams(int numFrames, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> noise(0.0f, 0.08f);
+        std::uniform_int_distribution<int> pitchDist(20, 60);
+        std::uniform_int_distribution<int> lengthDist(8, 60);
+
+        Posteriorgrams pg;
+        pg.notes.assign((size_t) numFrames, std::vector<float>(NUM_FREQ_OUT));
+        pg.onsets.assign((size_t) numFrames, std::vector<float>(NUM_FREQ_OUT));
+        pg.contours.assign((size_t) numFrames, std::vector<float>(NUM_FREQ_IN));
+        for (int f = 0; f < numFrames; ++f)
+        {
+            for (auto& v : pg.notes[(size_t) f]) v = noise(rng);
+            for (auto& v : pg.onsets[(size_t) f]) v = noise(rng);
+            for (auto& v : pg.contours[(size_t) f]) v = noise(rng);
+        }
+
+        // Zwei Stimmen mit wechselnden Noten
+        for (int voice = 0; voice < 2; ++voice)
+        {
+            for (int f = voice * 5; f < numFrames;)
+            {
+                const int pitch = pitchDist(rng) + voice * 12;
+                const int length = lengthDist(rng);
+                pg.onsets[(size_t) f][(size_t) pitch] = 0.9f;
+                for (int i = f; i < std::min(numFrames, f + length); ++i)
+                {
+                    pg.notes[(size_t) i][(size_t) pitch] = 0.8f;
+                    pg.contours[(size_t) i][(size_t) (pitch * 3 + 1)] = 0.8f;
+                }
+                f += length + 2;
+            }
+        }
+        return pg;
+    }
+
+    //==========================================================================
+
+    std::vector<Benchmark> createBenchmarks(const juce::File& dataDir)
+    {
+        std::vector<Benchmark> benchmarks;
+
+        const juce::StringArray gp5Files { "Comfortably 4.gp5", "Adagio.gp5", "test_partial.gp3" };
+        const juce::StringArray midiFiles { "Adagio.mid", "Clocks_Track3.mid" };
+        const juce::String gp7File = "test_partial.gp";
+
+        // --- Parser ---------------------------------------------------------
+        for (const auto& name : gp5Files)
+        {
+            const auto file = dataDir.getChildFile(name);
+            if (!file.existsAsFile())
+                continue;
+
+            benchmarks.push_back({ "GP5Parser::parse", name, 0.0, [file]
+            {
+                GP5Parser parser;
+                return parser.parse(file) ? checksumParser(parser) : 0;
+            } });
+        }
+
+        if (dataDir.getChildFile(gp7File).existsAsFile())
+        {
+            const auto file = dataDir.getChildFile(gp7File);
+            benchmarks.push_back({ "GP7Parser::parseFile", gp7File, 0.0, [file]
+            {
+                GP7Parser parser;
+                return parser.parseFile(file) ? checksumParser(parser) : 0;
+            } });
+        }
+
+        for (const auto& name : midiFiles)
+        {
+            const auto file = dataDir.getChildFile(name);
+            if (!file.existsAsFile())
+                continue;
+
+            benchmarks.push_back({ "MidiImporter::parseFile", name, 0.0, [file]
+            {
+                MidiImporter importer;
+                return importer.parseFile(file) ? checksumParser(importer) : 0;
+            } });
+        }
+
+        // --- Tab-Aufbau, Layout und Writer auf dem größten Beispiel -----------
+        const auto songFile = dataDir.getChildFile(gp5Files[0]);
+        auto song = std::make_shared<GP5Parser>();
+        if (songFile.existsAsFile() && song->parse(songFile) && song->getTracks().size() > 0)
+        {
+            benchmarks.push_back({ "convertToTabTrack", gp5Files[0] + " (all tracks)", 0.0, [song]
+            {
+                size_t sum = 0;
+                for (int t = 0; t < song->getTracks().size(); ++t)
+                    sum += checksumTrack(song->convertToTabTrack(t));
+                return sum;
+            } });
+
+            auto tracks = std::make_shared<std::vector<TabTrack>>();
+            for (int t = 0; t < song->getTracks().size(); ++t)
+                tracks->push_back(song->convertToTabTrack(t));
+
+            auto layoutTrack = std::make_shared<TabTrack>(tracks->front());
+            benchmarks.push_back({ "TabLayoutEngine::calculateLayout", gp5Files[0] + " (track 1)", 0.0, [layoutTrack]
+            {
+                TabLayoutEngine engine;
+                TabLayoutConfig config;
+                return (size_t) engine.calculateLayout(*layoutTrack, config, 1200.0f);
+            } });
+
+            benchmarks.push_back({ "GP5Writer::writeToMemory", gp5Files[0] + " (all tracks)", 0.0, [tracks]
+            {
+                GP5Writer writer;
+                juce::MemoryBlock data;
+                return writer.writeToMemory(*tracks, data) ? data.getSize() : 0;
+            } });
+        }
+
+        // --- Akkorde ----------------------------------------------------------
+        {
+            const std::vector<std::vector<int>> chords {
+                { 48, 52, 55, 60, 64 },        // C
+                { 43, 47, 50, 55, 59, 67 },    // G
+                { 45, 52, 57, 60, 64 },        // Am
+                { 41, 48, 53, 57, 60, 65 },    // F (Barré)
+                { 40, 47, 50, 56, 59, 64 },    // E7
+                { 41, 50, 57, 62, 65 },        // Dm/F
+                { 47, 54, 57, 62, 66 },        // Bm7
+                { 50, 57, 62, 66 },            // D
+            };
+            auto matcher = std::make_shared<ChordMatcher>();
+            benchmarks.push_back({ "ChordMatcher::findBestChord", juce::String((int) chords.size()) + " voicings", 0.0, [matcher, chords]
+            {
+                size_t sum = 0;
+                for (const auto& chord : chords)
+                {
+                    const auto result = matcher->findBestChord(chord, 0, true);
+                    sum = sum * 31 + (size_t) (result.totalCost * 100.0f) + (result.isMatch ? 1 : 0);
+                }
+                return sum;
+            } });
+        }
+
+        // --- Re-Optimierung der Aufnahme (Kern von reoptimizeRecordedNotes) ----
+        {
+            auto phrase = std::make_shared<std::vector<FingeringOptimizer::NoteGroup>>(makePhrase(10000, 42));
+            auto optimizer = std::make_shared<FingeringOptimizer>();
+            optimizer->setTuning(GuitarTuning::standardGuitar());
+
+            // Interaktiv = unter 100 ms für eine komplette Re-Optimierung
+            benchmarks.push_back({ "reoptimizeRecordedNotes (FingeringOptimizer)", "10000 notes, beam 16", 100.0, [phrase, optimizer]
+            {
+                size_t sum = 0;
+                for (const auto& group : optimizer->optimise(*phrase))
+                    for (const auto& choice : group)
+                        sum += (size_t) (choice.string * 31 + choice.fret);
+                return sum;
+            } });
+        }
+
+        // --- BasicPitch ---------------------------------------------------------
+        {
+            // 10 s Audio bei 22050 Hz / Hop 256
+            const int numFrames = (int) (10.0 * BASIC_PITCH_SAMPLE_RATE / FFT_HOP);
+            auto pg = std::make_shared<Posteriorgrams>(makePosteriorgrams(numFrames, 7));
+            benchmarks.push_back({ "Notes::convert", juce::String(numFrames) + " frames (10 s)", 0.0, [pg]
+            {
+                Notes notes;
+                Notes::ConvertParams params;
+                params.pitchBend = MultiPitchBend;
+                const auto events = notes.convert(pg->notes, pg->onsets, pg->contours, params, true);
+                size_t sum = events.size();
+                for (const auto& e : events)
+                    sum = sum * 31 + (size_t) (e.pitch * 1000 + e.startFrame);
+                return sum;
+            } });
+        }
+
+        {
+            constexpr int framesPerRun = 100;
+            auto cnn = std::make_shared<BasicPitchCNN>();
+            auto input = std::make_shared<std::vector<float>>((size_t) (NUM_HARMONICS * NUM_FREQ_IN * framesPerRun));
+            std::mt19937 rng(3);
+            std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+            for (auto& v : *input)
+                v = dist(rng);
+
+            benchmarks.push_back({ "BasicPitchCNN::frameInference", juce::String(framesPerRun) + " frames", 0.0, [cnn, input]
+            {
+                std::vector<float> contours(NUM_FREQ_IN), notes(NUM_FREQ_OUT), onsets(NUM_FREQ_OUT);
+                cnn->reset();
+                float sum = 0.0f;
+                for (int f = 0; f < framesPerRun; ++f)
+                {
+                    cnn->frameInference(input->data() + (size_t) f * NUM_HARMONICS * NUM_FREQ_IN, contours, notes, onsets);
+                    sum += notes[40] + onsets[40];
+                }
+                return (size_t) (sum * 1000.0f);
+            } });
+        }
+
+        return benchmarks;
+    }
+
+    juce::var toJson(const Benchmark& bench, const Result& result)
+    {
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty("name", bench.name);
+        obj->setProperty("input", bench.input);
+        obj->setProperty("iterations", result.iterations);
+        obj->setProperty("samples", result.samples);
+        obj->setProperty("minNs", result.minNs);
+        obj->setProperty("medianNs", result.medianNs);
+        obj->setProperty("meanNs", result.meanNs);
+        obj->setProperty("maxNs", result.maxNs);
+        obj->setProperty("checksum", juce::String::toHexString((juce::int64) result.checksum));
+        if (bench.budgetMs > 0.0)
+            obj->setProperty("budgetMs", bench.budgetMs);
+        return juce::var(obj);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ConsoleApplication::ArgumentList args(argc, argv);
+
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    const juce::File dataDir = args.containsOption("--data")
+        ? cwd.getChildFile(args.getValueForOption("--data"))
+        : juce::File(GP5_BENCH_DATA_DIR);
+    const juce::String filter = args.getValueForOption("--filter");
+    const int numSamples = juce::jmax(3, args.getValueForOption("--samples").getIntValue() > 0
+                                             ? args.getValueForOption("--samples").getIntValue() : 10);
+
+    auto benchmarks = createBenchmarks(dataDir);
+
+    if (args.containsOption("--list"))
+    {
+        for (const auto& bench : benchmarks)
+            std::cout << bench.name << " [" << bench.input << "]\n";
+        return 0;
+    }
+
+    juce::Array<juce::var> results;
+    bool budgetsMet = true;
+
+    for (const auto& bench : benchmarks)
+    {
+        if (filter.isNotEmpty() && !bench.name.containsIgnoreCase(filter))
+            continue;
+
+        const auto result = measure(bench, numSamples);
+        results.add(toJson(bench, result));
+
+        const double medianMs = result.medianNs / 1.0e6;
+        std::cout << bench.name << " [" << bench.input << "]: median " << medianMs << " ms"
+                  << ", min " << (result.minNs / 1.0e6) << " ms (" << result.iterations << " x "
+                  << result.samples << ")\n";
+
+        if (bench.budgetMs > 0.0 && result.minNs / 1.0e6 > bench.budgetMs)
+        {
+            std::cout << "  over budget (" << bench.budgetMs << " ms)\n";
+            budgetsMet = false;
+        }
+    }
+
+    if (args.containsOption("--json"))
+    {
+        auto* root = new juce::DynamicObject();
+        root->setProperty("schema", 1);
+        root->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+        root->setProperty("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty("os", juce::SystemStats::getOperatingSystemName());
+        root->setProperty("benchmarks", results);
+
+        const auto jsonFile = cwd.getChildFile(args.getValueForOption("--json"));
+        if (!jsonFile.replaceWithText(juce::JSON::toString(juce::var(root))))
+        {
+            std::cerr << "Could not write " << jsonFile.getFullPathName() << "\n";
+            return 2;
+        }
+    }
+
+    return budgetsMet ? 0 : 1;
+}
@@ -0,0 +1,247 @@
+/*
+  ==============================================================================
+
+    GP5ExportJob.h
+
+    GP5-Export im Hintergrund.
+
+    Ein eigener Thread konvertiert die Tracks (parallel auf dem Worker-Pool),
+    übernimmt Titel/Track-Namen/Instrumente aus dem Export-Panel, serialisiert
+    mit dem GP5Writer in einen vorab reservierten Speicherblock und schreibt
+    die Datei atomar (temporäre Datei + Umbenennen). Der Message-Thread fragt
+    nur Fortschritt und Ergebnis ab und blockiert nie.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "TabModels.h"
+#include "GP5Writer.h"
+#include "ChannelWorkerPool.h"
+#include <atomic>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+//==============================================================================
+/**
+ * GP5ExportJob
+ */
+class GP5ExportJob : private juce::Thread
+{
+public:
+    /** Liefert den TabTrack für einen Track-Index; wird parallel aufgerufen und darf nur lesen. */
+    using TrackSource = std::function<TabTrack(int trackIndex)>;
+
+    /** Liefert alle Tracks auf einmal (Aufnahme: ein Track pro MIDI-Kanal). */
+    using TrackListSource = std::function<std::vector<TabTrack>()>;
+
+    enum class Status { idle, running, succeeded, failed };
+
+    struct Request
+    {
+        juce::File outputFile;
+        juce::String title = "Untitled";
+        juce::String artist;
+        int tempo = 120;
+
+        std::vector<std::pair<juce::String, int>> trackData;   // Name + GM-Instrument pro Track
+        std::map<int, TabTrack> editedTracks;                   // ersetzen die konvertierten Tracks
+
+        int numTracks = 0;                // zusammen mit trackSource
+        TrackSource trackSource;
+        TrackListSource trackListSource;  // alternativ zu trackSource
+    };
+
+    explicit GP5ExportJob(ChannelWorkerPool& workerPool)
+        : juce::Thread("GP5ExportJob"),
+          pool(workerPool)
+    {
+    }
+
+    ~GP5ExportJob() override
+    {
+        cancel();
+    }
+
+    /**
+     * Startet den Export; false wenn bereits einer läuft. Die Quellen werden im
+     * Hintergrund aufgerufen - der Aufrufer muss cancel() aufrufen, bevor sie
+     * ungültig werden (neue Datei, Entladen).
+     */
+    bool start(Request newRequest)
+    {
+        if (isThreadRunning())
+            return false;
+
+        request = std::move(newRequest);
+        cancelRequested.store(false, std::memory_order_release);
+        progress.store(0.0f);
+        status.store(Status::running);
+        startThread(juce::Thread::Priority::low);
+        return true;
+    }
+
+    /**
+     * Bricht einen laufenden Export ab; die Zieldatei bleibt unverändert. Wartet ohne
+     * Timeout auf den Thread und seine Pool-Jobs, danach liest niemand mehr die Quellen.
+     */
+    void cancel()
+    {
+        cancelRequested.store(true, std::memory_order_release);
+        stopThread(-1);
+        request = Request();
+
+        Status expected = Status::running;
+        if (status.compare_exchange_strong(expected, Status::idle))
+            DBG("GP5ExportJob: cancelled");
+    }
+
+    bool isExporting() const { return status.load() == Status::running; }
+
+    /** Fortschritt 0..1 (Konvertieren bis 0.5, Serialisieren bis 0.9, Schreiben). */
+    float getProgress() const { return progress.load(std::memory_order_relaxed); }
+
+    /**
+     * Ergebnis eines beendeten Exports einmalig abholen (danach idle).
+     * message enthält den Dateinamen bzw. die Fehlermeldung.
+     */
+    Status takeResult(juce::String& message)
+    {
+        Status current = status.load(std::memory_order_acquire);
+        if (current != Status::succeeded && current != Status::failed)
+            return current;
+
+        message = resultMessage;
+        status.store(Status::idle);
+        return current;
+    }
+
+    //==========================================================================
+    /**
+     * Führt einen Export synchron aus (auch ohne Thread nutzbar).
+     * shouldExit wird zwischen den Schritten abgefragt, onProgress bekommt 0..1;
+     * cancelled (optional) lässt noch wartende Konvertierungs-Jobs aus.
+     */
+    static bool execute(const Request& request, ChannelWorkerPool& workerPool,
+                        const std::function<bool()>& shouldExit,
+                        const std::function<void(float)>& onProgress,
+                        juce::String& message,
+                        const std::atomic<bool>* cancelled = nullptr)
+    {
+        const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+        // 1. Tracks konvertieren - unabhängig pro Track, daher parallel
+        std::vector<TabTrack> tracks;
+        if (request.trackListSource)
+        {
+            tracks = request.trackListSource();
+            for (size_t i = 0; i < tracks.size(); ++i)
+            {
+                auto edited = request.editedTracks.find((int) i);
+                if (edited != request.editedTracks.end())
+                    tracks[i] = edited->second;
+            }
+            onProgress(0.5f);
+        }
+        else if (request.trackSource)
+        {
+            tracks.resize((size_t) juce::jmax(0, request.numTracks));
+            std::atomic<int> converted { 0 };
+
+            workerPool.runAll(request.numTracks, [&](int trackIndex)
+            {
+                if (shouldExit())
+                    return;
+
+                auto edited = request.editedTracks.find(trackIndex);
+                tracks[(size_t) trackIndex] = edited != request.editedTracks.end() ? edited->second
+                                                                                   : request.trackSource(trackIndex);
+                onProgress(0.5f * (float) (converted.fetch_add(1) + 1) / (float) request.numTracks);
+            }, cancelled);
+        }
+
+        if (shouldExit())
+        {
+            message = "Export cancelled";
+            return false;
+        }
+
+        if (tracks.empty() || (tracks.size() == 1 && tracks[0].measures.isEmpty()))
+        {
+            message = "No notes to export";
+            return false;
+        }
+
+        // Metadaten aus dem Export-Panel
+        for (size_t i = 0; i < tracks.size() && i < request.trackData.size(); ++i)
+        {
+            tracks[i].name = request.trackData[i].first;
+            tracks[i].midiInstrument = request.trackData[i].second;
+        }
+
+        // 2. In den Speicher serialisieren
+        GP5Writer writer;
+        writer.setTitle(request.title.isEmpty() ? "Untitled" : request.title);
+        writer.setArtist(request.artist);
+        writer.setTempo(request.tempo);
+        writer.setProgressCallback([&onProgress](float written) { onProgress(0.5f + 0.4f * written); });
+
+        juce::MemoryBlock data;
+        if (!writer.writeToMemory(tracks, data))
+        {
+            message = writer.getLastError();
+            return false;
+        }
+
+        if (shouldExit())
+        {
+            message = "Export cancelled";
+            return false;
+        }
+
+        // 3. Atomar schreiben
+        if (!GP5Writer::writeFileAtomically(data, request.outputFile, message))
+            return false;
+
+        onProgress(1.0f);
+        message = request.outputFile.getFileName();
+
+        DBG("GP5ExportJob: " << (int) tracks.size() << " track(s), " << (int) data.getSize() << " bytes in "
+            << juce::String(juce::Time::getMillisecondCounterHiRes() - startMs, 1) << " ms -> "
+            << request.outputFile.getFullPathName());
+        return true;
+    }
+
+private:
+    ChannelWorkerPool& pool;
+    Request request;
+
+    std::atomic<Status> status { Status::idle };
+    std::atomic<float> progress { 0.0f };
+    std::atomic<bool> cancelRequested { false };   // für runAll: wartende Jobs überspringen
+    juce::String resultMessage;   // gültig sobald status succeeded/failed ist
+
+    void run() override
+    {
+        juce::String message;
+        const bool ok = execute(request, pool,
+                                [this] { return threadShouldExit(); },
+                                [this](float value) { progress.store(value, std::memory_order_relaxed); },
+                                message, &cancelRequested);
+
+        if (threadShouldExit())
+            return;   // cancel() setzt den Status zurück
+
+        if (!ok)
+            DBG("GP5ExportJob failed: " << message);
+
+        resultMessage = message;
+        status.store(ok ? Status::succeeded : Status::failed, std::memory_order_release);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GP5ExportJob)
+};
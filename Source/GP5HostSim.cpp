@@ -0,0 +1,145 @@
+// GP5HostSim - Headless-Host: spielt ein Host-Skript gegen den Processor ab (ohne DAW)
+// Transport (Play/Stop/Seek/Loop/Tempo/Record-Arm), synthetisches MIDI und Sidechain-
+// Audio bei beliebigen Blockgrößen; Skriptformat siehe HostSimulator.h.
+// Build: cmake -DGP5_BUILD_HOSTSIM=ON ... (Target GP5HostSim, linkt den Plugin-Code)
+// Usage: GP5HostSim <script> [--golden <file>] [--update] [--timing <csv>] [--max-load <fraction>]
+//
+// Die ausgegebenen MIDI-Events werden mit dem Golden-File verglichen (bei Abweichung
+// landet die aktuelle Ausgabe in <golden>.actual), --update schreibt es neu. Ein
+// fehlendes Golden-File ist ein Fehler - angelegt wird es nur mit --update.
+// --max-load begrenzt die p99-Blocklaufzeit als Anteil der Block-Deadline (z.B. 0.25).
+// Exit-Codes: 0 ok, 1 Golden-Abweichung, 2 Laufzeitgrenze überschritten, 3 Skript-/IO-Fehler
+// oder fehlendes Golden-File.
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_events/juce_events.h>
+
+#include "PluginProcessor.h"
+#include "HostSimulator.h"
+
+#include <iostream>
+
+namespace
+{
+    /** Erste abweichende Zeile (1-basiert), 0 bei Gleichheit. */
+    int findFirstDifference(const juce::StringArray& expected, const juce::StringArray& actual)
+    {
+        const int common = juce::jmin(expected.size(), actual.size());
+        for (int i = 0; i < common; ++i)
+            if (expected[i] != actual[i])
+                return i + 1;
+        return expected.size() == actual.size() ? 0 : common + 1;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ConsoleApplication::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args[0].isOption())
+    {
+        std::cerr << "Usage: GP5HostSim <script> [--golden <file>] [--update] [--timing <csv>] [--max-load <fraction>]\n";
+        return 3;
+    }
+
+    // Message-Manager für die Timer des Processors (deren Arbeit holt der HostSimulator selbst ab)
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    const auto scriptFile = cwd.getChildFile(args[0].text);
+
+    juce::StringArray output;
+    juce::String timingReport, profilerReport, timingCsv;
+    double p99Load = 0.0;
+    {
+        NewProjectAudioProcessor processor;
+        HostSimulator simulator(processor);
+
+        if (!simulator.runScript(scriptFile))
+        {
+            std::cerr << simulator.getLastError() << "\n";
+            return 3;
+        }
+
+        output.add("# GP5HostSim " + scriptFile.getFileName());
+        output.addArray(simulator.getMidiLog());
+        timingReport = simulator.createTimingReport();
+        timingCsv = simulator.createTimingCsv();
+        p99Load = simulator.getP99Load();
+        profilerReport = processor.getAudioThreadProfiler().createReport();
+    }
+
+    std::cout << scriptFile.getFileName() << ": " << (output.size() - 1) << " log lines\n"
+              << timingReport << profilerReport;
+
+    if (args.containsOption("--timing"))
+    {
+        const auto csvFile = cwd.getChildFile(args.getValueForOption("--timing"));
+        if (!csvFile.replaceWithText(timingCsv))
+        {
+            std::cerr << "Could not write " << csvFile.getFullPathName() << "\n";
+            return 3;
+        }
+    }
+
+    int result = 0;
+
+    if (args.containsOption("--golden"))
+    {
+        const auto goldenFile = cwd.getChildFile(args.getValueForOption("--golden"));
+        const auto actualFile = goldenFile.withFileExtension(goldenFile.getFileExtension() + ".actual");
+        const auto text = output.joinIntoString("\n") + "\n";
+
+        if (args.containsOption("--update"))
+        {
+            if (!goldenFile.replaceWithText(text))
+            {
+                std::cerr << "Could not write " << goldenFile.getFullPathName() << "\n";
+                return 3;
+            }
+            std::cout << "golden written: " << goldenFile.getFullPathName() << "\n";
+        }
+        else if (!goldenFile.existsAsFile())
+        {
+            // Nicht stillschweigend anlegen, sonst gilt jede Ausgabe als richtig
+            actualFile.replaceWithText(text);
+            std::cerr << "Golden file " << goldenFile.getFullPathName() << " is missing (output written to "
+                      << actualFile.getFileName() << "; review it and rerun with --update)\n";
+            return 3;
+        }
+        else
+        {
+            juce::StringArray expected;
+            goldenFile.readLines(expected);
+            expected.removeEmptyStrings();
+
+            if (const int line = findFirstDifference(expected, output); line > 0)
+            {
+                std::cout << "MIDI output differs from " << goldenFile.getFileName() << " at line " << line << "\n"
+                          << "  expected: " << expected[line - 1] << "\n"
+                          << "  actual:   " << output[line - 1] << "\n";
+                actualFile.replaceWithText(text);
+                result = 1;
+            }
+            else
+            {
+                actualFile.deleteFile();
+                std::cout << "golden ok\n";
+            }
+        }
+    }
+
+    if (args.containsOption("--max-load"))
+    {
+        const double maxLoad = args.getValueForOption("--max-load").getDoubleValue();
+        if (maxLoad > 0.0 && p99Load > maxLoad)
+        {
+            std::cout << "p99 block load " << juce::String(100.0 * p99Load, 1) << "% exceeds limit "
+                      << juce::String(100.0 * maxLoad, 1) << "%\n";
+            if (result == 0)
+                result = 2;
+        }
+    }
+
+    return result;
+}
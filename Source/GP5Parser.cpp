@@ -10,6 +10,7 @@
 */
 
 #include "GP5Parser.h"
+#include "TraceRecorder.h"
 
 //==============================================================================
 GP5Parser::GP5Parser() {}
@@ -18,6 +19,8 @@ GP5Parser::~GP5Parser() {}
 //==============================================================================
 bool GP5Parser::parse(const juce::File& file)
 {
+    TraceScope trace("GP5Parser::parse", "parser");
+    
     // Reset state
     songInfo = GP5SongInfo();
     midiChannels.clear();
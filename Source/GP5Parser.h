@@ -150,6 +150,28 @@ struct GP5Track
     juce::Array<GP5TrackMeasure> measures;
 };
 
+/** Geschätzter Heap-Speicher eines geparsten Tracks (für MemoryAccounting). */
+inline size_t getHeapBytes(const GP5Track& track)
+{
+    size_t bytes = MemoryAccounting::bytesOf(track.name) + MemoryAccounting::bytesOf(track.tuning)
+                 + MemoryAccounting::bytesOf(track.measures);
+    for (const auto& measure : track.measures)
+    {
+        for (const auto* voice : { &measure.voice1, &measure.voice2 })
+        {
+            bytes += MemoryAccounting::bytesOf(*voice);
+            for (const auto& beat : *voice)
+            {
+                bytes += MemoryAccounting::nodeBytesOf(beat.notes) + MemoryAccounting::bytesOf(beat.text)
+                       + MemoryAccounting::bytesOf(beat.chordName);
+                for (const auto& [string, note] : beat.notes)
+                    bytes += MemoryAccounting::bytesOf(note.bendPoints);
+            }
+        }
+    }
+    return bytes;
+}
+
 //==============================================================================
 // GP5 Parser Class
 //==============================================================================
@@ -60,209 +60,257 @@ GP5Writer::GP5Writer()
 //==============================================================================
 bool GP5Writer::writeToFile(const TabTrack& track, const juce::File& outputFile)
 {
-    // Delete existing file to prevent appending
-    if (outputFile.existsAsFile())
-        outputFile.deleteFile();
+    return writeToFile(std::vector<TabTrack> { track }, outputFile);
+}
+
+//==============================================================================
+// Multi-track version
+//==============================================================================
+bool GP5Writer::writeToFile(const std::vector<TabTrack>& tracks, const juce::File& outputFile)
+{
+    juce::MemoryBlock data;
+    if (!writeToMemory(tracks, data))
+        return false;
     
-    outputStream = outputFile.createOutputStream();
-    if (!outputStream)
+    return writeFileAtomically(data, outputFile, lastError);
+}
+
+//==============================================================================
+bool GP5Writer::writeToMemory(const std::vector<TabTrack>& tracks, juce::MemoryBlock& dest)
+{
+    if (tracks.empty())
     {
-        lastError = "Could not create output file";
+        lastError = "No tracks to write";
         return false;
     }
     
+    // Ein Block in geschätzter Größe statt vieler kleiner Datei-Schreibzugriffe
+    dest.reset();
+    juce::MemoryOutputStream stream(dest, false);
+    stream.preallocate(estimateSize(tracks));
+    outputStream = &stream;
+    
     try
     {
-        // Determine time signature
-        int numerator = 4;
-        int denominator = 4;
-        if (!track.measures.isEmpty())
-        {
-            numerator = track.measures[0].timeSignatureNumerator;
-            denominator = track.measures[0].timeSignatureDenominator;
-        }
-        
-        int numMeasures = juce::jmax(1, (int)track.measures.size());
-        
-        // === PyGuitarPro GP5File.writeSong() order ===
-        
-        // 1. writeVersion()
-        writeVersion();
-        
-        // 2. writeClipboard() - skip if not clipboard
-        
-        // 3. writeInfo()
-        writeSongInfo();
-        
-        // 4. writeLyrics()
-        writeLyrics();
-        
-        // 5. writeRSEMasterEffect() - ONLY for GP5.1+, skip for GP5.0.0!
-        // (We're writing v5.00, so this is empty)
-        
-        // 6. writePageSetup()
-        writePageSetup();
-        
-        // 7. writeIntByteSizeString(tempoName) + writeI32(tempo)
-        writeStringWithLength("");  // Empty tempo name
-        writeInt(tempo);
-        
-        // 8. writeBool(hideTempo) - ONLY for GP5.1+, skip for GP5.0.0
-        
-        // 9. writeI8(key) + writeI32(octave)
-        writeByte(0);    // Key signature (0 = C major/A minor)
-        writeInt(0);     // Octave (always 0)
-        
-        // 10. writeMidiChannels() - use track instrument
-        {
-            std::vector<TabTrack> singleTrackVec = { track };
-            writeMidiChannels(singleTrackVec);
-        }
-        
-        // 11. writeDirections()
-        writeDirections();
-        
-        // 12. writeMasterReverb()
-        writeInt(0);  // Master reverb = 0
-        
-        // 13. writeI32(measureCount) + writeI32(trackCount)
-        writeInt(numMeasures);
-        writeInt(1);  // 1 track
-        
-        // 14. writeMeasureHeaders() - use per-measure data for repeats/markers/time sig changes
-        if (!track.measures.isEmpty())
-            writeMeasureHeaders(track.measures);
+        // If only one track, use the simpler single-track layout
+        if (tracks.size() == 1)
+            writeSingleTrackSong(tracks[0]);
         else
-            writeMeasureHeaders(numMeasures, numerator, denominator);
-        
-        // 15. writeTracks()
-        writeTracks(track);
-        
-        // 16. writeMeasures()
-        writeMeasures(track);
+            writeMultiTrackSong(tracks);
         
-        outputStream->flush();
-        outputStream.reset();
-        
-        return true;
+        stream.flush();   // kürzt dest auf die geschriebene Größe
+        outputStream = nullptr;
     }
     catch (const std::exception& e)
     {
         lastError = juce::String("Write error: ") + e.what();
-        outputStream.reset();
+        outputStream = nullptr;
         return false;
     }
+    
+    return true;
 }
 
 //==============================================================================
-// Multi-track version
+size_t GP5Writer::estimateSize(const std::vector<TabTrack>& tracks)
+{
+    // Erster Durchlauf: grobe Obergrenze aus Header, Takten, Beats und Noten
+    size_t size = 4096;   // Version, Song-Info, Page-Setup, 64 MIDI-Kanäle, Directions
+    int numMeasures = 1;
+    
+    for (const auto& track : tracks)
+    {
+        size += 256;   // Track-Header (Name, Tuning, Farbe, RSE)
+        numMeasures = juce::jmax(numMeasures, (int)track.measures.size());
+        
+        for (const auto& measure : track.measures)
+        {
+            size += 24;   // Zwei Voices + LineBreak
+            for (const auto& beat : measure.beats)
+            {
+                size += 16;
+                for (const auto& note : beat.notes)
+                    size += 32 + note.effects.bendPoints.size() * 9;
+            }
+        }
+    }
+    
+    size += (size_t)numMeasures * (64 + tracks.size() * 24);   // Measure-Header, leere Takte
+    return size;
+}
+
 //==============================================================================
-bool GP5Writer::writeToFile(const std::vector<TabTrack>& tracks, const juce::File& outputFile)
+bool GP5Writer::writeFileAtomically(const juce::MemoryBlock& data, const juce::File& outputFile, juce::String& error)
 {
-    if (tracks.empty())
+    // In eine temporäre Datei neben dem Ziel schreiben und erst danach umbenennen -
+    // ein abgebrochener Export hinterlässt nie eine halbe .gp5
+    juce::TemporaryFile temp(outputFile);
     {
-        lastError = "No tracks to write";
+        juce::FileOutputStream out(temp.getFile());
+        if (out.failedToOpen() || !out.write(data.getData(), data.getSize()))
+        {
+            error = "Could not create output file";
+            return false;
+        }
+        
+        out.flush();
+        if (out.getStatus().failed())
+        {
+            error = "Write error: " + out.getStatus().getErrorMessage();
+            return false;
+        }
+    }
+    
+    if (!temp.overwriteTargetFileWithTemporary())
+    {
+        error = "Could not replace " + outputFile.getFileName();
         return false;
     }
+    return true;
+}
+
+//==============================================================================
+void GP5Writer::writeSingleTrackSong(const TabTrack& track)
+{
+    // Determine time signature
+    int numerator = 4;
+    int denominator = 4;
+    if (!track.measures.isEmpty())
+    {
+        numerator = track.measures[0].timeSignatureNumerator;
+        denominator = track.measures[0].timeSignatureDenominator;
+    }
+    
+    int numMeasures = juce::jmax(1, (int)track.measures.size());
+    
+    // === PyGuitarPro GP5File.writeSong() order ===
+    
+    // 1. writeVersion()
+    writeVersion();
+    
+    // 2. writeClipboard() - skip if not clipboard
+    
+    // 3. writeInfo()
+    writeSongInfo();
+    
+    // 4. writeLyrics()
+    writeLyrics();
+    
+    // 5. writeRSEMasterEffect() - ONLY for GP5.1+, skip for GP5.0.0!
+    // (We're writing v5.00, so this is empty)
+    
+    // 6. writePageSetup()
+    writePageSetup();
+    
+    // 7. writeIntByteSizeString(tempoName) + writeI32(tempo)
+    writeStringWithLength("");  // Empty tempo name
+    writeInt(tempo);
+    
+    // 8. writeBool(hideTempo) - ONLY for GP5.1+, skip for GP5.0.0
     
-    // If only one track, use the simpler single-track method
-    if (tracks.size() == 1)
+    // 9. writeI8(key) + writeI32(octave)
+    writeByte(0);    // Key signature (0 = C major/A minor)
+    writeInt(0);     // Octave (always 0)
+    
+    // 10. writeMidiChannels() - use track instrument
     {
-        return writeToFile(tracks[0], outputFile);
+        std::vector<TabTrack> singleTrackVec = { track };
+        writeMidiChannels(singleTrackVec);
     }
     
-    // Delete existing file to prevent appending
-    if (outputFile.existsAsFile())
-        outputFile.deleteFile();
+    // 11. writeDirections()
+    writeDirections();
+    
+    // 12. writeMasterReverb()
+    writeInt(0);  // Master reverb = 0
+    
+    // 13. writeI32(measureCount) + writeI32(trackCount)
+    writeInt(numMeasures);
+    writeInt(1);  // 1 track
+    
+    // 14. writeMeasureHeaders() - use per-measure data for repeats/markers/time sig changes
+    if (!track.measures.isEmpty())
+        writeMeasureHeaders(track.measures);
+    else
+        writeMeasureHeaders(numMeasures, numerator, denominator);
+    
+    // 15. writeTracks()
+    writeTracks(track);
     
-    outputStream = outputFile.createOutputStream();
-    if (!outputStream)
+    // 16. writeMeasures()
+    writeMeasures(track);
+}
+
+//==============================================================================
+void GP5Writer::writeMultiTrackSong(const std::vector<TabTrack>& tracks)
+{
+    // Determine time signature from first track
+    int numerator = 4;
+    int denominator = 4;
+    if (!tracks[0].measures.isEmpty())
     {
-        lastError = "Could not create output file";
-        return false;
+        numerator = tracks[0].measures[0].timeSignatureNumerator;
+        denominator = tracks[0].measures[0].timeSignatureDenominator;
     }
     
-    try
+    // Find max measure count across all tracks
+    int numMeasures = 1;
+    for (const auto& track : tracks)
     {
-        // Determine time signature from first track
-        int numerator = 4;
-        int denominator = 4;
-        if (!tracks[0].measures.isEmpty())
-        {
-            numerator = tracks[0].measures[0].timeSignatureNumerator;
-            denominator = tracks[0].measures[0].timeSignatureDenominator;
-        }
-        
-        // Find max measure count across all tracks
-        int numMeasures = 1;
-        for (const auto& track : tracks)
-        {
-            numMeasures = juce::jmax(numMeasures, (int)track.measures.size());
-        }
-        
-        int numTracks = (int)tracks.size();
-        
-        // === PyGuitarPro GP5File.writeSong() order ===
-        
-        // 1. writeVersion()
-        writeVersion();
-        
-        // 3. writeInfo()
-        writeSongInfo();
-        
-        // 4. writeLyrics()
-        writeLyrics();
-        
-        // 6. writePageSetup()
-        writePageSetup();
-        
-        // 7. writeIntByteSizeString(tempoName) + writeI32(tempo)
-        writeStringWithLength("");  // Empty tempo name
-        writeInt(tempo);
-        
-        // 9. writeI8(key) + writeI32(octave)
-        writeByte(0);    // Key signature (0 = C major/A minor)
-        writeInt(0);     // Octave (always 0)
-        
-        // 10. writeMidiChannels() - use track instruments
-        writeMidiChannels(tracks);
-        
-        // 11. writeDirections()
-        writeDirections();
-        
-        // 12. writeMasterReverb()
-        writeInt(0);  // Master reverb = 0
-        
-        // 13. writeI32(measureCount) + writeI32(trackCount)
-        writeInt(numMeasures);
-        writeInt(numTracks);
-        
-        // 14. writeMeasureHeaders() - use per-measure data if available
-        if (!tracks.empty() && !tracks[0].measures.isEmpty())
-            writeMeasureHeaders(tracks[0].measures);
-        else
-            writeMeasureHeaders(numMeasures, numerator, denominator);
-        
-        // 15. writeTracks() - for each track
-        for (int t = 0; t < numTracks; ++t)
-        {
-            writeTrack(tracks[t], t, numTracks);
-        }
-        
-        // 16. writeMeasures() - interleaved: for each measure, write all tracks
-        writeMeasuresMultiTrack(tracks);
-        
-        outputStream->flush();
-        outputStream.reset();
-        
-        return true;
+        numMeasures = juce::jmax(numMeasures, (int)track.measures.size());
     }
-    catch (const std::exception& e)
+    
+    int numTracks = (int)tracks.size();
+    
+    // === PyGuitarPro GP5File.writeSong() order ===
+    
+    // 1. writeVersion()
+    writeVersion();
+    
+    // 3. writeInfo()
+    writeSongInfo();
+    
+    // 4. writeLyrics()
+    writeLyrics();
+    
+    // 6. writePageSetup()
+    writePageSetup();
+    
+    // 7. writeIntByteSizeString(tempoName) + writeI32(tempo)
+    writeStringWithLength("");  // Empty tempo name
+    writeInt(tempo);
+    
+    // 9. writeI8(key) + writeI32(octave)
+    writeByte(0);    // Key signature (0 = C major/A minor)
+    writeInt(0);     // Octave (always 0)
+    
+    // 10. writeMidiChannels() - use track instruments
+    writeMidiChannels(tracks);
+    
+    // 11. writeDirections()
+    writeDirections();
+    
+    // 12. writeMasterReverb()
+    writeInt(0);  // Master reverb = 0
+    
+    // 13. writeI32(measureCount) + writeI32(trackCount)
+    writeInt(numMeasures);
+    writeInt(numTracks);
+    
+    // 14. writeMeasureHeaders() - use per-measure data if available
+    if (!tracks.empty() && !tracks[0].measures.isEmpty())
+        writeMeasureHeaders(tracks[0].measures);
+    else
+        writeMeasureHeaders(numMeasures, numerator, denominator);
+    
+    // 15. writeTracks() - for each track
+    for (int t = 0; t < numTracks; ++t)
     {
-        lastError = juce::String("Write error: ") + e.what();
-        outputStream.reset();
-        return false;
+        writeTrack(tracks[t], t, numTracks);
     }
+    
+    // 16. writeMeasures() - interleaved: for each measure, write all tracks
+    writeMeasuresMultiTrack(tracks);
 }
 
 //==============================================================================
@@ -867,6 +915,8 @@ void GP5Writer::writeMeasures(const TabTrack& track)
         
         // LineBreak
         writeByte(0);
+        
+        reportProgress(m + 1, numMeasures);
     }
 }
 
@@ -937,6 +987,8 @@ void GP5Writer::writeMeasuresMultiTrack(const std::vector<TabTrack>& tracks)
             // LineBreak - must be after EACH track (not just last)
             writeByte(0);
         }
+        
+        reportProgress(m + 1, numMeasures);
     }
 }
 
@@ -1335,6 +1387,14 @@ void GP5Writer::writeBend(const NoteEffects& effects)
     }
 }
 
+//==============================================================================
+void GP5Writer::reportProgress(int measuresWritten, int numMeasures)
+{
+    // Alle 16 Takte melden reicht für eine Fortschrittsanzeige
+    if (progressCallback && (measuresWritten % 16 == 0 || measuresWritten == numMeasures))
+        progressCallback((float)measuresWritten / (float)juce::jmax(1, numMeasures));
+}
+
 //==============================================================================
 void GP5Writer::writeByte(juce::uint8 value)
 {
@@ -13,6 +13,7 @@
 
 #include <juce_core/juce_core.h>
 #include "TabModels.h"
+#include <functional>
 #include <vector>
 
 //==============================================================================
@@ -35,10 +36,26 @@ public:
     // Write multiple TabTracks to a GP5 file (multi-channel recording)
     bool writeToFile(const std::vector<TabTrack>& tracks, const juce::File& outputFile);
     
+    // Serialisiert in einen Speicherblock (vorab in geschätzter Größe reserviert)
+    bool writeToMemory(const std::vector<TabTrack>& tracks, juce::MemoryBlock& dest);
+    
+    // Grobe Obergrenze der Dateigröße (erster Durchlauf über Takte/Beats/Noten)
+    static size_t estimateSize(const std::vector<TabTrack>& tracks);
+    
+    // Schreibt über eine temporäre Datei + Umbenennen (nie halbe Dateien)
+    static bool writeFileAtomically(const juce::MemoryBlock& data, const juce::File& outputFile, juce::String& error);
+    
+    // Fortschritt 0..1 beim Schreiben der Takte (wird im schreibenden Thread aufgerufen)
+    void setProgressCallback(std::function<void(float)> callback) { progressCallback = std::move(callback); }
+    
     // Get last error message
     juce::String getLastError() const { return lastError; }
     
 private:
+    void writeSingleTrackSong(const TabTrack& track);
+    void writeMultiTrackSong(const std::vector<TabTrack>& tracks);
+    void reportProgress(int measuresWritten, int numMeasures);
+    
     // Helper functions for writing GP5 binary format (in correct order!)
     void writeVersion();
     void writeSongInfo();           // 9 strings + notice lines
@@ -73,8 +90,9 @@ private:
     static constexpr int bendPosition = 60;    // Max position in GP file
     static constexpr int bendSemitone = 25;    // Value per semitone in GP file
     
-    // Output stream
-    std::unique_ptr<juce::FileOutputStream> outputStream;
+    // Output stream (nur während writeToMemory gesetzt)
+    juce::MemoryOutputStream* outputStream = nullptr;
+    std::function<void(float)> progressCallback;
     
     // Song metadata
     juce::String songTitle = "Untitled";
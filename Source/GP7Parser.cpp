@@ -10,6 +10,7 @@
 */
 
 #include "GP7Parser.h"
+#include "TraceRecorder.h"
 #include "TabModels.h"
 #include <juce_core/juce_core.h>
 
@@ -31,6 +32,8 @@ GP7Parser::~GP7Parser()
 
 bool GP7Parser::parseFile(const juce::File& file)
 {
+    TraceScope trace("GP7Parser::parseFile", "parser");
+    
     if (!file.existsAsFile())
     {
         lastError = "File does not exist: " + file.getFullPathName();
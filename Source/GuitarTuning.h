@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+    GuitarTuning.h
+
+    Stimmung eines Saiteninstruments (4-9 Saiten, optional Capo) mit einer
+    einmalig vorberechneten Tabelle MIDI-Note -> alle spielbaren
+    Saiten/Bund-Positionen.
+
+    Live-Mapping, Re-Optimierung, Akkord-Platzierung und Editor teilen sich
+    diese Tabelle, statt Kandidaten bei jedem Aufruf neu zu berechnen.
+
+    Saitenindex folgt der Display-Konvention: 0 = höchste Saite (oben).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <cstdlib>
+
+//==============================================================================
+/**
+ * GuitarTuning
+ */
+class GuitarTuning
+{
+public:
+    static constexpr int minStrings = 4;
+    static constexpr int maxStrings = 9;
+    static constexpr int numMidiNotes = 128;
+
+    struct Position
+    {
+        int8_t string = 0;
+        int8_t fret = 0;
+    };
+
+    /** Alle Positionen einer Note, nach Saitenindex sortiert (ohne Allokation). */
+    struct PositionList
+    {
+        std::array<Position, maxStrings> positions {};
+        uint8_t count = 0;
+
+        const Position* begin() const { return positions.data(); }
+        const Position* end() const { return positions.data() + count; }
+        int size() const { return count; }
+        bool empty() const { return count == 0; }
+        const Position& operator[](int i) const { return positions[(size_t) i]; }
+    };
+
+    //==========================================================================
+    // Erzeugung
+    //==========================================================================
+
+    /** Standard-Gitarre (E4 B3 G3 D3 A2 E2). */
+    GuitarTuning() : GuitarTuning(standardGuitarStrings()) {}
+
+    /**
+     * @param openStringNotes Leersaiten-Tonhöhen, hohe Saite zuerst (4-9 Einträge)
+     * @param capo           Capo-Bund (Bünde werden relativ zum Capo gezählt)
+     * @param maxFret        Höchster spielbarer Bund
+     */
+    explicit GuitarTuning(std::vector<int> openStringNotes, int capo = 0, int maxFret = 24)
+        : openStrings(std::move(openStringNotes)),
+          capoFret(std::max(0, capo)),
+          highestFret(std::max(1, maxFret))
+    {
+        if ((int) openStrings.size() > maxStrings)
+            openStrings.resize((size_t) maxStrings);
+        rebuild();
+    }
+
+    /** Aus einem beliebigen Container (z.B. TabTrack::tuning). */
+    template <typename Container>
+    static GuitarTuning fromNotes(const Container& notes, int capo = 0, int maxFret = 24)
+    {
+        std::vector<int> strings;
+        for (int n : notes)
+            if (n > 0)
+                strings.push_back(n);
+        if (strings.empty())
+            strings = standardGuitarStrings();
+        return GuitarTuning(std::move(strings), capo, maxFret);
+    }
+
+    static std::vector<int> standardGuitarStrings() { return { 64, 59, 55, 50, 45, 40 }; }
+
+    static GuitarTuning standardGuitar() { return GuitarTuning(standardGuitarStrings()); }
+    static GuitarTuning sevenStringGuitar() { return GuitarTuning({ 64, 59, 55, 50, 45, 40, 35 }); }
+    static GuitarTuning eightStringGuitar() { return GuitarTuning({ 64, 59, 55, 50, 45, 40, 35, 30 }); }
+    static GuitarTuning standardBass() { return GuitarTuning({ 43, 38, 33, 28 }); }
+    static GuitarTuning fiveStringBass() { return GuitarTuning({ 43, 38, 33, 28, 23 }); }
+
+    //==========================================================================
+    // Abfragen
+    //==========================================================================
+
+    int getStringCount() const { return (int) openStrings.size(); }
+    int getCapo() const { return capoFret; }
+    int getMaxFret() const { return highestFret; }
+    const std::vector<int>& getOpenStrings() const { return openStrings; }
+
+    /** Klingende Leersaiten-Tonhöhe inkl. Capo. */
+    int getOpenNote(int stringIndex) const
+    {
+        if (stringIndex < 0 || stringIndex >= getStringCount())
+            return -1;
+        return openStrings[(size_t) stringIndex] + capoFret;
+    }
+
+    /** MIDI-Note für Saite/Bund (-1 bei ungültiger Saite). */
+    int getMidiNote(int stringIndex, int fret) const
+    {
+        int open = getOpenNote(stringIndex);
+        return (open < 0 || fret < 0) ? -1 : open + fret;
+    }
+
+    /** Alle spielbaren Positionen einer Note (Tabellenzugriff). */
+    const PositionList& getPositions(int midiNote) const
+    {
+        static const PositionList none {};
+        if (midiNote < 0 || midiNote >= numMidiNotes)
+            return none;
+        return table[(size_t) midiNote];
+    }
+
+    /** Tiefste Saite (höchster Index) - Fallback für unspielbare Noten. */
+    int getLowestString() const { return getStringCount() - 1; }
+
+    /** Nächstliegende Position für eine Note außerhalb des Griffbretts. */
+    Position getClosestPosition(int midiNote) const
+    {
+        Position best;
+        int minDist = 1 << 30;
+        for (int s = 0; s < getStringCount(); ++s)
+        {
+            int fret = midiNote - getOpenNote(s);
+            int dist = std::abs(fret);
+            if (dist < minDist)
+            {
+                minDist = dist;
+                best.string = (int8_t) s;
+                best.fret = (int8_t) std::max(0, std::min(highestFret, fret));
+            }
+        }
+        return best;
+    }
+
+    bool isStandardGuitar() const { return capoFret == 0 && openStrings == standardGuitarStrings(); }
+
+    bool operator==(const GuitarTuning& other) const
+    {
+        return openStrings == other.openStrings && capoFret == other.capoFret && highestFret == other.highestFret;
+    }
+    bool operator!=(const GuitarTuning& other) const { return !(*this == other); }
+
+private:
+    std::vector<int> openStrings;
+    int capoFret = 0;
+    int highestFret = 24;
+    std::array<PositionList, numMidiNotes> table {};
+
+    void rebuild()
+    {
+        for (auto& list : table)
+            list.count = 0;
+
+        for (int s = 0; s < getStringCount(); ++s)
+        {
+            const int open = getOpenNote(s);
+            for (int fret = 0; fret <= highestFret; ++fret)
+            {
+                const int note = open + fret;
+                if (note < 0 || note >= numMidiNotes)
+                    continue;
+
+                auto& list = table[(size_t) note];
+                list.positions[list.count++] = { (int8_t) s, (int8_t) fret };
+            }
+        }
+    }
+};
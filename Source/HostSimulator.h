@@ -0,0 +1,765 @@
+/*
+  ==============================================================================
+
+    HostSimulator.h
+
+    Headless-Host für NewProjectAudioProcessor: ein skriptbarer Transport
+    (SimulatedPlayHead) und ein Skript-Interpreter, der processBlock mit
+    beliebigen Blockgrößen, synthetischem MIDI und Sidechain-Audio aufruft.
+    Die ausgegebenen MidiBuffer werden als Textzeilen protokolliert (Golden-
+    Files), die Laufzeit jedes Blocks wird gegen seine Deadline gemessen.
+
+    Alles läuft im aufrufenden Thread (Message- und "Audio"-Thread in einem),
+    die Simulation ist damit bis auf Hintergrund-Jobs deterministisch. Die
+    BasicPitch-Transkription wird mit "sync" abgewartet.
+
+    Skript (eine Anweisung pro Zeile, '#' = Kommentar, Längen in Beats):
+
+        samplerate 48000          Samplerate (vor dem ersten run)
+        blocksize 256 [480 ...]   Blockgrößen, werden reihum verwendet
+        load "Adagio.gp5"         Datei laden (relativ zum Skript)
+        track 1                   ausgewählter Track (Editor-Modus)
+        midiout on|off            MIDI-Ausgabe des Players
+        offline on|off            Non-Realtime (Bounce-Pfad)
+        tempo 120                 Host-Tempo
+        timesig 3 4               Taktart
+        play | stop               Transport
+        record on|off             Record-Arm des Hosts
+        seek 8                    Position in Beats
+        loop 4 12 | loop off      Cycle-Bereich in Beats
+        note 64 100 0.5 [ch]      Note-On jetzt, Note-Off nach 0.5 Beats
+        cc 1 127 [ch]             Controller
+        bend 4096 [ch]            Pitch-Wheel (-8192..8191)
+        program 25 [ch]           Program Change
+        sidechain on|off          Sidechain-Bus aktivieren
+        sine 196 0.5 4            Sinus (Hz, Pegel, Beats) auf den Sidechain
+        audio "riff.wav" [gain]   Audiodatei auf den Sidechain
+        run 4 | run 2s | run 10blk  Zeit vergehen lassen
+        sync                      laufende Transkription abwarten
+        mark "text"               Markierung im Protokoll
+
+    Tab-Edits auf den ausgewählten Track (Indizes 0-basiert, wie die TabView):
+
+        edit position 0 1 0 2 5   Takt, Beat, Note -> Saite 2, Bund 5
+        edit pitch 0 1 0 69 0 5   Takt, Beat, Note -> MIDI 69 auf Saite 0, Bund 5
+        edit duration 0 2 8 [dotted]  Takt, Beat -> Achtel (1, 2, 4, 8, 16, 32)
+        edit delete 0 1 0         Takt, Beat, Note löschen
+        undo | redo               letzten Edit-Batch zurücknehmen / wiederholen
+        expect-tab                editierter Track und aus recordedNotes gebauter Tab
+                                  müssen dieselben Noten haben, sonst bricht das Skript ab
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "PluginProcessor.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//==============================================================================
+/**
+ * SimulatedPlayHead - Transport eines Hosts, vom Skript gesteuert.
+ * Die Position springt wie bei den meisten Hosts erst an der Blockgrenze zum Loop-Start.
+ */
+class SimulatedPlayHead : public juce::AudioPlayHead
+{
+public:
+    juce::Optional<PositionInfo> getPosition() const override
+    {
+        PositionInfo info;
+        info.setIsPlaying(playing);
+        info.setIsRecording(recording);
+        info.setIsLooping(looping);
+        info.setBpm(bpm);
+        info.setPpqPosition(ppqPosition);
+        info.setTimeInSamples(timeInSamples);
+        info.setTimeInSeconds((double) timeInSamples / sampleRate);
+
+        juce::AudioPlayHead::TimeSignature sig;
+        sig.numerator = numerator;
+        sig.denominator = denominator;
+        info.setTimeSignature(sig);
+
+        const double barLength = getBeatsPerBar();
+        info.setPpqPositionOfLastBarStart(std::floor(ppqPosition / barLength) * barLength);
+
+        if (looping)
+        {
+            juce::AudioPlayHead::LoopPoints points;
+            points.ppqStart = loopStart;
+            points.ppqEnd = loopEnd;
+            info.setLoopPoints(points);
+        }
+        return info;
+    }
+
+    void setSampleRate(double newSampleRate) { sampleRate = newSampleRate; }
+    void setPlaying(bool shouldPlay) { playing = shouldPlay; }
+    void setRecording(bool shouldRecord) { recording = shouldRecord; }
+    void setTempo(double newBpm) { bpm = juce::jlimit(10.0, 999.0, newBpm); }
+
+    void setTimeSignature(int newNumerator, int newDenominator)
+    {
+        numerator = juce::jmax(1, newNumerator);
+        denominator = juce::jmax(1, newDenominator);
+    }
+
+    void setLoop(bool shouldLoop, double startBeat = 0.0, double endBeat = 0.0)
+    {
+        looping = shouldLoop && endBeat > startBeat;
+        loopStart = startBeat;
+        loopEnd = endBeat;
+    }
+
+    /** Sprung auf eine Position; die Samplezeit wird mit dem aktuellen Tempo umgerechnet. */
+    void seek(double beat)
+    {
+        ppqPosition = beat;
+        timeInSamples = (juce::int64) std::llround(beatsToSeconds(beat) * sampleRate);
+    }
+
+    /** Nach einem Block: läuft der Transport, rückt die Position um numSamples vor. */
+    void advance(int numSamples)
+    {
+        if (!playing)
+            return;
+
+        const double previous = ppqPosition;
+        timeInSamples += numSamples;
+        ppqPosition += numSamples / sampleRate * bpm / 60.0;
+
+        // Nur beim Überschreiten des Loop-Endes springen (hinter dem Loop läuft der Transport weiter)
+        if (looping && previous < loopEnd && ppqPosition >= loopEnd)
+            seek(loopStart + std::fmod(ppqPosition - loopEnd, loopEnd - loopStart));
+    }
+
+    bool isPlaying() const { return playing; }
+    double getPpqPosition() const { return ppqPosition; }
+    double getBeatsPerBar() const { return numerator * (4.0 / denominator); }
+    double beatsToSeconds(double beats) const { return beats * 60.0 / bpm; }
+
+private:
+    double sampleRate = 44100.0;
+    bool playing = false;
+    bool recording = false;
+    bool looping = false;
+    double bpm = 120.0;
+    int numerator = 4;
+    int denominator = 4;
+    double ppqPosition = 0.0;
+    juce::int64 timeInSamples = 0;
+    double loopStart = 0.0;
+    double loopEnd = 0.0;
+};
+
+//==============================================================================
+/**
+ * HostSimulator - führt ein Host-Skript gegen einen Processor aus.
+ *
+ * Zeitbasis für MIDI- und Audio-Eingaben ist die Simulationsuhr (Samples seit
+ * Start), nicht der Transport: eine Note klingt auch über Seek, Loop und Stop
+ * hinweg so lange wie angegeben.
+ *
+ * Protokoll pro Ausgabe-Event: Simulationsuhr, Host-Beat am Blockanfang und
+ * MidiMessage::getDescription(). Am Ende folgen die aufgenommenen Noten ohne
+ * Saite/Bund - die hängen vom asynchronen LiveChordAnalyzer ab.
+ */
+class HostSimulator
+{
+public:
+    struct BlockTiming
+    {
+        juce::int64 clock = 0;     // Simulationsuhr am Blockanfang
+        int numSamples = 0;
+        double beat = 0.0;         // Host-Position am Blockanfang
+        double micros = 0.0;       // Laufzeit von processBlock
+        double deadlineMicros = 0.0;
+    };
+
+    explicit HostSimulator(NewProjectAudioProcessor& processorToDrive)
+        : processor(processorToDrive)
+    {
+        formatManager.registerBasicFormats();
+        processor.setPlayHead(&playHead);
+    }
+
+    ~HostSimulator()
+    {
+        if (prepared)
+            processor.releaseResources();
+        processor.setPlayHead(nullptr);
+    }
+
+    /** Führt das Skript aus; false mit getLastError() bei Syntax- oder Ladefehlern. */
+    bool runScript(const juce::File& scriptFile)
+    {
+        if (!scriptFile.existsAsFile())
+            return fail("script not found: " + scriptFile.getFullPathName());
+
+        scriptDirectory = scriptFile.getParentDirectory();
+
+        juce::StringArray lines;
+        scriptFile.readLines(lines);
+
+        for (int i = 0; i < lines.size(); ++i)
+        {
+            auto line = lines[i].upToFirstOccurrenceOf("#", false, false).trim();
+            if (line.isEmpty())
+                continue;
+
+            juce::StringArray tokens;
+            tokens.addTokens(line, " \t", "\"");
+            tokens.removeEmptyStrings();
+            for (auto& token : tokens)
+                token = token.unquoted();
+
+            if (!execute(tokens))
+                return fail(scriptFile.getFileName() + ":" + juce::String(i + 1) + ": " + lastError);
+        }
+
+        finish();
+        return true;
+    }
+
+    juce::String getLastError() const { return lastError; }
+    const juce::StringArray& getMidiLog() const { return midiLog; }
+    const std::vector<BlockTiming>& getBlockTimings() const { return blockTimings; }
+
+    /** Zusammenfassung der Blocklaufzeiten (p50/p99/max, Überläufe, Echtzeitfaktor). */
+    juce::String createTimingReport() const
+    {
+        juce::String report;
+        if (blockTimings.empty())
+            return "no blocks processed\n";
+
+        std::vector<double> loads;
+        double totalMicros = 0.0, totalAudioMicros = 0.0, maxMicros = 0.0;
+        int overruns = 0;
+        for (const auto& t : blockTimings)
+        {
+            loads.push_back(t.micros / t.deadlineMicros);
+            totalMicros += t.micros;
+            totalAudioMicros += t.deadlineMicros;
+            maxMicros = juce::jmax(maxMicros, t.micros);
+            if (t.micros > t.deadlineMicros)
+                ++overruns;
+        }
+        std::sort(loads.begin(), loads.end());
+
+        report << blockTimings.size() << " blocks, " << juce::String(totalAudioMicros / 1.0e6, 2) << " s audio in "
+               << juce::String(totalMicros / 1.0e3, 1) << " ms (" << juce::String(totalAudioMicros / juce::jmax(1.0, totalMicros), 1)
+               << "x realtime)\n"
+               << "load p50 " << juce::String(100.0 * getPercentile(loads, 0.50), 2) << "%, p99 "
+               << juce::String(100.0 * getPercentile(loads, 0.99), 2) << "%, max "
+               << juce::String(100.0 * loads.back(), 2) << "% of block deadline (max "
+               << juce::String(maxMicros, 1) << " us), " << overruns << " overruns\n";
+        return report;
+    }
+
+    /** Anteil der Deadline, den p99 der Blöcke verbraucht (für CI-Grenzen). */
+    double getP99Load() const
+    {
+        std::vector<double> loads;
+        for (const auto& t : blockTimings)
+            loads.push_back(t.micros / t.deadlineMicros);
+        std::sort(loads.begin(), loads.end());
+        return getPercentile(loads, 0.99);
+    }
+
+    /** Pro Block eine CSV-Zeile: clock,samples,beat,micros,deadlineMicros. */
+    juce::String createTimingCsv() const
+    {
+        juce::String csv("clock,samples,beat,micros,deadline_micros\n");
+        for (const auto& t : blockTimings)
+            csv << t.clock << "," << t.numSamples << "," << juce::String(t.beat, 4) << ","
+                << juce::String(t.micros, 2) << "," << juce::String(t.deadlineMicros, 2) << "\n";
+        return csv;
+    }
+
+private:
+    struct PendingMidi
+    {
+        juce::int64 clock;
+        juce::MidiMessage message;
+    };
+
+    struct SidechainSource
+    {
+        juce::int64 startClock = 0;
+        juce::int64 endClock = 0;
+        double frequency = 0.0;              // > 0: Sinus
+        float gain = 1.0f;
+        juce::AudioBuffer<float> samples;    // sonst: Audiodatei (bereits resampelt)
+    };
+
+    //==========================================================================
+    bool execute(const juce::StringArray& t)
+    {
+        const auto command = t[0].toLowerCase();
+        const auto argCount = t.size() - 1;
+        auto number = [&t](int index) { return t[index].getDoubleValue(); };
+        auto channelArg = [&t](int index) { return t.size() > index ? juce::jlimit(1, 16, t[index].getIntValue()) : 1; };
+
+        auto onOff = [&](bool& value)
+        {
+            if (t[1] != "on" && t[1] != "off")
+                return fail("expected on|off");
+            value = t[1] == "on";
+            return true;
+        };
+
+        if (command == "samplerate" && argCount == 1)
+        {
+            if (prepared)
+                return fail("samplerate must be set before the first run");
+            sampleRate = juce::jlimit(8000.0, 384000.0, number(1));
+            return true;
+        }
+        if (command == "blocksize" && argCount >= 1)
+        {
+            blockSizes.clear();
+            for (int i = 1; i < t.size(); ++i)
+                blockSizes.push_back(juce::jlimit(1, 8192, t[i].getIntValue()));
+            nextBlockSize = 0;
+            preparedBlockSize = 0;   // beim nächsten run neu vorbereiten
+            return true;
+        }
+        if (command == "load" && argCount == 1)
+        {
+            const auto file = scriptDirectory.getChildFile(t[1]);
+            if (!processor.loadGP5File(file))
+                return fail("could not load " + file.getFullPathName());
+            midiLog.add("# load " + file.getFileName());
+            return true;
+        }
+        if (command == "track" && argCount == 1)
+        {
+            processor.setSelectedTrack(t[1].getIntValue());
+            return true;
+        }
+        if (command == "midiout" && argCount == 1)
+        {
+            bool enabled = true;
+            if (!onOff(enabled))
+                return false;
+            processor.setMidiOutputEnabled(enabled);
+            return true;
+        }
+        if (command == "offline" && argCount == 1)
+        {
+            bool offline = false;
+            if (!onOff(offline))
+                return false;
+            processor.setNonRealtime(offline);
+            return true;
+        }
+        if (command == "tempo" && argCount == 1)       { playHead.setTempo(number(1)); return true; }
+        if (command == "timesig" && argCount == 2)     { playHead.setTimeSignature(t[1].getIntValue(), t[2].getIntValue()); return true; }
+        if (command == "play" && argCount == 0)        { playHead.setPlaying(true); return true; }
+        if (command == "stop" && argCount == 0)        { playHead.setPlaying(false); return true; }
+        if (command == "seek" && argCount == 1)        { playHead.seek(number(1)); return true; }
+        if (command == "record" && argCount == 1)
+        {
+            bool armed = false;
+            if (!onOff(armed))
+                return false;
+            playHead.setRecording(armed);
+            return true;
+        }
+        if (command == "loop" && (argCount == 1 || argCount == 2))
+        {
+            if (argCount == 1 && t[1] == "off")
+                playHead.setLoop(false);
+            else if (argCount == 2 && number(2) > number(1))
+                playHead.setLoop(true, number(1), number(2));
+            else
+                return fail("expected loop <start> <end> or loop off");
+            return true;
+        }
+        if (command == "note" && argCount >= 3)
+        {
+            const int channel = channelArg(4);
+            const int pitch = juce::jlimit(0, 127, t[1].getIntValue());
+            const auto velocity = (juce::uint8) juce::jlimit(1, 127, t[2].getIntValue());
+            pendingMidi.push_back({ clock, juce::MidiMessage::noteOn(channel, pitch, velocity) });
+            pendingMidi.push_back({ clock + beatsToSamples(number(3)), juce::MidiMessage::noteOff(channel, pitch) });
+            return true;
+        }
+        if (command == "cc" && argCount >= 2)
+        {
+            pendingMidi.push_back({ clock, juce::MidiMessage::controllerEvent(channelArg(3), t[1].getIntValue() & 127,
+                                                                              t[2].getIntValue() & 127) });
+            return true;
+        }
+        if (command == "bend" && argCount >= 1)
+        {
+            const int value = juce::jlimit(-8192, 8191, t[1].getIntValue()) + 8192;
+            pendingMidi.push_back({ clock, juce::MidiMessage::pitchWheel(channelArg(2), value) });
+            return true;
+        }
+        if (command == "program" && argCount >= 1)
+        {
+            pendingMidi.push_back({ clock, juce::MidiMessage::programChange(channelArg(2), t[1].getIntValue() & 127) });
+            return true;
+        }
+        if (command == "sidechain" && argCount == 1)
+        {
+            bool enabled = false;
+            if (!onOff(enabled))
+                return false;
+            return setSidechainEnabled(enabled);
+        }
+        if (command == "sine" && argCount == 3)
+        {
+            SidechainSource source;
+            source.startClock = clock;
+            source.endClock = clock + beatsToSamples(number(3));
+            source.frequency = number(1);
+            source.gain = (float) number(2);
+            sidechainSources.push_back(std::move(source));
+            return true;
+        }
+        if (command == "audio" && (argCount == 1 || argCount == 2))
+            return addAudioFile(scriptDirectory.getChildFile(t[1]), argCount == 2 ? (float) number(2) : 1.0f);
+        if (command == "run" && argCount == 1)
+            return run(t[1]);
+        if (command == "sync" && argCount == 0)
+            return waitForTranscription();
+        if (command == "mark" && argCount >= 1)
+        {
+            midiLog.add("# " + t.joinIntoString(" ", 1));
+            return true;
+        }
+        if (command == "edit" && argCount >= 3)
+            return applyEdit(t);
+        if (command == "undo" && argCount == 0)
+        {
+            if (!processor.undoTabEdit(processor.getSelectedTrack()))
+                return fail("nothing to undo");
+            midiLog.add("# undo");
+            return true;
+        }
+        if (command == "redo" && argCount == 0)
+        {
+            if (!processor.redoTabEdit(processor.getSelectedTrack()))
+                return fail("nothing to redo");
+            midiLog.add("# redo");
+            return true;
+        }
+        if (command == "expect-tab" && argCount == 0)
+            return expectTabMatchesRecording();
+
+        return fail("unknown command or wrong argument count: " + t.joinIntoString(" "));
+    }
+
+    //==========================================================================
+    bool run(const juce::String& amount)
+    {
+        prepareIfNeeded();
+
+        juce::int64 numSamples = 0;
+        if (amount.endsWithIgnoreCase("blk"))
+        {
+            for (int blocks = amount.dropLastCharacters(3).getIntValue(), i = 0; i < blocks; ++i)
+                numSamples += blockSizes[(nextBlockSize + (size_t) i) % blockSizes.size()];
+        }
+        else if (amount.endsWithIgnoreCase("s"))
+            numSamples = (juce::int64) std::llround(amount.dropLastCharacters(1).getDoubleValue() * sampleRate);
+        else
+            numSamples = beatsToSamples(amount.getDoubleValue());
+
+        if (numSamples <= 0)
+            return fail("run needs a positive length");
+
+        const auto endClock = clock + numSamples;
+        while (clock < endClock)
+        {
+            const int blockSize = (int) juce::jmin<juce::int64>(blockSizes[nextBlockSize], endClock - clock);
+            nextBlockSize = (nextBlockSize + 1) % blockSizes.size();
+            processNextBlock(blockSize);
+        }
+        return true;
+    }
+
+    void processNextBlock(int numSamples)
+    {
+        buffer.setSize(buffer.getNumChannels(), numSamples, false, false, true);
+        buffer.clear();
+        renderSidechain(numSamples);
+
+        midiBuffer.clear();
+        const auto blockEnd = clock + numSamples;
+        std::stable_sort(pendingMidi.begin(), pendingMidi.end(),
+                         [](const PendingMidi& a, const PendingMidi& b) { return a.clock < b.clock; });
+        auto firstLater = std::find_if(pendingMidi.begin(), pendingMidi.end(),
+                                       [blockEnd](const PendingMidi& m) { return m.clock >= blockEnd; });
+        for (auto it = pendingMidi.begin(); it != firstLater; ++it)
+            midiBuffer.addEvent(it->message, (int) juce::jmax<juce::int64>(0, it->clock - clock));
+        pendingMidi.erase(pendingMidi.begin(), firstLater);
+
+        const double beat = playHead.getPpqPosition();
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        {
+            const juce::ScopedLock sl(processor.getCallbackLock());
+            processor.processBlock(buffer, midiBuffer);
+        }
+        const auto elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+
+        // Keine laufende Message-Loop: die Arbeit des Processor-Timers (Capture-Flush,
+        // Transkription einfügen, Offline-Render) nach jedem Block selbst abholen, nicht mitgemessen
+        processor.dispatchPendingMessageThreadWork();
+
+        BlockTiming timing;
+        timing.clock = clock;
+        timing.numSamples = numSamples;
+        timing.beat = beat;
+        timing.micros = 1.0e6 * (double) elapsedTicks / (double) juce::Time::getHighResolutionTicksPerSecond();
+        timing.deadlineMicros = 1.0e6 * numSamples / sampleRate;
+        blockTimings.push_back(timing);
+
+        for (const auto metadata : midiBuffer)
+            midiLog.add(juce::String(clock + metadata.samplePosition).paddedLeft('0', 9)
+                        + "  beat " + juce::String(beat, 4) + "  " + metadata.getMessage().getDescription());
+
+        clock = blockEnd;
+        playHead.advance(numSamples);
+    }
+
+    void renderSidechain(int numSamples)
+    {
+        auto* bus = processor.getBus(true, 1);
+        if (bus == nullptr || !bus->isEnabled() || sidechainSources.empty())
+            return;
+
+        auto sidechain = processor.getBusBuffer(buffer, true, 1);
+        for (const auto& source : sidechainSources)
+        {
+            const auto from = juce::jmax(source.startClock, clock);
+            const auto to = juce::jmin(source.endClock, clock + numSamples);
+            for (auto pos = from; pos < to; ++pos)
+            {
+                const auto offset = pos - source.startClock;
+                for (int ch = 0; ch < sidechain.getNumChannels(); ++ch)
+                {
+                    float sample = 0.0f;
+                    if (source.frequency > 0.0)
+                        sample = (float) std::sin(juce::MathConstants<double>::twoPi * source.frequency * (double) offset / sampleRate);
+                    else
+                        sample = source.samples.getSample(ch % source.samples.getNumChannels(), (int) offset);
+                    sidechain.addSample(ch, (int) (pos - clock), sample * source.gain);
+                }
+            }
+        }
+
+        sidechainSources.erase(std::remove_if(sidechainSources.begin(), sidechainSources.end(),
+                                              [this, numSamples](const SidechainSource& s) { return s.endClock <= clock + numSamples; }),
+                               sidechainSources.end());
+    }
+
+    bool addAudioFile(const juce::File& file, float gain)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr)
+            return fail("could not read audio file " + file.getFullPathName());
+
+        juce::AudioBuffer<float> fileBuffer((int) reader->numChannels, (int) reader->lengthInSamples);
+        reader->read(&fileBuffer, 0, fileBuffer.getNumSamples(), 0, true, true);
+
+        SidechainSource source;
+        source.startClock = clock;
+        source.gain = gain;
+
+        // Auf die Simulations-Samplerate bringen
+        const double ratio = reader->sampleRate / sampleRate;
+        const int numOut = (int) std::floor(fileBuffer.getNumSamples() / ratio);
+        source.samples.setSize(fileBuffer.getNumChannels(), numOut);
+        for (int ch = 0; ch < fileBuffer.getNumChannels(); ++ch)
+        {
+            if (std::abs(ratio - 1.0) < 1.0e-9)
+                source.samples.copyFrom(ch, 0, fileBuffer, ch, 0, numOut);
+            else
+                juce::LagrangeInterpolator().process(ratio, fileBuffer.getReadPointer(ch),
+                                                     source.samples.getWritePointer(ch), numOut);
+        }
+        source.endClock = clock + numOut;
+        sidechainSources.push_back(std::move(source));
+        return true;
+    }
+
+    /** Wie ein Host: Layout nur zwischen releaseResources und prepareToPlay ändern. */
+    bool setSidechainEnabled(bool enabled)
+    {
+        auto* bus = processor.getBus(true, 1);
+        if (bus == nullptr)
+            return fail("processor has no sidechain bus");
+
+        if (prepared)
+            processor.releaseResources();
+        const bool ok = bus->enable(enabled);
+        preparedBlockSize = 0;
+        prepared = false;
+        return ok || fail("sidechain layout rejected");
+    }
+
+    void prepareIfNeeded()
+    {
+        if (blockSizes.empty())
+            blockSizes.push_back(512);
+
+        const int maxBlockSize = *std::max_element(blockSizes.begin(), blockSizes.end());
+        if (prepared && preparedBlockSize == maxBlockSize)
+            return;
+
+        if (prepared)
+            processor.releaseResources();
+
+        playHead.setSampleRate(sampleRate);
+        processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+        processor.prepareToPlay(sampleRate, maxBlockSize);
+        buffer.setSize(juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels()), maxBlockSize);
+        midiBuffer.ensureSize(4096);
+        prepared = true;
+        preparedBlockSize = maxBlockSize;
+    }
+
+    bool applyEdit(const juce::StringArray& t)
+    {
+        const auto type = t[1].toLowerCase();
+        auto arg = [&t](int index) { return t[index].getIntValue(); };
+
+        TabEdit edit;
+        if (type == "position" && t.size() == 7)
+            edit = TabEdit::setPosition(arg(2), arg(3), arg(4), arg(5), arg(6), -1);
+        else if (type == "pitch" && t.size() == 8)
+            edit = TabEdit::setPitch(arg(2), arg(3), arg(4), arg(5), arg(6), arg(7));
+        else if (type == "duration" && (t.size() == 5 || t.size() == 6))
+            edit = TabEdit::changeDuration(arg(2), arg(3), (NoteDuration) arg(4), t[5] == "dotted");
+        else if (type == "delete" && t.size() == 5)
+            edit = TabEdit::deleteNote(arg(2), arg(3), arg(4));
+        else
+            return fail("unknown edit: " + t.joinIntoString(" "));
+
+        // Basis wie die TabView: beim ersten Edit der aus der Aufnahme gebaute Tab
+        const int trackIndex = processor.getSelectedTrack();
+        const auto baseTrack = processor.hasEditedTrack(trackIndex) ? processor.getEditedTrack(trackIndex)
+                                                                    : processor.getRecordedTabTrack();
+        const auto knownSequence = processor.getTabEditJournal().getLastSequence();
+        processor.applyTabEdits(trackIndex, { edit }, baseTrack);
+        if (processor.getTabEditJournal().getLastSequence() == knownSequence)
+            return fail("edit not applied: " + t.joinIntoString(" "));
+
+        midiLog.add("# " + t.joinIntoString(" "));
+        return true;
+    }
+
+    /** Noten eines Taktes als Text: pro Beat "Saite/Bund ...", Pausen und leere Saiten ausgelassen. */
+    static juce::String describeMeasureNotes(const TabTrack& track, int measureIndex)
+    {
+        juce::StringArray beats;
+        if (measureIndex < track.measures.size())
+        {
+            for (const auto& beat : track.measures.getReference(measureIndex).beats)
+            {
+                juce::StringArray notes;
+                for (const auto& note : beat.notes)
+                    if (note.fret >= 0)
+                        notes.add(juce::String(note.string) + "/" + juce::String(note.fret));
+                notes.sort(false);
+                if (!beat.isRest && !notes.isEmpty())
+                    beats.add(notes.joinIntoString(" "));
+            }
+        }
+        return beats.joinIntoString(" | ");
+    }
+
+    bool expectTabMatchesRecording()
+    {
+        // Die Edits werden in recordedNotes gespiegelt (auch bei Undo/Redo) - beide Modelle müssen übereinstimmen
+        const int trackIndex = processor.getSelectedTrack();
+        if (!processor.hasEditedTrack(trackIndex))
+            return fail("expect-tab: track " + juce::String(trackIndex) + " has no edits");
+
+        const auto& edited = processor.getEditedTrack(trackIndex);
+        const auto recorded = processor.getRecordedTabTrack();
+        const int numMeasures = juce::jmax(edited.measures.size(), recorded.measures.size());
+        for (int m = 0; m < numMeasures; ++m)
+        {
+            const auto editedNotes = describeMeasureNotes(edited, m);
+            const auto recordedNotes = describeMeasureNotes(recorded, m);
+            if (editedNotes != recordedNotes)
+                return fail("expect-tab: measure " + juce::String(m) + " edited [" + editedNotes
+                            + "] but recorded [" + recordedNotes + "]");
+        }
+
+        midiLog.add("# tab matches recording (" + juce::String(numMeasures) + " measures)");
+        return true;
+    }
+
+    bool waitForTranscription()
+    {
+        // Transkription läuft im eigenen Thread; das Ergebnis wird danach hier im
+        // "Message-Thread" in die Aufnahme eingefügt, wie es sonst der Processor-Timer tut
+        const auto timeout = juce::Time::getMillisecondCounter() + 120000;
+        while (processor.isAudioTranscribing())
+        {
+            if (juce::Time::getMillisecondCounter() > timeout)
+                return fail("transcription did not finish within 120 s");
+            juce::Thread::sleep(10);
+        }
+        processor.dispatchPendingMessageThreadWork();
+        return true;
+    }
+
+    void finish()
+    {
+        for (const auto& note : processor.getRecordedNotes())
+            midiLog.add("recorded ch" + juce::String(note.midiChannel) + " note " + juce::String(note.midiNote)
+                        + " vel " + juce::String(note.velocity) + " beats " + juce::String(note.startBeat, 4)
+                        + "-" + juce::String(note.endBeat, 4));
+    }
+
+    juce::int64 beatsToSamples(double beats) const
+    {
+        return (juce::int64) std::llround(playHead.beatsToSeconds(beats) * sampleRate);
+    }
+
+    static double getPercentile(const std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty())
+            return 0.0;
+        return sorted[juce::jmin(sorted.size() - 1, (size_t) std::ceil(p * (double) sorted.size()) - 1)];
+    }
+
+    bool fail(const juce::String& message)
+    {
+        lastError = message;
+        return false;
+    }
+
+    NewProjectAudioProcessor& processor;
+    SimulatedPlayHead playHead;
+    juce::AudioFormatManager formatManager;
+    juce::File scriptDirectory;
+
+    double sampleRate = 44100.0;
+    std::vector<int> blockSizes;
+    size_t nextBlockSize = 0;
+    int preparedBlockSize = 0;
+    bool prepared = false;
+
+    juce::int64 clock = 0;
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midiBuffer;
+    std::vector<PendingMidi> pendingMidi;
+    std::vector<SidechainSource> sidechainSources;
+
+    juce::StringArray midiLog;
+    std::vector<BlockTiming> blockTimings;
+    juce::String lastError;
+
+    JUCE_DECLARE_NON_COPYABLE (HostSimulator)
+};
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+    LiveChordAnalyzer.h
+
+    Hintergrund-Thread für die Live-Akkord-/Fingersatz-Analyse.
+
+    - Der Audio-Thread meldet nur, wenn sich die gehaltenen Noten ändern
+      (post(), kurzer SpinLock auf einen festen Puffer, keine Allokation).
+    - Der Analyse-Thread wacht auf, rechnet Akkord-Matching, Griffbild und
+      Fingersatz und veröffentlicht ein unveränderliches Ergebnis.
+    - Die UI liest das jeweils neueste Ergebnis wait-free über einen
+      Triple-Buffer (getLatest(), nur ein Leser: Message-Thread).
+
+    Die neue Handposition (Trägheit für die nächste Note) geht über ein
+    Atomic an den Audio-Thread zurück, der sie selbst übernimmt - so bleibt
+    lastPlayedFret ausschließlich im Audio-Thread beschrieben.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "GuitarTuning.h"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+//==============================================================================
+/**
+ * LiveChordAnalyzer
+ */
+class LiveChordAnalyzer : private juce::Thread
+{
+public:
+    static constexpr int maxHeldNotes = 16;
+    static constexpr int noHandFret = -1;
+
+    /** Gehaltene Note wie vom Audio-Thread eingeordnet (midiNoteToTab). */
+    struct HeldNote
+    {
+        int midiNote = 0;
+        int velocity = 0;
+        int string = 0;
+        int fret = 0;
+    };
+
+    /** Eingabe: Momentaufnahme der gehaltenen Noten + Handposition. */
+    struct Input
+    {
+        std::array<HeldNote, maxHeldNotes> notes {};
+        int numNotes = 0;
+        int handFret = noHandFret;      // lastPlayedFret zum Zeitpunkt der Änderung
+        uint32_t generation = 0;
+    };
+
+    /** Ergebnis-Note (Darstellung im Tab). */
+    struct Note
+    {
+        int midiNote = 0;
+        int velocity = 0;
+        int string = 0;    // Calculated string (0 = highest)
+        int fret = 0;      // Calculated fret
+        int fingerNumber = -1;  // Finger (0=open, 1-4=finger, -1=unassigned)
+    };
+
+    /** Unveränderliches Analyse-Ergebnis. */
+    struct Result
+    {
+        std::vector<Note> notes;
+        std::array<bool, GuitarTuning::maxStrings> mutedStrings {};
+        juce::String chordName;
+        int handFret = noHandFret;      // neue Handposition, noHandFret = unverändert
+        uint32_t generation = 0;
+    };
+
+    using AnalyseFunction = std::function<Result(const Input&)>;
+
+    explicit LiveChordAnalyzer(AnalyseFunction analyseFunction)
+        : juce::Thread("LiveChordAnalyzer"),
+          analyse(std::move(analyseFunction))
+    {
+    }
+
+    ~LiveChordAnalyzer() override
+    {
+        stop();
+    }
+
+    void start()
+    {
+        if (! isThreadRunning())
+            startThread(juce::Thread::Priority::low);
+    }
+
+    void stop()
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread(1000);
+    }
+
+    //==========================================================================
+    // Producer (Audio-Thread oder Message-Thread)
+    //==========================================================================
+
+    /** Neue Momentaufnahme der gehaltenen Noten; weckt den Analyse-Thread. */
+    void post(const Input& input)
+    {
+        {
+            const juce::SpinLock::ScopedLockType lock(inputLock);
+            pendingInput = input;
+            pendingInput.generation = ++postedGeneration;
+        }
+        notify();
+    }
+
+    /** Audio-Thread: neue Handposition aus der letzten Analyse (oder noHandFret). */
+    int takeHandFret()
+    {
+        return handFretFeedback.exchange(noHandFret, std::memory_order_acq_rel);
+    }
+
+    //==========================================================================
+    // Consumer (nur Message-Thread)
+    //==========================================================================
+
+    /** Neuestes Ergebnis; wait-free, bleibt gültig bis zum nächsten Aufruf. */
+    const Result& getLatest() const
+    {
+        if (sharedState.load(std::memory_order_acquire) & dirtyBit)
+            frontIndex = sharedState.exchange(frontIndex, std::memory_order_acq_rel) & indexMask;
+        return slots[(size_t) frontIndex];
+    }
+
+private:
+    static constexpr int indexMask = 0x3;
+    static constexpr int dirtyBit = 0x4;
+
+    AnalyseFunction analyse;
+
+    // Eingabe-Mailbox
+    juce::SpinLock inputLock;
+    Input pendingInput;
+    uint32_t postedGeneration = 0;
+    uint32_t analysedGeneration = 0;
+
+    // Triple-Buffer: Writer besitzt backIndex, Reader frontIndex, sharedState = mittlerer Slot (+ dirty)
+    std::array<Result, 3> slots;
+    int backIndex = 0;
+    mutable int frontIndex = 1;
+    mutable std::atomic<int> sharedState { 2 };
+
+    std::atomic<int> handFretFeedback { noHandFret };
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            Input input;
+            while (takeInput(input) && ! threadShouldExit())
+                publish(analyse(input));
+
+            wait(-1);
+        }
+    }
+
+    bool takeInput(Input& input)
+    {
+        const juce::SpinLock::ScopedLockType lock(inputLock);
+        if (pendingInput.generation == analysedGeneration)
+            return false;
+
+        input = pendingInput;
+        analysedGeneration = input.generation;
+        return true;
+    }
+
+    void publish(Result result)
+    {
+        if (result.handFret != noHandFret)
+            handFretFeedback.store(result.handFret, std::memory_order_release);
+
+        slots[(size_t) backIndex] = std::move(result);
+        backIndex = sharedState.exchange(backIndex | dirtyBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LiveChordAnalyzer)
+};
@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+
+    MemoryAccounting.h
+
+    Speicherbuchhaltung pro Subsystem (Aufnahmepuffer, BasicPitch-Tensoren,
+    Posteriorgramme, Song-Modell, TabTrack-Kopien, Renderer, ...).
+
+    Jedes Subsystem besitzt ein MemoryAccount und meldet nach Änderungen
+    seinen belegten Heap-Speicher (explizit geschätzt über capacity bzw.
+    Elementanzahl, keine eigenen Allokatoren). Die zentrale Registry summiert
+    prozessweit über alle Plugin-Instanzen: aktuell, Spitze seit Programmstart
+    und die größte Spitze eines einzelnen Accounts. Da jede Instanz höchstens
+    ein Account pro Subsystem hat, ergibt die Summe dieser Einzelspitzen das
+    Worst-Case-Budget einer Instanz.
+
+    setBytes ist lock- und allokationsfrei (atomare Zähler), darf aber nur
+    von einem Thread pro Account gleichzeitig aufgerufen werden.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <map>
+#include <vector>
+
+class MemoryAccounting
+{
+public:
+    enum Subsystem
+    {
+        processor = 0,       // Instanz selbst (sizeof, inkl. fester Arrays)
+        audioCapture,        // Aufnahmepuffer 22,05 kHz, Resampler-Puffer, Transkriptions-Kopie
+        featureTensors,      // ONNX-Ausgabe (harmonisch gestapelte CQT)
+        posteriorgrams,      // Onsets/Notes/Contours + Note-Events
+        noteExtraction,      // Notes::mRemainingEnergy(+Index)
+        transcriptionModel,  // CNN-Gewichte, ONNX-Session (Schätzung)
+        songModel,           // geparste Tracks und Takt-Header
+        annotatedTracks,     // SongFingeringAnnotator-Cache
+        recordedNotes,       // RecordedNoteStore
+        recordedTab,         // RecordedTabBuilder (inkrementeller TabTrack)
+        editedTracks,        // editierte Tracks + Undo-Historien
+        tabView,             // TabTrack-Kopie im Editor
+        renderer,            // TabRenderer-Trefferlisten und Layout
+        numSubsystems
+    };
+
+    static const char* getSubsystemName(int subsystem)
+    {
+        static const char* names[] = { "processor", "audio capture", "feature tensors", "posteriorgrams",
+                                       "note extraction", "CNN/ONNX model", "song model", "annotated tracks",
+                                       "recorded notes", "recorded tab", "edited tracks", "tab view", "renderer" };
+        return (subsystem >= 0 && subsystem < numSubsystems) ? names[subsystem] : "";
+    }
+
+    struct Totals
+    {
+        int accounts = 0;                   // lebende Accounts (= Instanzen mit diesem Subsystem)
+        juce::int64 liveBytes = 0;
+        juce::int64 peakBytes = 0;          // Spitze der Summe seit Programmstart
+        juce::int64 largestPeakBytes = 0;   // größte Spitze eines einzelnen Accounts
+    };
+
+    static MemoryAccounting& getInstance()
+    {
+        static MemoryAccounting instance;
+        return instance;
+    }
+
+    Totals getTotals(int subsystem) const
+    {
+        Totals totals;
+        if (subsystem < 0 || subsystem >= numSubsystems)
+            return totals;
+
+        const auto& c = counters[(size_t) subsystem];
+        totals.accounts = c.accounts.load(std::memory_order_relaxed);
+        totals.liveBytes = c.live.load(std::memory_order_relaxed);
+        totals.peakBytes = c.peak.load(std::memory_order_relaxed);
+        totals.largestPeakBytes = c.largestPeak.load(std::memory_order_relaxed);
+        return totals;
+    }
+
+    /** Text-Tabelle für Debug-Panel und Report; projectedInstances skaliert das Instanz-Budget. */
+    juce::String createReport(int projectedInstances = 30) const
+    {
+        juce::String report;
+        report << "memory (all instances in this process)\n";
+        report << juce::String("subsystem").paddedRight(' ', 18)
+               << juce::String("inst").paddedLeft(' ', 5)
+               << juce::String("live").paddedLeft(' ', 11)
+               << juce::String("peak").paddedLeft(' ', 11)
+               << juce::String("max/inst").paddedLeft(' ', 11) << "\n";
+
+        juce::int64 totalLive = 0, perInstanceBudget = 0;
+        for (int s = 0; s < numSubsystems; ++s)
+        {
+            const auto t = getTotals(s);
+            totalLive += t.liveBytes;
+            perInstanceBudget += t.largestPeakBytes;
+            report << juce::String(getSubsystemName(s)).paddedRight(' ', 18)
+                   << juce::String(t.accounts).paddedLeft(' ', 5)
+                   << formatBytes(t.liveBytes).paddedLeft(' ', 11)
+                   << formatBytes(t.peakBytes).paddedLeft(' ', 11)
+                   << formatBytes(t.largestPeakBytes).paddedLeft(' ', 11) << "\n";
+        }
+
+        report << "live total " << formatBytes(totalLive)
+               << ", worst case per instance " << formatBytes(perInstanceBudget)
+               << " (x" << projectedInstances << " = " << formatBytes(perInstanceBudget * projectedInstances) << ")\n";
+        return report;
+    }
+
+    static juce::String formatBytes(juce::int64 bytes)
+    {
+        if (bytes < 1024)
+            return juce::String(bytes) + " B";
+        if (bytes < 1024 * 1024)
+            return juce::String((double) bytes / 1024.0, 1) + " KB";
+        return juce::String((double) bytes / (1024.0 * 1024.0), 1) + " MB";
+    }
+
+    //==========================================================================
+    // Schätzhilfen für Heap-Belegung (nur Nutzdaten, ohne Allokator-Overhead)
+
+    template <typename T>
+    static size_t bytesOf(const std::vector<T>& v) noexcept { return v.capacity() * sizeof(T); }
+
+    template <typename T>
+    static size_t bytesOf(const std::vector<std::vector<T>>& v) noexcept
+    {
+        size_t bytes = v.capacity() * sizeof(std::vector<T>);
+        for (const auto& inner : v)
+            bytes += inner.capacity() * sizeof(T);
+        return bytes;
+    }
+
+    /** juce::Array legt seine Kapazität nicht offen: Elementanzahl als Untergrenze. */
+    template <typename T>
+    static size_t bytesOf(const juce::Array<T>& a) noexcept { return (size_t) a.size() * sizeof(T); }
+
+    static size_t bytesOf(const juce::String& s) noexcept
+    {
+        // Nicht-leere Strings liegen mit Referenzzähler-Header auf dem Heap
+        return s.isEmpty() ? 0 : s.getNumBytesAsUTF8() + 1 + 2 * sizeof(size_t);
+    }
+
+    /** std::map: Knoten mit drei Zeigern und Farbe pro Eintrag. */
+    template <typename K, typename V>
+    static size_t nodeBytesOf(const std::map<K, V>& m) noexcept
+    {
+        return m.size() * (sizeof(std::pair<const K, V>) + 4 * sizeof(void*));
+    }
+
+private:
+    friend class MemoryAccount;
+
+    struct Counter
+    {
+        std::atomic<int> accounts { 0 };
+        std::atomic<juce::int64> live { 0 };
+        std::atomic<juce::int64> peak { 0 };
+        std::atomic<juce::int64> largestPeak { 0 };
+    };
+
+    MemoryAccounting() = default;
+
+    static void raiseTo(std::atomic<juce::int64>& value, juce::int64 candidate) noexcept
+    {
+        auto current = value.load(std::memory_order_relaxed);
+        while (candidate > current && !value.compare_exchange_weak(current, candidate, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    std::array<Counter, numSubsystems> counters;
+
+    JUCE_DECLARE_NON_COPYABLE (MemoryAccounting)
+};
+
+//==============================================================================
+/**
+ * MemoryAccount - Anteil eines Subsystems einer Instanz an der Buchhaltung.
+ * Als Member neben den gezählten Daten; der Destruktor bucht den Rest aus.
+ */
+class MemoryAccount
+{
+public:
+    explicit MemoryAccount(MemoryAccounting::Subsystem subsystemToReport) noexcept
+        : subsystem(subsystemToReport)
+    {
+        getCounter().accounts.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ~MemoryAccount()
+    {
+        setBytes(0);
+        getCounter().accounts.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /** Aktuell belegte Bytes melden (ersetzt den vorigen Wert). */
+    void setBytes(size_t newBytes) noexcept
+    {
+        const auto bytes = (juce::int64) newBytes;
+        const auto previous = liveBytes.exchange(bytes, std::memory_order_relaxed);
+        if (bytes == previous)
+            return;
+
+        auto& counter = getCounter();
+        const auto total = counter.live.fetch_add(bytes - previous, std::memory_order_relaxed) + (bytes - previous);
+        MemoryAccounting::raiseTo(counter.peak, total);
+
+        if (bytes > peakBytes.load(std::memory_order_relaxed))
+        {
+            peakBytes.store(bytes, std::memory_order_relaxed);
+            MemoryAccounting::raiseTo(counter.largestPeak, bytes);
+        }
+    }
+
+    size_t getBytes() const noexcept { return (size_t) liveBytes.load(std::memory_order_relaxed); }
+    size_t getPeakBytes() const noexcept { return (size_t) peakBytes.load(std::memory_order_relaxed); }
+
+private:
+    MemoryAccounting::Counter& getCounter() const noexcept
+    {
+        return MemoryAccounting::getInstance().counters[(size_t) subsystem];
+    }
+
+    const MemoryAccounting::Subsystem subsystem;
+    std::atomic<juce::int64> liveBytes { 0 };
+    std::atomic<juce::int64> peakBytes { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (MemoryAccount)
+};
@@ -16,8 +16,11 @@
 
 #include <juce_audio_formats/juce_audio_formats.h>
 #include <juce_core/juce_core.h>
+#include "TraceRecorder.h"
 #include "GP5Parser.h"  // For GP5Track, GP5Beat, GP5Note, GP5MeasureHeader, GP5SongInfo
 #include "TabModels.h"
+#include "FingeringOptimizer.h"
+#include "ChordNaming.h"
 #include <vector>
 #include <map>
 #include <set>
@@ -34,6 +37,8 @@ public:
     // Main entry point — parse a .mid / .midi file
     bool parseFile(const juce::File& file)
     {
+        TraceScope trace("MidiImporter::parseFile", "parser");
+        
         tracks.clear();
         measureHeaders.clear();
         lastError = "";
@@ -299,11 +304,6 @@ public:
             return "Track";
         };
         
-        // Guitar tuning (standard E)
-        const int standardTuning[] = { 64, 59, 55, 50, 45, 40 };
-        // Bass tuning (standard 4-string)
-        const int bassTuning[] = { 43, 38, 33, 28, -1, -1 };
-        
         int trackIdx = 0;
         for (auto& [channel, notes] : channelNotes)
         {
@@ -344,26 +344,18 @@ public:
             gp5Track.volume = 100;
             gp5Track.pan = 64;
             
-            if (isDrums)
-            {
-                gp5Track.stringCount = 6;
-                for (int s = 0; s < 6; ++s)
-                    gp5Track.tuning.add(standardTuning[s]);
-            }
-            else if (isBass)
-            {
-                gp5Track.stringCount = 4;
-                gp5Track.tuning.add(43);  // G2
-                gp5Track.tuning.add(38);  // D2
-                gp5Track.tuning.add(33);  // A1
-                gp5Track.tuning.add(28);  // E1
-            }
-            else
-            {
-                gp5Track.stringCount = 6;
-                for (int s = 0; s < 6; ++s)
-                    gp5Track.tuning.add(standardTuning[s]);
-            }
+            // Stimmung nach Tonumfang: tiefe Noten unter E2/E1 -> zusätzliche H-/Fis-Saite
+            GuitarTuning instrumentTuning;
+            if (isBass)
+                instrumentTuning = (minNote < 28) ? GuitarTuning::fiveStringBass() : GuitarTuning::standardBass();
+            else if (!isDrums && minNote < 35)
+                instrumentTuning = GuitarTuning::eightStringGuitar();
+            else if (!isDrums && minNote < 40)
+                instrumentTuning = GuitarTuning::sevenStringGuitar();
+            
+            gp5Track.stringCount = instrumentTuning.getStringCount();
+            for (int note : instrumentTuning.getOpenStrings())
+                gp5Track.tuning.add(note);
             
             // Set colour (cycle through some defaults)
             const juce::Colour trackColours[] = {
@@ -376,6 +368,16 @@ public:
             // =====================================================================
             // Build measures with beats and notes
             // =====================================================================
+            // Melodic tracks: string/fret assignment is deferred and optimised
+            // over the whole track afterwards (see FingeringOptimizer)
+            struct PendingBeat {
+                int measure;
+                int beat;
+                double startTick;
+                std::vector<NoteEvent> chordNotes;
+            };
+            std::vector<PendingBeat> pendingBeats;
+            
             for (int m = 0; m < (int)measureMap.size(); ++m)
             {
                 const auto& mi = measureMap[m];
@@ -479,38 +481,45 @@ public:
                         }
                         
                         // Assign notes to strings
-                        for (auto& cn : chord.chordNotes)
+                        if (!isDrums)
                         {
-                            auto [stringIdx, fret] = midiNoteToStringFret(
-                                cn.midiNote, gp5Track.tuning, gp5Track.stringCount, isDrums);
-                            
-                            if (stringIdx >= 0 && stringIdx < gp5Track.stringCount)
+                            pendingBeats.push_back({ m, gp5Measure.voice1.size(), chord.startTick, chord.chordNotes });
+                        }
+                        else
+                        {
+                            for (auto& cn : chord.chordNotes)
                             {
-                                // Don't overwrite if string already used in this beat
-                                if (beat.notes.find(stringIdx) == beat.notes.end())
-                                {
-                                    GP5Note gp5Note;
-                                    gp5Note.fret = fret;
-                                    gp5Note.velocity = cn.velocity;
-                                    beat.notes[stringIdx] = gp5Note;
-                                }
-                                else
+                                auto [stringIdx, fret] = midiNoteToStringFret(
+                                    cn.midiNote, gp5Track.tuning, gp5Track.stringCount, isDrums);
+                            
+                                if (stringIdx >= 0 && stringIdx < gp5Track.stringCount)
                                 {
-                                    // String already taken — try adjacent string
-                                    for (int offset : { -1, 1, -2, 2 })
+                                    // Don't overwrite if string already used in this beat
+                                    if (beat.notes.find(stringIdx) == beat.notes.end())
                                     {
-                                        int altString = stringIdx + offset;
-                                        if (altString >= 0 && altString < gp5Track.stringCount &&
-                                            beat.notes.find(altString) == beat.notes.end())
+                                        GP5Note gp5Note;
+                                        gp5Note.fret = fret;
+                                        gp5Note.velocity = cn.velocity;
+                                        beat.notes[stringIdx] = gp5Note;
+                                    }
+                                    else
+                                    {
+                                        // String already taken — try adjacent string
+                                        for (int offset : { -1, 1, -2, 2 })
                                         {
-                                            int altFret = cn.midiNote - gp5Track.tuning[altString];
-                                            if (altFret >= 0 && altFret <= 24)
+                                            int altString = stringIdx + offset;
+                                            if (altString >= 0 && altString < gp5Track.stringCount &&
+                                                beat.notes.find(altString) == beat.notes.end())
                                             {
-                                                GP5Note gp5Note;
-                                                gp5Note.fret = altFret;
-                                                gp5Note.velocity = cn.velocity;
-                                                beat.notes[altString] = gp5Note;
-                                                break;
+                                                int altFret = cn.midiNote - gp5Track.tuning[altString];
+                                                if (altFret >= 0 && altFret <= 24)
+                                                {
+                                                    GP5Note gp5Note;
+                                                    gp5Note.fret = altFret;
+                                                    gp5Note.velocity = cn.velocity;
+                                                    beat.notes[altString] = gp5Note;
+                                                    break;
+                                                }
                                             }
                                         }
                                     }
@@ -533,6 +542,9 @@ public:
                 gp5Track.measures.add(gp5Measure);
             }
             
+            if (!pendingBeats.empty())
+                assignStringsForTrack(gp5Track, pendingBeats, ticksPerQuarter);
+            
             tracks.add(gp5Track);
             trackIdx++;
         }
@@ -753,6 +765,57 @@ private:
         }
     }
     
+    //==============================================================================
+    // Helper: Assign strings/frets for all deferred beats of a melodic track
+    // in one pass, so hand shifts are planned over the whole track instead of
+    // picking the lowest fret per note
+    template <typename PendingBeatList>
+    static void assignStringsForTrack(GP5Track& gp5Track, const PendingBeatList& pendingBeats,
+                                      int ticksPerQuarter)
+    {
+        std::vector<FingeringOptimizer::NoteGroup> groups(pendingBeats.size());
+        for (size_t i = 0; i < pendingBeats.size(); ++i)
+        {
+            for (auto& cn : pendingBeats[i].chordNotes)
+                groups[i].midiNotes.push_back(cn.midiNote);
+            
+            if (i + 1 < pendingBeats.size())
+                groups[i].beatsToNext = (pendingBeats[i + 1].startTick - pendingBeats[i].startTick) / ticksPerQuarter;
+        }
+        
+        FingeringOptimizer optimizer;
+        optimizer.setTuning(GuitarTuning::fromNotes(gp5Track.tuning));
+        const auto assignments = optimizer.optimise(groups);
+        
+        juce::String lastChordName;
+        for (size_t i = 0; i < pendingBeats.size(); ++i)
+        {
+            const auto& pb = pendingBeats[i];
+            auto& beat = gp5Track.measures.getReference(pb.measure).voice1.getReference(pb.beat);
+            
+            // Chord annotation: name each new chord (3+ notes) once, like GP does
+            if (pb.chordNotes.size() >= 3)
+            {
+                auto chordName = ChordNaming::nameFor(groups[i].midiNotes);
+                if (chordName.isNotEmpty() && chordName != lastChordName)
+                    beat.chordName = chordName;
+                lastChordName = chordName;
+            }
+            
+            for (size_t n = 0; n < pb.chordNotes.size(); ++n)
+            {
+                const auto& choice = assignments[i][n];
+                if (!choice.isValid() || choice.string >= gp5Track.stringCount)
+                    continue;  // More notes than strings - drop, as before
+                
+                GP5Note gp5Note;
+                gp5Note.fret = choice.fret;
+                gp5Note.velocity = pb.chordNotes[n].velocity;
+                beat.notes[choice.string] = gp5Note;
+            }
+        }
+    }
+    
     //==============================================================================
     // Helper: Map a MIDI note to the best string/fret on the guitar
     static std::pair<int, int> midiNoteToStringFret(int midiNote, 
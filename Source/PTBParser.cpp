@@ -15,6 +15,7 @@
 */
 
 #include "PTBParser.h"
+#include "TraceRecorder.h"
 
 // PowerTab document library headers
 #include "powertabdocument.h"
@@ -103,6 +104,8 @@ static int convertPTBBendToGP5(uint8_t ptbBendType)
 //==============================================================================
 bool PTBParser::parse(const juce::File& file)
 {
+    TraceScope trace("PTBParser::parse", "parser");
+    
     // Reset state
     songInfo = GP5SongInfo();
     measureHeaders.clear();
@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+    PerformanceHudComponent.h
+
+    Overlay mit den processBlock-Laufzeiten (AudioThreadProfiler):
+    p50/p99/max pro Abschnitt und Überläufe gegen die Block-Deadline.
+    "Dump..." schreibt den Report samt Host/System-Infos für Bug-Reports,
+    "Trace" zeichnet Trace-Marker aller Threads auf (TraceRecorder) und
+    "Save trace..." exportiert sie als Chrome-Trace-JSON für Perfetto.
+    "Memory" schaltet auf die Speicherbuchhaltung pro Subsystem um
+    (MemoryAccounting, alle Instanzen im Prozess); der Dump enthält sie immer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "PluginProcessor.h"
+#include <functional>
+#include <memory>
+
+class PerformanceHudComponent : public juce::Component,
+                                private juce::Timer
+{
+public:
+    PerformanceHudComponent(NewProjectAudioProcessor& processor)
+        : processor(processor), profiler(processor.getAudioThreadProfiler())
+    {
+        addAndMakeVisible(titleLabel);
+        titleLabel.setText("Audio Thread", juce::dontSendNotification);
+        titleLabel.setFont(juce::FontOptions(14.0f, juce::Font::bold));
+        titleLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+
+        addAndMakeVisible(resetButton);
+        resetButton.onClick = [this]() { profiler.requestReset(); };
+
+        addAndMakeVisible(dumpButton);
+        dumpButton.onClick = [this]() { dumpToFile(); };
+
+        addAndMakeVisible(traceButton);
+        traceButton.setClickingTogglesState(true);
+        traceButton.setToggleState(TraceRecorder::isEnabled(), juce::dontSendNotification);
+        traceButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::red.darker());
+        traceButton.onClick = [this]() { TraceRecorder::getInstance().setEnabled(traceButton.getToggleState()); };
+
+        addAndMakeVisible(memoryButton);
+        memoryButton.setClickingTogglesState(true);
+        memoryButton.onClick = [this]()
+        {
+            titleLabel.setText(showsMemory() ? "Memory" : "Audio Thread", juce::dontSendNotification);
+            refresh();
+            if (onPreferredHeightChanged) onPreferredHeightChanged();
+        };
+
+        addAndMakeVisible(saveTraceButton);
+        saveTraceButton.onClick = [this]() { saveTrace(); };
+
+        addAndMakeVisible(closeButton);
+        closeButton.onClick = [this]() {
+            if (onClose) onClose();
+        };
+
+        refresh();
+        startTimerHz(4);  // Histogramme ändern sich langsam, 4 Hz reicht
+    }
+
+    ~PerformanceHudComponent() override
+    {
+        stopTimer();
+    }
+
+    std::function<void()> onClose;
+    std::function<void()> onPreferredHeightChanged;
+
+    /** Die Speichertabelle hat eine Zeile pro Subsystem und braucht mehr Platz. */
+    int getPreferredHeight() const { return showsMemory() ? 290 : 165; }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.fillAll(juce::Colour(0xE0252528));
+        g.setColour(juce::Colours::grey);
+        g.drawRect(getLocalBounds(), 1);
+
+        auto textArea = getLocalBounds().reduced(10).withTrimmedTop(30);
+        g.setFont(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 12.0f, juce::Font::plain));
+
+        // Überläufe rot hervorheben
+        const auto totalStats = profiler.getStats(AudioThreadProfiler::total);
+        g.setColour(!showsMemory() && totalStats.overruns > 0 ? juce::Colour(0xFFFF8080) : juce::Colours::lightgrey);
+        g.drawMultiLineText(reportText, textArea.getX(), textArea.getY() + 12, textArea.getWidth());
+    }
+
+    void resized() override
+    {
+        auto titleRow = getLocalBounds().reduced(10).removeFromTop(25);
+        closeButton.setBounds(titleRow.removeFromRight(25));
+        titleRow.removeFromRight(5);
+        dumpButton.setBounds(titleRow.removeFromRight(70));
+        titleRow.removeFromRight(5);
+        saveTraceButton.setBounds(titleRow.removeFromRight(85));
+        titleRow.removeFromRight(5);
+        traceButton.setBounds(titleRow.removeFromRight(50));
+        titleRow.removeFromRight(5);
+        memoryButton.setBounds(titleRow.removeFromRight(60));
+        titleRow.removeFromRight(5);
+        resetButton.setBounds(titleRow.removeFromRight(55));
+        titleLabel.setBounds(titleRow);
+    }
+
+private:
+    void timerCallback() override
+    {
+        refresh();
+    }
+
+    bool showsMemory() const { return memoryButton.getToggleState(); }
+
+    void refresh()
+    {
+        if (showsMemory())
+        {
+            processor.updateMemoryAccounts();
+            reportText = MemoryAccounting::getInstance().createReport();
+        }
+        else
+        {
+            reportText = profiler.createReport();
+        }
+        repaint();
+    }
+
+    void dumpToFile()
+    {
+        fileChooser = std::make_unique<juce::FileChooser>(
+            "Save performance report...",
+            juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+                .getChildFile(juce::String(JucePlugin_Name) + "-perf-"
+                              + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".txt"),
+            "*.txt");
+
+        auto flags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::warnAboutOverwriting;
+        fileChooser->launchAsync(flags, [this](const juce::FileChooser& fc)
+        {
+            auto file = fc.getResult();
+            if (file == juce::File())
+                return;
+
+            processor.updateMemoryAccounts();
+
+            juce::String text;
+            text << JucePlugin_Name << " " << JucePlugin_VersionString << "\n"
+                 << "Date: " << juce::Time::getCurrentTime().toString(true, true) << "\n"
+                 << "Host: " << juce::PluginHostType().getHostDescription() << "\n"
+                 << "OS: " << juce::SystemStats::getOperatingSystemName() << "\n"
+                 << "CPU: " << juce::SystemStats::getCpuModel() << " ("
+                 << juce::SystemStats::getNumCpus() << " threads)\n\n"
+                 << profiler.createReport() << "\n"
+                 << MemoryAccounting::getInstance().createReport();
+
+            if (!file.replaceWithText(text))
+                DBG("PerformanceHud: could not write " << file.getFullPathName());
+        });
+    }
+
+    void saveTrace()
+    {
+        fileChooser = std::make_unique<juce::FileChooser>(
+            "Save Chrome trace (open in ui.perfetto.dev)...",
+            juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+                .getChildFile(juce::String(JucePlugin_Name) + "-trace-"
+                              + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".json"),
+            "*.json");
+
+        auto flags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::warnAboutOverwriting;
+        fileChooser->launchAsync(flags, [](const juce::FileChooser& fc)
+        {
+            auto file = fc.getResult();
+            if (file != juce::File() && !TraceRecorder::getInstance().writeChromeTrace(file))
+                DBG("PerformanceHud: could not write " << file.getFullPathName());
+        });
+    }
+
+    NewProjectAudioProcessor& processor;
+    AudioThreadProfiler& profiler;
+    juce::String reportText;
+
+    juce::Label titleLabel;
+    juce::TextButton resetButton { "Reset" };
+    juce::TextButton dumpButton { "Dump..." };
+    juce::TextButton traceButton { "Trace" };
+    juce::TextButton memoryButton { "Memory" };
+    juce::TextButton saveTraceButton { "Save trace..." };
+    juce::TextButton closeButton { "X" };
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerformanceHudComponent)
+};
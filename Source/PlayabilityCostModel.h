@@ -0,0 +1,543 @@
+/*
+  ==============================================================================
+
+    PlayabilityCostModel.h
+
+    Gemeinsames Kostenmodell für die Spielbarkeit von Saiten/Bund-Positionen.
+
+    Alle Fingersatz-Algorithmen (Live-Eingabe, Viterbi-Optimierung, Akkord-
+    Matching, Alternativen-Dialog) bewerten Positionen hierüber. Die
+    Low/Mid/High-Präferenz wird einmal pro Einstellung in eine konstante
+    Parametertabelle aufgelöst statt bei jedem Aufruf per switch.
+
+    Für die heißen Schleifen gibt es Batch-Varianten im SoA-Layout (Saiten,
+    Bünde, Richtungen als getrennte Arrays). Die Kernel sind verzweigungsfrei
+    formuliert (Select statt if), damit der Compiler sie vektorisiert, und
+    summieren die Terme in derselben Reihenfolge wie die Skalar-Referenz in
+    FingeringCost - ohne FMA-Kontraktion sind die Ergebnisse bitgleich.
+
+    Bewusst ohne JUCE-Abhängigkeit, damit die Benchmarks eigenständig bauen.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "GuitarTuning.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+
+//==============================================================================
+/**
+ * FretChoice
+ *
+ * Eine Saiten/Bund-Position. string = -1 bedeutet "nicht spielbar".
+ * Saitenindex folgt der Display-Konvention (0 = höchste Saite).
+ */
+struct FretChoice
+{
+    int string = -1;
+    int fret = -1;
+
+    bool isValid() const { return string >= 0 && fret >= 0; }
+};
+
+//==============================================================================
+/**
+ * FingeringCostParams
+ *
+ * Aufgelöste Einstellungen für die Kostenfunktion (bevorzugter Bundbereich
+ * und Leersaiten-Bonus aus der Low/Mid/High-Präferenz).
+ */
+struct FingeringCostParams
+{
+    int preferredMinFret = 0;
+    int preferredMaxFret = 4;
+    float openStringBonus = 12.0f;  // Low: 8+4, Mid: 8, High: 8-3
+
+    bool isInPreferredRange(int fret) const
+    {
+        return fret >= preferredMinFret && fret <= preferredMaxFret;
+    }
+
+    /** Abstand zum bevorzugten Bereich in Bünden (0 = innerhalb). */
+    int distanceFromPreferred(int fret) const
+    {
+        return (fret < preferredMinFret) ? (preferredMinFret - fret)
+             : (fret > preferredMaxFret) ? (fret - preferredMaxFret) : 0;
+    }
+};
+
+//==============================================================================
+/**
+ * FingeringCost
+ *
+ * Die Terme der Positionskosten als reine Funktionen, aufgeteilt in den
+ * positionsabhängigen Anteil (Platzierung) und den Bewegungsanteil
+ * (Übergang von der vorherigen Position). Skalar-Referenz für die
+ * Batch-Kernel in PlayabilityCostModel.
+ */
+namespace FingeringCost
+{
+    /** Terme 0, 5, 6: bevorzugte Region, Leersaiten-Bonus, Saitenpräferenz. */
+    inline float placement(const FretChoice& current, const FingeringCostParams& p)
+    {
+        float cost = 0.0f;
+
+        // 0. Fret-Position-Präferenz (Low/Mid/High)
+        if (p.isInPreferredRange(current.fret))
+        {
+            cost -= 10.0f;
+        }
+        else
+        {
+            int distFromPreferred = (current.fret < p.preferredMinFret)
+                                        ? (p.preferredMinFret - current.fret)
+                                        : (current.fret - p.preferredMaxFret);
+            cost += distFromPreferred * 3.0f;
+        }
+
+        // 5. Offene Saiten sind immer einfacher zu spielen
+        if (current.fret == 0)
+            cost -= p.openStringBonus;
+
+        // 6. Kleine Präferenz nach Saitenindex
+        cost -= current.string * 0.15f;
+
+        return cost;
+    }
+
+    /**
+     * Terme 1-4 und 7-11: Bewegung von previous nach current.
+     * @param fastPassageFactor  0 = langsam, >0 verteuert große Sprünge (Term 8)
+     * @param previousDirection  -1/0/+1, letzte Bundrichtung (Term 9)
+     */
+    inline float movement(const FretChoice& current, const FretChoice& previous,
+                          const FingeringCostParams& p,
+                          float fastPassageFactor, int previousDirection)
+    {
+        float cost = 0.0f;
+
+        // 1. Fret-Distanz (Horizontal)
+        int fretDiff = std::abs(current.fret - previous.fret);
+        cost += fretDiff * 1.0f;
+        if (fretDiff > 4)
+            cost += (fretDiff - 4) * (fretDiff - 4) * 0.3f;
+
+        // 2. String-Distanz (Vertikal)
+        int stringDiff = std::abs(current.string - previous.string);
+        cost += stringDiff * 0.5f;
+
+        // 3. Hand-Spanne - nur wenn wir uns nicht zur bevorzugten Region bewegen
+        bool movingTowardsPreferred = p.isInPreferredRange(current.fret) ||
+                                      (current.fret < previous.fret && previous.fret > p.preferredMaxFret) ||
+                                      (current.fret > previous.fret && previous.fret < p.preferredMinFret);
+
+        if (fretDiff > 4 && current.fret != 0 && previous.fret != 0 && !movingTowardsPreferred)
+        {
+            cost += 8.0f;
+            cost += (fretDiff - 4) * 1.5f;
+        }
+
+        // 4. Handposition-Trägheit (nur wenn vorherige Position in bevorzugter Region)
+        if (p.isInPreferredRange(previous.fret) && previous.fret >= 5 && current.fret != 0)
+        {
+            int distFromCenter = std::abs(current.fret - previous.fret);
+            if (distFromCenter > 3)
+                cost += (distFromCenter - 3) * 2.0f;
+        }
+
+        // 7. Bonus für das Bleiben auf derselben Saite
+        if (current.string == previous.string && fretDiff <= 4)
+            cost -= 1.5f;
+
+        // 8. Große Sprünge (>3) bei schnellen Passagen
+        if (fastPassageFactor > 0.0f && fretDiff > 3 && current.fret != 0 && previous.fret != 0)
+            cost += (fretDiff - 3) * 50.0f * fastPassageFactor;
+
+        // 9. Auf-/Abwärts-Richtung beibehalten (KTH Paper 6.2.9)
+        if (previousDirection != 0 && current.fret != 0 && previous.fret != 0 && fretDiff > 0)
+        {
+            int currentDirection = (current.fret > previous.fret) ? 1 : -1;
+            cost += (currentDirection != previousDirection) ? 2.0f : -1.0f;
+        }
+
+        // 10. Saitenwechsel auf denselben Bund (KTH Paper 6.3.3)
+        if (current.string != previous.string && current.fret == previous.fret && current.fret > 0)
+        {
+            if (stringDiff == 1)
+                cost += 1.5f;
+            else
+                cost += 4.0f + stringDiff * 1.0f;
+        }
+
+        // 11. Neck Position Scaling (KTH Paper 6.2.7)
+        if (current.fret > 12 && previous.fret > 12 && fretDiff > 2)
+        {
+            float avgFret = (current.fret + previous.fret) / 2.0f;
+            float reductionFactor = std::max(0.6f, 1.0f - (avgFret - 12.0f) * 0.033f);
+            cost -= fretDiff * 1.0f * (1.0f - reductionFactor);
+        }
+
+        return cost;
+    }
+
+    /** Faktor für Term 8 aus dem Notenabstand in Beats (32stel=3, 16tel=2, Achtel=1). */
+    inline float fastPassageFactorForBeats(double beats)
+    {
+        if (beats <= 0.125 + 0.01) return 3.0f;
+        if (beats <= 0.25 + 0.01)  return 2.0f;
+        if (beats <= 0.5 + 0.01)   return 1.0f;
+        return 0.0f;
+    }
+
+    /** Neue Bundrichtung nach einem Schritt (unverändert bei Leersaiten oder gleichem Bund). */
+    inline int nextDirection(const FretChoice& current, const FretChoice& previous, int previousDirection)
+    {
+        if (current.fret > 0 && previous.fret > 0 && current.fret != previous.fret)
+            return (current.fret > previous.fret) ? 1 : -1;
+        return previousDirection;
+    }
+}
+
+//==============================================================================
+/**
+ * PlayabilityCostModel
+ *
+ * Aufgelöste Parameter + alle Bewertungsfunktionen. Instanzen pro Präferenz
+ * liegen in einer statischen Tabelle (forPreference), Kopien sind billig.
+ */
+class PlayabilityCostModel
+{
+public:
+    /** Gleiche Reihenfolge wie NewProjectAudioProcessor::FretPosition. */
+    enum class Preference { Low = 0, Mid = 1, High = 2 };
+
+    /** Ein Kandidat pro Saite - mehr Positionen hat eine Note nicht. */
+    static constexpr int maxCandidates = GuitarTuning::maxStrings;
+
+    //==========================================================================
+    /**
+     * CandidateBatch
+     *
+     * Kandidaten-Positionen einer Note im SoA-Layout für die Batch-Kernel.
+     */
+    struct CandidateBatch
+    {
+        std::array<int, maxCandidates> strings {};
+        std::array<int, maxCandidates> frets {};
+        int count = 0;
+
+        static CandidateBatch fromPositions(const GuitarTuning::PositionList& positions)
+        {
+            CandidateBatch batch;
+            for (const auto& p : positions)
+            {
+                batch.strings[(size_t) batch.count] = p.string;
+                batch.frets[(size_t) batch.count] = p.fret;
+                ++batch.count;
+            }
+            return batch;
+        }
+
+        FretChoice operator[](int i) const { return { strings[(size_t) i], frets[(size_t) i] }; }
+    };
+
+    //==========================================================================
+    PlayabilityCostModel() = default;
+    explicit PlayabilityCostModel(const FingeringCostParams& resolvedParams) : params(resolvedParams) {}
+
+    /** Vorab aufgelöstes Modell für eine Low/Mid/High-Präferenz (0/1/2, wird begrenzt). */
+    static const PlayabilityCostModel& forPreference(int preference)
+    {
+        static const std::array<PlayabilityCostModel, 3> models {
+            PlayabilityCostModel({ 0, 4, 12.0f }),   // Low: Extra Bonus für Leersaiten
+            PlayabilityCostModel({ 5, 8, 8.0f }),    // Mid
+            PlayabilityCostModel({ 9, 12, 5.0f })    // High: Leichte Reduzierung des Bonus
+        };
+        return models[(size_t) std::clamp(preference, 0, 2)];
+    }
+
+    static const PlayabilityCostModel& forPreference(Preference preference)
+    {
+        return forPreference(static_cast<int>(preference));
+    }
+
+    const FingeringCostParams& getParams() const { return params; }
+    int getPreferredMinFret() const { return params.preferredMinFret; }
+    int getPreferredMaxFret() const { return params.preferredMaxFret; }
+
+    //==========================================================================
+    // Positionskosten (Live-Eingabe + Viterbi), niedriger = besser
+    //==========================================================================
+
+    float placement(const FretChoice& current) const
+    {
+        return FingeringCost::placement(current, params);
+    }
+
+    float movement(const FretChoice& current, const FretChoice& previous,
+                   float fastPassageFactor, int previousDirection) const
+    {
+        return FingeringCost::movement(current, previous, params, fastPassageFactor, previousDirection);
+    }
+
+    /** Platzierungskosten für alle Kandidaten (out[0..count-1]). */
+    void scorePlacement(const CandidateBatch& batch, float* out) const
+    {
+        placementKernel(batch.strings.data(), batch.frets.data(), batch.count, out);
+    }
+
+    /** Platzierung + Bewegung von einer festen Vorgänger-Position für alle Kandidaten. */
+    void scorePositions(const CandidateBatch& batch, const FretChoice& previous,
+                        float fastPassageFactor, int previousDirection, float* out) const
+    {
+        float moves[maxCandidates];
+        placementKernel(batch.strings.data(), batch.frets.data(), batch.count, out);
+        movementKernel(Lanes { batch.strings.data(), batch.frets.data(), nullptr },
+                       Broadcast { previous.string, previous.fret, previousDirection },
+                       batch.count, fastPassageFactor, moves);
+
+        for (int i = 0; i < batch.count; ++i)
+            out[i] += moves[i];
+    }
+
+    /** Index des günstigsten Kandidaten (erster bei Gleichstand), -1 wenn leer. */
+    int findBest(const CandidateBatch& batch, const FretChoice& previous,
+                 float fastPassageFactor, int previousDirection) const
+    {
+        float costs[maxCandidates];
+        scorePositions(batch, previous, fastPassageFactor, previousDirection, costs);
+        return argMin(costs, batch.count);
+    }
+
+    /**
+     * Bewegung von vielen Vorgängern (SoA) zu einer festen Position - der
+     * innere Viterbi-Übergang. previousDirections darf nicht nullptr sein.
+     */
+    void scoreMovementFrom(const int* previousStrings, const int* previousFrets, const int* previousDirections,
+                           int count, const FretChoice& current, float fastPassageFactor, float* out) const
+    {
+        movementKernel(Broadcast { current.string, current.fret, 0 },
+                       Lanes { previousStrings, previousFrets, previousDirections },
+                       count, fastPassageFactor, out);
+    }
+
+    static int argMin(const float* costs, int count)
+    {
+        int best = -1;
+        for (int i = 0; i < count; ++i)
+            if (best < 0 || costs[i] < costs[best])
+                best = i;
+        return best;
+    }
+
+    //==========================================================================
+    // Spezialisierte Bewertungen
+    //==========================================================================
+
+    /**
+     * Erste Note ohne Handposition: bevorzugter Bereich + höhere Saiten.
+     * Score, höher = besser.
+     */
+    int initialPlacementScore(int string, int fret) const
+    {
+        int score = params.isInPreferredRange(fret) ? 100 : -params.distanceFromPreferred(fret) * 5;
+        score += string * 2;  // Präferenz für höhere Saiten
+        return score;
+    }
+
+    /**
+     * Option einer gehaltenen Note im Live-Akkord (ohne passendes Griffbild).
+     * Score, höher = besser.
+     */
+    int liveChordOptionScore(int string, int fret, int handFret) const
+    {
+        int score = 0;
+
+        // Bonus für Frets im bevorzugten Bereich
+        if (params.isInPreferredRange(fret))
+        {
+            score += 100;
+        }
+        else
+        {
+            // Progressive Strafe - je weiter weg, desto teurer
+            int dist = params.distanceFromPreferred(fret);
+            score -= dist * 15;
+            if (dist > 3)
+                score -= (dist - 3) * (dist - 3) * 5;
+        }
+
+        // Trägheit: in einer hohen Lage bleiben
+        if (handFret >= 7)
+        {
+            int distFromLast = std::abs(fret - handFret);
+            if (distFromLast <= 3)
+                score += 30;
+            else if (distFromLast > 5)
+                score -= (distFromLast - 5) * 8;
+        }
+
+        // Leichte Präferenz für höhere Saiten (Melodie)
+        score += string * 2;
+        return score;
+    }
+
+    /** Akkord-Griffbild: Bonus/Malus für die Lage relativ zum bevorzugten Bereich. */
+    float chordShapePreferenceCost(int shapePosition) const
+    {
+        if (params.isInPreferredRange(shapePosition))
+            return -15.0f;
+        return params.distanceFromPreferred(shapePosition) * 4.0f;
+    }
+
+    /** Lagenwechsel der Greifhand (Akkord-Griffbilder). */
+    static float handShiftCost(int fromFret, int toFret)
+    {
+        return std::abs(toFret - fromFret) * 1.5f;
+    }
+
+    /** Übergang zu einem Griffbild; Open Chords sind am Sattel kostenlos. */
+    static float chordShapeTransitionCost(int shapePosition, int currentFretPosition, bool isOpenChord)
+    {
+        if (currentFretPosition <= 3 && isOpenChord)
+            return 0.0f;
+        return handShiftCost(currentFretPosition, shapePosition);
+    }
+
+    /**
+     * Statische Bewertung im Alternativen-Dialog: tiefe Bünde, Leersaiten und
+     * mittlere Saiten bevorzugt, optional Nähe zu einer Wunschlage.
+     */
+    static float alternativeCost(int string, int fret, int stringCount, int preferredFret)
+    {
+        float cost = 0.0f;
+
+        // Leersaiten bevorzugt
+        if (fret == 0) cost -= 2.0f;
+
+        // Niedrige Bünde einfacher
+        cost += fret * 0.1f;
+
+        // Hohe Bünde schwieriger
+        if (fret > 12) cost += (fret - 12) * 0.3f;
+
+        // Mittlere Saiten bevorzugt
+        float middleString = (stringCount - 1) / 2.0f;
+        cost += std::abs(string - middleString) * 0.2f;
+
+        // Abstand von bevorzugter Position
+        if (preferredFret > 0)
+            cost += std::abs(fret - preferredFret) * 0.5f;
+
+        return cost;
+    }
+
+private:
+    FingeringCostParams params;
+
+    // Kernel-Operanden: entweder ein Wert für alle Lanes oder ein Array
+    struct Broadcast
+    {
+        int s, f, d;
+        int string(int) const { return s; }
+        int fret(int) const { return f; }
+        int direction(int) const { return d; }
+    };
+
+    struct Lanes
+    {
+        const int* s;
+        const int* f;
+        const int* d;
+        int string(int i) const { return s[i]; }
+        int fret(int i) const { return f[i]; }
+        int direction(int i) const { return d[i]; }
+    };
+
+    /** Terme 0, 5, 6 - verzweigungsfrei, gleiche Reihenfolge wie FingeringCost::placement. */
+    void placementKernel(const int* strings, const int* frets, int count, float* out) const
+    {
+        const int minF = params.preferredMinFret;
+        const int maxF = params.preferredMaxFret;
+        const float bonus = params.openStringBonus;
+
+        for (int i = 0; i < count; ++i)
+        {
+            const int fret = frets[i];
+            const bool inRange = fret >= minF && fret <= maxF;
+            const int dist = (fret < minF) ? (minF - fret) : (fret - maxF);
+
+            float cost = 0.0f;
+            cost += inRange ? -10.0f : dist * 3.0f;
+            cost -= (fret == 0) ? bonus : 0.0f;
+            cost -= strings[i] * 0.15f;
+            out[i] = cost;
+        }
+    }
+
+    /** Terme 1-4 und 7-11 - verzweigungsfrei, gleiche Reihenfolge wie FingeringCost::movement. */
+    template <typename Current, typename Previous>
+    void movementKernel(Current cur, Previous prev, int count, float fastPassageFactor, float* out) const
+    {
+        const int minF = params.preferredMinFret;
+        const int maxF = params.preferredMaxFret;
+        const bool fast = fastPassageFactor > 0.0f;
+
+        for (int i = 0; i < count; ++i)
+        {
+            const int cs = cur.string(i), cf = cur.fret(i);
+            const int ps = prev.string(i), pf = prev.fret(i), pd = prev.direction(i);
+
+            const int fretDiff = std::abs(cf - pf);
+            const int stringDiff = std::abs(cs - ps);
+            const bool bothFretted = cf != 0 && pf != 0;
+            const bool curInRange = cf >= minF && cf <= maxF;
+            const bool prevInRange = pf >= minF && pf <= maxF;
+
+            float cost = 0.0f;
+
+            // 1. Fret-Distanz
+            cost += fretDiff * 1.0f;
+            cost += (fretDiff > 4) ? (fretDiff - 4) * (fretDiff - 4) * 0.3f : 0.0f;
+
+            // 2. String-Distanz
+            cost += stringDiff * 0.5f;
+
+            // 3. Hand-Spanne
+            const bool movingTowardsPreferred = curInRange || (cf < pf && pf > maxF) || (cf > pf && pf < minF);
+            const bool overSpan = fretDiff > 4 && bothFretted && ! movingTowardsPreferred;
+            cost += overSpan ? 8.0f : 0.0f;
+            cost += overSpan ? (fretDiff - 4) * 1.5f : 0.0f;
+
+            // 4. Handposition-Trägheit
+            const int distFromCenter = fretDiff;
+            cost += (prevInRange && pf >= 5 && cf != 0 && distFromCenter > 3) ? (distFromCenter - 3) * 2.0f : 0.0f;
+
+            // 7. Gleiche Saite
+            cost -= (cs == ps && fretDiff <= 4) ? 1.5f : 0.0f;
+
+            // 8. Große Sprünge bei schnellen Passagen
+            cost += (fast && fretDiff > 3 && bothFretted) ? (fretDiff - 3) * 50.0f * fastPassageFactor : 0.0f;
+
+            // 9. Richtung beibehalten
+            const int currentDirection = (cf > pf) ? 1 : -1;
+            cost += (pd != 0 && bothFretted && fretDiff > 0) ? ((currentDirection != pd) ? 2.0f : -1.0f) : 0.0f;
+
+            // 10. Saitenwechsel auf denselben Bund
+            const bool sameFretOtherString = cs != ps && cf == pf && cf > 0;
+            cost += sameFretOtherString ? ((stringDiff == 1) ? 1.5f : 4.0f + stringDiff * 1.0f) : 0.0f;
+
+            // 11. Neck Position Scaling
+            const float avgFret = (cf + pf) / 2.0f;
+            const float reductionFactor = std::max(0.6f, 1.0f - (avgFret - 12.0f) * 0.033f);
+            cost -= (cf > 12 && pf > 12 && fretDiff > 2) ? fretDiff * 1.0f * (1.0f - reductionFactor) : 0.0f;
+
+            out[i] = cost;
+        }
+    }
+};
@@ -44,6 +44,11 @@ NewProjectAudioProcessorEditor::NewProjectAudioProcessorEditor (NewProjectAudioP
     addAndMakeVisible (settingsButton);
     settingsButton.onClick = [this] { toggleSettingsPanel(); };
     
+    // Performance-HUD (Laufzeiten des Audio-Threads für Dropout-Meldungen)
+    addAndMakeVisible (perfButton);
+    perfButton.setTooltip ("Show audio thread timing (p50/p99/max, overruns)");
+    perfButton.onClick = [this] { togglePerformanceHud(); };
+    
     // Unified Save Button (shows format menu: MIDI or GP5)
     addAndMakeVisible (saveButton);
     saveButton.onClick = [this] { saveButtonClicked(); };
@@ -311,52 +316,31 @@ NewProjectAudioProcessorEditor::NewProjectAudioProcessorEditor (NewProjectAudioP
         }
     };
     
-    // Note-Position-Changed Callback
-    tabView.onNotePositionChanged = [this](int measureIdx, int beatIdx, int oldString, int newString, int newFret) {
-        DBG("Note geändert: Takt " << (measureIdx + 1) << ", Beat " << (beatIdx + 1) 
-            << ", Saite " << (oldString + 1) << " -> Saite " << (newString + 1) << ", Bund " << newFret);
-        
-        // Änderung an den Processor weiterleiten für Speicherung und Export
-        audioProcessor.updateRecordedNotePosition(measureIdx, beatIdx, oldString, newString, newFret);
-        
-        // Speichere den aktuellen Track-Zustand im Processor
-        audioProcessor.setEditedTrack(audioProcessor.getSelectedTrack(), tabView.getTrack());
-    };
-    
-    // Note-Deleted Callback
-    tabView.onNoteDeleted = [this](int measureIdx, int beatIdx, int stringIndex) {
-        DBG("Note gelöscht: Takt " << (measureIdx + 1) << ", Beat " << (beatIdx + 1) 
-            << ", Saite " << (stringIndex + 1));
+    // Edit-Befehle der Tab-Ansicht: Processor wendet sie auf sein Modell an,
+    // danach wird das Journal in die Ansicht zurückgespielt (keine Track-Kopien)
+    tabView.onTabEdits = [this](const std::vector<TabEdit>& edits) {
+        const int trackIndex = audioProcessor.getSelectedTrack();
+        const auto knownSequence = audioProcessor.getTabEditJournal().getLastSequence();
         
-        audioProcessor.deleteRecordedNote(measureIdx, beatIdx, stringIndex);
-        audioProcessor.setEditedTrack(audioProcessor.getSelectedTrack(), tabView.getTrack());
-    };
-    
-    // Beat-Duration-Changed Callback
-    tabView.onBeatDurationChanged = [this](int measureIdx, int beatIdx, int newDurationValue, bool isDotted) {
-        DBG("Beat-Dauer geändert: Takt " << (measureIdx + 1) << ", Beat " << (beatIdx + 1) 
-            << ", Dauer " << newDurationValue << (isDotted ? " (dotted)" : ""));
+        audioProcessor.applyTabEdits(trackIndex, edits, tabView.getTrack());
         
-        audioProcessor.updateRecordedNoteDuration(measureIdx, beatIdx, newDurationValue, isDotted);
-        audioProcessor.setEditedTrack(audioProcessor.getSelectedTrack(), tabView.getTrack());
+        const int applied = replayTabEditJournal(trackIndex, knownSequence);
+        DBG("Tab-Edits: " << (int) edits.size() << " angefordert, " << applied
+            << " angewendet (Track " << (trackIndex + 1) << ")");
     };
     
-    // Note-Pitch-Changed Callback
-    tabView.onNotePitchChanged = [this](int measureIdx, int beatIdx, int stringIndex, int newMidiNote, int newFret) {
-        DBG("Tonhöhe geändert: Takt " << (measureIdx + 1) << ", Beat " << (beatIdx + 1) 
-            << ", Saite " << (stringIndex + 1) << ", neue MIDI-Note " << newMidiNote << ", Bund " << newFret);
-        
-        audioProcessor.updateRecordedNotePitch(measureIdx, beatIdx, stringIndex, newMidiNote, newFret);
-        audioProcessor.setEditedTrack(audioProcessor.getSelectedTrack(), tabView.getTrack());
+    // Undo/Redo: Processor setzt sein Modell zurück, die ersetzten Takte kommen über das Journal
+    tabView.onUndoRequested = [this]() {
+        const int trackIndex = audioProcessor.getSelectedTrack();
+        const auto knownSequence = audioProcessor.getTabEditJournal().getLastSequence();
+        if (audioProcessor.undoTabEdit(trackIndex))
+            replayTabEditJournal(trackIndex, knownSequence);
     };
-    
-    // Note-Inserted Callback (insert note into rest)
-    tabView.onNoteInserted = [this](int measureIdx, int beatIdx, int stringIndex, int fret, int midiNote) {
-        DBG("Note eingefügt: Takt " << (measureIdx + 1) << ", Beat " << (beatIdx + 1) 
-            << ", Saite " << (stringIndex + 1) << ", Bund " << fret << ", MIDI " << midiNote);
-        
-        audioProcessor.insertRecordedNote(measureIdx, beatIdx, stringIndex, fret, midiNote);
-        audioProcessor.setEditedTrack(audioProcessor.getSelectedTrack(), tabView.getTrack());
+    tabView.onRedoRequested = [this]() {
+        const int trackIndex = audioProcessor.getSelectedTrack();
+        const auto knownSequence = audioProcessor.getTabEditJournal().getLastSequence();
+        if (audioProcessor.redoTabEdit(trackIndex))
+            replayTabEditJournal(trackIndex, knownSequence);
     };
 
     // Fenstergröße setzen (größer für die Tab-Ansicht + Header)
@@ -509,6 +493,12 @@ void NewProjectAudioProcessorEditor::resized()
     
     // Auto-Scroll Toggle (in beiden Modi)
     autoScrollButton.setBounds (toolbar.removeFromRight(100));
+    toolbar.removeFromRight(5);
+    
+    // Performance-HUD Toggle
+    perfButton.setBounds (toolbar.removeFromRight(45));
+    if (performanceHud != nullptr)
+        performanceHud->setBounds (getWidth() - 500, 55, 490, performanceHud->getPreferredHeight());
     
     // Tabulatur-Ansicht (Rest des Fensters)
     bounds = bounds.reduced(5);
@@ -683,6 +673,7 @@ void NewProjectAudioProcessorEditor::refreshFromProcessor()
         TabTrack emptyTrack = audioProcessor.getEmptyTabTrack();
         tabView.setTrack(emptyTrack);
         tabView.setEditorMode(true);
+        recordedTabRevision = 0;
         return;
     }
     
@@ -804,6 +795,9 @@ void NewProjectAudioProcessorEditor::trackSelectionChanged()
     
     int trackIndex = selectedId - 1;  // Zurück zu 0-basiert
     
+    // Live-Aufnahme beim nächsten Timer-Tick wieder komplett anzeigen
+    recordedTabRevision = 0;
+    
     // Unterscheide zwischen Player-Modus (Datei geladen) und Editor-Modus (Aufnahmen)
     if (audioProcessor.isFileLoaded())
     {
@@ -819,26 +813,9 @@ void NewProjectAudioProcessorEditor::trackSelectionChanged()
             {
                 track = audioProcessor.getEditedTrack(trackIndex);
             }
-            else if (audioProcessor.isUsingGP7Parser())
-            {
-                const auto& gp7Tracks = audioProcessor.getGP7Parser().getTracks();
-                juce::Array<TabMeasure> measures = audioProcessor.getGP7Parser().convertToTabMeasures(trackIndex);
-                track.name = gp7Tracks[trackIndex].name;
-                track.stringCount = gp7Tracks[trackIndex].stringCount;
-                track.tuning = gp7Tracks[trackIndex].tuning;
-                track.measures = measures;
-            }
-            else if (audioProcessor.isUsingMidiImporter())
-            {
-                track = audioProcessor.getMidiImporter().convertToTabTrack(trackIndex);
-            }
-            else if (audioProcessor.isUsingPTBParser())
-            {
-                track = audioProcessor.getPTBParser().convertToTabTrack(trackIndex);
-            }
             else
             {
-                track = audioProcessor.getGP5Parser().convertToTabTrack(trackIndex);
+                track = audioProcessor.getLoadedTabTrack(trackIndex);
             }
             tabView.setTrack(track);
             
@@ -878,7 +855,11 @@ void NewProjectAudioProcessorEditor::trackSelectionChanged()
 
 void NewProjectAudioProcessorEditor::timerCallback()
 {
+    TraceScope trace("editor timer", "ui");
+    
     updateTransportDisplay();
+    updateGP5ExportStatus();
+    checkAutosaveRecovery();
     
     // ===========================================================================
     // Editor Mode: Zeige leeren Tab mit Live-MIDI-Noten wenn keine Datei geladen
@@ -974,27 +955,33 @@ void NewProjectAudioProcessorEditor::timerCallback()
         }
         
         // Zeige aufgezeichnete Noten wenn Recording aktiv oder Aufnahmen vorhanden
-        auto recordedNotes = audioProcessor.getRecordedNotes();
-        if (!recordedNotes.empty())
+        if (hasRecordings)
         {
             // Während Recording: Zeige kombinierte Live-Ansicht
             // Nach Recording (Record deaktiviert): Zeige gewählten Track
-            if (isRecording || isRecordEnabled)
+            if ((isRecording || isRecordEnabled) && !audioRecordingActive)
+            {
+                // MIDI-Recording: zeige kombinierte Live-Aufnahme. Geänderte Takte werden
+                // direkt in den Track der View kopiert, fertige Takte bleiben stehen
+                if (tabView.getTrackGeneration() != recordedTabViewGeneration)
+                    recordedTabRevision = 0;   // View zeigt inzwischen einen anderen Track
+                if (audioProcessor.updateRecordedTabTrack(tabView.getTrackForEditing(), recordedTabRevision))
+                    tabView.trackChanged();
+                recordedTabViewGeneration = tabView.getTrackGeneration();
+                tabView.setEditorMode(true);
+            }
+            else
             {
                 // Im Audio-Modus während REC: Kein Live-Tab-Update (Overlay wird angezeigt)
-                if (!audioRecordingActive)
-                {
-                    // MIDI-Recording: zeige kombinierte Live-Aufnahme
-                    TabTrack recordedTrack = audioProcessor.getRecordedTabTrack();
-                    tabView.setTrack(recordedTrack);
-                    tabView.setEditorMode(true);
-                }
+                // Sonst: Der gewählte Track wird bereits durch trackSelectionChanged() gesetzt
+                // Timer soll nicht überschreiben!
+                recordedTabRevision = 0;
             }
-            // Sonst: Der gewählte Track wird bereits durch trackSelectionChanged() gesetzt
-            // Timer soll nicht überschreiben!
         }
         else
         {
+            recordedTabRevision = 0;
+            
             // Keine aufgenommenen Noten - leeren Track anzeigen
             if (!tabView.isEditorMode())
             {
@@ -1007,9 +994,9 @@ void NewProjectAudioProcessorEditor::timerCallback()
         // Live-MIDI-Noten aktualisieren (nur wenn kein Audio-Recording-Overlay aktiv)
         if (!audioRecordingActive && !audioTranscribing)
         {
-            auto midiNotes = audioProcessor.getLiveMidiNotes();
+            const auto analysis = audioProcessor.getLiveAnalysis();
             std::vector<TabViewComponent::LiveNote> liveNotes;
-            for (const auto& note : midiNotes)
+            for (const auto& note : analysis.notes)
             {
                 TabViewComponent::LiveNote ln;
                 ln.string = note.string;
@@ -1019,10 +1006,10 @@ void NewProjectAudioProcessorEditor::timerCallback()
                 liveNotes.push_back(ln);
             }
             tabView.setLiveNotes(liveNotes);
-            tabView.setLiveMutedStrings(audioProcessor.getLiveMutedStrings());
+            tabView.setLiveMutedStrings(analysis.mutedStrings);
             
             // Erkannten Akkordnamen anzeigen
-            tabView.setLiveChordName(audioProcessor.getDetectedChordName());
+            tabView.setLiveChordName(analysis.chordName);
         }
         
         // Auch im Editor-Modus: Playhead-Position aktualisieren und bei Start zum ersten Takt scrollen
@@ -1062,6 +1049,14 @@ void NewProjectAudioProcessorEditor::timerCallback()
             tabView.setEditorMode(false);
             tabView.setLiveNotes({});  // Clear live notes
         }
+        
+        // Fingersatz-Annotation im Hintergrund fortgeschritten → Track neu übernehmen
+        const auto annotationGeneration = audioProcessor.getSongAnnotationGeneration();
+        if (annotationGeneration != lastSongAnnotationGeneration)
+        {
+            lastSongAnnotationGeneration = annotationGeneration;
+            trackSelectionChanged();
+        }
     }
     
     bool isPlaying = audioProcessor.isHostPlaying();
@@ -1222,6 +1217,25 @@ void NewProjectAudioProcessorEditor::toggleSettingsPanel()
     }
 }
 
+void NewProjectAudioProcessorEditor::togglePerformanceHud()
+{
+    if (performanceHud != nullptr)
+    {
+        removeChildComponent(performanceHud.get());
+        performanceHud.reset();
+        return;
+    }
+    
+    performanceHud = std::make_unique<PerformanceHudComponent>(audioProcessor);
+    performanceHud->onClose = [this]() { togglePerformanceHud(); };
+    performanceHud->onPreferredHeightChanged = [this]()
+    {
+        performanceHud->setSize(performanceHud->getWidth(), performanceHud->getPreferredHeight());
+    };
+    performanceHud->setBounds(getWidth() - 500, 55, 490, performanceHud->getPreferredHeight());
+    addAndMakeVisible(performanceHud.get());
+}
+
 void NewProjectAudioProcessorEditor::saveButtonClicked()
 {
     // Popup-Menü mit Format-Auswahl
@@ -1359,28 +1373,10 @@ void NewProjectAudioProcessorEditor::showExportPanel()
     if (audioProcessor.isFileLoaded())
     {
         // Player-Modus: Konvertiere geladene Tracks zu TabTracks
+        // (aus dem Cache der Hintergrund-Annotation, die eigentliche Konvertierung macht der Export)
         const auto& loadedTracks = audioProcessor.getActiveTracks();
-        for (size_t i = 0; i < loadedTracks.size(); ++i)
-        {
-            if (audioProcessor.isUsingPTBParser())
-            {
-                tracks.push_back(audioProcessor.getPTBParser().convertToTabTrack(static_cast<int>(i)));
-            }
-            else if (audioProcessor.isUsingGP7Parser())
-            {
-                TabTrack t;
-                const auto& gp7Tracks = audioProcessor.getGP7Parser().getTracks();
-                t.name = gp7Tracks[static_cast<int>(i)].name;
-                t.stringCount = gp7Tracks[static_cast<int>(i)].stringCount;
-                t.tuning = gp7Tracks[static_cast<int>(i)].tuning;
-                t.measures = audioProcessor.getGP7Parser().convertToTabMeasures(static_cast<int>(i));
-                tracks.push_back(t);
-            }
-            else
-            {
-                tracks.push_back(audioProcessor.getGP5Parser().convertToTabTrack(static_cast<int>(i)));
-            }
-        }
+        for (int i = 0; i < loadedTracks.size(); ++i)
+            tracks.push_back(audioProcessor.getLoadedTabTrack(i));
         defaultTitle = audioProcessor.getActiveSongInfo().title;
         if (defaultTitle.isEmpty())
             defaultTitle = "Untitled";
@@ -1412,8 +1408,13 @@ void NewProjectAudioProcessorEditor::showExportPanel()
         [this](const juce::String& title, const std::vector<std::pair<juce::String, int>>& trackData) {
             doExportWithMetadata(title, trackData);
         },
-        // Cancel callback
+        // Cancel callback (bricht auch einen laufenden Export ab)
         [this]() {
+            if (audioProcessor.isExportingGP5())
+            {
+                audioProcessor.cancelGP5Export();
+                infoLabel.setText("GP5 export cancelled", juce::dontSendNotification);
+            }
             hideExportPanel();
         }
     );
@@ -1449,7 +1450,9 @@ void NewProjectAudioProcessorEditor::hideExportPanel()
 void NewProjectAudioProcessorEditor::doExportWithMetadata(const juce::String& title, 
     const std::vector<std::pair<juce::String, int>>& trackData)
 {
-    hideExportPanel();
+    // Panel bleibt offen und zeigt später den Fortschritt
+    if (audioProcessor.isExportingGP5())
+        return;
     
     // Create file chooser for GP5 save
     midiFileChooser = std::make_unique<juce::FileChooser>(
@@ -1470,27 +1473,85 @@ void NewProjectAudioProcessorEditor::doExportWithMetadata(const juce::String& ti
         {
             auto file = fc.getResult();
             
-            if (file != juce::File{})
+            if (file == juce::File{})
             {
-                // Ensure file has .gp5 extension
-                if (!file.hasFileExtension(".gp5"))
-                    file = file.withFileExtension(".gp5");
-                
-                bool success = audioProcessor.exportRecordingToGP5WithMetadata(
-                    file, savedTitle, savedTrackData);
-                
-                if (success)
-                {
-                    infoLabel.setText("GP5 saved: " + file.getFileName(), juce::dontSendNotification);
-                }
-                else
-                {
-                    infoLabel.setText("Error saving GP5 file!", juce::dontSendNotification);
-                }
+                hideExportPanel();
+                return;
+            }
+            
+            // Ensure file has .gp5 extension
+            if (!file.hasFileExtension(".gp5"))
+                file = file.withFileExtension(".gp5");
+            
+            // Konvertieren, Serialisieren und Schreiben laufen im Hintergrund,
+            // Fortschritt und Ergebnis holt timerCallback() ab
+            if (audioProcessor.startGP5Export(file, savedTitle, savedTrackData))
+            {
+                if (exportPanel)
+                    exportPanel->setExporting(file.getFileName());
+                infoLabel.setText("Exporting GP5: " + file.getFileName() + "...", juce::dontSendNotification);
+            }
+            else
+            {
+                hideExportPanel();
+                infoLabel.setText("GP5 export already running!", juce::dontSendNotification);
             }
         });
 }
 
+void NewProjectAudioProcessorEditor::updateGP5ExportStatus()
+{
+    if (audioProcessor.isExportingGP5())
+    {
+        if (exportPanel)
+            exportPanel->setProgress(audioProcessor.getGP5ExportProgress());
+        return;
+    }
+    
+    juce::String message;
+    const auto result = audioProcessor.takeGP5ExportResult(message);
+    if (result == GP5ExportJob::Status::succeeded)
+    {
+        hideExportPanel();
+        infoLabel.setText("GP5 saved: " + message, juce::dontSendNotification);
+    }
+    else if (result == GP5ExportJob::Status::failed)
+    {
+        hideExportPanel();
+        infoLabel.setText("Error saving GP5 file: " + message, juce::dontSendNotification);
+    }
+}
+
+void NewProjectAudioProcessorEditor::checkAutosaveRecovery()
+{
+    if (autosavePromptShown || !audioProcessor.hasAutosaveRecovery())
+        return;
+    
+    autosavePromptShown = true;
+    auto options = juce::MessageBoxOptions()
+        .withIconType(juce::MessageBoxIconType::QuestionIcon)
+        .withTitle("Recover")
+        .withMessage("This project was not closed properly.\n\n"
+                     "Recover the recordings and tab edits that were autosaved after the last save?")
+        .withButton("Recover")
+        .withButton("Discard")
+        .withAssociatedComponent(this);
+    juce::AlertWindow::showAsync(options, [this](int result) {
+        if (result == 1)  // Recover
+        {
+            if (audioProcessor.recoverAutosave())
+            {
+                refreshFromProcessor();
+                infoLabel.setText("Recovered autosaved recordings and edits", juce::dontSendNotification);
+            }
+        }
+        else
+        {
+            audioProcessor.discardAutosaveRecovery();
+        }
+    });
+}
+
 void NewProjectAudioProcessorEditor::noteEditToggled()
 {
     bool editingEnabled = noteEditButton.getToggleState();
@@ -1533,6 +1594,19 @@ void NewProjectAudioProcessorEditor::noteEditToggled()
     }
 }
 
+int NewProjectAudioProcessorEditor::replayTabEditJournal(int trackIndex, uint64_t knownSequence)
+{
+    // Edits und ersetzte Takte (Undo/Redo) seit knownSequence in die Ansicht spielen;
+    // ist die Lücke nicht mehr im Journal, den Track komplett neu laden
+    std::vector<TabEdit> applied;
+    if (audioProcessor.getTabEditJournal().replaySince(trackIndex, knownSequence,
+                                                       [&](const TabEdit& edit) { applied.push_back(edit); }))
+        tabView.applyEdits(applied);
+    else if (audioProcessor.hasEditedTrack(trackIndex))
+        tabView.setTrack(audioProcessor.getEditedTrack(trackIndex));
+    return (int) applied.size();
+}
+
 void NewProjectAudioProcessorEditor::reoptimizeAndRefreshNotes()
 {
     // Only reoptimize if there are recorded notes
@@ -12,6 +12,7 @@
 #include "TabViewComponent.h"
 #include "TrackSettingsComponent.h"
 #include "ExportPanelComponent.h"
+#include "PerformanceHudComponent.h"
 #include <juce_gui_basics/juce_gui_basics.h>
 
 //==============================================================================
@@ -111,6 +112,14 @@ private:
     void showExportPanel();
     void hideExportPanel();
     void doExportWithMetadata(const juce::String& title, const std::vector<std::pair<juce::String, int>>& trackData);
+    void updateGP5ExportStatus();  // Fortschritt/Ergebnis des Hintergrund-Exports (Timer)
+    void checkAutosaveRecovery();  // Nach Absturz: Autosave-Stand anbieten (Timer)
+    bool autosavePromptShown = false;
+    
+    // 9c. Performance-HUD (processBlock-Laufzeiten, Overlay)
+    juce::TextButton perfButton { "Perf" };
+    std::unique_ptr<PerformanceHudComponent> performanceHud;
+    void togglePerformanceHud();
 
     // 10. Hilfsfunktionen
     void loadButtonClicked();
@@ -126,6 +135,7 @@ private:
     void doSaveMidi();
     void doSaveGp5();
     void noteEditToggled();
+    int replayTabEditJournal(int trackIndex, uint64_t knownSequence);  // Journal in die Tab-Ansicht, liefert Anzahl
     void reoptimizeAndRefreshNotes();  // Recalculate recorded notes after settings change
     
     // 11. State
@@ -134,6 +144,9 @@ private:
     bool wasPlaying = false;            // Letzter Play-Status
     bool wasRecording = false;          // Letzter Recording-Status (für UI-Update)
     bool hadRecordedNotes = false;      // Ob Aufnahmen vorhanden waren (für UI-Update)
+    uint32_t lastSongAnnotationGeneration = 0;  // Stand der Fingersatz-Annotation (für UI-Update)
+    uint32_t recordedTabRevision = 0;           // Stand der angezeigten Live-Aufnahme (0 = neu setzen)
+    uint32_t recordedTabViewGeneration = 0;     // TabView-Track, in den die Live-Aufnahme kopiert wurde
 
     NewProjectAudioProcessor& audioProcessor;
 
@@ -102,81 +102,30 @@ static bool fixMidiFileFormat(const juce::File& midiFile)
 }
 
 //==============================================================================
-// Helper: Berechnet die Dauer eines GP5-Beats in Viertelnoten (Quarter Notes)
+// Helper: Schreibt eine MIDI-Datei (480 Ticks/Viertel). Einzelne Spuren werden
+// als Format 0 gespeichert (JUCE schreibt immer Format 1)
 //==============================================================================
-static double getGP5BeatDurationInQuarters(const GP5Beat& beat)
+static bool writeMidiFile(const juce::MidiFile& midiFile, const juce::File& outputFile)
 {
-    // GP5 duration: -2=whole, -1=half, 0=quarter, 1=eighth, 2=sixteenth, 3=32nd
-    // Formel: Dauer in Vierteln = 4 / (2^(duration + 2))
-    // -2 -> 4/1 = 4.0 (ganze Note)
-    // -1 -> 4/2 = 2.0 (halbe Note)
-    //  0 -> 4/4 = 1.0 (Viertelnote)
-    //  1 -> 4/8 = 0.5 (Achtelnote)
-    //  2 -> 4/16= 0.25 (Sechzehntelnote)
-    //  3 -> 4/32= 0.125 (Zweiunddreißigstelnote)
-    
-    double baseDuration = 4.0 / std::pow(2.0, beat.duration + 2);
-    
-    // Punktierung: +50% der Dauer
-    if (beat.isDotted)
-        baseDuration *= 1.5;
-    
-    // Tuplet (z.B. Triole: 3 Noten in der Zeit von 2)
-    if (beat.tupletN > 0)
-    {
-        // Typische Tuplets: 3 (Triole), 5, 6, 7, etc.
-        // Eine Triole bedeutet: 3 Noten in der Zeit von 2
-        // Allgemein: N Noten in der Zeit von floor(N * 2/3) für ungerade N
-        // Für Standardfälle:
-        switch (beat.tupletN)
-        {
-            case 3:  baseDuration *= (2.0 / 3.0); break;  // Triole: 3 in 2
-            case 5:  baseDuration *= (4.0 / 5.0); break;  // Quintole: 5 in 4
-            case 6:  baseDuration *= (4.0 / 6.0); break;  // Sextole: 6 in 4
-            case 7:  baseDuration *= (4.0 / 7.0); break;  // Septole: 7 in 4
-            case 9:  baseDuration *= (8.0 / 9.0); break;  // 9 in 8
-            case 10: baseDuration *= (8.0 / 10.0); break; // 10 in 8
-            case 11: baseDuration *= (8.0 / 11.0); break; // 11 in 8
-            case 12: baseDuration *= (8.0 / 12.0); break; // 12 in 8
-            case 13: baseDuration *= (8.0 / 13.0); break; // 13 in 8
-            default: break;  // Kein Tuplet oder unbekannt
-        }
-    }
-    
-    return baseDuration;
-}
-
-//==============================================================================
-// Helper: Findet den Beat-Index und die relative Position für eine Beat-Position im Takt
-// Gibt den Index des Beats zurück, der bei beatInMeasure aktiv ist
-// beatStartTime wird auf die Startzeit des gefundenen Beats gesetzt
-//==============================================================================
-static int findBeatAtPosition(const juce::Array<GP5Beat>& beats, double beatInMeasure, double& beatStartTime)
-{
-    double cumulativeTime = 0.0;
+    outputFile.deleteFile();
     
-    for (int i = 0; i < beats.size(); ++i)
     {
-        double beatDuration = getGP5BeatDurationInQuarters(beats[i]);
+        // Scope für FileOutputStream - muss geschlossen werden bevor fixMidiFileFormat die Datei öffnet
+        juce::FileOutputStream outputStream(outputFile);
         
-        if (beatInMeasure < cumulativeTime + beatDuration)
-        {
-            beatStartTime = cumulativeTime;
-            return i;
-        }
+        if (!outputStream.openedOk())
+            return false;
+        
+        if (!midiFile.writeTo(outputStream))
+            return false;
         
-        cumulativeTime += beatDuration;
+        outputStream.flush();
     }
     
-    // Falls wir über das Ende hinaus sind, letzten Beat zurückgeben
-    if (beats.size() > 0)
-    {
-        beatStartTime = cumulativeTime - getGP5BeatDurationInQuarters(beats[beats.size() - 1]);
-        return beats.size() - 1;
-    }
+    if (midiFile.getNumTracks() == 1)
+        fixMidiFileFormat(outputFile);
     
-    beatStartTime = 0.0;
-    return 0;
+    return true;
 }
 
 //==============================================================================
@@ -207,16 +156,33 @@ NewProjectAudioProcessor::NewProjectAudioProcessor()
     // Initialize per-track beat tracking
     lastProcessedBeatPerTrack.resize(maxTracks, -1);
     lastProcessedMeasurePerTrack.resize(maxTracks, -1);
+    publishedEditedTracks = std::make_shared<const EditedTracksSnapshot>();
+    processorMemory.setBytes(sizeof(*this) + MemoryAccounting::bytesOf(lastProcessedBeatPerTrack)
+                             + MemoryAccounting::bytesOf(lastProcessedMeasurePerTrack));
     
-    // Load chord finger database from embedded BinaryData
-    {
-        chordFingerDB.loadFromBinaryData(BinaryData::chordfingers_csv, BinaryData::chordfingers_csvSize);
-        DBG("ChordFingerDB loaded: " << chordFingerDB.getEntryCount() << " entries from BinaryData");
-    }
+    // Processor und Editor leben im Message-Thread (Parser, Editor-Timer im Trace)
+    TraceRecorder::nameCurrentThread("message");
+    
+    // Chord finger database is compiled in (ChordFingerData.h, generated from CSV)
+    DBG("ChordFingerDB: " << chordFingerDB.getEntryCount() << " entries");
+    
+    // Live-Akkordanalyse läuft ereignisgesteuert im Hintergrund
+    liveChordAnalyzer.start();
+    
+    // Audio-Thread meldet Arbeit nur per Flag, der Timer holt sie im Message-Thread ab
+    startTimerHz(30);
+    
+    // Neue Session: eigenes Journal, setStateInformation übernimmt ggf. die gespeicherte ID
+    sessionAutosave.start(SessionAutosave::createSessionId(), false);
 }
 
 NewProjectAudioProcessor::~NewProjectAudioProcessor()
 {
+    stopTimer();
+    liveChordAnalyzer.stop();
+    gp5ExportJob.cancel();
+    songAnnotator.cancel();
+    sessionAutosave.stop(true);  // sauber beendet - Journal wird nicht mehr gebraucht
 }
 
 //==============================================================================
@@ -292,6 +258,24 @@ void NewProjectAudioProcessor::prepareToPlay (double sampleRate, int samplesPerB
     
     // Polyphonic Audio Transcriber (BasicPitch) vorbereiten
     audioTranscriber.prepare(sampleRate, samplesPerBlock);
+    
+    // Block-Deadline für die Laufzeitmessung
+    audioThreadProfiler.prepare(sampleRate, samplesPerBlock);
+    
+    // Offline-Strom für den nächsten Bounce (Host-Thread, nicht im Audio-Thread).
+    // Hat setNonRealtime schon gerendert, nicht doppelt.
+    offlineRender.reset();
+    offlineNextBeat = -1.0;
+    if (isNonRealtime())
+    {
+        bool hasPending = false;
+        {
+            std::lock_guard<std::mutex> lock(offlineRenderMutex);
+            hasPending = pendingOfflineRender != nullptr;
+        }
+        if (!hasPending)
+            prepareOfflineRender();
+    }
 }
 
 void NewProjectAudioProcessor::releaseResources()
@@ -345,10 +329,14 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
 
     // Temporärer Buffer für neue MIDI-Events
     juce::MidiBuffer generatedMidi;
+    
+    // Laufzeitmessung (Performance-HUD), Offline-Blöcke werden nicht gezählt
+    audioThreadProfiler.beginBlock(buffer.getNumSamples(), !isNonRealtime());
 
     // =========================================================================
     // DAW Synchronisation - Hole Position vom Host
     // =========================================================================
+    auto hostSyncSection = audioThreadProfiler.beginSection(AudioThreadProfiler::hostSync);
     if (auto* playHead = getPlayHead())
     {
         if (auto posInfo = playHead->getPosition())
@@ -380,7 +368,25 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
             }
         }
     }
+    audioThreadProfiler.endSection(hostSyncSection);
 
+    // =========================================================================
+    // Offline-Bounce/Freeze: vorgerenderten Event-Strom blockweise kopieren.
+    // Live-Input, Audio-to-MIDI, Transkription und Meter-Zeiten entfallen.
+    // =========================================================================
+    if (isNonRealtime() && fileLoaded && midiOutputEnabled.load()
+        && renderOfflineBlock(buffer.getNumSamples(), generatedMidi))
+    {
+        midiMessages.addEvents(generatedMidi, 0, buffer.getNumSamples(), 0);
+        
+        for (auto i = 0; i < totalNumOutputChannels; ++i)
+            buffer.clear (i, 0, buffer.getNumSamples());
+        return;
+    }
+    
+    // Zurück in Echtzeit: offenen Offline-Strom beenden
+    releaseOfflineRender(generatedMidi);
+    
     // =========================================================================
     // Auto-detect Input Mode: Sidechain aktiv → Audio, sonst MIDI/Player
     // =========================================================================
@@ -401,6 +407,8 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
     // =========================================================================
     if (inputMode.load() == static_cast<int>(InputMode::Audio))
     {
+        AudioThreadProfiler::ScopedSection profile(audioThreadProfiler, AudioThreadProfiler::audioToMidi);
+        
         bool isPlaying = hostIsPlaying.load();
         bool isRecArmed = hostIsRecording.load();
         bool isManualRec = recordingEnabled.load();
@@ -484,15 +492,13 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
             
             if (audioTranscriber.getRecordedDurationSeconds() > 0.1)
             {
-                // Vorher aufgenommene Noten löschen (könnten Reste von vorher sein)
-                {
-                    std::lock_guard<std::mutex> recLock(recordingMutex);
-                    recordedNotes.clear();
-                    activeRecordingNotes.clear();
-                }
+                // Vorher aufgenommene Noten löschen (könnten Reste von vorher sein) -
+                // im Message-Thread, bevor dort die Transkription eingefügt wird (der Timer pollt das Flag)
+                recordingClearPending.store(true);
                 
                 DBG("Audio recording stopped - starting BasicPitch transcription ("
                     << juce::String(audioTranscriber.getRecordedDurationSeconds(), 1) << "s audio)");
+                transcriptionStartBeat.store(audioRecordingStartBeat);
                 audioTranscriber.startTranscription();
             }
             audioRecordingStartSet = false;
@@ -500,19 +506,24 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
         
         wasRecordingAudio = shouldRecordAudio;
         
-        // Poll: Wenn Transkription fertig → Noten in Tab einfügen
-        if (audioTranscriber.hasResults())
-        {
-            insertTranscribedNotesIntoTab();
-        }
+        // Fertige Transkription fragt der Timer im Message-Thread ab
+        // (Optimierung der ganzen Aufnahme allokiert und darf hier nicht laufen)
     }
 
     // =========================================================================
     // MIDI Input - Verarbeite eingehende MIDI-Noten für Tab-Anzeige
     // =========================================================================
     {
+        AudioThreadProfiler::ScopedSection profile(audioThreadProfiler, AudioThreadProfiler::liveMidi);
         std::lock_guard<std::mutex> lock(liveMidiMutex);
         
+        // Handposition aus der letzten Akkord-Analyse übernehmen (Trägheit für Folgenoten)
+        int analysedHandFret = liveChordAnalyzer.takeHandFret();
+        if (analysedHandFret != LiveChordAnalyzer::noHandFret)
+            lastPlayedFret = analysedHandFret;
+        
+        bool heldNotesChanged = false;
+        
         double currentBeat = hostPositionBeats.load();
         bool isPlaying = hostIsPlaying.load();
         bool isRecArmed = hostIsRecording.load();
@@ -536,12 +547,11 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
                 
                 LiveMidiNote tabNote = midiNoteToTab(midiNote, velocity);
                 liveMidiNotes[midiNote] = tabNote;
+                heldNotesChanged = true;
                 
                 // Recording: Start einer neuen Note
                 if (shouldRecord)
                 {
-                    std::lock_guard<std::mutex> recLock(recordingMutex);
-                    
                     // Beim ersten Note speichern wir den Start-Beat für die Bar-Synchronisation
                     // Wir runden auf den Anfang des aktuellen Takts
                     if (!recordingStartSet)
@@ -553,7 +563,7 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
                         recordingStartSet = true;
                         // Speichere die aktuelle FretPosition für die Aufnahme
                         recordingFretPosition = getFretPosition();
-                        DBG("Recording started at beat " << currentBeat << ", measure start: " << recordingStartBeat << ", fret position: " << static_cast<int>(recordingFretPosition));
+                        DBG("Recording started at beat " << currentBeat << ", measure start: " << recordingStartBeat.load() << ", fret position: " << static_cast<int>(recordingFretPosition.load()));
                     }
                     
                     RecordedNote recNote;
@@ -593,14 +603,16 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
                     lastFingerUsed = recNote.fingerNumber;
                     lastFingerString = recNote.string;
                     
-                    recordedNotes.push_back(recNote);
-                    activeRecordingNotes[midiNote] = recordedNotes.size() - 1;
+                    // Allokations- und lockfrei in den Capture-Puffer; der Store wird außerhalb des Audio-Threads befüllt
+                    recordingCapture.beginNote(recNote);
+                    if (recordingCapture.needsFlush())
+                        requestMessageThreadWork();
                 }
             }
             else if (msg.isNoteOff())
             {
                 int midiNote = msg.getNoteNumber();
-                liveMidiNotes.erase(midiNote);
+                heldNotesChanged |= (liveMidiNotes.erase(midiNote) > 0);
                 
                 // Reset last played position wenn keine Noten mehr gehalten werden
                 if (liveMidiNotes.empty())
@@ -612,24 +624,14 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
                 // Recording: Note beenden
                 if (hostIsRecording.load())
                 {
-                    std::lock_guard<std::mutex> recLock(recordingMutex);
-                    auto it = activeRecordingNotes.find(midiNote);
-                    if (it != activeRecordingNotes.end())
-                    {
-                        if (it->second < recordedNotes.size())
-                        {
-                            recordedNotes[it->second].endBeat = currentBeat;
-                            recordedNotes[it->second].isActive = false;
-                        }
-                        activeRecordingNotes.erase(it);
-                    }
+                    recordingCapture.endNote(midiNote, currentBeat);
+                    requestMessageThreadWork();
                 }
             }
             else if (msg.isPitchWheel())
             {
                 if (shouldRecord)
                 {
-                    std::lock_guard<std::mutex> recLock(recordingMutex);
                     int channel = msg.getChannel();
                     int wheelValue = msg.getPitchWheelValue();
                     
@@ -638,44 +640,20 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
                     int bendVal = (int)((wheelValue - 8192.0) / 8192.0 * 200.0);
                     if (std::abs(bendVal) < 10) bendVal = 0; // Noise threshold (10 cents)
                     
-                    for (auto& [note, idx] : activeRecordingNotes)
-                    {
-                        if (idx < recordedNotes.size())
-                        {
-                            auto& recNote = recordedNotes[idx];
-                            if (recNote.isActive && recNote.midiChannel == channel)
-                            {
-                                // Only store non-zero bend events to keep curve clean
-                                if (bendVal != 0 || !recNote.rawBendEvents.empty())
-                                    recNote.rawBendEvents.push_back({currentBeat, bendVal});
-                                float valSemis = std::abs(bendVal) / 100.0f;
-                                if (valSemis > recNote.maxBendValue)
-                                    recNote.maxBendValue = valSemis;
-                            }
-                        }
-                    }
+                    recordingCapture.addBend(channel, currentBeat, bendVal);
+                    if (recordingCapture.needsFlush())
+                        requestMessageThreadWork();
                 }
             }
             else if (msg.isController())
             {
                if (shouldRecord && msg.getControllerNumber() == 1) // Modulation Wheel
                {
-                    std::lock_guard<std::mutex> recLock(recordingMutex);
                     int channel = msg.getChannel();
                     int val = msg.getControllerValue();
                     
                     if (val > 20) // Threshold for Vibrato
-                    {
-                         for (auto& [note, idx] : activeRecordingNotes)
-                        {
-                            if (idx < recordedNotes.size())
-                            {
-                                auto& recNote = recordedNotes[idx];
-                                if (recNote.isActive && recNote.midiChannel == channel)
-                                   recNote.hasVibrato = true;
-                            }
-                        }
-                    }
+                        recordingCapture.setVibrato(channel);
                }
             }
             else if (msg.isProgramChange())
@@ -692,6 +670,7 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
             }
             else if (msg.isAllNotesOff() || msg.isAllSoundOff())
             {
+                heldNotesChanged |= !liveMidiNotes.empty();
                 liveMidiNotes.clear();
                 
                 // Reset last played position für Kostenfunktion
@@ -700,16 +679,8 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
                 // Recording: Alle aktiven Noten beenden
                 if (hostIsRecording.load())
                 {
-                    std::lock_guard<std::mutex> recLock(recordingMutex);
-                    for (auto& [note, idx] : activeRecordingNotes)
-                    {
-                        if (idx < recordedNotes.size())
-                        {
-                            recordedNotes[idx].endBeat = currentBeat;
-                            recordedNotes[idx].isActive = false;
-                        }
-                    }
-                    activeRecordingNotes.clear();
+                    recordingCapture.endAllNotes(currentBeat);
+                    requestMessageThreadWork();
                 }
             }
         }
@@ -718,11 +689,16 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
         // Recording: Die string/fret Werte werden bereits korrekt von midiNoteToTab()
         // berechnet und in recordedNotes gespeichert. Keine weitere Optimierung nötig.
         // =====================================================================
+        
+        // Akkord-/Fingersatz-Analyse nur bei geänderten gehaltenen Noten (Hintergrund-Thread)
+        if (heldNotesChanged)
+            postHeldNotesToAnalyzer();
     }
     
     // =========================================================================
     // MIDI Output - Mit Echtzeit-Bend-Interpolation
     // =========================================================================
+    auto noteOutputSection = audioThreadProfiler.beginSection(AudioThreadProfiler::noteOutput);
     if (fileLoaded && midiOutputEnabled.load())
     {
         bool isPlaying = hostIsPlaying.load();
@@ -759,137 +735,7 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
             // STEP 1: Update ALL active bends - real-time pitch bend interpolation
             // This runs on EVERY processBlock call, not just on beat changes!
             // =====================================================================
-            for (int b = 0; b < activeBendCount; ++b)
-            {
-                ActiveBend& bend = activeBends[b];
-                
-                // Calculate position in bend (0.0 to 1.0)
-                double elapsed = currentBeat - bend.startBeat;
-                double progress = (bend.durationBeats > 0) ? (elapsed / bend.durationBeats) : 1.0;
-                
-                // Remove bend if note duration exceeded
-                if (progress >= 1.0)
-                {
-                    // Reset pitch wheel at end of bend
-                    generatedMidi.addEvent(juce::MidiMessage::pitchWheel(bend.midiChannel, 8192), 0);
-                    // Remove by swapping with last
-                    activeBends[b] = activeBends[activeBendCount - 1];
-                    activeBendCount--;
-                    b--;  // Re-check this index
-                    continue;
-                }
-                
-                progress = juce::jlimit(0.0, 1.0, progress);
-                
-                // Convert progress (0-1) to GP5 position scale (0-60)
-                int positionInBend = (int)(progress * 60.0);
-                
-                // Interpolate bend value from bend points
-                int bendValue = 0;  // Value in 1/100 semitones
-                int vibratoValue = 0; // 0=none, 1=fast, 2=avg, 3=slow
-                
-                if (bend.pointCount >= 2)
-                {
-                    // Find the two surrounding points
-                    int prevIdx = 0;
-                    int nextIdx = bend.pointCount - 1;
-                    
-                    for (int i = 0; i < bend.pointCount; ++i)
-                    {
-                        if (bend.points[i].position <= positionInBend)
-                            prevIdx = i;
-                    }
-                    for (int i = bend.pointCount - 1; i >= 0; --i)
-                    {
-                        if (bend.points[i].position >= positionInBend)
-                            nextIdx = i;
-                    }
-                    
-                    if (nextIdx < prevIdx) nextIdx = prevIdx;
-                    
-                    const auto& prevPoint = bend.points[prevIdx];
-                    const auto& nextPoint = bend.points[nextIdx];
-                    
-                    // Use vibrato from the starting point of the segment
-                    vibratoValue = prevPoint.vibrato;
-                    
-                    if (prevPoint.position == nextPoint.position)
-                    {
-                        bendValue = prevPoint.value;
-                    }
-                    else
-                    {
-                        // Linear interpolation between points
-                        double t = (double)(positionInBend - prevPoint.position) / 
-                                   (double)(nextPoint.position - prevPoint.position);
-                        t = juce::jlimit(0.0, 1.0, t);
-                        bendValue = (int)(prevPoint.value + t * (nextPoint.value - prevPoint.value));
-                    }
-                }
-                else if (bend.pointCount == 1)
-                {
-                    vibratoValue = bend.points[0].vibrato;
-                    
-                    // Single point - use progress to interpolate based on bend type
-                    if (bend.bendType == 1)  // Normal bend: 0 -> target
-                        bendValue = (int)(bend.points[0].value * progress);
-                    else if (bend.bendType == 2)  // Bend+Release: 0 -> target -> 0
-                    {
-                        if (progress < 0.5)
-                            bendValue = (int)(bend.points[0].value * (progress * 2.0));
-                        else
-                            bendValue = (int)(bend.points[0].value * ((1.0 - progress) * 2.0));
-                    }
-                    else if (bend.bendType == 3 || bend.bendType == 5)  // Release: target -> 0
-                        bendValue = (int)(bend.points[0].value * (1.0 - progress));
-                    else
-                        bendValue = bend.points[0].value;
-                }
-                else
-                {
-                    // No points but has bend - use simple interpolation based on type
-                    if (bend.bendType == 1)  // Normal bend: 0 -> target
-                        bendValue = (int)(bend.maxBendValue * progress);
-                    else if (bend.bendType == 2)  // Bend+Release: 0 -> target -> 0
-                    {
-                        if (progress < 0.5)
-                            bendValue = (int)(bend.maxBendValue * (progress * 2.0));
-                        else
-                            bendValue = (int)(bend.maxBendValue * ((1.0 - progress) * 2.0));
-                    }
-                    else if (bend.bendType == 3 || bend.bendType == 5)  // Release: target -> 0
-                        bendValue = (int)(bend.maxBendValue * (1.0 - progress));
-                    else
-                        bendValue = bend.maxBendValue;
-                }
-                
-                // === Apply Vibrato Modulation ===
-                if (vibratoValue > 0)
-                {
-                   // Approximate 5Hz vibrato
-                    double vibDepth = 0.0; // In 1/100 semitones
-                    if (vibratoValue == 1) vibDepth = 25.0;  // +/- 0.25 semi (Fast)
-                    else if (vibratoValue == 2) vibDepth = 50.0;  // +/- 0.50 semi (Average)
-                    else if (vibratoValue == 3) vibDepth = 100.0; // +/- 1.00 semi (Slow/Wide)
-                    
-                    // Use measure position for phase to keep it continuous
-                    double phase = currentBeat * 30.0; // Approx speed
-                    bendValue += (int)(std::sin(phase) * vibDepth);
-                }
-
-                // Convert bend value to MIDI pitch wheel
-                // ±2 semitone range: 4096 per semitone
-                constexpr double unitsPerSemitone = 8192.0 / 2.0;
-                int pitchBend = 8192 + (int)((bendValue / 100.0) * unitsPerSemitone);
-                pitchBend = juce::jlimit(0, 16383, pitchBend);
-                
-                // Send if changed (lower threshold for smoother bends)
-                if (std::abs(pitchBend - bend.lastSentPitchBend) > 50)
-                {
-                    generatedMidi.addEvent(juce::MidiMessage::pitchWheel(bend.midiChannel, pitchBend), 0);
-                    bend.lastSentPitchBend = pitchBend;
-                }
-            }
+            updateActiveBends(currentBeat, generatedMidi);
             
             // =====================================================================
             // STEP 2: Process new notes and send MIDI
@@ -912,7 +758,7 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
             
             for (int m = 0; m < measureHeaders.size(); ++m)
             {
-                double measureLength = measureHeaders[m].numerator * (4.0 / measureHeaders[m].denominator);
+                double measureLength = SongEventRenderer::measureLength(measureHeaders[m].numerator, measureHeaders[m].denominator);
                 if (currentBeat < cumulativeBeat + measureLength)
                 {
                     measureIndex = m;
@@ -929,6 +775,9 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
             // Iteriere über Tracks
             int numTracks = juce::jmin((int)tracks.size(), maxTracks);
             
+            // Editierte Tracks: veröffentlichter Stand, nie auf editedTracksMutex warten
+            const auto edited = getEditedTracksSnapshot();
+            
             for (int trackIdx = 0; trackIdx < numTracks; ++trackIdx)
             {
                 bool isMuted = isTrackMuted(trackIdx);
@@ -937,362 +786,70 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
                 if (isMuted || (anySoloActive && !isSolo))
                     continue;
                 
-                // =============================================================
-                // CHECK FOR EDITED TRACK: If the user edited notes (pitch, 
-                // duration, position, delete), use the TabTrack data instead
-                // of the original parser data for MIDI output.
-                // =============================================================
-                if (hasEditedTrack(trackIdx))
-                {
-                    const auto& editTrack = getEditedTrack(trackIdx);
-                    int midiChannel = getTrackMidiChannel(trackIdx);
-                    int volumeScale = getTrackVolume(trackIdx);
-                    int pan = getTrackPan(trackIdx);
-                    
-                    // Find the measure at the current position
-                    // For loaded files, measureIndex is sequential (0-based)
-                    if (measureIndex < 0 || measureIndex >= editTrack.measures.size())
-                        continue;
-                    
-                    const auto& etMeasure = editTrack.measures[measureIndex];
-                    const auto& etBeats = etMeasure.beats;
-                    
-                    if (etBeats.size() == 0)
-                        continue;
-                    
-                    // Find current beat using TabBeat duration
-                    double etBeatStartTime = 0.0;
-                    int etBeatIndex = 0;
-                    for (int b = 0; b < etBeats.size(); ++b)
-                    {
-                        double dur = etBeats[b].getDurationInQuarters();
-                        if (beatInMeasure < etBeatStartTime + dur)
-                        {
-                            etBeatIndex = b;
-                            break;
-                        }
-                        etBeatStartTime += dur;
-                        etBeatIndex = b;
-                    }
-                    
-                    if (measureIndex != lastProcessedMeasurePerTrack[trackIdx] ||
-                        etBeatIndex != lastProcessedBeatPerTrack[trackIdx])
-                    {
-                        // Stop all notes on this channel
-                        if (activeNotesPerChannel.count(midiChannel))
-                        {
-                            for (int note : activeNotesPerChannel[midiChannel])
-                                generatedMidi.addEvent(juce::MidiMessage::noteOff(midiChannel, note), 0);
-                            activeNotesPerChannel[midiChannel].clear();
-                        }
-                        
-                        // Reset pitch wheel if no active bends
-                        bool hasActiveBendOnChannel = false;
-                        for (int b = 0; b < activeBendCount; ++b)
-                        {
-                            if (activeBends[b].midiChannel == midiChannel)
-                            {
-                                hasActiveBendOnChannel = true;
-                                break;
-                            }
-                        }
-                        if (!hasActiveBendOnChannel)
-                            generatedMidi.addEvent(juce::MidiMessage::pitchWheel(midiChannel, 8192), 0);
-                        
-                        const auto& etBeat = etBeats[etBeatIndex];
-                        
-                        if (!etBeat.isRest)
-                        {
-                            generatedMidi.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 10, pan), 0);
-                            
-                            // Calculate beat duration for bend/timing
-                            double etBeatDuration = etBeat.getDurationInQuarters();
-                            
-                            for (const auto& tabNote : etBeat.notes)
-                            {
-                                if (tabNote.fret < 0 || tabNote.isTied)
-                                    continue;
-                                
-                                // Calculate MIDI note
-                                int midiNote = 0;
-                                if (tabNote.midiNote > 0)
-                                    midiNote = tabNote.midiNote;
-                                else if (tabNote.string >= 0 && tabNote.string < editTrack.tuning.size())
-                                    midiNote = editTrack.tuning[tabNote.string] + tabNote.fret;
-                                else if (tabNote.string < 6)
-                                {
-                                    const int defaultTuning[] = { 64, 59, 55, 50, 45, 40 };
-                                    midiNote = defaultTuning[tabNote.string] + tabNote.fret;
-                                }
-                                
-                                if (midiNote <= 0 || midiNote >= 128)
-                                    continue;
-                                
-                                // Velocity with effects
-                                int velocity = tabNote.velocity > 0 ? tabNote.velocity : 95;
-                                if (tabNote.effects.ghostNote) velocity = 50;
-                                if (tabNote.effects.accentuatedNote) velocity = 115;
-                                if (tabNote.effects.heavyAccentuatedNote) velocity = 127;
-                                if (tabNote.effects.hammerOn) velocity = juce::jmax(50, velocity - 15);
-                                velocity = (velocity * volumeScale) / 100;
-                                velocity = juce::jlimit(1, 127, velocity);
-                                
-                                // Expression controllers
-                                if (tabNote.effects.vibrato || tabNote.effects.wideVibrato)
-                                    generatedMidi.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 1, 80), 0);
-                                if (tabNote.effects.hammerOn)
-                                    generatedMidi.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 68, 127), 0);
-                                if (tabNote.effects.slideType != SlideType::None)
-                                {
-                                    generatedMidi.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 65, 127), 0);
-                                    generatedMidi.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 5, 64), 0);
-                                }
-                                
-                                // Bend handling
-                                if (tabNote.effects.bend && tabNote.effects.bendValue != 0.0f)
-                                {
-                                    int bendVal100 = (int)(tabNote.effects.bendValue * 100.0f);
-                                    constexpr double unitsPerSemitone = 8192.0 / 2.0;
-                                    int maxPitchBend = 8192 + (int)((bendVal100 / 100.0) * unitsPerSemitone);
-                                    maxPitchBend = juce::jlimit(0, 16383, maxPitchBend);
-                                    int initialPitchBend = 8192;
-                                    
-                                    switch (tabNote.effects.bendType)
-                                    {
-                                        case 1: case 2: initialPitchBend = 8192; break;
-                                        case 3: case 5: initialPitchBend = maxPitchBend; break;
-                                        case 4: initialPitchBend = maxPitchBend; break;
-                                        default: initialPitchBend = 8192; break;
-                                    }
-                                    
-                                    generatedMidi.addEvent(juce::MidiMessage::pitchWheel(midiChannel, initialPitchBend), 0);
-                                    
-                                    if (tabNote.effects.bendType != 4 && activeBendCount < maxActiveBends)
-                                    {
-                                        ActiveBend& newBend = activeBends[activeBendCount++];
-                                        newBend.midiChannel = midiChannel;
-                                        newBend.midiNote = midiNote;
-                                        newBend.startBeat = currentBeat;
-                                        newBend.durationBeats = etBeatDuration;
-                                        newBend.bendType = tabNote.effects.bendType;
-                                        newBend.maxBendValue = bendVal100;
-                                        newBend.pointCount = std::min((int)tabNote.effects.bendPoints.size(), 16);
-                                        for (int i = 0; i < newBend.pointCount; ++i)
-                                        {
-                                            newBend.points[i].position = tabNote.effects.bendPoints[i].position;
-                                            newBend.points[i].value = tabNote.effects.bendPoints[i].value;
-                                            newBend.points[i].vibrato = tabNote.effects.bendPoints[i].vibrato;
-                                        }
-                                        newBend.lastSentPitchBend = initialPitchBend;
-                                    }
-                                }
-                                
-                                // Note On
-                                generatedMidi.addEvent(juce::MidiMessage::noteOn(midiChannel, midiNote, (juce::uint8)velocity), 0);
-                                activeNotesPerChannel[midiChannel].insert(midiNote);
-                                
-                                // Track note end time
-                                double tempo = hostTempo.load();
-                                if (tempo <= 0.0) tempo = 120.0;
-                                double noteDurationMs = etBeatDuration * 60000.0 / tempo;
-                                double noteEndTime = juce::Time::getMillisecondCounterHiRes() + noteDurationMs;
-                                trackNoteEndTime[trackIdx].store(noteEndTime);
-                            }
-                        }
-                        
-                        lastProcessedMeasurePerTrack[trackIdx] = measureIndex;
-                        lastProcessedBeatPerTrack[trackIdx] = etBeatIndex;
-                    }
-                    
-                    continue;  // Skip original GP5Track processing for this track
-                }
-                
-                const auto& track = tracks[trackIdx];
                 int midiChannel = getTrackMidiChannel(trackIdx);
                 int volumeScale = getTrackVolume(trackIdx);
                 int pan = getTrackPan(trackIdx);
                 
-                if (measureIndex < 0 || measureIndex >= (int)track.measures.size())
-                    continue;
-                
-                const auto& measure = track.measures[measureIndex];
-                const auto& beats = measure.voice1;
-                
-                if (beats.size() == 0)
-                    continue;
-                
-                double beatStartTime = 0.0;
-                int beatIndex = findBeatAtPosition(beats, beatInMeasure, beatStartTime);
-                beatIndex = juce::jlimit(0, (int)beats.size() - 1, beatIndex);
-                
-                if (measureIndex != lastProcessedMeasurePerTrack[trackIdx] || 
-                    beatIndex != lastProcessedBeatPerTrack[trackIdx])
+                // Beat an der Host-Position aus dem editierten TabTrack oder dem
+                // Original-GP5Track - beide über denselben SongEventRenderer wie der MIDI-Export
+                auto playBeatAt = [&](const auto& sourceTrack, const auto& beats)
                 {
+                    if (beats.size() == 0)
+                        return;
+                    
+                    double beatStartTime = 0.0;
+                    int beatIndex = SongEventRenderer::findBeatAt(beats, beatInMeasure, beatStartTime);
+                    
+                    if (measureIndex == lastProcessedMeasurePerTrack[trackIdx] &&
+                        beatIndex == lastProcessedBeatPerTrack[trackIdx])
+                        return;
+                    
                     // Alle Noten auf diesem Kanal stoppen
                     if (activeNotesPerChannel.count(midiChannel))
                     {
                         for (int note : activeNotesPerChannel[midiChannel])
-                        {
                             generatedMidi.addEvent(juce::MidiMessage::noteOff(midiChannel, note), 0);
-                        }
                         activeNotesPerChannel[midiChannel].clear();
                     }
                     
                     // Reset pitch wheel before new notes (only if no active bends for this channel)
-                    bool hasActiveBendOnChannel = false;
-                    for (int b = 0; b < activeBendCount; ++b)
-                    {
-                        if (activeBends[b].midiChannel == midiChannel)
-                        {
-                            hasActiveBendOnChannel = true;
-                            break;
-                        }
-                    }
-                    if (!hasActiveBendOnChannel)
-                    {
+                    if (!hasActiveBendOnChannel(midiChannel))
                         generatedMidi.addEvent(juce::MidiMessage::pitchWheel(midiChannel, 8192), 0);
-                    }
-                    
-                    const auto& beat = beats[beatIndex];
                     
-                    // Calculate beat duration in quarter notes
-                    double beatDurationBeats = 4.0 / std::pow(2.0, beat.duration + 2);
-                    if (beat.isDotted) beatDurationBeats *= 1.5;
-                    if (beat.tupletN > 0)
-                    {
-                        int tupletDenom = (beat.tupletN == 3) ? 2 : (beat.tupletN == 5 || beat.tupletN == 6) ? 4 : beat.tupletN - 1;
-                        beatDurationBeats = beatDurationBeats * tupletDenom / beat.tupletN;
-                    }
+                    const auto& beat = beats.getReference(beatIndex);
+                    const double beatDuration = SongEventRenderer::beatDuration(beat);
                     
                     if (!beat.isRest)
-                    {
                         generatedMidi.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 10, pan), 0);
+                    
+                    SongEventRenderer::forEachNote(sourceTrack, beat, volumeScale, defaultGuitarTuning,
+                                                   [&](const SongEventRenderer::Note& note)
+                    {
+                        startRenderedNote(note, midiChannel, currentBeat, beatDuration, generatedMidi);
+                        activeNotesPerChannel[midiChannel].insert(note.midiNote);
                         
-                        // Iteriere sicher über die Noten
-                        for (auto it = beat.notes.begin(); it != beat.notes.end(); ++it)
-                        {
-                            int stringIndex = it->first;
-                            const auto& gpNote = it->second;
-                            
-                            if (gpNote.isDead || gpNote.isTied)
-                                continue;
-                            
-                            if (stringIndex < 0 || stringIndex >= 12)
-                                continue;
-                            
-                            // MIDI-Note berechnen
-                            int midiNote = 0;
-                            int tuningSize = track.tuning.size();
-                            if (tuningSize > 0 && stringIndex < tuningSize)
-                            {
-                                midiNote = track.tuning[stringIndex] + gpNote.fret;
-                            }
-                            else if (stringIndex < 6)
-                            {
-                                const int defaultTuning[] = { 64, 59, 55, 50, 45, 40 };
-                                midiNote = defaultTuning[stringIndex] + gpNote.fret;
-                            }
-                            
-                            if (midiNote <= 0 || midiNote >= 128)
-                                continue;
-                            
-                            // Velocity
-                            int velocity = gpNote.velocity > 0 ? gpNote.velocity : 95;
-                            if (gpNote.isGhost) velocity = 50;
-                            if (gpNote.hasAccent) velocity = 115;
-                            if (gpNote.hasHeavyAccent) velocity = 127;
-                            if (gpNote.hasHammerOn) velocity = juce::jmax(50, velocity - 15);
-                            velocity = (velocity * volumeScale) / 100;
-                            velocity = juce::jlimit(1, 127, velocity);
-                            
-                            // Expression Controllers
-                            if (gpNote.hasVibrato)
-                                generatedMidi.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 1, 80), 0);
-                            
-                            if (gpNote.hasHammerOn)
-                                generatedMidi.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 68, 127), 0);
-                            
-                            if (gpNote.hasSlide)
-                            {
-                                generatedMidi.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 65, 127), 0);
-                                generatedMidi.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 5, 64), 0);
-                            }
-                            
-                            // =========================================================
-                            // BEND HANDLING - Create ActiveBend for real-time interpolation
-                            // =========================================================
-                            if (gpNote.hasBend && gpNote.bendValue != 0)
-                            {
-                                // Calculate initial pitch based on bend type
-                                int initialPitchBend = 8192;
-                                constexpr double unitsPerSemitone = 8192.0 / 2.0;  // ±2 semitone range
-                                int maxPitchBend = 8192 + (int)((gpNote.bendValue / 100.0) * unitsPerSemitone);
-                                maxPitchBend = juce::jlimit(0, 16383, maxPitchBend);
-                                
-                                switch (gpNote.bendType)
-                                {
-                                    case 1:  // Normal Bend: Start at 0, bend UP to target
-                                        initialPitchBend = 8192;  // Start at original pitch
-                                        break;
-                                        
-                                    case 2:  // Bend and Release: Start at 0, bend up, back to 0
-                                        initialPitchBend = 8192;  // Start at original pitch
-                                        break;
-                                        
-                                    case 3:  // Release: Start at target, release to 0
-                                    case 5:  // Pre-Bend and Release: Start at target, release to 0
-                                        initialPitchBend = maxPitchBend;  // Start bent
-                                        break;
-                                        
-                                    case 4:  // Pre-Bend: Static at target pitch (no interpolation needed)
-                                        initialPitchBend = maxPitchBend;
-                                        break;
-                                        
-                                    default:
-                                        initialPitchBend = 8192;
-                                        break;
-                                }
-                                
-                                // Send initial pitch bend
-                                generatedMidi.addEvent(juce::MidiMessage::pitchWheel(midiChannel, initialPitchBend), 0);
-                                
-                                // Add to active bends for real-time interpolation (not for static pre-bend)
-                                if (gpNote.bendType != 4 && activeBendCount < maxActiveBends)
-                                {
-                                    ActiveBend& newBend = activeBends[activeBendCount++];
-                                    newBend.midiChannel = midiChannel;
-                                    newBend.midiNote = midiNote;
-                                    newBend.startBeat = currentBeat;
-                                    newBend.durationBeats = beatDurationBeats;
-                                    newBend.bendType = gpNote.bendType;
-                                    newBend.maxBendValue = gpNote.bendValue;
-                                    
-                                    // Manual copy to fixed array for thread safety
-                                    newBend.pointCount = std::min((int)gpNote.bendPoints.size(), 16);
-                                    for (int i = 0; i < newBend.pointCount; ++i)
-                                    {
-                                        newBend.points[i] = gpNote.bendPoints[i];
-                                    }
-                                    
-                                    newBend.lastSentPitchBend = initialPitchBend;
-                                }
-                            }
-                            
-                            // Note On
-                            generatedMidi.addEvent(juce::MidiMessage::noteOn(midiChannel, midiNote, (juce::uint8)velocity), 0);
-                            activeNotesPerChannel[midiChannel].insert(midiNote);
-                            
-                            // Mark track as playing - calculate note end time in milliseconds
-                            double tempo = hostTempo.load();
-                            if (tempo <= 0.0) tempo = 120.0;  // Fallback
-                            double noteDurationMs = beatDurationBeats * 60000.0 / tempo;
-                            double noteEndTime = juce::Time::getMillisecondCounterHiRes() + noteDurationMs;
-                            trackNoteEndTime[trackIdx].store(noteEndTime);
-                        }
-                    }
+                        // Mark track as playing - calculate note end time in milliseconds
+                        double tempo = hostTempo.load();
+                        if (tempo <= 0.0) tempo = 120.0;  // Fallback
+                        double noteEndTime = juce::Time::getMillisecondCounterHiRes() + beatDuration * 60000.0 / tempo;
+                        trackNoteEndTime[trackIdx].store(noteEndTime);
+                    });
                     
                     lastProcessedMeasurePerTrack[trackIdx] = measureIndex;
                     lastProcessedBeatPerTrack[trackIdx] = beatIndex;
+                };
+                
+                // Editierte Tracks (Tonhöhe, Dauer, Löschen) ersetzen die Parser-Daten
+                if (const auto* editTrack = edited->find(trackIdx))
+                {
+                    if (measureIndex >= 0 && measureIndex < editTrack->measures.size())
+                        playBeatAt(*editTrack, editTrack->measures.getReference(measureIndex).beats);
+                }
+                else
+                {
+                    const auto& track = tracks.getReference(trackIdx);
+                    if (measureIndex >= 0 && measureIndex < track.measures.size())
+                        playBeatAt(track, track.measures.getReference(measureIndex).voice1);
                 }
             }
             }  // Ende des else-Blocks für currentBeat >= 0
@@ -1309,13 +866,16 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
         bool isPlaying = hostIsPlaying.load();
         double currentBeat = hostPositionBeats.load();
         
-        // Stop-Erkennung: Wenn Playback stoppt, alle Noten beenden
+        // Stop-Erkennung: Wenn Playback stoppt, alle Noten und Bends beenden
         if (!isPlaying && wasPlaying)
         {
             for (int note : activePlaybackNotes)
             {
                 generatedMidi.addEvent(juce::MidiMessage::noteOff(1, note), 0);
             }
+            if (activeBendCount > 0)
+                generatedMidi.addEvent(juce::MidiMessage::pitchWheel(1, 8192), 0);
+            activeBendCount = 0;
             activePlaybackNotes.clear();
             lastPlaybackBeat = -1.0;
             lastProcessedRecMeasure = -1;
@@ -1324,16 +884,19 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
         
         if (isPlaying && currentBeat >= 0.0)
         {
+            updateActiveBends(currentBeat, generatedMidi);
+            
             int selTrack = selectedTrackIndex.load();
-            bool useEditedTrack = hasEditedTrack(selTrack);
+            const auto edited = getEditedTracksSnapshot();  // ohne editedTracksMutex
+            const TabTrack* editedSelTrack = edited->find(selTrack);
             
-            if (useEditedTrack)
+            if (editedSelTrack != nullptr)
             {
                 // =============================================================
                 // EDITED TRACK PLAYBACK: Walk through TabTrack measures/beats
                 // This respects rest deletion and duration edits!
                 // =============================================================
-                const auto& editTrack = getEditedTrack(selTrack);
+                const auto& editTrack = *editedSelTrack;
                 
                 int numerator = hostTimeSigNumerator.load();
                 int denominator = hostTimeSigDenominator.load();
@@ -1358,25 +921,12 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
                 
                 if (measureIdx >= 0 && measureIdx < editTrack.measures.size())
                 {
-                    const auto& measure = editTrack.measures[measureIdx];
-                    const auto& beats = measure.beats;
+                    const auto& beats = editTrack.measures.getReference(measureIdx).beats;
                     
                     if (beats.size() > 0)
                     {
-                        // Find which beat we're at based on beat-in-measure position
                         double beatStartTime = 0.0;
-                        int beatIndex = 0;
-                        for (int b = 0; b < beats.size(); ++b)
-                        {
-                            double dur = beats[b].getDurationInQuarters();
-                            if (beatInMeasure < beatStartTime + dur)
-                            {
-                                beatIndex = b;
-                                break;
-                            }
-                            beatStartTime += dur;
-                            beatIndex = b;
-                        }
+                        int beatIndex = SongEventRenderer::findBeatAt(beats, beatInMeasure, beatStartTime);
                         
                         // Only process when beat changes (same logic as file-based playback)
                         if (measureIdx != lastProcessedRecMeasure || beatIndex != lastProcessedRecBeat)
@@ -1388,44 +938,19 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
                             }
                             activePlaybackNotes.clear();
                             
-                            const auto& beat = beats[beatIndex];
+                            if (!hasActiveBendOnChannel(1))
+                                generatedMidi.addEvent(juce::MidiMessage::pitchWheel(1, 8192), 0);
+                            
+                            // Noten mit Effekten wie beim Export (Rests stoppen nur die alten Noten)
+                            const auto& beat = beats.getReference(beatIndex);
+                            const double beatDuration = SongEventRenderer::beatDuration(beat);
                             
-                            if (!beat.isRest)
+                            SongEventRenderer::forEachNote(editTrack, beat, 100, defaultGuitarTuning,
+                                                           [&](const SongEventRenderer::Note& note)
                             {
-                                // Play all notes in this beat
-                                for (const auto& tabNote : beat.notes)
-                                {
-                                    if (tabNote.fret < 0)
-                                        continue;  // Empty string slot
-                                    
-                                    if (tabNote.isTied)
-                                        continue;
-                                    
-                                    // Calculate MIDI note from string + fret + tuning
-                                    int midiNote = 0;
-                                    if (tabNote.midiNote > 0)
-                                    {
-                                        midiNote = tabNote.midiNote;
-                                    }
-                                    else if (tabNote.string >= 0 && tabNote.string < editTrack.tuning.size())
-                                    {
-                                        midiNote = editTrack.tuning[tabNote.string] + tabNote.fret;
-                                    }
-                                    else if (tabNote.string < 6)
-                                    {
-                                        const int defaultTuning[] = { 64, 59, 55, 50, 45, 40 };
-                                        midiNote = defaultTuning[tabNote.string] + tabNote.fret;
-                                    }
-                                    
-                                    if (midiNote <= 0 || midiNote >= 128)
-                                        continue;
-                                    
-                                    int velocity = juce::jlimit(1, 127, tabNote.velocity > 0 ? tabNote.velocity : 95);
-                                    generatedMidi.addEvent(juce::MidiMessage::noteOn(1, midiNote, (juce::uint8)velocity), 0);
-                                    activePlaybackNotes.insert(midiNote);
-                                }
-                            }
-                            // If beat.isRest, we just stopped old notes and don't start new ones
+                                startRenderedNote(note, 1, currentBeat, beatDuration, generatedMidi);
+                                activePlaybackNotes.insert(note.midiNote);
+                            });
                             
                             lastProcessedRecMeasure = measureIdx;
                             lastProcessedRecBeat = beatIndex;
@@ -1440,9 +965,11 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
                 // =============================================================
                 // RAW RECORDED NOTES PLAYBACK (fallback, no edits applied)
                 // =============================================================
-                std::lock_guard<std::mutex> lock(recordingMutex);
+                // Nie auf den Message-Thread warten (flushInto allokiert unter recordingMutex):
+                // ist der Lock belegt, holt der nächste Block das Fenster seit lastPlaybackBeat nach
+                std::unique_lock<std::mutex> lock(recordingMutex, std::try_to_lock);
                 
-                if (!recordedNotes.empty() && recordingStartSet)
+                if (lock.owns_lock() && !recordedNotes.empty() && recordingStartSet)
                 {
                     // Berechne relative Position zu Recording-Start
                     double relativeBeat = currentBeat - recordingStartBeat;
@@ -1488,6 +1015,7 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
     
     // Generierte MIDI-Events zum Output hinzufügen
     midiMessages.addEvents(generatedMidi, 0, buffer.getNumSamples(), 0);
+    audioThreadProfiler.endSection(noteOutputSection);
 
     // Dieses Plugin ist ein MIDI-Generator (Synth/Instrument).
     // Es soll KEIN Audio durchleiten - weder vom Main Input noch vom Sidechain.
@@ -1496,35 +1024,287 @@ void NewProjectAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
     // was zu einem "doppelten" Klang führt.
     for (auto i = 0; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
+    
+    audioThreadProfiler.endBlock();
 }
 
 //==============================================================================
-bool NewProjectAudioProcessor::hasEditor() const
+// Echtzeit-Bends: Verlauf aus dem SongEventRenderer (identisch zum MIDI-Export)
+//==============================================================================
+void NewProjectAudioProcessor::updateActiveBends(double currentBeat, juce::MidiBuffer& midi)
 {
-    return true; // (change this to false if you choose to not supply an editor)
+    AudioThreadProfiler::ScopedSection profile(audioThreadProfiler, AudioThreadProfiler::bendLoop);
+    
+    for (int b = 0; b < activeBendCount; ++b)
+    {
+        ActiveBend& bend = activeBends[b];
+
+        // Calculate position in bend (0.0 to 1.0)
+        double elapsed = currentBeat - bend.startBeat;
+        double progress = (bend.durationBeats > 0) ? (elapsed / bend.durationBeats) : 1.0;
+
+        // Remove bend if note duration exceeded
+        if (progress >= 1.0)
+        {
+            // Reset pitch wheel at end of bend
+            midi.addEvent(juce::MidiMessage::pitchWheel(bend.midiChannel, 8192), 0);
+            // Remove by swapping with last
+            activeBends[b] = activeBends[activeBendCount - 1];
+            activeBendCount--;
+            b--;  // Re-check this index
+            continue;
+        }
+
+        const auto& note = bend.note;
+        int bendValue = SongEventRenderer::bendValueAt(note.bendType, note.bendValue, note.points, note.pointCount,
+                                                       progress, currentBeat);
+        int pitchBend = SongEventRenderer::toPitchWheel(bendValue);
+
+        // Send if changed (lower threshold for smoother bends)
+        if (std::abs(pitchBend - bend.lastSentPitchBend) > SongEventRenderer::pitchWheelThreshold)
+        {
+            midi.addEvent(juce::MidiMessage::pitchWheel(bend.midiChannel, pitchBend), 0);
+            bend.lastSentPitchBend = pitchBend;
+        }
+    }
 }
 
-juce::AudioProcessorEditor* NewProjectAudioProcessor::createEditor()
+bool NewProjectAudioProcessor::hasActiveBendOnChannel(int midiChannel) const
 {
-    return new NewProjectAudioProcessorEditor (*this);
+    for (int b = 0; b < activeBendCount; ++b)
+    {
+        if (activeBends[b].midiChannel == midiChannel)
+            return true;
+    }
+    return false;
 }
 
-//==============================================================================
-void NewProjectAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+void NewProjectAudioProcessor::startRenderedNote(const SongEventRenderer::Note& note, int midiChannel,
+                                                 double currentBeat, double beatDuration, juce::MidiBuffer& midi)
 {
-    // Speichere den Dateipfad der geladenen GP5-Datei und UI-Zustand
-    juce::ValueTree state ("GP5PluginState");
-    state.setProperty ("filePath", loadedFilePath, nullptr);
-    state.setProperty ("selectedTrack", selectedTrackIndex.load(), nullptr);
-    state.setProperty ("autoScroll", autoScrollEnabled.load(), nullptr);
-    state.setProperty ("fretPosition", static_cast<int>(fretPosition.load()), nullptr);
-    state.setProperty ("positionLookahead", positionLookahead.load(), nullptr);
-    
-    // Speichere Track-MIDI-Einstellungen
-    juce::ValueTree trackSettings ("TrackSettings");
-    for (int i = 0; i < maxTracks; ++i)
+    SongEventRenderer::emitNoteStart(note, midiChannel, [&midi](const juce::MidiMessage& message)
     {
-        juce::ValueTree track ("Track");
+        midi.addEvent(message, 0);
+    });
+
+    // Add to active bends for real-time interpolation (not for static pre-bend)
+    if (note.hasMovingBend() && activeBendCount < maxActiveBends)
+    {
+        ActiveBend& newBend = activeBends[activeBendCount++];
+        newBend.midiChannel = midiChannel;
+        newBend.startBeat = currentBeat;
+        newBend.durationBeats = beatDuration;
+        newBend.note = note;
+        newBend.lastSentPitchBend = SongEventRenderer::initialPitchWheel(note);
+    }
+}
+
+//==============================================================================
+// Offline-Rendering (Bounce/Freeze): der ganze Song als ein sortierter Strom.
+// Gerendert wird nie im Audio-Thread: beim Umschalten auf Offline (setNonRealtime,
+// prepareToPlay) im Host-Thread, nach jedem Bounce im Message-Thread für den nächsten.
+//==============================================================================
+void NewProjectAudioProcessor::setNonRealtime (bool isNonRealtime) noexcept
+{
+    AudioProcessor::setNonRealtime(isNonRealtime);
+    
+    if (isNonRealtime)
+    {
+        prepareOfflineRender();
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(offlineRenderMutex);
+        pendingOfflineRender.reset();
+    }
+}
+
+void NewProjectAudioProcessor::prepareOfflineRender()
+{
+    if (!fileLoaded)
+        return;
+    
+    auto render = std::make_unique<OfflineRender>();
+    
+    const auto& tracks = getActiveTracks();
+    const int numTracks = juce::jmin((int)tracks.size(), maxTracks);
+    const bool anySoloActive = hasAnySolo();
+    
+    // Nacheinander im aufrufenden Thread - nicht über channelWorkerPool, wo der Bounce
+    // hinter Annotation/Export warten müsste. Alle Tracks aus einem veröffentlichten Stand.
+    const auto edited = getEditedTracksSnapshot();
+    std::vector<SongEventRenderer::RenderedTrack> rendered((size_t)numTracks);
+    for (int trackIdx = 0; trackIdx < numTracks; ++trackIdx)
+    {
+        if (isTrackMuted(trackIdx) || (anySoloActive && !isTrackSolo(trackIdx)))
+            continue;
+        
+        const int midiChannel = getTrackMidiChannel(trackIdx);
+        auto& renderedTrack = rendered[(size_t)trackIdx];
+        renderedTrack = renderLoadedTrack(trackIdx, midiChannel, *edited);
+        
+        // Pan einmal am Anfang statt pro Beat
+        renderedTrack.events.insert(renderedTrack.events.begin(),
+            { 0.0, juce::MidiMessage::controllerEvent(midiChannel, 10, getTrackPan(trackIdx)) });
+    }
+    
+    size_t totalEvents = 0;
+    for (const auto& renderedTrack : rendered)
+        totalEvents += renderedTrack.events.size();
+    render->events.reserve(totalEvents);
+    
+    for (int trackIdx = 0; trackIdx < numTracks; ++trackIdx)
+    {
+        auto& events = rendered[(size_t)trackIdx].events;
+        if (events.empty())
+            continue;
+        
+        render->channelsUsed[(size_t)juce::jlimit(1, 16, getTrackMidiChannel(trackIdx))] = true;
+        
+        // Jeder Strom ist sortiert - stabil zusammenführen (Reihenfolge pro Beat bleibt)
+        const auto middle = render->events.size();
+        render->events.insert(render->events.end(), events.begin(), events.end());
+        std::inplace_merge(render->events.begin(), render->events.begin() + (std::ptrdiff_t)middle, render->events.end(),
+                           [](const SongEventRenderer::Event& a, const SongEventRenderer::Event& b) { return a.beat < b.beat; });
+    }
+    
+    DBG("Offline render: " << (int)render->events.size() << " events from " << numTracks << " track(s)");
+    
+    std::lock_guard<std::mutex> lock(offlineRenderMutex);
+    pendingOfflineRender = std::move(render);
+}
+
+bool NewProjectAudioProcessor::adoptOfflineRender()
+{
+    // Offline darf der Audio-Thread warten und freigeben; der Renderer hält die
+    // Sperre nur für den Tausch
+    std::lock_guard<std::mutex> lock(offlineRenderMutex);
+    if (pendingOfflineRender == nullptr)
+        return false;
+    
+    offlineRender = std::move(pendingOfflineRender);
+    offlineNextBeat = -1.0;
+    
+    // Echtzeit-Zustand verwerfen, damit beim Zurückwechseln nichts hängen bleibt
+    activeNotesPerChannel.clear();
+    activeBendCount = 0;
+    wasPlaying = false;
+    for (int i = 0; i < maxTracks; ++i)
+    {
+        lastProcessedBeatPerTrack[i] = -1;
+        lastProcessedMeasurePerTrack[i] = -1;
+    }
+    return true;
+}
+
+void NewProjectAudioProcessor::releaseOfflineRender(juce::MidiBuffer& midi)
+{
+    // Nur klingende Noten beenden; der Strom bleibt bis zum nächsten Tausch liegen
+    // (keine Freigabe im Echtzeit-Audio-Thread)
+    if (offlineRender != nullptr && offlineNextBeat >= 0.0)
+    {
+        for (int channel = 1; channel <= 16; ++channel)
+        {
+            if (offlineRender->channelsUsed[(size_t)channel])
+            {
+                midi.addEvent(juce::MidiMessage::allNotesOff(channel), 0);
+                midi.addEvent(juce::MidiMessage::pitchWheel(channel, 8192), 0);
+            }
+        }
+    }
+    offlineNextBeat = -1.0;
+}
+
+bool NewProjectAudioProcessor::renderOfflineBlock(int numSamples, juce::MidiBuffer& midi)
+{
+    if (!hostIsPlaying.load())
+    {
+        // Bounce beendet: für den nächsten Start neu rendern (Edits, Mute/Solo, Lautstärke)
+        if (offlineNextBeat >= 0.0)
+        {
+            releaseOfflineRender(midi);
+            offlineRenderRequested.store(true);
+            requestMessageThreadWork();
+        }
+        return offlineRender != nullptr;
+    }
+    
+    // Neuer Strom nur zu Beginn eines Bounces, nie mittendrin
+    if (offlineNextBeat < 0.0)
+        adoptOfflineRender();
+    
+    // Noch nichts vorgerendert (Song erst während des Bounces geladen) - Echtzeit-Pfad
+    if (offlineRender == nullptr)
+        return false;
+    
+    const auto& events = offlineRender->events;
+    
+    double tempo = hostTempo.load();
+    if (tempo <= 0.0) tempo = 120.0;
+    const double sampleRate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+    const double samplesPerBeat = sampleRate * 60.0 / tempo;
+    
+    const double blockStartBeat = hostPositionBeats.load();
+    const double blockEndBeat = blockStartBeat + numSamples / samplesPerBeat;
+    
+    // Sprung (Cycle, Start mitten im Song): klingende Noten beenden und Cursor neu setzen.
+    // Kleine Abweichungen (Tempo-Automation, Rundung des Hosts) gelten nicht als Sprung.
+    const bool jumped = offlineNextBeat < 0.0
+                     || blockStartBeat < offlineNextBeat - 1.0e-3
+                     || blockStartBeat > offlineNextBeat + 0.25;
+    if (jumped)
+    {
+        if (offlineNextBeat >= 0.0)
+        {
+            for (int channel = 1; channel <= 16; ++channel)
+                if (offlineRender->channelsUsed[(size_t)channel])
+                    midi.addEvent(juce::MidiMessage::allNotesOff(channel), 0);
+        }
+        
+        offlineCursor = (size_t)(std::lower_bound(events.begin(), events.end(), blockStartBeat,
+                                                  [](const SongEventRenderer::Event& e, double beat) { return e.beat < beat; })
+                                 - events.begin());
+    }
+    
+    while (offlineCursor < events.size() && events[offlineCursor].beat < blockEndBeat)
+    {
+        const auto& event = events[offlineCursor++];
+        const int samplePosition = juce::jlimit(0, numSamples - 1, (int)((event.beat - blockStartBeat) * samplesPerBeat));
+        midi.addEvent(event.message, samplePosition);
+    }
+    
+    offlineNextBeat = blockEndBeat;
+    return true;
+}
+
+//==============================================================================
+bool NewProjectAudioProcessor::hasEditor() const
+{
+    return true; // (change this to false if you choose to not supply an editor)
+}
+
+juce::AudioProcessorEditor* NewProjectAudioProcessor::createEditor()
+{
+    return new NewProjectAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+void NewProjectAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    // Speichere den Dateipfad der geladenen GP5-Datei und UI-Zustand
+    juce::ValueTree state ("GP5PluginState");
+    state.setProperty ("filePath", loadedFilePath, nullptr);
+    state.setProperty ("selectedTrack", selectedTrackIndex.load(), nullptr);
+    state.setProperty ("autoScroll", autoScrollEnabled.load(), nullptr);
+    state.setProperty ("fretPosition", static_cast<int>(fretPosition.load()), nullptr);
+    state.setProperty ("positionLookahead", positionLookahead.load(), nullptr);
+    state.setProperty ("sessionId", sessionAutosave.getSessionId(), nullptr);
+    
+    // Speichere Track-MIDI-Einstellungen
+    juce::ValueTree trackSettings ("TrackSettings");
+    for (int i = 0; i < maxTracks; ++i)
+    {
+        juce::ValueTree track ("Track");
         track.setProperty ("index", i, nullptr);
         track.setProperty ("midiChannel", trackMidiChannels[i].load(), nullptr);
         track.setProperty ("muted", trackMuted[i].load(), nullptr);
@@ -1535,39 +1315,42 @@ void NewProjectAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
     }
     state.appendChild (trackSettings, nullptr);
     
-    // Speichere aufgezeichnete Noten
+    // Einstellungen bleiben ein (kleiner) ValueTree, Noten und editierte Tracks
+    // gehen binär in den State (PluginStateCodec, inkl. Bends und Fingersatz)
+    PluginStateCodec::Snapshot snapshot;
+    {
+        juce::MemoryOutputStream settingsStream (snapshot.settings, false);
+        state.writeToStream (settingsStream);
+    }
+    
     {
         std::lock_guard<std::mutex> lock(recordingMutex);
-        if (!recordedNotes.empty())
-        {
-            juce::ValueTree recNotesTree ("RecordedNotes");
-            recNotesTree.setProperty ("startBeat", recordingStartBeat, nullptr);
-            recNotesTree.setProperty ("startSet", recordingStartSet, nullptr);
-            
-            for (const auto& note : recordedNotes)
-            {
-                juce::ValueTree noteTree ("Note");
-                noteTree.setProperty ("midiNote", note.midiNote, nullptr);
-                noteTree.setProperty ("velocity", note.velocity, nullptr);
-                noteTree.setProperty ("string", note.string, nullptr);
-                noteTree.setProperty ("fret", note.fret, nullptr);
-                noteTree.setProperty ("startBeat", note.startBeat, nullptr);
-                noteTree.setProperty ("endBeat", note.endBeat, nullptr);
-                noteTree.setProperty ("midiChannel", note.midiChannel, nullptr);
-                recNotesTree.appendChild (noteTree, nullptr);
-            }
-            state.appendChild (recNotesTree, nullptr);
-        }
+        syncRecordingCapture();
+        snapshot.recordedNotes = recordedNotes.getNotes();
+        snapshot.recordingStartBeat = recordingStartBeat;
+        snapshot.recordingStartSet = recordingStartSet;
     }
+    for (const auto& [trackIndex, track] : getEditedTracksSnapshot()->tracks)
+        snapshot.editedTracks[trackIndex] = *track;
     
-    juce::MemoryOutputStream stream (destData, false);
-    state.writeToStream (stream);
+    PluginStateCodec::write (snapshot, destData);
 }
 
 void NewProjectAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
+    // Binärer State (PluginStateCodec) oder altes reines ValueTree-Format
+    PluginStateCodec::Snapshot snapshot;
+    const bool isBinaryState = PluginStateCodec::isBinaryState (data, static_cast<size_t>(sizeInBytes));
+    if (isBinaryState && ! PluginStateCodec::read (data, static_cast<size_t>(sizeInBytes), snapshot))
+    {
+        DBG("setStateInformation: unreadable binary state, ignored");
+        return;
+    }
+    
     // Lade den Dateipfad und parse die Datei erneut
-    juce::ValueTree state = juce::ValueTree::readFromData (data, static_cast<size_t>(sizeInBytes));
+    juce::ValueTree state = isBinaryState
+        ? juce::ValueTree::readFromData (snapshot.settings.getData(), snapshot.settings.getSize())
+        : juce::ValueTree::readFromData (data, static_cast<size_t>(sizeInBytes));
     
     if (state.isValid() && state.hasType ("GP5PluginState"))
     {
@@ -1614,15 +1397,26 @@ void NewProjectAudioProcessor::setStateInformation (const void* data, int sizeIn
             }
         }
         
-        // Lade aufgezeichnete Noten
+        if (isBinaryState)
+        {
+            restoreSnapshot (snapshot);
+            resumeAutosaveSession (state);
+            
+            DBG("Loaded " << (int) recordedNotes.size() << " recorded notes and "
+                << (int) editedTracks.size() << " edited tracks from binary state");
+            return;
+        }
+        
+        // Lade aufgezeichnete Noten (altes Format)
         juce::ValueTree recNotesTree = state.getChildWithName ("RecordedNotes");
         if (recNotesTree.isValid())
         {
             std::lock_guard<std::mutex> lock(recordingMutex);
             recordedNotes.clear();
+            recordingCapture.clear();
             
-            recordingStartBeat = recNotesTree.getProperty ("startBeat", 0.0);
-            recordingStartSet = recNotesTree.getProperty ("startSet", false);
+            recordingStartBeat = (double) recNotesTree.getProperty ("startBeat", 0.0);
+            recordingStartSet = (bool) recNotesTree.getProperty ("startSet", false);
             
             for (int i = 0; i < recNotesTree.getNumChildren(); ++i)
             {
@@ -1636,16 +1430,138 @@ void NewProjectAudioProcessor::setStateInformation (const void* data, int sizeIn
                 note.endBeat = noteTree.getProperty ("endBeat", 0.0);
                 note.midiChannel = noteTree.getProperty ("midiChannel", 1);
                 note.isActive = false;
-                recordedNotes.push_back(note);
+                recordedNotes.add(note);
             }
             
             DBG("Loaded " << recordedNotes.size() << " recorded notes from state");
         }
+        
+        resumeAutosaveSession (state);
+    }
+}
+
+void NewProjectAudioProcessor::restoreSnapshot (PluginStateCodec::Snapshot& snapshot)
+{
+    {
+        std::lock_guard<std::mutex> lock(recordingMutex);
+        recordedNotes.clear();
+        recordingCapture.clear();
+        recordingStartBeat = snapshot.recordingStartBeat;
+        recordingStartSet = snapshot.recordingStartSet;
+        for (auto& note : snapshot.recordedNotes)
+        {
+            note.isActive = false;
+            recordedNotes.add (std::move (note));
+        }
+        accountRecordedNotes();
+    }
+    // Speicher der Tracks vor dem Lock zählen (Autosave und Undo-Abfragen warten auf editedTracksMutex)
+    std::map<int, size_t> trackBytes;
+    for (const auto& [trackIndex, track] : snapshot.editedTracks)
+        trackBytes[trackIndex] = getHeapBytes(track);
+    {
+        std::lock_guard<std::mutex> lock(editedTracksMutex);
+        editedTracks = std::move (snapshot.editedTracks);
+        editedTrackHeapBytes = std::move (trackBytes);
+        tabUndoHistories.clear();
+        clearRecordedNotesUndo(allEditedTracks);
+        accountEditedTracks();
+    }
+    publishEditedTracks (allEditedTracks);
+    tabEditJournal.clear();
+}
+
+void NewProjectAudioProcessor::resumeAutosaveSession (const juce::ValueTree& state)
+{
+    // Gleiche Session wie im gespeicherten Projekt: ein übrig gebliebenes Journal
+    // (Absturz nach dem letzten Speichern) wird im Hintergrund geprüft
+    const juce::String savedId = state.getProperty ("sessionId", "").toString();
+    if (savedId.isNotEmpty() && savedId != sessionAutosave.getSessionId())
+    {
+        sessionAutosave.stop (true);
+        sessionAutosave.start (savedId, true);
+    }
+    else
+    {
+        sessionAutosave.postRebase();
+    }
+}
+
+//==============================================================================
+// Autosave-Quellen (laufen im Autosave-Thread)
+
+PluginStateCodec::Snapshot NewProjectAudioProcessor::makeAutosaveSnapshot (uint64_t& sequence)
+{
+    // Veröffentlichter Stand samt Sequenz - Basis und Journal passen zusammen, kopiert
+    // wird hier im Autosave-Thread ohne editedTracksMutex
+    PluginStateCodec::Snapshot snapshot;
+    const auto edited = getEditedTracksSnapshot();
+    for (const auto& [trackIndex, track] : edited->tracks)
+        snapshot.editedTracks[trackIndex] = *track;
+    sequence = edited->autosaveSequence;
+    {
+        std::lock_guard<std::mutex> lock(recordingMutex);
+        syncRecordingCapture();
+        snapshot.recordedNotes = recordedNotes.getNotes();
+        snapshot.recordingStartBeat = recordingStartBeat;
+        snapshot.recordingStartSet = recordingStartSet;
+        markAutosaveNotesJournaled (0);
+    }
+    return snapshot;
+}
+
+bool NewProjectAudioProcessor::collectAutosaveNotes (SessionAutosave::NotesDelta& delta)
+{
+    std::lock_guard<std::mutex> lock(recordingMutex);
+    syncRecordingCapture();
+    if (recordedNotes.getRevision() == autosaveNotesRevision)
+        return false;
+    
+    // Ab der ersten noch klingenden bzw. seitdem geänderten Note neu schreiben
+    const size_t from = std::min({ autosaveNoteWatermark, recordedNotes.getLowestChangedIndex(), recordedNotes.size() });
+    delta.from = from;
+    delta.notes.assign (recordedNotes.getNotes().begin() + static_cast<std::ptrdiff_t>(from), recordedNotes.getNotes().end());
+    delta.recordingStartBeat = recordingStartBeat;
+    delta.recordingStartSet = recordingStartSet;
+    markAutosaveNotesJournaled (from);
+    return true;
+}
+
+void NewProjectAudioProcessor::markAutosaveNotesJournaled (size_t from)
+{
+    // Aufrufer hält recordingMutex. Aktive Noten ändern noch ihr Ende und
+    // müssen im nächsten Delta erneut mit
+    autosaveNoteWatermark = recordedNotes.size();
+    for (size_t i = from; i < recordedNotes.size(); ++i)
+    {
+        if (recordedNotes[i].isActive)
+        {
+            autosaveNoteWatermark = i;
+            break;
+        }
     }
+    recordedNotes.resetLowestChangedIndex();
+    autosaveNotesRevision = recordedNotes.getRevision();
+}
+
+bool NewProjectAudioProcessor::recoverAutosave()
+{
+    PluginStateCodec::Snapshot snapshot;
+    if (!sessionAutosave.getRecovery (snapshot))
+        return false;
+    
+    restoreSnapshot (snapshot);
+    sessionAutosave.finishRecovery();
+    
+    DBG("Autosave: recovered " << (int) recordedNotes.size() << " recorded notes and "
+        << (int) editedTracks.size() << " edited tracks");
+    return true;
 }
 
 void NewProjectAudioProcessor::unloadFile()
 {
+    gp5ExportJob.cancel();
+    songAnnotator.cancel();
     fileLoaded = false;
     loadedFilePath = "";
     usingGP7Parser = false;
@@ -1669,13 +1585,27 @@ void NewProjectAudioProcessor::unloadFile()
     clearSeekPosition();
     
     // Clear edited tracks
-    editedTracks.clear();
+    {
+        std::lock_guard<std::mutex> lock(editedTracksMutex);
+        editedTracks.clear();
+        editedTrackHeapBytes.clear();
+        tabUndoHistories.clear();
+        clearRecordedNotesUndo(allEditedTracks);
+        sessionAutosave.postClearTracks();
+        accountEditedTracks();
+    }
+    publishEditedTracks(allEditedTracks);
+    tabEditJournal.clear();
     
     DBG("Processor: File unloaded");
 }
 
 bool NewProjectAudioProcessor::loadGP5File(const juce::File& file)
 {
+    // Annotation und Export lesen die Parser - vor dem Neuladen anhalten
+    gp5ExportJob.cancel();
+    songAnnotator.cancel();
+    
     // Check file extension to determine which parser to use
     auto extension = file.getFileExtension().toLowerCase();
     
@@ -1692,6 +1622,7 @@ bool NewProjectAudioProcessor::loadGP5File(const juce::File& file)
             
             // Initialize track settings based on imported MIDI
             initializeTrackSettings();
+            startSongAnnotation();
             
             DBG("Processor: MIDI file loaded successfully: " << loadedFilePath);
             return true;
@@ -1717,6 +1648,7 @@ bool NewProjectAudioProcessor::loadGP5File(const juce::File& file)
             
             // Initialize track settings based on loaded file
             initializeTrackSettings();
+            startSongAnnotation();
             
             DBG("Processor: GP7/8 file loaded successfully: " << loadedFilePath);
             return true;
@@ -1742,6 +1674,7 @@ bool NewProjectAudioProcessor::loadGP5File(const juce::File& file)
             
             // Initialize track settings based on loaded file
             initializeTrackSettings();
+            startSongAnnotation();
             
             DBG("Processor: PTB file loaded successfully: " << loadedFilePath);
             return true;
@@ -1765,6 +1698,7 @@ bool NewProjectAudioProcessor::loadGP5File(const juce::File& file)
         
         // Initialize track settings based on loaded file
         initializeTrackSettings();
+        startSongAnnotation();
         
         DBG("Processor: GP5 file loaded successfully: " << loadedFilePath);
         return true;
@@ -1777,6 +1711,47 @@ bool NewProjectAudioProcessor::loadGP5File(const juce::File& file)
     }
 }
 
+TabTrack NewProjectAudioProcessor::convertLoadedTrack(int trackIndex) const
+{
+    if (usingGP7Parser)
+    {
+        TabTrack track;
+        const auto& gp7Tracks = gp7Parser.getTracks();
+        if (trackIndex < 0 || trackIndex >= gp7Tracks.size())
+            return track;
+        
+        track.name = gp7Tracks[trackIndex].name;
+        track.stringCount = gp7Tracks[trackIndex].stringCount;
+        track.tuning = gp7Tracks[trackIndex].tuning;
+        track.measures = gp7Parser.convertToTabMeasures(trackIndex);
+        return track;
+    }
+    
+    if (usingMidiImporter)
+        return midiImporter.convertToTabTrack(trackIndex);
+    
+    if (usingPTBParser)
+        return ptbParser.convertToTabTrack(trackIndex);
+    
+    return gp5Parser.convertToTabTrack(trackIndex);
+}
+
+TabTrack NewProjectAudioProcessor::getLoadedTabTrack(int trackIndex) const
+{
+    TabTrack track;
+    if (songAnnotator.getTrack(trackIndex, track))
+        return track;
+    
+    // Annotation läuft noch - unannotierten Track sofort liefern
+    return convertLoadedTrack(trackIndex);
+}
+
+void NewProjectAudioProcessor::startSongAnnotation()
+{
+    accountSongModel();
+    songAnnotator.start(getActiveTracks().size(), [this](int trackIndex) { return convertLoadedTrack(trackIndex); });
+}
+
 void NewProjectAudioProcessor::initializeTrackSettings()
 {
     const auto& tracks = getActiveTracks();
@@ -1958,276 +1933,96 @@ void NewProjectAudioProcessor::setSeekPosition(int measureIndex, double position
 // MIDI Input -> Tab Display (Editor Mode)
 //==============================================================================
 
-std::vector<NewProjectAudioProcessor::GuitarPosition> NewProjectAudioProcessor::getPossiblePositions(int midiNote) const
+const GuitarTuning::PositionList& NewProjectAudioProcessor::getPossiblePositions(int midiNote) const
 {
-    std::vector<GuitarPosition> positions;
-    for (int str = 0; str < 6; ++str)
-    {
-        int fret = midiNote - standardTuning[str];
-        // Prüfen ob im spielbaren Bereich (0 bis 24 Bünde)
-        if (fret >= 0 && fret <= 24)
-        {
-            positions.push_back({str, fret});
-        }
-    }
-    return positions;
+    // Vorberechnete Tabelle der aktuellen Eingangs-Stimmung (0 bis 24 Bünde)
+    return inputTuning.getPositions(midiNote);
 }
 
-float NewProjectAudioProcessor::calculatePositionCost(const GuitarPosition& current, const GuitarPosition& previous) const
+void NewProjectAudioProcessor::setInputTuning(const GuitarTuning& newTuning)
 {
-    float cost = 0.0f;
-
-    // 0. Fret-Position-Präferenz (Low/Mid/High) - sanfte Tendenz zur bevorzugten Region
-    FretPosition pos = getFretPosition();
-    int preferredMinFret, preferredMaxFret;
-    switch (pos)
-    {
-        case FretPosition::Mid:
-            preferredMinFret = 5;
-            preferredMaxFret = 8;
-            break;
-        case FretPosition::High:
-            preferredMinFret = 9;
-            preferredMaxFret = 12;
-            break;
-        case FretPosition::Low:
-        default:
-            preferredMinFret = 0;
-            preferredMaxFret = 4;
-            break;
-    }
+    std::scoped_lock lock(liveMidiMutex, recordingMutex);
+    if (newTuning == inputTuning)
+        return;
     
-    // Bonus wenn in bevorzugter Region, STARKE Strafe wenn außerhalb
-    if (current.fret >= preferredMinFret && current.fret <= preferredMaxFret)
-    {
-        cost -= 10.0f;  // Starker Bonus für bevorzugte Region
-    }
-    else
-    {
-        int distFromPreferred = 0;
-        if (current.fret < preferredMinFret)
-            distFromPreferred = preferredMinFret - current.fret;
-        else
-            distFromPreferred = current.fret - preferredMaxFret;
-        cost += distFromPreferred * 3.0f;  // Deutliche Strafe pro Bund Abstand
-    }
-
-    // 1. Fret-Distanz (Horizontal) - Bewegung entlang des Halses
-    int fretDiff = std::abs(current.fret - previous.fret);
-    cost += fretDiff * 1.0f;  // Reduziert von 1.5
+    inputTuning = newTuning;
     
-    // Zusätzliche quadratische Komponente für große Sprünge (nur bei sehr großen)
-    if (fretDiff > 4)
-    {
-        cost += (fretDiff - 4) * (fretDiff - 4) * 0.3f;
-    }
+    // Handposition bezieht sich auf die alte Saitenbelegung
+    lastPlayedString = -1;
+    lastPlayedFret = -1;
+    lastFretDirection = 0;
+    postHeldNotesToAnalyzer();
+}
 
-    // 2. String-Distanz (Vertikal) - Saitenwechsel
-    int stringDiff = std::abs(current.stringIndex - previous.stringIndex);
-    cost += stringDiff * 0.5f;  // Reduziert von 0.8
+GuitarTuning NewProjectAudioProcessor::getInputTuning() const
+{
+    std::lock_guard<std::mutex> lock(liveMidiMutex);
+    return inputTuning;
+}
+
+float NewProjectAudioProcessor::getLiveFastPassageFactor() const
+{
+    // 8. Schnelle Passagen: Im Live-Modus nutzen wir die Zeit seit dem letzten Note-On.
+    //    Achtel bei 120 BPM = 0.25s, bei 200 BPM = 0.15s.
+    //    Threshold: 0.3s deckt Achtel und schneller ab.
+    if (lastNoteOnTime <= 0.0)
+        return 0.0f;
+    
+    double now = juce::Time::getMillisecondCounterHiRes() / 1000.0;
+    double timeSinceLastNote = now - lastNoteOnTime;
+    if (timeSinceLastNote < 0.3)
+        return static_cast<float>(1.0 - (timeSinceLastNote / 0.3));  // 0..1
+    return 0.0f;
+}
 
-    // 3. Hand-Spanne (Stretch Penalty) - NUR wenn NICHT in bevorzugter Region
-    // Wenn wir in Richtung bevorzugte Region gehen, keine Strafe!
-    bool movingTowardsPreferred = (current.fret >= preferredMinFret && current.fret <= preferredMaxFret) ||
-                                   (current.fret < previous.fret && previous.fret > preferredMaxFret) ||
-                                   (current.fret > previous.fret && previous.fret < preferredMinFret);
+FingeringOptimizer NewProjectAudioProcessor::createFingeringOptimizer() const
+{
+    FingeringOptimizer optimizer;
+    optimizer.setTuning(inputTuning);
+    optimizer.setCostModel(getCostModel());
+    // Position Lookahead (1-4) bestimmt, wie "träge" die Hand in einer Lage bleibt
+    optimizer.setHandInertia(1.0f + 0.25f * (positionLookahead.load() - 1));
+    return optimizer;
+}
+
+NewProjectAudioProcessor::GuitarPosition NewProjectAudioProcessor::findBestPosition(int midiNote, int previousString, int previousFret) const
+{
+    const auto& candidates = getPossiblePositions(midiNote);
     
-    if (fretDiff > 4 && current.fret != 0 && previous.fret != 0 && !movingTowardsPreferred)
+    if (candidates.empty())
     {
-        cost += 8.0f;  // Reduziert von 15.0
-        cost += (fretDiff - 4) * 1.5f;  // Reduziert von 3.0
+        // Fallback: Note nicht spielbar
+        return {0, juce::jmax(0, midiNote - inputTuning.getOpenNote(inputTuning.getLowestString()))}; 
     }
+
+    const auto& costModel = getCostModel();
     
-    // 4. "Handposition-Trägheit" - DEAKTIVIERT wenn außerhalb bevorzugter Region
-    // Dies ermöglicht das Verlassen einer hohen Position wenn Low bevorzugt ist
-    bool previousInPreferred = (previous.fret >= preferredMinFret && previous.fret <= preferredMaxFret);
-    if (previousInPreferred && previous.fret >= 5 && current.fret != 0)
+    // Wenn keine vorherige Position, nutze Fret-Position-Präferenz
+    if (previousString < 0 || previousFret < 0)
     {
-        // Nur Trägheit anwenden wenn vorherige Position bereits im bevorzugten Bereich war
-        int centerFret = previous.fret;
-        int distFromCenter = std::abs(current.fret - centerFret);
+        // Finde beste Position im bevorzugten Bereich
+        GuitarPosition bestPos = { candidates[0].string, candidates[0].fret };
+        int bestScore = -1000;
         
-        if (distFromCenter > 3)
+        for (const auto& c : candidates)
         {
-            cost += (distFromCenter - 3) * 2.0f;  // Reduziert von 4.0
+            int score = costModel.initialPlacementScore(c.string, c.fret);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestPos = { c.string, c.fret };
+            }
         }
+        return bestPos;
     }
 
-    // 5. Offene Saiten sind IMMER einfacher zu spielen (starker Bonus)
-    if (current.fret == 0)
-    {
-        cost -= 8.0f;  // Starker Bonus für offene Saiten - immer einfacher zu greifen
-        if (pos == FretPosition::Low)
-            cost -= 4.0f;  // Extra Bonus bei Low-Präferenz
-        else if (pos == FretPosition::High)
-            cost += 3.0f;  // Leichte Reduzierung des Bonus bei High-Präferenz
-    }
-    
-    // 6. Kleine Präferenz für höhere Saiten bei Melodien (dünnere Saiten)
-    cost -= current.stringIndex * 0.15f;
-    
-    // 7. Bonus für das Bleiben auf derselben Saite (fließenderes Spiel)
-    if (current.stringIndex == previous.stringIndex && fretDiff <= 4)
-    {
-        cost -= 1.5f;
-    }
-
-    // 8. Hohe Strafe für große Fret-Sprünge (>3) bei schnellen Passagen
-    //    Im Live-Modus nutzen wir die Zeit seit dem letzten Note-On.
-    //    Achtel bei 120 BPM = 0.25s, bei 200 BPM = 0.15s.
-    //    Threshold: 0.3s deckt Achtel und schneller ab.
-    if (fretDiff > 3 && current.fret != 0 && previous.fret != 0)
-    {
-        double now = juce::Time::getMillisecondCounterHiRes() / 1000.0;
-        double timeSinceLastNote = now - lastNoteOnTime;
-        if (lastNoteOnTime > 0.0 && timeSinceLastNote < 0.3)
-        {
-            // Je schneller die Passage, desto teurer der Sprung
-            float speedFactor = static_cast<float>(1.0 - (timeSinceLastNote / 0.3));  // 0..1
-            cost += (fretDiff - 3) * 50.0f * speedFactor;  // Sehr hohe Strafe
-        }
-    }
-
-    // 9. Ascending/Descending Direction Penalty (KTH Paper 6.2.9)
-    //    Wenn die Melodie sich in eine Richtung bewegt (aufsteigend/absteigend),
-    //    bevorzuge Positionen die diese Richtung beibehalten.
-    //    Richtungswechsel sind teurer, besonders bei schnellen Passagen.
-    if (lastFretDirection != 0 && current.fret != 0 && previous.fret != 0 && fretDiff > 0)
-    {
-        int currentDirection = (current.fret > previous.fret) ? 1 : -1;
-        if (currentDirection != lastFretDirection)
-        {
-            // Richtungswechsel - moderate Strafe
-            cost += 2.0f;
-        }
-        else
-        {
-            // Gleiche Richtung - kleiner Bonus (flüssigere Bewegung)
-            cost -= 1.0f;
-        }
-    }
-
-    // 10. String Change to Same Fret Penalty (KTH Paper 6.3.3)
-    //     Saitenwechsel zum gleichen Bund ist auf der Gitarre schwieriger als
-    //     man denkt - erfordert Barré oder schnellen Fingerwechsel.
-    //     Ausnahme: Leersaiten (fret 0) und adjacent strings (nur 1 Saite entfernt)
-    if (current.stringIndex != previous.stringIndex &&
-        current.fret == previous.fret && current.fret > 0)
-    {
-        int stringDist = std::abs(current.stringIndex - previous.stringIndex);
-        if (stringDist == 1)
-        {
-            // Benachbarte Saiten, gleicher Bund: Barré möglich, leichte Strafe
-            cost += 1.5f;
-        }
-        else
-        {
-            // Nicht-benachbarte Saiten, gleicher Bund: sehr schwierig
-            cost += 4.0f + stringDist * 1.0f;
-        }
-    }
-
-    // 11. Neck Position Scaling (KTH Paper 6.2.7)
-    //     Auf höheren Bünden (>12) sind die Abstände physisch kleiner,
-    //     daher sind größere Fret-Sprünge dort einfacher.
-    //     Reduziere die Fret-Distanz-Strafe proportional.
-    if (current.fret > 12 && previous.fret > 12 && fretDiff > 2)
-    {
-        // Durchschnittliche Position auf dem Hals
-        float avgFret = (current.fret + previous.fret) / 2.0f;
-        // Reduktionsfaktor: bei Fret 12 = 1.0 (kein Rabatt), bei Fret 24 = 0.6
-        float reductionFactor = 1.0f - (avgFret - 12.0f) * 0.033f;
-        reductionFactor = juce::jmax(0.6f, reductionFactor);
-        // Die Fret-Distanz-Kosten aus Punkt 1 teilweise zurückgeben
-        float fretCostReduction = fretDiff * 1.0f * (1.0f - reductionFactor);
-        cost -= fretCostReduction;
-    }
-
-    return cost;
-}
-
-NewProjectAudioProcessor::GuitarPosition NewProjectAudioProcessor::findBestPosition(int midiNote, int previousString, int previousFret) const
-{
-    auto candidates = getPossiblePositions(midiNote);
-    
-    if (candidates.empty())
-    {
-        // Fallback: Note nicht spielbar
-        return {0, juce::jmax(0, midiNote - standardTuning[5])}; 
-    }
-
-    // Wenn keine vorherige Position, nutze Fret-Position-Präferenz
-    if (previousString < 0 || previousFret < 0)
-    {
-        FretPosition pos = getFretPosition();
-        int preferredMinFret, preferredMaxFret;
-        switch (pos)
-        {
-            case FretPosition::Mid:
-                preferredMinFret = 5;
-                preferredMaxFret = 8;
-                break;
-            case FretPosition::High:
-                preferredMinFret = 9;
-                preferredMaxFret = 12;
-                break;
-            case FretPosition::Low:
-            default:
-                preferredMinFret = 0;
-                preferredMaxFret = 4;
-                break;
-        }
-        
-        // Finde beste Position im bevorzugten Bereich
-        GuitarPosition bestPos = candidates[0];
-        int bestScore = -1000;
-        
-        for (const auto& cand : candidates)
-        {
-            int score = 0;
-            
-            if (cand.fret >= preferredMinFret && cand.fret <= preferredMaxFret)
-            {
-                score += 100;
-            }
-            else
-            {
-                int distFromRange = 0;
-                if (cand.fret < preferredMinFret)
-                    distFromRange = preferredMinFret - cand.fret;
-                else
-                    distFromRange = cand.fret - preferredMaxFret;
-                score -= distFromRange * 5;
-            }
-            
-            // Präferenz für höhere Saiten
-            score += cand.stringIndex * 2;
-            
-            if (score > bestScore)
-            {
-                bestScore = score;
-                bestPos = cand;
-            }
-        }
-        return bestPos;
-    }
-
-    // Mit vorheriger Position: Nutze Kostenfunktion
-    GuitarPosition previousPos = {previousString, previousFret};
-    GuitarPosition bestPos = candidates[0];
-    float minCost = std::numeric_limits<float>::max();
-
-    for (const auto& cand : candidates)
-    {
-        float currentCost = calculatePositionCost(cand, previousPos);
-        if (currentCost < minCost)
-        {
-            minCost = currentCost;
-            bestPos = cand;
-        }
-    }
-    return bestPos;
-}
+    // Mit vorheriger Position: alle Kandidaten in einem Batch bewerten
+    // (gleiche Terme wie die Offline-Optimierung, siehe PlayabilityCostModel)
+    const auto batch = PlayabilityCostModel::CandidateBatch::fromPositions(candidates);
+    const int best = costModel.findBest(batch, { previousString, previousFret },
+                                        getLiveFastPassageFactor(), lastFretDirection);
+    return { batch.strings[(size_t) best], batch.frets[(size_t) best] };
+}
 
 NewProjectAudioProcessor::LiveMidiNote NewProjectAudioProcessor::midiNoteToTab(int midiNote, int velocity) const
 {
@@ -2257,7 +2052,7 @@ NewProjectAudioProcessor::LiveMidiNote NewProjectAudioProcessor::midiNoteToTab(i
     // Finde beste Position mit Kostenfunktion
     GuitarPosition bestPos = findBestPosition(midiNote, lastPlayedString, lastPlayedFret);
     
-    // Track note-on time for fast-passage detection in calculatePositionCost
+    // Track note-on time for fast-passage detection (getLiveFastPassageFactor)
     lastNoteOnTime = juce::Time::getMillisecondCounterHiRes() / 1000.0;
     
     // Track fret movement direction for ascending/descending sequence awareness (Paper 6.2.9)
@@ -2285,70 +2080,77 @@ NewProjectAudioProcessor::LiveMidiNote NewProjectAudioProcessor::midiNoteToTab(i
     }
     // If lookahead > 1 and counter not reached, keep using the old reference position
     
-    // standardTuning[0]=E4 (highest, top line), [5]=E2 (lowest, bottom line)
-    // This already matches display convention: 0=top, 5=bottom
+    // inputTuning: index 0 = highest string (top line), last = lowest (bottom line)
+    // This already matches display convention
     result.string = bestPos.stringIndex;
     result.fret = bestPos.fret;
     
     return result;
 }
 
-std::vector<NewProjectAudioProcessor::LiveMidiNote> NewProjectAudioProcessor::getLiveMidiNotes() const
+void NewProjectAudioProcessor::postHeldNotesToAnalyzer()
 {
-    std::lock_guard<std::mutex> lock(liveMidiMutex);
+    // Aufrufer hält liveMidiMutex
+    LiveChordAnalyzer::Input input;
+    input.handFret = lastPlayedFret;
+    for (const auto& [note, liveNote] : liveMidiNotes)
+    {
+        if (input.numNotes >= LiveChordAnalyzer::maxHeldNotes)
+            break;
+        input.notes[(size_t) input.numNotes++] = { note, liveNote.velocity, liveNote.string, liveNote.fret };
+    }
+    liveChordAnalyzer.post(input);
+}
+
+LiveChordAnalyzer::Result NewProjectAudioProcessor::analyseHeldNotes(const LiveChordAnalyzer::Input& held) const
+{
+    // Läuft im LiveChordAnalyzer-Thread: nur lesen, Ergebnis (inkl. neuer
+    // Handposition) wird als Ganzes veröffentlicht
+    LiveChordAnalyzer::Result analysis;
     
-    if (liveMidiNotes.empty())
+    if (held.numNotes == 0)
+        return analysis;  // Kein Akkord wenn keine Noten
+    
+    GuitarTuning tuning;
     {
-        detectedChordName = "";  // Kein Akkord wenn keine Noten
-        liveMutedStrings = { false, false, false, false, false, false };
-        return {};
+        std::lock_guard<std::mutex> lock(liveMidiMutex);
+        tuning = inputTuning;
     }
     
+    // Fret-Präferenz einmal für die ganze Analyse auflösen
+    const auto& costModel = getCostModel();
+    
     // Sammle alle aktiven MIDI-Noten
     std::vector<int> midiNoteNumbers;
     std::map<int, int> noteVelocities;
-    for (const auto& [note, liveNote] : liveMidiNotes)
+    for (int i = 0; i < held.numNotes; ++i)
     {
-        midiNoteNumbers.push_back(note);
-        noteVelocities[note] = liveNote.velocity;
+        midiNoteNumbers.push_back(held.notes[(size_t) i].midiNote);
+        noteVelocities[held.notes[(size_t) i].midiNote] = held.notes[(size_t) i].velocity;
     }
     std::sort(midiNoteNumbers.begin(), midiNoteNumbers.end());
     
+    // Akkordname für die UI direkt aus den gespielten Tonklassen (Tabellen-Lookup,
+    // unabhängig davon ob ein Griffbild in der Shape-Bibliothek existiert)
+    const juce::String playedChordName = (midiNoteNumbers.size() >= 3) ? ChordNaming::nameFor(midiNoteNumbers)
+                                                                       : juce::String();
+    
     // =========================================================================
     // CHORD MATCHING: Versuche zuerst, einen bekannten Akkord zu finden
     // =========================================================================
-    if (midiNoteNumbers.size() >= 3)  // Mindestens 3 Noten für Akkord-Matching
+    // Die Shape-Bibliothek kennt nur Griffbilder für 6-saitige Standardstimmung
+    if (midiNoteNumbers.size() >= 3 && tuning.isStandardGuitar())  // Mindestens 3 Noten für Akkord-Matching
     {
-        // Berechne aktuelle Handposition aus lastPlayedFret
-        int currentFretPosition = (lastPlayedFret >= 0) ? lastPlayedFret : 0;
-        
-        // Hole Fret-Präferenz
-        FretPosition pos = getFretPosition();
-        int preferredMinFret, preferredMaxFret;
-        switch (pos)
-        {
-            case FretPosition::Mid:
-                preferredMinFret = 5;
-                preferredMaxFret = 8;
-                break;
-            case FretPosition::High:
-                preferredMinFret = 9;
-                preferredMaxFret = 12;
-                break;
-            case FretPosition::Low:
-            default:
-                preferredMinFret = 0;
-                preferredMaxFret = 4;
-                break;
-        }
+        // Berechne aktuelle Handposition aus lastPlayedFret (Stand bei Notenänderung)
+        int currentFretPosition = (held.handFret >= 0) ? held.handFret : 0;
         
         // Versuche erst mit exaktem Bass-Matching
-        auto chordResult = chordMatcher.findBestChord(midiNoteNumbers, currentFretPosition, true, preferredMinFret, preferredMaxFret);
+        auto chordResult = chordMatcher.findBestChord(midiNoteNumbers, currentFretPosition, true, costModel);
         
         // Falls kein Match mit exaktem Bass, versuche ohne Bass-Constraint
         if (!chordResult.isMatch)
         {
-            chordResult = chordMatcher.findBestChord(midiNoteNumbers, currentFretPosition, false, preferredMinFret, preferredMaxFret);
+            chordResult = chordMatcher.findBestChord(midiNoteNumbers, currentFretPosition, false, costModel);
         }
         
         if (chordResult.isMatch && chordResult.shape != nullptr)
@@ -2358,19 +2160,18 @@ std::vector<NewProjectAudioProcessor::LiveMidiNote> NewProjectAudioProcessor::ge
             const auto& shape = *chordResult.shape;
             
             // Speichere erkannten Akkordnamen für die UI
-            detectedChordName = shape.name;
+            analysis.chordName = playedChordName.isNotEmpty() ? playedChordName : shape.name;
             
             DBG("Chord matched: " << shape.name << " (cost: " << chordResult.totalCost << ")");
             
             // Determine muted strings from the chord shape
             // ChordShape.frets: index 0=E2(lowest), 5=E4(highest)
-            // Display/standardTuning: index 0=E4(highest), 5=E2(lowest)
+            // Display/inputTuning: index 0=E4(highest), 5=E2(lowest)
             // So we need to reverse: display string s corresponds to shape string (5-s)
-            liveMutedStrings = { false, false, false, false, false, false };
             for (int s = 0; s < 6; ++s)
             {
                 if (shape.frets[5 - s] < 0)  // -1 = gedämpft (x)
-                    liveMutedStrings[s] = true;
+                    analysis.mutedStrings[(size_t) s] = true;
             }
             
             for (int s = 0; s < 6; ++s)
@@ -2378,7 +2179,7 @@ std::vector<NewProjectAudioProcessor::LiveMidiNote> NewProjectAudioProcessor::ge
                 int shapeString = 5 - s;  // Reverse: display s=0(E4) -> shape 5(E4)
                 if (shape.frets[shapeString] >= 0)  // Nicht gedämpft
                 {
-                    int midiNote = standardTuning[s] + shape.frets[shapeString];
+                    int midiNote = tuning.getOpenNote(s) + shape.frets[shapeString];
                     
                     // Finde die entsprechende Velocity (oder Standard)
                     int velocity = 100;
@@ -2401,69 +2202,41 @@ std::vector<NewProjectAudioProcessor::LiveMidiNote> NewProjectAudioProcessor::ge
                 }
             }
             
-            // Update lastPlayedFret für nächsten Akkord
-            lastPlayedFret = shape.baseFret;
+            // Update lastPlayedFret für nächsten Akkord (übernimmt der Audio-Thread)
+            analysis.handFret = shape.baseFret;
             
             // === Assign finger numbers for matched chord ===
             {
-                std::array<int, 6> chordFrets = { -1, -1, -1, -1, -1, -1 };
+                const int numStrings = tuning.getStringCount();
+                std::array<int, GuitarTuning::maxStrings> chordFrets;
+                chordFrets.fill(-1);
                 for (const auto& ln : result)
-                    if (ln.string >= 0 && ln.string < 6)
-                        chordFrets[ln.string] = ln.fret;
-                
-                // Try database lookup first
-                std::array<int, 6> fingers = { -1, -1, -1, -1, -1, -1 };
-                if (chordFingerDB.isLoaded())
-                    fingers = chordFingerDB.findFingers(shape.name, chordFrets, standardTuning);
+                    if (ln.string >= 0 && ln.string < numStrings)
+                        chordFrets[(size_t) ln.string] = ln.fret;
                 
-                // Fallback: algorithmic
-                bool hasDBFingers = false;
-                for (int f : fingers)
-                    if (f >= 0) { hasDBFingers = true; break; }
-                if (!hasDBFingers)
-                    fingers = ChordFingerDB::calculateFingersForChord(chordFrets);
-                
-                // Apply to result
+                // DB-Griff, sonst algorithmisch
+                const auto fingers = chordFingerDB.findOrCalculateFingers(shape.name, chordFrets, numStrings);
                 for (auto& ln : result)
-                    if (ln.string >= 0 && ln.string < 6)
-                        ln.fingerNumber = fingers[ln.string];
+                    if (ln.string >= 0 && ln.string < numStrings)
+                        ln.fingerNumber = fingers[(size_t) ln.string];
             }
             
-            return result;
+            analysis.notes = std::move(result);
+            return analysis;
         }
     }
     
     // =========================================================================
     // FALLBACK: Kein Akkord erkannt - verwende bestehenden Algorithmus
     // =========================================================================
-    detectedChordName = "";  // Kein bekannter Akkord
-    liveMutedStrings = { false, false, false, false, false, false };  // No muted strings in fallback
-    
-    // Hole bevorzugten Fret-Bereich
-    FretPosition pos = getFretPosition();
-    int preferredMinFret, preferredMaxFret;
-    switch (pos)
-    {
-        case FretPosition::Mid:
-            preferredMinFret = 5;
-            preferredMaxFret = 8;
-            break;
-        case FretPosition::High:
-            preferredMinFret = 9;
-            preferredMaxFret = 12;
-            break;
-        case FretPosition::Low:
-        default:
-            preferredMinFret = 0;
-            preferredMaxFret = 4;
-            break;
-    }
+    analysis.chordName = playedChordName;  // Kein Griffbild - Name (falls benennbar) trotzdem anzeigen
+    // No muted strings in fallback
     
     // Sammle alle aktiven Noten und sortiere sie nach Tonhöhe (niedrig zu hoch)
     std::vector<std::pair<int, int>> notesWithVelocity;  // midiNote, velocity
-    for (const auto& [note, liveNote] : liveMidiNotes)
+    for (int i = 0; i < held.numNotes; ++i)
     {
-        notesWithVelocity.push_back({note, liveNote.velocity});
+        notesWithVelocity.push_back({held.notes[(size_t) i].midiNote, held.notes[(size_t) i].velocity});
     }
     std::sort(notesWithVelocity.begin(), notesWithVelocity.end());
     
@@ -2478,51 +2251,12 @@ std::vector<NewProjectAudioProcessor::LiveMidiNote> NewProjectAudioProcessor::ge
     for (const auto& [midiNote, velocity] : notesWithVelocity)
     {
         std::vector<NoteOption> options;
-        for (int s = 0; s < 6; ++s)
+        for (const auto& position : tuning.getPositions(midiNote))
         {
-            int fret = midiNote - standardTuning[s];
-            if (fret >= 0 && fret <= 24)
-            {
-                // Berechne Score für diese Option
-                int score = 0;
-                
-                // Bonus für Frets im bevorzugten Bereich
-                if (fret >= preferredMinFret && fret <= preferredMaxFret)
-                {
-                    score += 100;
-                }
-                else
-                {
-                    // Strafe basierend auf Distanz zum bevorzugten Bereich
-                    // Progressive Strafe - je weiter weg, desto teurer
-                    int dist = 0;
-                    if (fret < preferredMinFret)
-                        dist = preferredMinFret - fret;
-                    else
-                        dist = fret - preferredMaxFret;
-                    
-                    // Quadratische Strafe für große Distanzen
-                    score -= dist * 15;  // Erhöht von 10
-                    if (dist > 3)
-                        score -= (dist - 3) * (dist - 3) * 5;
-                }
-                
-                // Bonus für Nähe zur letzten Position (Trägheit)
-                if (lastPlayedFret >= 0 && lastPlayedFret >= 7)
-                {
-                    // Wir sind in einer hohen Position - bevorzuge diese beizubehalten
-                    int distFromLast = std::abs(fret - lastPlayedFret);
-                    if (distFromLast <= 3)
-                        score += 30;  // Bonus für nahes Bleiben
-                    else if (distFromLast > 5)
-                        score -= (distFromLast - 5) * 8;  // Strafe für weites Springen
-                }
-                
-                // Leichte Präferenz für höhere Saiten (Melodie)
-                score += s * 2;
-                
-                options.push_back({s, fret, score});
-            }
+            const int s = position.string;
+            const int fret = position.fret;
+            const int score = costModel.liveChordOptionScore(s, fret, held.handFret);
+            options.push_back({s, fret, score});
         }
         // Sortiere Optionen nach Score (höchster zuerst)
         std::sort(options.begin(), options.end(), [](const NoteOption& a, const NoteOption& b) {
@@ -2565,10 +2299,10 @@ std::vector<NewProjectAudioProcessor::LiveMidiNote> NewProjectAudioProcessor::ge
                 if (fretSpan <= 2) score += 20;
                 else if (fretSpan <= 3) score += 10;
                 
-                if (lastPlayedFret >= 7 && maxFret > 0)
+                if (held.handFret >= 7 && maxFret > 0)
                 {
                     int centerOfCurrent = (minFret + maxFret) / 2;
-                    int distFromLastPos = std::abs(centerOfCurrent - lastPlayedFret);
+                    int distFromLastPos = std::abs(centerOfCurrent - held.handFret);
                     if (distFromLastPos <= 3)
                         score += 25;
                     else
@@ -2636,32 +2370,42 @@ std::vector<NewProjectAudioProcessor::LiveMidiNote> NewProjectAudioProcessor::ge
     }
     
     // Fallback: Wenn immer noch keine gültige Kombination, zeige einzelne Noten
+    // (Positionen wie sie der Audio-Thread beim Note-On per midiNoteToTab() vergeben hat)
     if (bestResult.empty())
     {
-        for (const auto& [midiNote, velocity] : notesWithVelocity)
+        for (int i = 0; i < held.numNotes; ++i)
         {
-            LiveMidiNote ln = midiNoteToTab(midiNote, velocity);
+            const auto& heldNote = held.notes[(size_t) i];
+            LiveMidiNote ln;
+            ln.midiNote = heldNote.midiNote;
+            ln.velocity = heldNote.velocity;
+            ln.string = heldNote.string;
+            ln.fret = heldNote.fret;
             bestResult.push_back(ln);
         }
+        std::sort(bestResult.begin(), bestResult.end(),
+                  [](const LiveMidiNote& a, const LiveMidiNote& b) { return a.midiNote < b.midiNote; });
     }
     
     // Assign finger numbers to fallback bestResult (backtracking or single-note path)
+    const int numStrings = tuning.getStringCount();
     if (!bestResult.empty() && bestResult[0].fingerNumber < 0)
     {
         if (bestResult.size() > 1)
         {
             // Multi-note: use algorithmic chord finger calculation
-            std::array<int,6> chordFrets = {-1,-1,-1,-1,-1,-1};
+            std::array<int, GuitarTuning::maxStrings> chordFrets;
+            chordFrets.fill(-1);
             for (const auto& n : bestResult)
             {
-                if (n.string >= 0 && n.string < 6)
-                    chordFrets[n.string] = n.fret;
+                if (n.string >= 0 && n.string < numStrings)
+                    chordFrets[(size_t) n.string] = n.fret;
             }
             auto fingers = ChordFingerDB::calculateFingersForChord(chordFrets);
             for (auto& n : bestResult)
             {
-                if (n.string >= 0 && n.string < 6)
-                    n.fingerNumber = fingers[n.string];
+                if (n.string >= 0 && n.string < numStrings)
+                    n.fingerNumber = fingers[(size_t) n.string];
             }
         }
         else
@@ -2669,12 +2413,13 @@ std::vector<NewProjectAudioProcessor::LiveMidiNote> NewProjectAudioProcessor::ge
             // Single note: use single-note finger calculation
             for (auto& n : bestResult)
             {
-                if (n.string >= 0 && n.string < 6)
+                if (n.string >= 0 && n.string < numStrings)
                 {
-                    std::array<int,6> singleFrets = {-1,-1,-1,-1,-1,-1};
-                    singleFrets[n.string] = n.fret;
+                    std::array<int, GuitarTuning::maxStrings> singleFrets;
+                    singleFrets.fill(-1);
+                    singleFrets[(size_t) n.string] = n.fret;
                     auto fingers = ChordFingerDB::calculateFingersForChord(singleFrets);
-                    n.fingerNumber = fingers[n.string];
+                    n.fingerNumber = fingers[(size_t) n.string];
                 }
             }
         }
@@ -2690,18 +2435,18 @@ std::vector<NewProjectAudioProcessor::LiveMidiNote> NewProjectAudioProcessor::ge
                 maxFret = note.fret;
         }
         if (maxFret > 0)
-            lastPlayedFret = maxFret;
+            analysis.handFret = maxFret;
     }
     
-    return bestResult;
+    analysis.notes = std::move(bestResult);
+    return analysis;
 }
 
 TabTrack NewProjectAudioProcessor::getEmptyTabTrack() const
 {
     TabTrack track;
     track.name = "MIDI Input";
-    track.stringCount = 6;
-    track.tuning = { 64, 59, 55, 50, 45, 40 };  // E-Standard (High to Low)
+    applyInputTuning(track);
     track.colour = juce::Colours::blue;
     
     // Create measures based on DAW time signature
@@ -2736,6 +2481,7 @@ void NewProjectAudioProcessor::insertTranscribedNotesIntoTab()
     if (noteEvents.empty())
     {
         DBG("AudioTranscriber: No notes detected in transcription");
+        audioTranscriber.clearResults();
         return;
     }
     
@@ -2747,22 +2493,18 @@ void NewProjectAudioProcessor::insertTranscribedNotesIntoTab()
     
     // Beats per second = BPM / 60
     double beatsPerSecond = tempo / 60.0;
+    const double takeStartBeat = transcriptionStartBeat.load();
     
-    std::lock_guard<std::mutex> recLock(recordingMutex);
-    
-    // Setze recordingStartBeat falls nicht gesetzt
-    if (!recordingStartSet)
-    {
-        recordingStartBeat = audioRecordingStartBeat;
-        recordingStartSet = true;
-    }
+    // Umrechnung und Optimierung ohne Lock - der Audio-Thread nimmt recordingMutex
+    std::vector<RecordedNote> transcribed;
+    transcribed.reserve(noteEvents.size());
     
     for (const auto& event : noteEvents)
     {
         // BasicPitch event times are in seconds (relative to start of recording at 22050 Hz)
         // Convert to beats relative to DAW timeline
-        double startBeat = audioRecordingStartBeat + (event.startTime * beatsPerSecond);
-        double endBeat = audioRecordingStartBeat + (event.endTime * beatsPerSecond);
+        double startBeat = takeStartBeat + (event.startTime * beatsPerSecond);
+        double endBeat = takeStartBeat + (event.endTime * beatsPerSecond);
         
         // Quantize to 1/64 note grid (like MIDI recording does)
         double quantizeGrid = 0.0625;
@@ -2779,15 +2521,10 @@ void NewProjectAudioProcessor::insertTranscribedNotesIntoTab()
         // Velocity from amplitude
         int velocity = juce::jlimit(1, 127, static_cast<int>(event.amplitude * 127.0));
         
-        // Convert to tab position using the same logic as MIDI recording
-        LiveMidiNote tabNote = midiNoteToTab(midiNote, velocity);
-        
         RecordedNote recNote;
         recNote.midiNote = midiNote;
         recNote.midiChannel = 1;  // Audio input = channel 1
         recNote.velocity = velocity;
-        recNote.string = tabNote.string;
-        recNote.fret = tabNote.fret;
         recNote.startBeat = startBeat;
         recNote.endBeat = endBeat;
         recNote.isActive = false;  // Already complete
@@ -2814,14 +2551,65 @@ void NewProjectAudioProcessor::insertTranscribedNotesIntoTab()
                 recNote.maxBendValue = 0.0f;
         }
         
-        // Assign finger number for audio-transcribed notes
-        recNote.fingerNumber = ChordFingerDB::calculateFingerForNote(
-            recNote.fret, recNote.string,
-            lastPlayedFret, lastFingerUsed, lastFingerString);
-        lastFingerUsed = recNote.fingerNumber;
-        lastFingerString = recNote.string;
+        transcribed.push_back(recNote);
+    }
+    
+    // Saiten/Bünde für die komplette Transkription global optimieren
+    // (gleiche Akkord-Toleranz wie reoptimizeRecordedNotes)
+    std::sort(transcribed.begin(), transcribed.end(), [](const RecordedNote& a, const RecordedNote& b) {
+        return a.startBeat < b.startBeat;
+    });
+    
+    std::vector<FingeringOptimizer::NoteGroup> noteGroups;
+    std::vector<size_t> groupStarts;
+    for (size_t i = 0; i < transcribed.size(); ++i)
+    {
+        if (groupStarts.empty() || transcribed[i].startBeat - transcribed[groupStarts.back()].startBeat > 0.06)
+        {
+            if (! noteGroups.empty())
+                noteGroups.back().beatsToNext = transcribed[i].startBeat - transcribed[groupStarts.back()].startBeat;
+            groupStarts.push_back(i);
+            noteGroups.emplace_back();
+            noteGroups.back().beatsToNext = transcribed[i].endBeat - transcribed[i].startBeat;
+        }
+        noteGroups.back().midiNotes.push_back(transcribed[i].midiNote);
+    }
+    
+    const auto assignments = createFingeringOptimizer().optimise(noteGroups);
+    
+    // Fingerverkettung nur innerhalb der Transkription (lastFingerUsed gehört dem Audio-Thread)
+    int previousFret = -1, previousFinger = -1, previousFingerString = -1;
+    for (size_t g = 0; g < groupStarts.size(); ++g)
+    {
+        for (size_t n = 0; n < assignments[g].size(); ++n)
+        {
+            auto& recNote = transcribed[groupStarts[g] + n];
+            const auto& choice = assignments[g][n];
+            recNote.string = choice.isValid() ? choice.string : 0;
+            recNote.fret = choice.isValid() ? choice.fret : 0;
+            
+            // Assign finger number for audio-transcribed notes
+            recNote.fingerNumber = ChordFingerDB::calculateFingerForNote(
+                recNote.fret, recNote.string,
+                previousFret, previousFinger, previousFingerString);
+            previousFinger = recNote.fingerNumber;
+            previousFingerString = recNote.string;
+            previousFret = recNote.fret;
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> recLock(recordingMutex);
+        
+        // Setze recordingStartBeat falls nicht gesetzt
+        if (!recordingStartSet)
+        {
+            recordingStartBeat = takeStartBeat;
+            recordingStartSet = true;
+        }
         
-        recordedNotes.push_back(recNote);
+        for (auto& recNote : transcribed)
+            recordedNotes.add(std::move(recNote));
     }
     
     DBG("AudioTranscriber: " << noteEvents.size() << " notes inserted, total recorded: " << recordedNotes.size());
@@ -2835,9 +2623,10 @@ void NewProjectAudioProcessor::clearRecording()
     {
         std::lock_guard<std::mutex> lock(recordingMutex);
         recordedNotes.clear();
-        activeRecordingNotes.clear();
+        recordingCapture.clear();
         recordingStartBeat = 0.0;
         recordingStartSet = false;
+        accountRecordedNotes();
     }
     
     // Reset playback state
@@ -2860,13 +2649,24 @@ void NewProjectAudioProcessor::clearRecording()
     {
         std::lock_guard<std::mutex> lock(liveMidiMutex);
         liveMidiNotes.clear();
+        postHeldNotesToAnalyzer();
     }
     
     // Reset YIN monophonic pitch detector
     audioToMidiProcessor.reset();
     
     // Clear edited tracks
-    editedTracks.clear();
+    {
+        std::lock_guard<std::mutex> lock(editedTracksMutex);
+        editedTracks.clear();
+        editedTrackHeapBytes.clear();
+        tabUndoHistories.clear();
+        clearRecordedNotesUndo(allEditedTracks);
+        sessionAutosave.postClearTracks();
+        accountEditedTracks();
+    }
+    publishEditedTracks(allEditedTracks);
+    tabEditJournal.clear();
     
     // Reset recording enabled flag
     recordingEnabled.store(false);
@@ -2876,501 +2676,157 @@ void NewProjectAudioProcessor::clearRecording()
 
 void NewProjectAudioProcessor::reoptimizeRecordedNotes(int midiChannelFilter)
 {
-    std::lock_guard<std::mutex> lock(recordingMutex);
+    // 1. Momentaufnahme pro Kanal - recordingMutex nur kurz halten,
+    //    damit der Audio-Thread während der Optimierung weiter aufnehmen kann
+    std::map<int, std::vector<ReoptimizeNote>> notesByChannel;
+    {
+        std::lock_guard<std::mutex> lock(recordingMutex);
+        syncRecordingCapture();
+        for (size_t i = 0; i < recordedNotes.size(); ++i)
+        {
+            const auto& note = recordedNotes[i];
+            if (midiChannelFilter < 0 || note.midiChannel == midiChannelFilter)
+                notesByChannel[note.midiChannel].push_back({ i, note.midiNote, note.startBeat, note.endBeat,
+                                                             note.string, note.fret, note.fingerNumber });
+        }
+    }
     
-    if (recordedNotes.empty())
+    if (notesByChannel.empty())
         return;
     
-    // Get current settings
-    int lookahead = positionLookahead.load();
-    FretPosition pos = getFretPosition();
-    int preferredMinFret, preferredMaxFret;
-    switch (pos)
+    // 2. Kanäle sind unabhängige Phrasen → parallel optimieren.
+    //    Optimizer und Akkordname werden einmal erzeugt und von allen Jobs nur gelesen.
+    const auto optimizer = createFingeringOptimizer();
+    const juce::String detectedChordName = getLiveAnalysis().chordName;
+    
+    std::vector<std::vector<ReoptimizeNote>*> shards;
+    for (auto& [channel, notes] : notesByChannel)
+        shards.push_back(&notes);
+    
+    channelWorkerPool.runAll((int) shards.size(), [&](int i)
     {
-        case FretPosition::Mid:
-            preferredMinFret = 5;
-            preferredMaxFret = 8;
-            break;
-        case FretPosition::High:
-            preferredMinFret = 9;
-            preferredMaxFret = 12;
-            break;
-        case FretPosition::Low:
-        default:
-            preferredMinFret = 0;
-            preferredMaxFret = 4;
-            break;
-    }
+        reoptimizeChannelNotes(*shards[(size_t) i], optimizer, detectedChordName);
+    });
     
-    // Collect indices to process (filtered by channel if specified)
-    std::vector<size_t> sortedIndices;
-    for (size_t i = 0; i < recordedNotes.size(); ++i)
+    // 3. Ergebnisse atomar zurückschreiben. Noten, die sich inzwischen geändert
+    //    haben (clearRecording, Undo, neue Aufnahme), werden übersprungen.
     {
-        if (midiChannelFilter < 0 || recordedNotes[i].midiChannel == midiChannelFilter)
-            sortedIndices.push_back(i);
+        std::lock_guard<std::mutex> lock(recordingMutex);
+        syncRecordingCapture();
+        for (const auto* shard : shards)
+        {
+            for (const auto& n : *shard)
+            {
+                if (n.index >= recordedNotes.size())
+                    continue;
+                
+                const auto& current = recordedNotes[n.index];
+                if (current.midiNote != n.midiNote || current.startBeat != n.startBeat)
+                    continue;
+                
+                auto& note = recordedNotes.modify(n.index);
+                note.string = n.string;
+                note.fret = n.fret;
+                note.fingerNumber = n.fingerNumber;
+            }
+        }
     }
     
-    if (sortedIndices.empty())
-        return;
-    
-    // Sortiere Noten nach Startzeit für sequentielle Verarbeitung
-    std::sort(sortedIndices.begin(), sortedIndices.end(), [this](size_t a, size_t b) {
-        return recordedNotes[a].startBeat < recordedNotes[b].startBeat;
-    });
-    
-    // Reset last played position
+    // Reset für normale Verwendung
     lastPlayedString = -1;
     lastPlayedFret = -1;
-    positionLookaheadCounter = 0;  // Reset counter for lookahead
-    
-    // Tracking variables for lookahead - separate from the mutable class members
-    int referenceString = -1;
-    int referenceFret = -1;
-    int noteCounter = 0;
+    positionLookaheadCounter = 0;
+}
+
+void NewProjectAudioProcessor::reoptimizeChannelNotes(std::vector<ReoptimizeNote>& notes,
+                                                      const FingeringOptimizer& optimizer,
+                                                      const juce::String& detectedChordName) const
+{
+    // Sortiere Noten nach Startzeit für sequentielle Verarbeitung
+    std::stable_sort(notes.begin(), notes.end(), [](const ReoptimizeNote& a, const ReoptimizeNote& b) {
+        return a.startBeat < b.startBeat;
+    });
     
     // Gruppiere Noten nach Beat (simultane Noten = Akkord)
+    // WICHTIG: Muss mit RecordedNoteStore::chordThreshold (Tab-Layout) übereinstimmen!
+    // Sonst werden Noten dort als Akkord gruppiert, aber hier einzeln verarbeitet
+    // → gleiche Saite möglich → zweite Note wird in der Tab-Ausgabe überschrieben!
+    const double beatTolerance = RecordedNoteStore::chordThreshold;  // Noten innerhalb von 0.06 Beats = gleichzeitig
+    std::vector<std::vector<size_t>> groups;
     double currentBeat = -1.0;
-    std::vector<size_t> currentGroup;
+    for (size_t idx = 0; idx < notes.size(); ++idx)
+    {
+        double noteBeat = notes[idx].startBeat;
+        if (groups.empty() || std::abs(noteBeat - currentBeat) > beatTolerance)
+        {
+            groups.emplace_back();
+            currentBeat = noteBeat;
+        }
+        groups.back().push_back(idx);
+    }
     
-    auto processGroup = [this, &referenceString, &referenceFret, &noteCounter, lookahead, preferredMinFret, preferredMaxFret](std::vector<size_t>& group) {
-        if (group.empty()) return;
+    // Globale Optimierung über die gesamte Phrase (Viterbi statt gierig pro Note)
+    std::vector<FingeringOptimizer::NoteGroup> noteGroups(groups.size());
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        auto& ng = noteGroups[g];
+        for (size_t idx : groups[g])
+            ng.midiNotes.push_back(notes[idx].midiNote);
         
-        if (group.size() == 1)
+        double groupStart = notes[groups[g].front()].startBeat;
+        if (g + 1 < groups.size())
         {
-            // Einzelne Note - custom lookahead logic
-            size_t idx = group[0];
-            int midiNote = recordedNotes[idx].midiNote;
+            ng.beatsToNext = notes[groups[g + 1].front()].startBeat - groupStart;
+        }
+        else
+        {
+            const auto& last = notes[groups[g].front()];
+            ng.beatsToNext = last.endBeat - last.startBeat;
+        }
+    }
+    
+    const auto assignments = optimizer.optimise(noteGroups);
+    
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        const auto& group = groups[g];
+        for (size_t i = 0; i < group.size(); ++i)
+        {
+            const auto& choice = assignments[g][i];
+            if (! choice.isValid())
+                continue;  // Nicht spielbar (mehr Noten als Saiten) - alte Position behalten
             
-            // Find best position based on reference position
-            auto candidates = getPossiblePositions(midiNote);
-            if (candidates.empty())
+            notes[group[i]].string = choice.string;
+            notes[group[i]].fret = choice.fret;
+        }
+        
+        // === Chord finger assignment ===
+        // For groups with 2+ notes, assign fingers using the DB or algorithmic method
+        if (group.size() >= 2)
+        {
+            // Bundarray über alle Saiten der Stimmung (auch 7/8-Saiter)
+            const int numStrings = optimizer.getTuning().getStringCount();
+            std::array<int, GuitarTuning::maxStrings> chordFrets;
+            chordFrets.fill(-1);
+            for (size_t idx : group)
             {
-                recordedNotes[idx].string = 0;
-                recordedNotes[idx].fret = juce::jmax(0, midiNote - standardTuning[5]);
+                int s = notes[idx].string;
+                if (s >= 0 && s < numStrings)
+                    chordFrets[(size_t) s] = notes[idx].fret;
             }
-            else
+            
+            // DB-Griff (falls ein Akkord erkannt wurde), sonst algorithmisch
+            const auto fingers = chordFingerDB.findOrCalculateFingers(detectedChordName, chordFrets, numStrings);
+            
+            // Apply fingers to recorded notes
+            for (size_t idx : group)
             {
-                GuitarPosition bestPos = candidates[0];
-                
-                // Check if fret 0 is available as an option
-                bool hasFret0Option = false;
-                int fret0String = -1;
-                for (const auto& cand : candidates)
-                {
-                    if (cand.fret == 0)
-                    {
-                        hasFret0Option = true;
-                        fret0String = cand.stringIndex;
-                        break;
-                    }
-                }
-                
-                // Store scores for debug output
-                std::vector<std::pair<GuitarPosition, int>> debugScores;
-                
-                if (referenceString < 0 || referenceFret < 0)
-                {
-                    // No reference - use fret position preference
-                    int bestScore = -1000;
-                    for (const auto& cand : candidates)
-                    {
-                        int score = 0;
-                        
-                        // Open string (fret 0) gets a bonus to be preferred
-                        if (cand.fret == 0)
-                        {
-                            score += 115;  // Bonus for open strings
-                        }
-                        else if (cand.fret >= preferredMinFret && cand.fret <= preferredMaxFret)
-                        {
-                            score += 100;
-                        }
-                        else
-                        {
-                            int dist = (cand.fret < preferredMinFret) ? (preferredMinFret - cand.fret) : (cand.fret - preferredMaxFret);
-                            score -= dist * 5;
-                        }
-                        score += cand.stringIndex * 2;  // Slight preference for higher strings
-                        
-                        debugScores.push_back({cand, score});
-                        
-                        if (score > bestScore)
-                        {
-                            bestScore = score;
-                            bestPos = cand;
-                        }
-                    }
-                    
-                    // Debug: Why was fret 0 not chosen?
-                    if (hasFret0Option && bestPos.fret != 0)
-                    {
-                        DBG("=== FRET 0 NOT CHOSEN (no ref) for MIDI " << midiNote << " ===");
-                        DBG("  Chosen: string=" << bestPos.stringIndex << " fret=" << bestPos.fret);
-                        DBG("  preferredMinFret=" << preferredMinFret << " preferredMaxFret=" << preferredMaxFret);
-                        for (const auto& [pos, score] : debugScores)
-                        {
-                            DBG("    Option: string=" << pos.stringIndex << " fret=" << pos.fret << " -> score=" << score);
-                        }
-                    }
-                }
-                else
-                {
-                    // Have reference - use reference position as dynamic center
-                    // The reference position becomes the new "preferred" position
-                    float bestCost = 99999.0f;
-                    std::vector<std::pair<GuitarPosition, float>> debugCosts;
-                    
-                    for (const auto& cand : candidates)
-                    {
-                        float cost = 0.0f;
-                        
-                        // Open string (fret 0) gets a bonus - subtract from cost
-                        if (cand.fret == 0)
-                        {
-                            cost -= 10.0f;  // Bonus for open strings
-                        }
-                        else
-                        {
-                            // Distance from reference position
-                            int fretDiff = std::abs(cand.fret - referenceFret);
-                            cost += fretDiff * 5.0f;  // Strong penalty for moving away from reference
-                        }
-                        
-                        // String jump penalty
-                        int stringDiff = std::abs(cand.stringIndex - referenceString);
-                        cost += stringDiff * 3.0f;
-                        
-                        // Small preference for staying in original fret position range
-                        if (cand.fret > 0 && cand.fret >= preferredMinFret && cand.fret <= preferredMaxFret)
-                            cost -= 2.0f;
-                        
-                        // Hohe Strafe für große Fret-Sprünge (>3) bei schnellen Noten
-                        // Achtel = 0.5 Beats, Sechzehntel = 0.25, 32stel = 0.125
-                        if (cand.fret != 0 && referenceFret > 0)
-                        {
-                            int fretJump = std::abs(cand.fret - referenceFret);
-                            if (fretJump > 3)
-                            {
-                                double noteDuration = recordedNotes[idx].endBeat - recordedNotes[idx].startBeat;
-                                if (noteDuration <= 0.5 + 0.01)  // Achtel oder kürzer (+ kleine Toleranz)
-                                {
-                                    // Je kürzer die Note, desto teurer der Sprung
-                                    float speedFactor = (noteDuration <= 0.125) ? 3.0f :   // 32stel
-                                                        (noteDuration <= 0.25)  ? 2.0f :   // 16tel
-                                                                                   1.0f;    // Achtel
-                                    cost += (fretJump - 3) * 50.0f * speedFactor;
-                                }
-                            }
-                        }
-                        
-                        debugCosts.push_back({cand, cost});
-                        
-                        if (cost < bestCost)
-                        {
-                            bestCost = cost;
-                            bestPos = cand;
-                        }
-                    }
-                    
-                    // Debug: Why was fret 0 not chosen?
-                    if (hasFret0Option && bestPos.fret != 0)
-                    {
-                        DBG("=== FRET 0 NOT CHOSEN (with ref) for MIDI " << midiNote << " ===");
-                        DBG("  Chosen: string=" << bestPos.stringIndex << " fret=" << bestPos.fret);
-                        DBG("  refString=" << referenceString << " refFret=" << referenceFret);
-                        for (const auto& [pos, cost] : debugCosts)
-                        {
-                            DBG("    Option: string=" << pos.stringIndex << " fret=" << pos.fret << " -> cost=" << cost);
-                        }
-                    }
-                }
-                
-                recordedNotes[idx].string = bestPos.stringIndex;
-                recordedNotes[idx].fret = bestPos.fret;
-                
-                // Update reference only every N notes (lookahead)
-                noteCounter++;
-                if (noteCounter >= lookahead)
-                {
-                    referenceString = bestPos.stringIndex;
-                    referenceFret = bestPos.fret;
-                    noteCounter = 0;
-                }
-            }
-        }
-        else
-        {
-            // Mehrere Noten gleichzeitig - verwende getLiveMidiNotes-Logik
-            // Baue temporäre liveMidiNotes auf
-            std::map<int, LiveMidiNote> tempLiveMidi;
-            for (size_t idx : group)
-            {
-                LiveMidiNote ln;
-                ln.midiNote = recordedNotes[idx].midiNote;
-                ln.velocity = recordedNotes[idx].velocity;
-                tempLiveMidi[ln.midiNote] = ln;
-            }
-            
-            // Sammle alle Noten und sortiere nach Tonhöhe
-            std::vector<std::pair<int, size_t>> notesWithIdx;  // midiNote, index in group
-            for (size_t i = 0; i < group.size(); ++i)
-            {
-                notesWithIdx.push_back({recordedNotes[group[i]].midiNote, i});
-            }
-            std::sort(notesWithIdx.begin(), notesWithIdx.end());
-            
-            // Für jede Note: finde alle möglichen Positionen
-            struct NoteOption { int string; int fret; int score; };
-            std::vector<std::vector<NoteOption>> allOptions;
-            
-            for (const auto& [midiNote, _] : notesWithIdx)
-            {
-                std::vector<NoteOption> options;
-                for (int s = 0; s < 6; ++s)
-                {
-                    int fret = midiNote - standardTuning[s];
-                    if (fret >= 0 && fret <= 24)
-                    {
-                        int score = 0;
-                        
-                        // Open string (fret 0) is neutral - valid in any fret position range
-                        if (fret == 0 || (fret >= preferredMinFret && fret <= preferredMaxFret))
-                        {
-                            score += 100;
-                        }
-                        else
-                        {
-                            int dist = (fret < preferredMinFret) ? (preferredMinFret - fret) : (fret - preferredMaxFret);
-                            score -= dist * 15;
-                            if (dist > 3)
-                                score -= (dist - 3) * (dist - 3) * 5;
-                        }
-                        
-                        // Use reference fret for lookahead consistency (only for fretted notes)
-                        if (fret > 0 && referenceFret >= 7)
-                        {
-                            int distFromRef = std::abs(fret - referenceFret);
-                            if (distFromRef <= 3)
-                                score += 30;
-                            else if (distFromRef > 5)
-                                score -= (distFromRef - 5) * 8;
-                        }
-                        
-                        score += s * 2;
-                        options.push_back({s, fret, score});
-                    }
-                }
-                std::sort(options.begin(), options.end(), [](const NoteOption& a, const NoteOption& b) {
-                    return a.score > b.score;
-                });
-                allOptions.push_back(options);
-            }
-            
-            // Backtracking-Suche mit progressiver Relaxierung:
-            // Erst versuche max 3 Bünde Spannweite, dann 4, 5, ... bis Lösung gefunden.
-            // Die Spannweite fließt als SCHWERE Strafe in den Score ein.
-            std::vector<NoteOption> bestAssignment(allOptions.size());
-            int bestTotalScore = -100000;
-            int usedMaxSpan = 0;
-            
-            auto runBacktracking = [&](int allowedSpan) {
-                std::function<void(size_t, std::vector<NoteOption>&, std::set<int>&)> findBestChord;
-                findBestChord = [&](size_t noteIdx, std::vector<NoteOption>& current, std::set<int>& usedStrings) {
-                    if (noteIdx >= allOptions.size())
-                    {
-                        // Prüfe Fret-Spannweite (Leersaiten ausgenommen)
-                        int minF = 100, maxF = 0;
-                        for (const auto& opt : current)
-                        {
-                            if (opt.fret > 0)
-                            {
-                                minF = std::min(minF, opt.fret);
-                                maxF = std::max(maxF, opt.fret);
-                            }
-                        }
-                        int span = (minF <= maxF) ? (maxF - minF) : 0;
-                        if (span > allowedSpan)
-                            return;  // Spannweite zu groß für diese Runde
-                        
-                        int totalScore = 0;
-                        for (const auto& opt : current)
-                            totalScore += opt.score;
-                        // Schwere Strafe für Spannweite - je größer, desto schlimmer
-                        totalScore -= span * span * 15;
-                        if (span <= 2) totalScore += 20;
-                        else if (span <= 3) totalScore += 10;
-                        
-                        if (totalScore > bestTotalScore)
-                        {
-                            bestTotalScore = totalScore;
-                            bestAssignment = current;
-                            usedMaxSpan = span;
-                        }
-                        return;
-                    }
-                    
-                    for (const auto& opt : allOptions[noteIdx])
-                    {
-                        // Saite darf NICHT doppelt belegt sein
-                        if (usedStrings.count(opt.string) > 0)
-                            continue;
-                        
-                        // Frühe Prüfung: Fret-Spannweite
-                        int minF = 100, maxF = 0;
-                        for (const auto& prev : current)
-                        {
-                            if (prev.fret > 0) { minF = std::min(minF, prev.fret); maxF = std::max(maxF, prev.fret); }
-                        }
-                        if (opt.fret > 0)
-                        {
-                            int newMin = std::min(minF, opt.fret);
-                            int newMax = std::max(maxF, opt.fret);
-                            if (newMin <= newMax && newMax - newMin > allowedSpan)
-                                continue;  // Würde erlaubte Spannweite überschreiten
-                        }
-                        
-                        current.push_back(opt);
-                        usedStrings.insert(opt.string);
-                        findBestChord(noteIdx + 1, current, usedStrings);
-                        usedStrings.erase(opt.string);
-                        current.pop_back();
-                    }
-                };
-                
-                std::vector<NoteOption> current;
-                std::set<int> usedStrings;
-                findBestChord(0, current, usedStrings);
-            };
-            
-            // Progressive Relaxierung: erst 3 Bünde, dann 4, 5, ... bis max 7
-            for (int trySpan = 3; trySpan <= 7; ++trySpan)
-            {
-                runBacktracking(trySpan);
-                if (bestTotalScore > -100000)
-                    break;  // Gültige Lösung gefunden!
-            }
-            
-            // Absoluter Notfall: Kein gültiges Ergebnis bis Spannweite 7.
-            // Nimm die beste Option pro Note mit unique Strings.
-            if (bestTotalScore <= -100000)
-            {
-                std::set<int> usedStrings;
-                for (size_t i = 0; i < allOptions.size(); ++i)
-                {
-                    bool assigned = false;
-                    for (const auto& opt : allOptions[i])
-                    {
-                        if (usedStrings.count(opt.string) == 0)
-                        {
-                            bestAssignment[i] = opt;
-                            usedStrings.insert(opt.string);
-                            assigned = true;
-                            break;
-                        }
-                    }
-                    if (!assigned && !allOptions[i].empty())
-                        bestAssignment[i] = allOptions[i][0];
-                }
-            }
-            
-            // Weise die Ergebnisse zu
-            int avgFret = 0;
-            int fretCount = 0;
-            for (size_t i = 0; i < notesWithIdx.size(); ++i)
-            {
-                size_t groupIdx = notesWithIdx[i].second;
-                size_t recIdx = group[groupIdx];
-                // standardTuning[0]=E4(top), [5]=E2(bottom) - matches display convention
-                recordedNotes[recIdx].string = bestAssignment[i].string;
-                recordedNotes[recIdx].fret = bestAssignment[i].fret;
-                
-                // Track average fret for chord position reference
-                if (bestAssignment[i].fret > 0)
-                {
-                    avgFret += bestAssignment[i].fret;
-                    fretCount++;
-                }
-            }
-            
-            // === Chord finger assignment ===
-            // For groups with 2+ notes, assign fingers using the DB or algorithmic method
-            if (group.size() >= 2)
-            {
-                // Build fret array for all 6 strings
-                std::array<int, 6> chordFrets = { -1, -1, -1, -1, -1, -1 };
-                for (size_t idx : group)
-                {
-                    int s = recordedNotes[idx].string;
-                    if (s >= 0 && s < 6)
-                        chordFrets[s] = recordedNotes[idx].fret;
-                }
-                
-                // Try database lookup first (if chord was detected)
-                std::array<int, 6> fingers = { -1, -1, -1, -1, -1, -1 };
-                if (chordFingerDB.isLoaded() && detectedChordName.isNotEmpty())
-                {
-                    fingers = chordFingerDB.findFingers(detectedChordName, chordFrets, standardTuning);
-                }
-                
-                // Fallback: algorithmic chord finger assignment
-                bool hasDBFingers = false;
-                for (int f : fingers)
-                    if (f >= 0) { hasDBFingers = true; break; }
-                
-                if (!hasDBFingers)
-                    fingers = ChordFingerDB::calculateFingersForChord(chordFrets);
-                
-                // Apply fingers to recorded notes
-                for (size_t idx : group)
-                {
-                    int s = recordedNotes[idx].string;
-                    if (s >= 0 && s < 6)
-                        recordedNotes[idx].fingerNumber = fingers[s];
-                }
-            }
-            
-            // Update reference with lookahead for chords
-            noteCounter++;
-            if (noteCounter >= lookahead && fretCount > 0)
-            {
-                referenceFret = avgFret / fretCount;
-                referenceString = 2;  // Middle string as reference for chords
-                noteCounter = 0;
+                int s = notes[idx].string;
+                if (s >= 0 && s < numStrings)
+                    notes[idx].fingerNumber = fingers[(size_t) s];
             }
         }
-        group.clear();
-    };
-    
-    // Verarbeite Noten in Gruppen nach Beat
-    // WICHTIG: Muss mit chordThreshold in getRecordedTabTrack() übereinstimmen!
-    // Sonst werden Noten dort als Akkord gruppiert, aber hier einzeln verarbeitet
-    // → gleiche Saite möglich → zweite Note wird in der Tab-Ausgabe überschrieben!
-    const double beatTolerance = 0.06;  // Noten innerhalb von 0.06 Beats = gleichzeitig (=chordThreshold)
-    for (size_t idx : sortedIndices)
-    {
-        double noteBeat = recordedNotes[idx].startBeat;
-        
-        if (currentBeat < 0 || std::abs(noteBeat - currentBeat) <= beatTolerance)
-        {
-            // Gleicher Beat - zur Gruppe hinzufügen
-            currentGroup.push_back(idx);
-            if (currentBeat < 0)
-                currentBeat = noteBeat;
-        }
-        else
-        {
-            // Neuer Beat - vorherige Gruppe verarbeiten
-            processGroup(currentGroup);
-            currentGroup.push_back(idx);
-            currentBeat = noteBeat;
-        }
     }
-    // Letzte Gruppe verarbeiten
-    processGroup(currentGroup);
-    
-    // Reset für normale Verwendung
-    lastPlayedString = -1;
-    lastPlayedFret = -1;
 }
 
 void NewProjectAudioProcessor::updateRecordedNotesFromLive(const std::vector<LiveMidiNote>& liveNotes)
@@ -3381,329 +2837,386 @@ void NewProjectAudioProcessor::updateRecordedNotesFromLive(const std::vector<Liv
     
     std::lock_guard<std::mutex> lock(recordingMutex);
     
+    // Gehaltene Noten liegen im Capture-Puffer; unveränderte Positionen werden dort ignoriert
     for (const auto& liveNote : liveNotes)
-    {
-        // Finde die entsprechende aufgezeichnete Note (via activeRecordingNotes map)
-        auto it = activeRecordingNotes.find(liveNote.midiNote);
-        if (it != activeRecordingNotes.end() && it->second < recordedNotes.size())
-        {
-            // Aktualisiere mit den optimierten Werten aus der Live-Anzeige
-            recordedNotes[it->second].string = liveNote.string;
-            recordedNotes[it->second].fret = liveNote.fret;
-        }
-    }
+        recordingCapture.setActiveNotePosition(liveNote.midiNote, liveNote.string, liveNote.fret);
+    
+    syncRecordingCapture();
 }
 
 std::vector<NewProjectAudioProcessor::RecordedNote> NewProjectAudioProcessor::getRecordedNotes() const
 {
     std::lock_guard<std::mutex> lock(recordingMutex);
-    return recordedNotes;
+    syncRecordingCapture();
+    return recordedNotes.getNotes();
 }
 
 void NewProjectAudioProcessor::updateRecordedNotePosition(int measureIndex, int beatIndex, int oldString, int newString, int newFret)
 {
-    // Diese Funktion aktualisiert sowohl den editedTrack als auch die recordedNotes
-    // basierend auf Takt/Beat und alter String-Position
+    // Aktualisiert die recordedNotes anhand von Takt/Beat und alter String-Position
     // oldString ist die String-Position VOR der Änderung (um die Note in recordedNotes zu finden)
-    
-    // Aktualisiere editedTrack (wenn vorhanden) - hier ist die Änderung bereits in der UI erfolgt
-    // Wir müssen den Track aus der UI holen (wird über setEditedTrack gemacht)
-    
-    // Aktualisiere recordedNotes
+    // Der editedTrack wurde bereits über applyTabEdits geändert
     std::lock_guard<std::mutex> lock(recordingMutex);
+    syncRecordingCapture();
     
-    if (!recordedNotes.empty())
+    // measureIndex in der UI ist 0-basiert, entspricht barNum-1 in getRecordedTabTrack
+    const auto layout = recordedNotes.layoutBar(measureIndex + 1, getRecordedBarRule(), legatoQuantizationThreshold.load());
+    if (beatIndex < 0 || beatIndex >= (int)layout.size() || layout[(size_t)beatIndex].isRest)
     {
-        int numerator = hostTimeSigNumerator.load();
-        int denominator = hostTimeSigDenominator.load();
-        double beatsPerMeasure = numerator * (4.0 / denominator);
+        DBG("Beat " << beatIndex << " not found in measure " << (measureIndex + 1));
+        return;
+    }
+    
+    for (size_t recIdx : layout[(size_t)beatIndex].notes)
+    {
+        if (recordedNotes[recIdx].string == oldString)
+        {
+            auto& note = recordedNotes.modify(recIdx);
+            note.string = newString;
+            note.fret = newFret;
+            DBG("Updated recordedNotes[" << (int)recIdx << "] string " << oldString 
+                << " -> " << newFret << "/" << newString);
+            return;
+        }
+    }
+    DBG("Note not found on string " << oldString << " in beat " << beatIndex);
+}
+
+void NewProjectAudioProcessor::setEditedTrack(int trackIndex, const TabTrack& track)
+{
+    const size_t trackBytes = getHeapBytes(track);
+    {
+        std::lock_guard<std::mutex> lock(editedTracksMutex);
+        editedTracks[trackIndex] = track;
+        editedTrackHeapBytes[trackIndex] = trackBytes;
+        tabUndoHistories.erase(trackIndex);
+        clearRecordedNotesUndo(trackIndex);
+        accountEditedTracks();
+    }
+    publishEditedTracks(trackIndex, true);
+    tabEditJournal.clear();
+}
+
+void NewProjectAudioProcessor::applyTabEdits(int trackIndex, const std::vector<TabEdit>& edits, const TabTrack& baseTrack)
+{
+    // 1. Auf das Modell anwenden - pro Edit nur der betroffene Takt; die Wiedergabe
+    //    sieht die Änderung erst mit publishEditedTracks
+    std::vector<TabEdit> applied;
+    applied.reserve(edits.size());
+    
+    // Nur der Message-Thread schreibt editedTracks - Lesen ohne Lock ist hier sicher
+    const bool firstEdit = editedTracks.count(trackIndex) == 0;
+    const size_t baseBytes = firstEdit ? getHeapBytes(baseTrack) : 0;
+    std::vector<int> touchedMeasures;
+    size_t committedStep = 0;
+    {
+        std::lock_guard<std::mutex> lock(editedTracksMutex);
+        auto it = editedTracks.find(trackIndex);
+        if (it == editedTracks.end())
+        {
+            it = editedTracks.emplace(trackIndex, baseTrack).first;
+            editedTrackHeapBytes[trackIndex] = baseBytes;
+        }
         
-        // measureIndex in der UI ist 0-basiert, entspricht aber barNum-1 in getRecordedTabTrack
-        int barNum = measureIndex + 1;
-        double measureStartBeat = (barNum - 1) * beatsPerMeasure;
+        auto& history = tabUndoHistories[trackIndex];
+        if (!history.isInitialised())
+        {
+            history.reset(it->second);
+            clearRecordedNotesUndo(trackIndex);
+        }
         
-        // Sammle Noten in diesem Takt (gleiche Logik wie getRecordedTabTrack)
-        std::vector<std::pair<size_t, RecordedNote*>> notesInMeasure;
-        for (size_t i = 0; i < recordedNotes.size(); ++i)
+        // Speicher des Tracks pro betroffenem Takt nachführen
+        auto& trackBytes = editedTrackHeapBytes[trackIndex];
+        for (auto edit : edits)
         {
-            auto& note = recordedNotes[i];
-            double roundedPPQ = std::round(note.startBeat * 1000.0) / 1000.0;
-            int noteBar = static_cast<int>(roundedPPQ / beatsPerMeasure) + 1;
-            
-            // Anwenden der gleichen Quantisierungs-Logik
-            double positionInMeasure = roundedPPQ - (noteBar - 1) * beatsPerMeasure;
-            double distanceToNextBar = beatsPerMeasure - positionInMeasure;
-            double originalDuration = note.endBeat - note.startBeat;
-            
-            if (measureQuantizationEnabled.load() && distanceToNextBar < 0.5 && distanceToNextBar > 0.001)
-            {
-                double truncatedDuration = distanceToNextBar;
-                double truncationRatio = truncatedDuration / std::max(0.001, originalDuration);
-                if (truncationRatio < 0.25 && originalDuration > 0.25)
-                {
-                    noteBar = noteBar + 1;
-                }
-            }
-            
-            if (noteBar == barNum)
+            const bool validMeasure = edit.measureIndex >= 0 && edit.measureIndex < it->second.measures.size();
+            const size_t before = validMeasure ? getHeapBytes(it->second.measures.getReference(edit.measureIndex)) : 0;
+            if (TabEditJournal::apply(it->second, edit))
             {
-                notesInMeasure.push_back({i, &note});
+                trackBytes += getHeapBytes(it->second.measures.getReference(edit.measureIndex)) - before;
+                applied.push_back(edit);
+                touchedMeasures.push_back(edit.measureIndex);
             }
         }
         
-        if (notesInMeasure.empty())
+        // Ein Batch (z.B. Gruppen-Edit) ist ein Undo-Schritt
+        if (!touchedMeasures.empty())
         {
-            DBG("No recorded notes found in measure " << (measureIndex + 1));
-            return;
+            history.commit(it->second, touchedMeasures);
+            committedStep = history.getCurrentStep();
+            if (committedStep == 0)
+                clearRecordedNotesUndo(trackIndex);   // Historie neu aufgesetzt
         }
         
-        // Sortiere nach startBeat
-        std::sort(notesInMeasure.begin(), notesInMeasure.end(), 
-            [](const auto& a, const auto& b) { return a.second->startBeat < b.second->startBeat; });
-        
-        // Gruppiere nach Slots (gleiche Logik wie getRecordedTabTrack)
-        double subdivision = 0.125; // 32nd note in quarter-note beats
-        double chordThreshold = 0.08; // Notes within ~80ms are chord
-        
-        struct SlotGroup {
-            int slot;
-            std::vector<std::pair<size_t, RecordedNote*>> notes;
-        };
-        std::vector<SlotGroup> slotGroups;
-        
-        int lastOccupiedSlot = -1;
-        double lastStartTime = -999.0;
+        // Beim ersten Edit geht der ganze Track (mit den Edits) ins Autosave
+        if (!firstEdit)
+            sessionAutosave.postEdits(trackIndex, applied);
+        accountEditedTracks();
+    }
+    if (firstEdit || !applied.empty())
+        publishEditedTracks(trackIndex, firstEdit);
+    
+    // 2. Protokollieren (Views spielen das Journal nach) und recordedNotes nachziehen.
+    //    Die Noten der betroffenen Takte vorher/nachher gehören zum Undo-Schritt.
+    RecordedNotesStep step;
+    if (committedStep > 0)
+    {
+        // Nachbartakte mit: Dauer-Edits können eine Note über die Taktgrenze umordnen
+        for (int measure : touchedMeasures)
+            for (int m = juce::jmax(0, measure - 1); m <= measure + 1; ++m)
+                if (std::find(step.measures.begin(), step.measures.end(), m) == step.measures.end())
+                    step.measures.push_back(m);
+        step.before = copyRecordedMeasureNotes(step.measures);
+    }
+    
+    for (const auto& edit : applied)
+    {
+        tabEditJournal.record(trackIndex, edit);
         
-        for (auto& [noteIdx, notePtr] : notesInMeasure)
+        switch (edit.type)
         {
-            double posInMeasure = notePtr->startBeat - measureStartBeat;
-            if (posInMeasure < 0.0) posInMeasure = 0.0;
-            
-            int idealSlot = (int)(posInMeasure / subdivision + 0.5);
-            
-            // Prüfe ob diese Note zum letzten Slot gehört (Akkord)
-            bool isChord = !slotGroups.empty() && 
-                          std::abs(notePtr->startBeat - lastStartTime) < chordThreshold;
-            
-            if (isChord)
-            {
-                slotGroups.back().notes.push_back({noteIdx, notePtr});
-            }
-            else
-            {
-                int slot = std::max(idealSlot, lastOccupiedSlot + 1);
-                int maxSlots = static_cast<int>(beatsPerMeasure / subdivision);
-                if (slot >= maxSlots) slot = maxSlots - 1;
-                if (slot < 0) slot = 0;
-                
-                SlotGroup group;
-                group.slot = slot;
-                group.notes.push_back({noteIdx, notePtr});
-                slotGroups.push_back(group);
-                lastOccupiedSlot = slot;
-            }
-            lastStartTime = notePtr->startBeat;
+            case TabEdit::Type::SetPosition:
+                updateRecordedNotePosition(edit.measureIndex, edit.beatIndex, edit.oldString, edit.string, edit.fret);
+                break;
+            case TabEdit::Type::SetPitch:
+                updateRecordedNotePitch(edit.measureIndex, edit.beatIndex, edit.oldString, edit.midiNote, edit.fret);
+                break;
+            case TabEdit::Type::ChangeDuration:
+                updateRecordedNoteDuration(edit.measureIndex, edit.beatIndex, static_cast<int>(edit.duration), edit.dotted);
+                break;
+            case TabEdit::Type::DeleteNote:
+                deleteRecordedNote(edit.measureIndex, edit.beatIndex, edit.oldString);
+                break;
+            case TabEdit::Type::InsertNote:
+                insertRecordedNote(edit.measureIndex, edit.beatIndex, edit.string, edit.fret, edit.midiNote);
+                break;
+            case TabEdit::Type::DeleteRest:
+                break;  // Pausen existieren in recordedNotes nicht
+            case TabEdit::Type::ReplaceMeasure:
+                break;  // nur Undo/Redo, kommt nicht aus den Views
         }
+    }
+    
+    if (committedStep > 0)
+    {
+        step.after = copyRecordedMeasureNotes(step.measures);
+        step.heapBytes = MemoryAccounting::bytesOf(step.measures) + MemoryAccounting::bytesOf(step.before)
+                       + MemoryAccounting::bytesOf(step.after);
         
-        // beatIndex entspricht der Reihenfolge der Slot-Gruppen (nicht dem Slot-Wert selbst!)
-        int currentBeatIdx = 0;
-        int currentSlot = 0;
-        int maxSlots = static_cast<int>(beatsPerMeasure / subdivision);
-        size_t groupIdx = 0;
+        std::lock_guard<std::mutex> lock(editedTracksMutex);
+        auto& steps = recordedNotesUndo[trackIndex];
         
-        while (currentSlot < maxSlots && groupIdx <= slotGroups.size())
+        // Redo-Schritte verwirft commit, hier ebenso - Eintrag i bleibt Schritt i der Historie
+        for (size_t i = committedStep - 1; i < steps.size(); ++i)
+            recordedNotesUndoBytes -= steps[i].heapBytes;
+        steps.resize(committedStep - 1);
+        recordedNotesUndoBytes += step.heapBytes;
+        steps.push_back(std::move(step));
+        accountEditedTracks();
+    }
+}
+
+void NewProjectAudioProcessor::clearRecordedNotesUndo(int trackIndex)
+{
+    for (auto it = recordedNotesUndo.begin(); it != recordedNotesUndo.end();)
+    {
+        if (trackIndex != allEditedTracks && it->first != trackIndex)
         {
-            if (groupIdx < slotGroups.size() && slotGroups[groupIdx].slot == currentSlot)
-            {
-                // Dies ist ein Beat mit Noten
-                if (currentBeatIdx == beatIndex)
-                {
-                    // Gefunden! Suche nach der Note mit der alten String-Position
-                    for (auto& [recIdx, notePtr] : slotGroups[groupIdx].notes)
-                    {
-                        if (notePtr->string == oldString)
-                        {
-                            notePtr->string = newString;
-                            notePtr->fret = newFret;
-                            DBG("Updated recordedNotes[" << recIdx << "] string " << oldString 
-                                << " -> " << newFret << "/" << newString);
-                            return;
-                        }
-                    }
-                    DBG("Note not found on string " << oldString << " in beat " << beatIndex);
-                    return;
-                }
-                
-                // Berechne Slot-Sprung
-                int nextSlot = maxSlots;
-                if (groupIdx + 1 < slotGroups.size())
-                    nextSlot = slotGroups[groupIdx + 1].slot;
-                    
-                currentSlot = nextSlot;
-                groupIdx++;
-                currentBeatIdx++;
-            }
-            else
-            {
-                // Pause
-                int nextNoteSlot = (groupIdx < slotGroups.size()) ? slotGroups[groupIdx].slot : maxSlots;
-                
-                while (currentSlot < nextNoteSlot)
-                {
-                    int remaining = nextNoteSlot - currentSlot;
-                    int pauseDuration;
-                    if (remaining >= 32) pauseDuration = 32;
-                    else if (remaining >= 16) pauseDuration = 16;
-                    else if (remaining >= 8) pauseDuration = 8;
-                    else if (remaining >= 4) pauseDuration = 4;
-                    else if (remaining >= 2) pauseDuration = 2;
-                    else pauseDuration = 1;
-                    
-                    currentSlot += pauseDuration;
-                    currentBeatIdx++;
-                }
-            }
+            ++it;
+            continue;
         }
-        
-        DBG("Beat " << beatIndex << " not found in measure " << (measureIndex + 1) 
-            << " (had " << slotGroups.size() << " note groups, iterated to beat " << currentBeatIdx << ")");
+        for (const auto& step : it->second)
+            recordedNotesUndoBytes -= step.heapBytes;
+        it = recordedNotesUndo.erase(it);
     }
 }
 
-void NewProjectAudioProcessor::setEditedTrack(int trackIndex, const TabTrack& track)
+std::vector<RecordedNote> NewProjectAudioProcessor::copyRecordedMeasureNotes(const std::vector<int>& measures) const
 {
-    editedTracks[trackIndex] = track;
+    std::lock_guard<std::mutex> lock(recordingMutex);
+    syncRecordingCapture();
+    
+    std::vector<RecordedNote> notes;
+    const auto rule = getRecordedBarRule();
+    for (int measure : measures)
+        for (const auto& beat : recordedNotes.layoutBar(measure + 1, rule, legatoQuantizationThreshold.load()))
+            for (size_t recIdx : beat.notes)
+                notes.push_back(recordedNotes[recIdx]);
+    return notes;
 }
 
-//==============================================================================
-// Delete a recorded note by measure/beat/string
-//==============================================================================
-void NewProjectAudioProcessor::deleteRecordedNote(int measureIndex, int beatIndex, int stringIndex)
+void NewProjectAudioProcessor::replaceRecordedMeasureNotes(const std::vector<int>& measures,
+                                                           const std::vector<RecordedNote>& notes)
 {
     std::lock_guard<std::mutex> lock(recordingMutex);
+    syncRecordingCapture();
     
-    if (recordedNotes.empty()) return;
-    
-    int numerator = hostTimeSigNumerator.load();
-    int denominator = hostTimeSigDenominator.load();
-    double beatsPerMeasure = numerator * (4.0 / denominator);
-    int barNum = measureIndex + 1;
+    std::vector<size_t> indices;
+    const auto rule = getRecordedBarRule();
+    for (int measure : measures)
+        for (const auto& beat : recordedNotes.layoutBar(measure + 1, rule, legatoQuantizationThreshold.load()))
+            indices.insert(indices.end(), beat.notes.begin(), beat.notes.end());
     
-    // Collect notes in this measure (same logic as updateRecordedNotePosition)
-    std::vector<std::pair<size_t, RecordedNote*>> notesInMeasure;
-    for (size_t i = 0; i < recordedNotes.size(); ++i)
+    // Von hinten löschen, damit die übrigen Indizes gültig bleiben
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    for (auto it = indices.rbegin(); it != indices.rend(); ++it)
     {
-        auto& note = recordedNotes[i];
-        double roundedPPQ = std::round(note.startBeat * 1000.0) / 1000.0;
-        int noteBar = static_cast<int>(roundedPPQ / beatsPerMeasure) + 1;
-        
-        double positionInMeasure = roundedPPQ - (noteBar - 1) * beatsPerMeasure;
-        double distanceToNextBar = beatsPerMeasure - positionInMeasure;
-        double originalDuration = note.endBeat - note.startBeat;
-        
-        if (measureQuantizationEnabled.load() && distanceToNextBar < 0.5 && distanceToNextBar > 0.001)
-        {
-            double truncationRatio = distanceToNextBar / std::max(0.001, originalDuration);
-            if (truncationRatio < 0.25 && originalDuration > 0.25)
-                noteBar = noteBar + 1;
-        }
-        
-        if (noteBar == barNum)
-            notesInMeasure.push_back({i, &note});
+        recordedNotes.erase(*it);
+        recordingCapture.storeNoteErased(*it);
     }
     
-    if (notesInMeasure.empty()) return;
-    
-    // Sort by startBeat
-    std::sort(notesInMeasure.begin(), notesInMeasure.end(),
-        [](const auto& a, const auto& b) { return a.second->startBeat < b.second->startBeat; });
-    
-    // Group into slots (same logic as updateRecordedNotePosition)
-    double subdivision = 0.125;
-    double chordThreshold = 0.08;
-    double measureStartBeat = (barNum - 1) * beatsPerMeasure;
-    
-    struct SlotGroup { int slot; std::vector<std::pair<size_t, RecordedNote*>> notes; };
-    std::vector<SlotGroup> slotGroups;
-    int lastOccupiedSlot = -1;
-    double lastStartTime = -999.0;
-    
-    for (auto& [noteIdx, notePtr] : notesInMeasure)
+    for (const auto& note : notes)
+        recordedNotes.add(note);
+    accountRecordedNotes();
+}
+
+void NewProjectAudioProcessor::publishEditedTracks(int changedTrack, bool postTrackToAutosave)
+{
+    // Nur der Message-Thread schreibt editedTracks - Lesen und Kopieren ohne editedTracksMutex.
+    // Unveränderte Tracks teilt der neue Stand mit dem vorigen.
     {
-        double posInMeasure = notePtr->startBeat - measureStartBeat;
-        if (posInMeasure < 0.0) posInMeasure = 0.0;
-        int idealSlot = (int)(posInMeasure / subdivision + 0.5);
+        std::lock_guard<std::mutex> lock(publishMutex);
+        auto previous = std::atomic_load(&publishedEditedTracks);
+        auto next = std::make_shared<EditedTracksSnapshot>();
         
-        bool isChord = !slotGroups.empty() && std::abs(notePtr->startBeat - lastStartTime) < chordThreshold;
-        if (isChord)
+        if (changedTrack == allEditedTracks)
         {
-            slotGroups.back().notes.push_back({noteIdx, notePtr});
+            for (const auto& [trackIndex, track] : editedTracks)
+                next->tracks[trackIndex] = std::make_shared<const TabTrack>(track);
         }
         else
         {
-            int slot = std::max(idealSlot, lastOccupiedSlot + 1);
-            int maxSlots = static_cast<int>(beatsPerMeasure / subdivision);
-            slot = std::clamp(slot, 0, maxSlots - 1);
-            SlotGroup group;
-            group.slot = slot;
-            group.notes.push_back({noteIdx, notePtr});
-            slotGroups.push_back(group);
-            lastOccupiedSlot = slot;
+            next->tracks = previous->tracks;
+            auto it = editedTracks.find(changedTrack);
+            if (it != editedTracks.end())
+                next->tracks[changedTrack] = std::make_shared<const TabTrack>(it->second);
+            else
+                next->tracks.erase(changedTrack);
         }
-        lastStartTime = notePtr->startBeat;
+        
+        // Autosave teilt den veröffentlichten Track und serialisiert ihn im eigenen Thread
+        if (postTrackToAutosave && next->tracks.count(changedTrack) > 0)
+            sessionAutosave.postTrack(changedTrack, next->tracks[changedTrack]);
+        
+        // Nach den Autosave-Posts der Änderung - der Stand enthält alles bis hierher
+        next->autosaveSequence = sessionAutosave.getPostedSequence();
+        std::atomic_store(&publishedEditedTracks, std::shared_ptr<const EditedTracksSnapshot>(std::move(next)));
+        retiredEditedTracks.push_back(std::move(previous));
+    }
+    releaseRetiredEditedTracks();
+}
+
+void NewProjectAudioProcessor::releaseRetiredEditedTracks()
+{
+    // Freigeben erst, wenn kein Leser (Audio-Thread, Autosave, Offline-Render) den Stand mehr hält
+    std::lock_guard<std::mutex> lock(publishMutex);
+    retiredEditedTracks.erase(std::remove_if(retiredEditedTracks.begin(), retiredEditedTracks.end(),
+                                             [](const auto& snapshot) { return snapshot.use_count() == 1; }),
+                              retiredEditedTracks.end());
+}
+
+bool NewProjectAudioProcessor::undoTabEdit(int trackIndex)
+{
+    if (!restoreTabEdit(trackIndex, true))
+        return false;
+    DBG("Undo Tab-Edit (Track " << (trackIndex + 1) << ")");
+    return true;
+}
+
+bool NewProjectAudioProcessor::redoTabEdit(int trackIndex)
+{
+    if (!restoreTabEdit(trackIndex, false))
+        return false;
+    DBG("Redo Tab-Edit (Track " << (trackIndex + 1) << ")");
+    return true;
+}
+
+bool NewProjectAudioProcessor::restoreTabEdit(int trackIndex, bool undo)
+{
+    TabUndoHistory::Restored restored;
+    int numMeasures = 0;
+    const RecordedNotesStep* notesStep = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(editedTracksMutex);
+        auto track = editedTracks.find(trackIndex);
+        auto history = tabUndoHistories.find(trackIndex);
+        if (track == editedTracks.end() || history == tabUndoHistories.end())
+            return false;
+        if (!(undo ? history->second.undo(track->second, restored) : history->second.redo(track->second, restored)))
+            return false;
+        numMeasures = track->second.measures.size();
+        editedTrackHeapBytes[trackIndex] += (size_t) restored.trackHeapDelta;
+        accountEditedTracks();
+        
+        // Undo: Schritt hinter dem Cursor, Redo: Schritt vor dem Cursor. Nur der Message-Thread
+        // ändert recordedNotesUndo, der Zeiger bleibt bis zum Ende dieser Funktion gültig.
+        const size_t stepIndex = history->second.getCurrentStep() - (undo ? 0 : 1);
+        auto steps = recordedNotesUndo.find(trackIndex);
+        if (steps != recordedNotesUndo.end() && stepIndex < steps->second.size())
+            notesStep = &steps->second[stepIndex];
+    }
+    
+    // recordedNotes wie in applyTabEdits mitziehen: die Noten der Takte des Schritts zurücksetzen
+    if (notesStep != nullptr)
+        replaceRecordedMeasureNotes(notesStep->measures, undo ? notesStep->before : notesStep->after);
+    
+    // Taktanzahl wich ab (Track komplett neu aufgebaut) - Autosave bekommt den ganzen Track, Views laden neu
+    if (restored.measures.empty())
+    {
+        publishEditedTracks(trackIndex, true);
+        tabEditJournal.clear();
+        return true;
     }
     
-    // Walk through beats to find the matching beatIndex
-    int currentBeatIdx = 0;
-    int currentSlot = 0;
-    int maxSlots = static_cast<int>(beatsPerMeasure / subdivision);
-    size_t groupIdx = 0;
+    // Nur die ersetzten Takte: Autosave serialisiert außerhalb der Sperre,
+    // Views spielen sie wie jeden anderen Edit aus dem Journal nach
+    sessionAutosave.postMeasures(trackIndex, numMeasures, restored.measures);
+    publishEditedTracks(trackIndex);
+    for (auto& [index, measure] : restored.measures)
+        tabEditJournal.record(trackIndex, TabEdit::replaceMeasure(index, std::move(measure)));
+    return true;
+}
+
+bool NewProjectAudioProcessor::canUndoTabEdit(int trackIndex) const
+{
+    std::lock_guard<std::mutex> lock(editedTracksMutex);
+    auto history = tabUndoHistories.find(trackIndex);
+    return history != tabUndoHistories.end() && history->second.canUndo();
+}
+
+bool NewProjectAudioProcessor::canRedoTabEdit(int trackIndex) const
+{
+    std::lock_guard<std::mutex> lock(editedTracksMutex);
+    auto history = tabUndoHistories.find(trackIndex);
+    return history != tabUndoHistories.end() && history->second.canRedo();
+}
+
+//==============================================================================
+// Delete a recorded note by measure/beat/string
+//==============================================================================
+void NewProjectAudioProcessor::deleteRecordedNote(int measureIndex, int beatIndex, int stringIndex)
+{
+    std::lock_guard<std::mutex> lock(recordingMutex);
+    syncRecordingCapture();
+    
+    const auto layout = recordedNotes.layoutBar(measureIndex + 1, getRecordedBarRule(), legatoQuantizationThreshold.load());
+    if (beatIndex < 0 || beatIndex >= (int)layout.size() || layout[(size_t)beatIndex].isRest)
+        return;
     
-    while (currentSlot < maxSlots && groupIdx <= slotGroups.size())
+    for (size_t recIdx : layout[(size_t)beatIndex].notes)
     {
-        if (groupIdx < slotGroups.size() && slotGroups[groupIdx].slot == currentSlot)
+        if (recordedNotes[recIdx].string == stringIndex)
         {
-            if (currentBeatIdx == beatIndex)
-            {
-                // Found the beat! Delete the note on stringIndex
-                for (auto& [recIdx, notePtr] : slotGroups[groupIdx].notes)
-                {
-                    if (notePtr->string == stringIndex)
-                    {
-                        DBG("Deleting recordedNotes[" << recIdx << "] on string " << stringIndex);
-                        recordedNotes.erase(recordedNotes.begin() + recIdx);
-                        return;
-                    }
-                }
-                DBG("Note not found on string " << stringIndex << " in beat " << beatIndex);
-                return;
-            }
+            DBG("Deleting recordedNotes[" << (int)recIdx << "] on string " << stringIndex);
+            recordedNotes.erase(recIdx);
             
-            int nextSlot = maxSlots;
-            if (groupIdx + 1 < slotGroups.size())
-                nextSlot = slotGroups[groupIdx + 1].slot;
-            currentSlot = nextSlot;
-            groupIdx++;
-            currentBeatIdx++;
-        }
-        else
-        {
-            int nextNoteSlot = (groupIdx < slotGroups.size()) ? slotGroups[groupIdx].slot : maxSlots;
-            while (currentSlot < nextNoteSlot)
-            {
-                int remaining = nextNoteSlot - currentSlot;
-                int pauseDuration;
-                if (remaining >= 32) pauseDuration = 32;
-                else if (remaining >= 16) pauseDuration = 16;
-                else if (remaining >= 8) pauseDuration = 8;
-                else if (remaining >= 4) pauseDuration = 4;
-                else if (remaining >= 2) pauseDuration = 2;
-                else pauseDuration = 1;
-                currentSlot += pauseDuration;
-                currentBeatIdx++;
-            }
+            // Indizes hinter der gelöschten Note rücken nach vorne
+            recordingCapture.storeNoteErased(recIdx);
+            return;
         }
     }
+    DBG("Note not found on string " << stringIndex << " in beat " << beatIndex);
 }
 
 //==============================================================================
@@ -3712,130 +3225,25 @@ void NewProjectAudioProcessor::deleteRecordedNote(int measureIndex, int beatInde
 void NewProjectAudioProcessor::updateRecordedNoteDuration(int measureIndex, int beatIndex, int newDurationValue, bool isDotted)
 {
     std::lock_guard<std::mutex> lock(recordingMutex);
+    syncRecordingCapture();
     
-    if (recordedNotes.empty()) return;
-    
-    int numerator = hostTimeSigNumerator.load();
-    int denominator = hostTimeSigDenominator.load();
-    double beatsPerMeasure = numerator * (4.0 / denominator);
-    int barNum = measureIndex + 1;
-    double measureStartBeat = (barNum - 1) * beatsPerMeasure;
+    const auto rule = getRecordedBarRule();
+    const auto layout = recordedNotes.layoutBar(measureIndex + 1, rule, legatoQuantizationThreshold.load());
+    if (beatIndex < 0 || beatIndex >= (int)layout.size() || layout[(size_t)beatIndex].isRest)
+        return;
     
     // Calculate new duration in quarter notes
     double newDurInQuarters = 4.0 / static_cast<double>(newDurationValue);
     if (isDotted) newDurInQuarters *= 1.5;
     
-    // Collect notes in this measure
-    std::vector<std::pair<size_t, RecordedNote*>> notesInMeasure;
-    for (size_t i = 0; i < recordedNotes.size(); ++i)
-    {
-        auto& note = recordedNotes[i];
-        double roundedPPQ = std::round(note.startBeat * 1000.0) / 1000.0;
-        int noteBar = static_cast<int>(roundedPPQ / beatsPerMeasure) + 1;
-        
-        double positionInMeasure = roundedPPQ - (noteBar - 1) * beatsPerMeasure;
-        double distanceToNextBar = beatsPerMeasure - positionInMeasure;
-        double originalDuration = note.endBeat - note.startBeat;
-        
-        if (measureQuantizationEnabled.load() && distanceToNextBar < 0.5 && distanceToNextBar > 0.001)
-        {
-            double truncationRatio = distanceToNextBar / std::max(0.001, originalDuration);
-            if (truncationRatio < 0.25 && originalDuration > 0.25)
-                noteBar = noteBar + 1;
-        }
-        
-        if (noteBar == barNum)
-            notesInMeasure.push_back({i, &note});
-    }
-    
-    if (notesInMeasure.empty()) return;
-    
-    std::sort(notesInMeasure.begin(), notesInMeasure.end(),
-        [](const auto& a, const auto& b) { return a.second->startBeat < b.second->startBeat; });
+    // Clamp to measure end
+    const double measureEnd = (measureIndex + 1) * rule.beatsPerMeasure;
     
-    // Group into slots
-    double subdivision = 0.125;
-    double chordThreshold = 0.08;
-    
-    struct SlotGroup { int slot; std::vector<std::pair<size_t, RecordedNote*>> notes; };
-    std::vector<SlotGroup> slotGroups;
-    int lastOccupiedSlot = -1;
-    double lastStartTime = -999.0;
-    
-    for (auto& [noteIdx, notePtr] : notesInMeasure)
-    {
-        double posInMeasure = notePtr->startBeat - measureStartBeat;
-        if (posInMeasure < 0.0) posInMeasure = 0.0;
-        int idealSlot = (int)(posInMeasure / subdivision + 0.5);
-        
-        bool isChord = !slotGroups.empty() && std::abs(notePtr->startBeat - lastStartTime) < chordThreshold;
-        if (isChord)
-        {
-            slotGroups.back().notes.push_back({noteIdx, notePtr});
-        }
-        else
-        {
-            int slot = std::max(idealSlot, lastOccupiedSlot + 1);
-            int maxSlots = static_cast<int>(beatsPerMeasure / subdivision);
-            slot = std::clamp(slot, 0, maxSlots - 1);
-            SlotGroup group;
-            group.slot = slot;
-            group.notes.push_back({noteIdx, notePtr});
-            slotGroups.push_back(group);
-            lastOccupiedSlot = slot;
-        }
-        lastStartTime = notePtr->startBeat;
-    }
-    
-    // Walk through beats to find the matching beatIndex
-    int currentBeatIdx = 0;
-    int currentSlot = 0;
-    int maxSlots = static_cast<int>(beatsPerMeasure / subdivision);
-    size_t groupIdx = 0;
-    
-    while (currentSlot < maxSlots && groupIdx <= slotGroups.size())
+    for (size_t recIdx : layout[(size_t)beatIndex].notes)
     {
-        if (groupIdx < slotGroups.size() && slotGroups[groupIdx].slot == currentSlot)
-        {
-            if (currentBeatIdx == beatIndex)
-            {
-                // Found the beat! Update all notes' endBeat to reflect the new duration
-                for (auto& [recIdx, notePtr] : slotGroups[groupIdx].notes)
-                {
-                    double newEnd = notePtr->startBeat + newDurInQuarters;
-                    // Clamp to measure end
-                    double measureEnd = measureStartBeat + beatsPerMeasure;
-                    if (newEnd > measureEnd) newEnd = measureEnd;
-                    notePtr->endBeat = newEnd;
-                    DBG("Updated recordedNotes[" << recIdx << "] duration to " << newDurInQuarters << " quarters");
-                }
-                return;
-            }
-            
-            int nextSlot = maxSlots;
-            if (groupIdx + 1 < slotGroups.size())
-                nextSlot = slotGroups[groupIdx + 1].slot;
-            currentSlot = nextSlot;
-            groupIdx++;
-            currentBeatIdx++;
-        }
-        else
-        {
-            int nextNoteSlot = (groupIdx < slotGroups.size()) ? slotGroups[groupIdx].slot : maxSlots;
-            while (currentSlot < nextNoteSlot)
-            {
-                int remaining = nextNoteSlot - currentSlot;
-                int pauseDuration;
-                if (remaining >= 32) pauseDuration = 32;
-                else if (remaining >= 16) pauseDuration = 16;
-                else if (remaining >= 8) pauseDuration = 8;
-                else if (remaining >= 4) pauseDuration = 4;
-                else if (remaining >= 2) pauseDuration = 2;
-                else pauseDuration = 1;
-                currentSlot += pauseDuration;
-                currentBeatIdx++;
-            }
-        }
+        const double newEnd = std::min(recordedNotes[recIdx].startBeat + newDurInQuarters, measureEnd);
+        recordedNotes.setEndBeat(recIdx, newEnd);
+        DBG("Updated recordedNotes[" << (int)recIdx << "] duration to " << newDurInQuarters << " quarters");
     }
 }
 
@@ -3845,890 +3253,251 @@ void NewProjectAudioProcessor::updateRecordedNoteDuration(int measureIndex, int
 void NewProjectAudioProcessor::updateRecordedNotePitch(int measureIndex, int beatIndex, int oldString, int newMidiNote, int newFret)
 {
     std::lock_guard<std::mutex> lock(recordingMutex);
+    syncRecordingCapture();
     
-    if (recordedNotes.empty()) return;
-    
-    int numerator = hostTimeSigNumerator.load();
-    int denominator = hostTimeSigDenominator.load();
-    double beatsPerMeasure = numerator * (4.0 / denominator);
-    int barNum = measureIndex + 1;
-    double measureStartBeat = (barNum - 1) * beatsPerMeasure;
-    
-    // Collect notes in this measure
-    std::vector<std::pair<size_t, RecordedNote*>> notesInMeasure;
-    for (size_t i = 0; i < recordedNotes.size(); ++i)
-    {
-        auto& note = recordedNotes[i];
-        double roundedPPQ = std::round(note.startBeat * 1000.0) / 1000.0;
-        int noteBar = static_cast<int>(roundedPPQ / beatsPerMeasure) + 1;
-        
-        double positionInMeasure = roundedPPQ - (noteBar - 1) * beatsPerMeasure;
-        double distanceToNextBar = beatsPerMeasure - positionInMeasure;
-        double originalDuration = note.endBeat - note.startBeat;
-        
-        if (measureQuantizationEnabled.load() && distanceToNextBar < 0.5 && distanceToNextBar > 0.001)
-        {
-            double truncationRatio = distanceToNextBar / std::max(0.001, originalDuration);
-            if (truncationRatio < 0.25 && originalDuration > 0.25)
-                noteBar = noteBar + 1;
-        }
-        
-        if (noteBar == barNum)
-            notesInMeasure.push_back({i, &note});
-    }
-    
-    if (notesInMeasure.empty())
+    const auto layout = recordedNotes.layoutBar(measureIndex + 1, getRecordedBarRule(), legatoQuantizationThreshold.load());
+    if (beatIndex < 0 || beatIndex >= (int)layout.size() || layout[(size_t)beatIndex].isRest)
     {
-        DBG("No recorded notes found in measure " << (measureIndex + 1) << " for pitch change");
+        DBG("No recorded notes found in measure " << (measureIndex + 1) << ", beat " << beatIndex << " for pitch change");
         return;
     }
     
-    std::sort(notesInMeasure.begin(), notesInMeasure.end(),
-        [](const auto& a, const auto& b) { return a.second->startBeat < b.second->startBeat; });
-    
-    // Group into slots
-    double subdivision = 0.125;
-    double chordThreshold = 0.08;
-    
-    struct SlotGroup { int slot; std::vector<std::pair<size_t, RecordedNote*>> notes; };
-    std::vector<SlotGroup> slotGroups;
-    int lastOccupiedSlot = -1;
-    double lastStartTime = -999.0;
-    
-    for (auto& [noteIdx, notePtr] : notesInMeasure)
-    {
-        double posInMeasure = notePtr->startBeat - measureStartBeat;
-        if (posInMeasure < 0.0) posInMeasure = 0.0;
-        int idealSlot = (int)(posInMeasure / subdivision + 0.5);
-        
-        bool isChord = !slotGroups.empty() && std::abs(notePtr->startBeat - lastStartTime) < chordThreshold;
-        if (isChord)
-        {
-            slotGroups.back().notes.push_back({noteIdx, notePtr});
-        }
-        else
-        {
-            int slot = std::max(idealSlot, lastOccupiedSlot + 1);
-            int maxSlots = static_cast<int>(beatsPerMeasure / subdivision);
-            slot = std::clamp(slot, 0, maxSlots - 1);
-            SlotGroup group;
-            group.slot = slot;
-            group.notes.push_back({noteIdx, notePtr});
-            slotGroups.push_back(group);
-            lastOccupiedSlot = slot;
-        }
-        lastStartTime = notePtr->startBeat;
-    }
-    
-    // Walk through beats to find the matching beatIndex
-    int currentBeatIdx = 0;
-    int currentSlot = 0;
-    int maxSlots = static_cast<int>(beatsPerMeasure / subdivision);
-    size_t groupIdx = 0;
-    
-    while (currentSlot < maxSlots && groupIdx <= slotGroups.size())
+    for (size_t recIdx : layout[(size_t)beatIndex].notes)
     {
-        if (groupIdx < slotGroups.size() && slotGroups[groupIdx].slot == currentSlot)
-        {
-            if (currentBeatIdx == beatIndex)
-            {
-                // Found the beat! Find note on the old string and update pitch
-                for (auto& [recIdx, notePtr] : slotGroups[groupIdx].notes)
-                {
-                    if (notePtr->string == oldString)
-                    {
-                        int oldMidi = notePtr->midiNote;
-                        notePtr->midiNote = newMidiNote;
-                        notePtr->fret = newFret;
-                        // String may also change if fret position calculation moved it
-                        // We'll update string through updateRecordedNotePosition pattern
-                        DBG("Updated recordedNotes[" << recIdx << "] pitch " << oldMidi 
-                            << " -> " << newMidiNote << ", fret " << newFret);
-                        return;
-                    }
-                }
-                DBG("Note not found on string " << oldString << " for pitch change in beat " << beatIndex);
-                return;
-            }
-            
-            int nextSlot = maxSlots;
-            if (groupIdx + 1 < slotGroups.size())
-                nextSlot = slotGroups[groupIdx + 1].slot;
-            currentSlot = nextSlot;
-            groupIdx++;
-            currentBeatIdx++;
-        }
-        else
+        if (recordedNotes[recIdx].string == oldString)
         {
-            int nextNoteSlot = (groupIdx < slotGroups.size()) ? slotGroups[groupIdx].slot : maxSlots;
-            while (currentSlot < nextNoteSlot)
-            {
-                int remaining = nextNoteSlot - currentSlot;
-                int pauseDuration;
-                if (remaining >= 32) pauseDuration = 32;
-                else if (remaining >= 16) pauseDuration = 16;
-                else if (remaining >= 8) pauseDuration = 8;
-                else if (remaining >= 4) pauseDuration = 4;
-                else if (remaining >= 2) pauseDuration = 2;
-                else pauseDuration = 1;
-                currentSlot += pauseDuration;
-                currentBeatIdx++;
-            }
+            auto& note = recordedNotes.modify(recIdx);
+            int oldMidi = note.midiNote;
+            note.midiNote = newMidiNote;
+            note.fret = newFret;
+            // String may also change if fret position calculation moved it
+            // We'll update string through updateRecordedNotePosition pattern
+            DBG("Updated recordedNotes[" << (int)recIdx << "] pitch " << oldMidi 
+                << " -> " << newMidiNote << ", fret " << newFret);
+            return;
         }
     }
+    DBG("Note not found on string " << oldString << " for pitch change in beat " << beatIndex);
 }
 
 void NewProjectAudioProcessor::insertRecordedNote(int measureIndex, int beatIndex, int stringIndex, int fret, int midiNote)
 {
     std::lock_guard<std::mutex> lock(recordingMutex);
+    syncRecordingCapture();
     
-    int numerator = hostTimeSigNumerator.load();
-    int denominator = hostTimeSigDenominator.load();
-    double beatsPerMeasure = numerator * (4.0 / denominator);
-    int barNum = measureIndex + 1;
-    double measureStartBeat = (barNum - 1) * beatsPerMeasure;
-    
-    // We need to find the beat position (in PPQ) where this rest starts
-    // Use the same slot-group logic to walk through beats
-    
-    // Collect notes in this measure
-    std::vector<std::pair<size_t, RecordedNote*>> notesInMeasure;
-    for (size_t i = 0; i < recordedNotes.size(); ++i)
-    {
-        auto& note = recordedNotes[i];
-        double roundedPPQ = std::round(note.startBeat * 1000.0) / 1000.0;
-        int noteBar = static_cast<int>(roundedPPQ / beatsPerMeasure) + 1;
-        
-        double positionInMeasure = roundedPPQ - (noteBar - 1) * beatsPerMeasure;
-        double distanceToNextBar = beatsPerMeasure - positionInMeasure;
-        double originalDuration = note.endBeat - note.startBeat;
-        
-        if (measureQuantizationEnabled.load() && distanceToNextBar < 0.5 && distanceToNextBar > 0.001)
-        {
-            double truncationRatio = distanceToNextBar / std::max(0.001, originalDuration);
-            if (truncationRatio < 0.25 && originalDuration > 0.25)
-                noteBar = noteBar + 1;
-        }
-        
-        if (noteBar == barNum)
-            notesInMeasure.push_back({i, &note});
-    }
-    
-    // Sort by startBeat
-    std::sort(notesInMeasure.begin(), notesInMeasure.end(),
-        [](const auto& a, const auto& b) { return a.second->startBeat < b.second->startBeat; });
-    
-    // Group into slots
-    double subdivision = 0.125;
-    double chordThreshold = 0.08;
-    
-    struct SlotGroup { int slot; std::vector<std::pair<size_t, RecordedNote*>> notes; };
-    std::vector<SlotGroup> slotGroups;
-    int lastOccupiedSlot = -1;
-    double lastStartTime = -999.0;
-    
-    for (auto& [noteIdx, notePtr] : notesInMeasure)
+    // Die Pause an beatIndex bestimmt Startposition und Länge der neuen Note
+    const auto rule = getRecordedBarRule();
+    const auto layout = recordedNotes.layoutBar(measureIndex + 1, rule, legatoQuantizationThreshold.load());
+    if (beatIndex < 0 || beatIndex >= (int)layout.size() || ! layout[(size_t)beatIndex].isRest)
     {
-        double posInMeasure = notePtr->startBeat - measureStartBeat;
-        if (posInMeasure < 0.0) posInMeasure = 0.0;
-        int idealSlot = (int)(posInMeasure / subdivision + 0.5);
-        
-        bool isChord = !slotGroups.empty() && std::abs(notePtr->startBeat - lastStartTime) < chordThreshold;
-        if (isChord)
-        {
-            slotGroups.back().notes.push_back({noteIdx, notePtr});
-        }
-        else
-        {
-            int slot = std::max(idealSlot, lastOccupiedSlot + 1);
-            int maxSlots = static_cast<int>(beatsPerMeasure / subdivision);
-            slot = std::clamp(slot, 0, maxSlots - 1);
-            SlotGroup group;
-            group.slot = slot;
-            group.notes.push_back({noteIdx, notePtr});
-            slotGroups.push_back(group);
-            lastOccupiedSlot = slot;
-        }
-        lastStartTime = notePtr->startBeat;
+        DBG("Could not find rest at beat " << beatIndex << " in measure " << (measureIndex + 1) << " for insertion");
+        return;
     }
     
-    // Walk through beats to find the target rest position
-    int currentBeatIdx = 0;
-    int currentSlot = 0;
-    int maxSlots = static_cast<int>(beatsPerMeasure / subdivision);
-    size_t groupIdx = 0;
+    const auto& rest = layout[(size_t)beatIndex];
+    const double insertBeat = measureIndex * rule.beatsPerMeasure + rest.slot * RecordedNoteStore::subdivision;
     
-    while (currentSlot < maxSlots && groupIdx <= slotGroups.size())
-    {
-        if (groupIdx < slotGroups.size() && slotGroups[groupIdx].slot == currentSlot)
-        {
-            // This is a note beat - skip
-            int nextSlot = maxSlots;
-            if (groupIdx + 1 < slotGroups.size())
-                nextSlot = slotGroups[groupIdx + 1].slot;
-            currentSlot = nextSlot;
-            groupIdx++;
-            currentBeatIdx++;
-        }
-        else
-        {
-            // This is a rest region
-            int nextNoteSlot = (groupIdx < slotGroups.size()) ? slotGroups[groupIdx].slot : maxSlots;
-            while (currentSlot < nextNoteSlot)
-            {
-                int remaining = nextNoteSlot - currentSlot;
-                int pauseDuration;
-                if (remaining >= 32) pauseDuration = 32;
-                else if (remaining >= 16) pauseDuration = 16;
-                else if (remaining >= 8) pauseDuration = 8;
-                else if (remaining >= 4) pauseDuration = 4;
-                else if (remaining >= 2) pauseDuration = 2;
-                else pauseDuration = 1;
-                
-                if (currentBeatIdx == beatIndex)
-                {
-                    // Found the rest position! Insert a new RecordedNote here
-                    double insertBeat = measureStartBeat + currentSlot * subdivision;
-                    double noteDuration = pauseDuration * subdivision;
-                    
-                    RecordedNote newNote;
-                    newNote.midiNote = midiNote;
-                    newNote.velocity = 100;
-                    newNote.string = stringIndex;
-                    newNote.fret = fret;
-                    newNote.startBeat = insertBeat;
-                    newNote.endBeat = insertBeat + noteDuration;
-                    newNote.isActive = false;
-                    newNote.midiChannel = 1;
-                    
-                    recordedNotes.push_back(newNote);
-                    
-                    // Sort by startBeat to keep order
-                    std::sort(recordedNotes.begin(), recordedNotes.end(),
-                        [](const RecordedNote& a, const RecordedNote& b) { return a.startBeat < b.startBeat; });
-                    
-                    DBG("Inserted note MIDI " << midiNote << " at beat " << insertBeat 
-                        << " (measure " << (measureIndex + 1) << ", beat " << beatIndex 
-                        << ", string " << stringIndex << ", fret " << fret << ")");
-                    return;
-                }
-                
-                currentSlot += pauseDuration;
-                currentBeatIdx++;
-            }
-        }
-    }
+    RecordedNote newNote;
+    newNote.midiNote = midiNote;
+    newNote.velocity = 100;
+    newNote.string = stringIndex;
+    newNote.fret = fret;
+    newNote.startBeat = insertBeat;
+    newNote.endBeat = insertBeat + rest.durationInSlots * RecordedNoteStore::subdivision;
+    newNote.isActive = false;
+    newNote.midiChannel = 1;
     
-    // If we got here and didn't insert (e.g. empty measure with no notes)
-    if (notesInMeasure.empty() && beatIndex == 0)
-    {
-        // Empty measure - insert at measure start
-        double insertBeat = measureStartBeat;
-        double noteDuration = 1.0;  // Default quarter note duration
-        
-        RecordedNote newNote;
-        newNote.midiNote = midiNote;
-        newNote.velocity = 100;
-        newNote.string = stringIndex;
-        newNote.fret = fret;
-        newNote.startBeat = insertBeat;
-        newNote.endBeat = insertBeat + noteDuration;
-        newNote.isActive = false;
-        newNote.midiChannel = 1;
-        
-        recordedNotes.push_back(newNote);
-        std::sort(recordedNotes.begin(), recordedNotes.end(),
-            [](const RecordedNote& a, const RecordedNote& b) { return a.startBeat < b.startBeat; });
-        
-        DBG("Inserted note MIDI " << midiNote << " at start of empty measure " << (measureIndex + 1));
-        return;
-    }
+    // Anhängen statt neu sortieren: Takt-Index und Capture-Verweise bleiben gültig
+    recordedNotes.add(newNote);
     
-    DBG("Could not find rest at beat " << beatIndex << " in measure " << (measureIndex + 1) << " for insertion");
+    DBG("Inserted note MIDI " << midiNote << " at beat " << insertBeat 
+        << " (measure " << (measureIndex + 1) << ", beat " << beatIndex 
+        << ", string " << stringIndex << ", fret " << fret << ")");
 }
 
-TabTrack NewProjectAudioProcessor::getRecordedTabTrack() const
+RecordedNoteStore::BarRule NewProjectAudioProcessor::getRecordedBarRule() const
 {
-    TabTrack track;
-    track.name = "Recording";
-    track.stringCount = 6;
-    track.tuning = { 64, 59, 55, 50, 45, 40 };  // E-Standard (High to Low)
-    track.colour = juce::Colours::red;
-    
-    int numerator = hostTimeSigNumerator.load();
-    int denominator = hostTimeSigDenominator.load();
-    
-    // Bei 4/4: beatsPerMeasure = 4 (jeder Takt hat 4 Quarter Notes)
-    double beatsPerMeasure = numerator * (4.0 / denominator);
+    RecordedNoteStore::BarRule rule;
+    rule.beatsPerMeasure = hostTimeSigNumerator.load() * (4.0 / hostTimeSigDenominator.load());
+    rule.measureQuantization = measureQuantizationEnabled.load();
+    return rule;
+}
+
+void NewProjectAudioProcessor::syncRecordingCapture() const
+{
+    recordingCapture.flushInto(recordedNotes);
+}
+
+void NewProjectAudioProcessor::timerCallback()
+{
+    dispatchPendingMessageThreadWork();
+    releaseRetiredEditedTracks();
+}
+
+void NewProjectAudioProcessor::dispatchPendingMessageThreadWork()
+{
+    // Aufnahme-Pfad: Löschauftrag und fertige Transkription werden direkt gepollt,
+    // der Audio-Thread muss dafür nichts anstoßen
+    const bool recordingWork = recordingClearPending.load() || audioTranscriber.hasResults();
+    if (messageThreadWorkPending.exchange(false, std::memory_order_acquire) || recordingWork)
+        handleMessageThreadWork();
+}
+
+void NewProjectAudioProcessor::handleMessageThreadWork()
+{
+    if (offlineRenderRequested.exchange(false) && isNonRealtime())
+        prepareOfflineRender();
     
-    // Hole aufgezeichnete Noten - die string/fret Werte wurden bereits während
-    // der Aufnahme von updateRecordedNotesFromLive() mit den Live-Werten synchronisiert!
-    std::vector<RecordedNote> notes;
-    double startBeatRef = 0.0;
+    if (recordingClearPending.exchange(false))
     {
         std::lock_guard<std::mutex> lock(recordingMutex);
-        notes = recordedNotes;
-        startBeatRef = recordingStartBeat;
+        recordedNotes.clear();
+        recordingCapture.clear();
+        accountRecordedNotes();
     }
     
-    // =========================================================================
-    // Build the TabTrack from the recorded notes (already optimized during recording)
-    // =========================================================================
-    
-    // Berechne, in welchem DAW-Takt die Aufnahme begann (1-basiert)
-    // ppqPosition 0-3.99 = Takt 1, 4-7.99 = Takt 2, etc.
-    int firstMeasureNumber = (int)(startBeatRef / beatsPerMeasure) + 1;
-    
-    if (notes.empty())
+    if (audioTranscriber.hasResults())
+        insertTranscribedNotesIntoTab();
+
+    std::lock_guard<std::mutex> lock(recordingMutex);
+    syncRecordingCapture();
+    accountRecordedNotes();
+
+    if (recordingCapture.getDroppedNotes() > 0 || recordingCapture.getDroppedBends() > 0)
+        DBG("RecordingCapture: dropped " << recordingCapture.getDroppedNotes() << " notes, "
+            << recordingCapture.getDroppedBends() << " bend events (buffer full)");
+}
+
+//==============================================================================
+// Speicherbuchhaltung
+//==============================================================================
+void NewProjectAudioProcessor::accountSongModel()
+{
+    // Jeder Parser behält seinen letzten Song, auch wenn ein anderes Format aktiv ist
+    size_t bytes = 0;
+    auto addParser = [&bytes](const auto& parser)
+    {
+        const auto& tracks = parser.getTracks();
+        bytes += MemoryAccounting::bytesOf(tracks) + MemoryAccounting::bytesOf(parser.getMeasureHeaders());
+        for (const auto& track : tracks)
+            bytes += getHeapBytes(track);
+    };
+    addParser(gp5Parser);
+    addParser(gp7Parser);
+    addParser(ptbParser);
+    addParser(midiImporter);
+    songModelMemory.setBytes(bytes);
+}
+
+void NewProjectAudioProcessor::accountRecordedNotes() const
+{
+    recordedNotesMemory.setBytes(recordedNotes.getHeapBytes());
+}
+
+void NewProjectAudioProcessor::accountRecordedTab() const
+{
+    recordedTabMemory.setBytes(recordedTabBuilder.getHeapBytes());
+}
+
+void NewProjectAudioProcessor::accountEditedTracks()
+{
+    // Nur mitgeführte Werte (editedTrackHeapBytes, TabUndoHistory) - kein Lauf über Takte
+    // oder Stände, läuft unter editedTracksMutex. Jeder Track liegt zusätzlich als
+    // veröffentlichte Kopie gleicher Größe im EditedTracksSnapshot.
+    size_t bytes = 2 * MemoryAccounting::nodeBytesOf(editedTracks) + MemoryAccounting::nodeBytesOf(tabUndoHistories)
+                 + MemoryAccounting::nodeBytesOf(editedTrackHeapBytes);
+    for (const auto& [trackIndex, trackBytes] : editedTrackHeapBytes)
+        bytes += 2 * trackBytes;
+    for (const auto& [trackIndex, history] : tabUndoHistories)
+        bytes += history.getHeapBytes();
+    bytes += recordedNotesUndoBytes + MemoryAccounting::nodeBytesOf(recordedNotesUndo);
+    editedTracksMemory.setBytes(bytes);
+}
+
+void NewProjectAudioProcessor::updateMemoryAccounts()
+{
+    accountSongModel();
     {
-        // Leere Takte zurückgeben
-        for (int m = 0; m < 16; ++m)
-        {
-            TabMeasure measure;
-            measure.measureNumber = m + 1;
-            measure.timeSignatureNumerator = numerator;
-            measure.timeSignatureDenominator = denominator;
-            track.measures.add(measure);
-        }
-        return track;
+        std::lock_guard<std::mutex> lock(editedTracksMutex);
+        accountEditedTracks();
     }
-    
-    // Sortiere Noten nach Startzeit
-    std::sort(notes.begin(), notes.end(), [](const RecordedNote& a, const RecordedNote& b) {
-        return a.startBeat < b.startBeat;
-    });
-    
-    // =========================================================================
-    // LEGATO QUANTIZATION: Extend note durations to fill small gaps
-    // This helps when the audio-to-MIDI engine produces too-short notes
-    // =========================================================================
-    double legatoThreshold = legatoQuantizationThreshold.load();
-    if (legatoThreshold > 0.001)
     {
-        // Group notes by string for legato processing
-        // (notes on the same string should connect, different strings are independent)
-        std::map<int, std::vector<size_t>> notesByString;
-        for (size_t i = 0; i < notes.size(); ++i)
-        {
-            notesByString[notes[i].string].push_back(i);
-        }
-        
-        // Process each string independently
-        for (auto& [stringNum, indices] : notesByString)
-        {
-            // Sort indices by start time (should already be sorted, but be safe)
-            std::sort(indices.begin(), indices.end(), [&notes](size_t a, size_t b) {
-                return notes[a].startBeat < notes[b].startBeat;
-            });
-            
-            // Extend each note to the next note if the gap is small enough
-            for (size_t i = 0; i + 1 < indices.size(); ++i)
-            {
-                RecordedNote& currentNote = notes[indices[i]];
-                const RecordedNote& nextNote = notes[indices[i + 1]];
-                
-                double gap = nextNote.startBeat - currentNote.endBeat;
-                
-                // If gap is small (likely an artifact of early note-off), extend to next note
-                if (gap > 0.0 && gap <= legatoThreshold)
-                {
-                    currentNote.endBeat = nextNote.startBeat;
-                }
-            }
-        }
+        std::lock_guard<std::mutex> cacheLock(recordedTabMutex);
+        accountRecordedTab();
         
-        // Also extend notes that end just before the next event on ANY string
-        // (to avoid tiny rests before chord changes)
-        for (size_t i = 0; i < notes.size(); ++i)
-        {
-            RecordedNote& note = notes[i];
-            
-            // Find the next event (any note starting after this note's current end)
-            double nextEventStart = std::numeric_limits<double>::max();
-            for (size_t j = 0; j < notes.size(); ++j)
-            {
-                if (notes[j].startBeat > note.endBeat)
-                {
-                    nextEventStart = std::min(nextEventStart, notes[j].startBeat);
-                }
-            }
-            
-            // If there's a tiny gap to the next event, extend
-            if (nextEventStart < std::numeric_limits<double>::max())
-            {
-                double gap = nextEventStart - note.endBeat;
-                if (gap > 0.0 && gap <= legatoThreshold * 0.5) // Tighter threshold for cross-string
-                {
-                    note.endBeat = nextEventStart;
-                }
-            }
-        }
+        std::lock_guard<std::mutex> lock(recordingMutex);
+        syncRecordingCapture();
+        accountRecordedNotes();
     }
+    if (!audioTranscriber.isTranscribing())
+        audioTranscriber.updateMemoryAccounts();
+}
+
+TabTrack NewProjectAudioProcessor::getRecordedTabTrack() const
+{
+    TraceScope trace("getRecordedTabTrack", "tab");
+    TabTrack track;
+    uint32_t knownRevision = 0;
+    updateRecordedTabTrack(track, knownRevision);
+    return track;
+}
+
+bool NewProjectAudioProcessor::updateRecordedTabTrack(TabTrack& track, uint32_t& knownRevision) const
+{
+    std::lock_guard<std::mutex> cacheLock(recordedTabMutex);
     
-    // Finde den letzten Beat
-    double maxBeat = 0.0;
-    for (const auto& note : notes)
+    // Unter dem Lock nur geänderte Takte bestimmen und ihre Noten kopieren - die string/fret
+    // Werte wurden bereits während der Aufnahme von updateRecordedNotesFromLive() mit den
+    // Live-Werten synchronisiert! Der Aufbau der TabBeats läuft danach ohne Lock.
+    RecordedTabBuilder::Update update;
     {
-        maxBeat = std::max(maxBeat, note.endBeat);
+        std::lock_guard<std::mutex> lock(recordingMutex);
+        syncRecordingCapture();
+        
+        RecordedTabBuilder::Settings settings;
+        settings.numerator = hostTimeSigNumerator.load();
+        settings.denominator = hostTimeSigDenominator.load();
+        settings.rule.beatsPerMeasure = settings.numerator * (4.0 / settings.denominator);
+        settings.rule.measureQuantization = measureQuantizationEnabled.load();
+        settings.legatoThreshold = legatoQuantizationThreshold.load();
+        settings.tuning = inputTuning;
+        
+        update = recordedTabBuilder.collect(recordedNotes, settings);
     }
     
-    // Berechne Anzahl der Takte ab dem Start-Takt
-    // Takte werden relativ zum Aufnahme-Start erstellt
-    int lastMeasureNumber = (int)(maxBeat / beatsPerMeasure) + 1;
-    int numMeasures = std::max(16, lastMeasureNumber + 2);
+    recordedTabBuilder.apply(std::move(update));
+    accountRecordedTab();
     
-    // Erstelle Takte - die measureNumber entspricht direkt der DAW-Taktnummer
-    // ppqPosition 0-3.99 = Takt 1, ppqPosition 4-7.99 = Takt 2, etc.
-    // Wir iterieren über Taktnummern (1-basiert wie im DAW)
-    for (int barNum = 1; barNum <= numMeasures; ++barNum)
+    const uint32_t revision = recordedTabBuilder.getTrackRevision();
+    if (revision == knownRevision && knownRevision != 0)
+        return false;
+    
+    // Während der Aufnahme ändern sich nur der offene Takt und seine Nachbarn
+    const auto& measures = recordedTabBuilder.getMeasures();
+    std::vector<int> changedMeasures;
+    if (knownRevision != 0 && ! track.measures.isEmpty()
+        && recordedTabBuilder.getMeasuresChangedSince(knownRevision, changedMeasures))
     {
-        TabMeasure measure;
-        measure.measureNumber = barNum;
-        measure.timeSignatureNumerator = numerator;
-        measure.timeSignatureDenominator = denominator;
-        
-        // Der Takt barNum entspricht ppqPosition [(barNum-1)*beatsPerMeasure, barNum*beatsPerMeasure)
-        double measureStartBeat = (barNum - 1) * beatsPerMeasure;
-        
-        // Sammle alle Noten in diesem Takt
-        // Mit intelligenter Quantisierung: Wenn eine Note nahe am Taktanfang beginnt
-        // und stark gekürzt werden müsste, verschiebe sie in den nächsten Takt
-        std::vector<const RecordedNote*> notesInMeasure;
-        for (const auto& note : notes)
-        {
-            // Bestimme den Takt dieser Note mit Toleranz für Floating-Point-Fehler
-            // Ein startBeat von z.B. 7.999 soll als Takt 3 (= Beat 8.0) erkannt werden,
-            // nicht als kurze Note am Ende von Takt 2
-            double startBeat = note.startBeat;
-            double originalDuration = note.endBeat - note.startBeat;
-            
-            // Berechne den "natürlichen" Takt der Note
-            int noteBar = static_cast<int>(startBeat / beatsPerMeasure) + 1;
-            double positionInMeasure = startBeat - (noteBar - 1) * beatsPerMeasure;
-            double distanceToNextBar = beatsPerMeasure - positionInMeasure;
-            
-            // Takt-Quantisierung: Verschiebe Noten am Taktende in den nächsten Takt
-            if (measureQuantizationEnabled.load() && distanceToNextBar < 0.5 && distanceToNextBar > 0.0001)
-            {
-                // Wie viel der Note passt noch in diesen Takt?
-                double truncatedDuration = distanceToNextBar;
-                
-                // Bedingung 1: Note ist kürzer als eine 32tel-Note im aktuellen Takt
-                // (= sie wird zu kurz um sinnvoll dargestellt zu werden)
-                bool tooShortInCurrentBar = truncatedDuration < 0.125;
-                
-                // Bedingung 2: Note würde auf weniger als 33% ihrer Länge gekürzt
-                // UND ist mindestens eine 16tel-Note lang
-                double truncationRatio = truncatedDuration / std::max(0.001, originalDuration);
-                bool severelyTruncated = (truncationRatio < 0.33 && originalDuration >= 0.125);
-                
-                if (tooShortInCurrentBar || severelyTruncated)
-                {
-                    noteBar = noteBar + 1; // Verschiebe in nächsten Takt
-                }
-            }
-            
-            if (noteBar == barNum)
-            {
-                notesInMeasure.push_back(&note);
-            }
-        }
-        
-        if (notesInMeasure.empty())
-        {
-            // Fülle leere Takte mit Pausen
-            double remainingSlots = beatsPerMeasure / 0.125;
-            while (remainingSlots > 0.1) // Float safety
-            {
-                TabBeat beat;
-                beat.isRest = true;
-                
-                // Max duration check
-                if (remainingSlots >= 32.0) { beat.duration = NoteDuration::Whole; remainingSlots -= 32.0; }
-                else if (remainingSlots >= 16.0) { beat.duration = NoteDuration::Half; remainingSlots -= 16.0; }
-                else if (remainingSlots >= 8.0) { beat.duration = NoteDuration::Quarter; remainingSlots -= 8.0; }
-                else if (remainingSlots >= 4.0) { beat.duration = NoteDuration::Eighth; remainingSlots -= 4.0; }
-                else if (remainingSlots >= 2.0) { beat.duration = NoteDuration::Sixteenth; remainingSlots -= 2.0; }
-                else { beat.duration = NoteDuration::ThirtySecond; remainingSlots -= 1.0; }
-                
-                // Add empty notes for GP5 writer
-                for (int s = 0; s < 6; ++s) {
-                   TabNote emptyNote; emptyNote.string = s; emptyNote.fret = -1; beat.notes.add(emptyNote);
-                }
-                measure.beats.add(beat);
-            }
-            track.measures.add(measure);
-            continue;
-        }
-        
-        // 32nd note resolution (0.125 beats)
-        const double subdivision = 0.125;
-        const int maxSlots = (int)(beatsPerMeasure / subdivision + 0.5);
-        
-        // --- CHORD DETECTION & SEQUENCING ---
-        // Gruppiere Noten nach "Musikalischen Events" (Akkorde vs. Sequenzen)
-        // um zu verhindern, dass schnelle Triller als Akkord im selben Slot landen.
-        
-        // 1. Sortiere Noten zeitlich
-        std::vector<const RecordedNote*> sortedNotes = notesInMeasure;
-        std::sort(sortedNotes.begin(), sortedNotes.end(), 
-            [](const RecordedNote* a, const RecordedNote* b) { return a->startBeat < b->startBeat; });
-
-        // 2. Cluster Noten in Events
-        struct MusicalEvent {
-            double startTimeSum = 0.0;
-            std::vector<const RecordedNote*> notes;
-            double getStartTime() const { return notes.empty() ? 0.0 : startTimeSum / notes.size(); }
-        };
-        std::vector<MusicalEvent> events;
-        
-        // Toleranz für Akkorde: 0.06 Beats (ca. 30ms bei 120bpm)
-        const double chordThreshold = 0.06;
-
-        for (const auto* note : sortedNotes) {
-            if (events.empty()) {
-                MusicalEvent evt;
-                evt.notes.push_back(note);
-                evt.startTimeSum = note->startBeat;
-                events.push_back(evt);
-            } else {
-                auto& lastEvt = events.back();
-                double avgStart = lastEvt.getStartTime();
-                
-                // Wenn Note sehr nah am vorherigen Event startet -> Teil des Akkords
-                if ((note->startBeat - avgStart) < chordThreshold) {
-                    lastEvt.notes.push_back(note);
-                    lastEvt.startTimeSum += note->startBeat;
-                } else {
-                    // Neues Event (z.B. nächster Ton im Triller)
-                    MusicalEvent evt;
-                    evt.notes.push_back(note);
-                    evt.startTimeSum = note->startBeat;
-                    events.push_back(evt);
-                }
-            }
-        }
-
-        // 3. Map Events auf Slots (mit Konfliktlösung)
-        std::map<int, std::vector<const RecordedNote*>> noteGroups;
-        int lastOccupiedSlot = -1;
-
-        for (int evtIdx = 0; evtIdx < (int)events.size(); ++evtIdx) {
-            const auto& evt = events[evtIdx];
-            double posInMeasure = evt.getStartTime() - measureStartBeat;
-            
-            // Wenn die Position negativ ist (Note wurde aus dem vorherigen Takt verschoben),
-            // platziere sie am Taktanfang (Slot 0)
-            if (posInMeasure < 0.0)
-                posInMeasure = 0.0;
-            
-            int idealSlot = (int)(posInMeasure / subdivision + 0.5);
-            
-            // Stelle sicher, dass Events in unterschiedlichen Slots landen
-            // (außer sie sind extrem weit weg vom Grid und wir müssen mergen, aber hier priorisieren wir Trennung)
-            int slot = std::max(idealSlot, lastOccupiedSlot + 1);
-            
-            // Limit auf Taktlänge
-            if (slot >= maxSlots) slot = maxSlots - 1;
-            if (slot < 0) slot = 0;
-
-            for (const auto* n : evt.notes) {
-                noteGroups[slot].push_back(n);
-            }
-            
-            // Update last occupied (nur wenn wir wirklich in einem neuen Slot sind)
-            if (slot > lastOccupiedSlot) {
-                lastOccupiedSlot = slot;
-            }
-        }
+        while (track.measures.size() > measures.size())
+            track.measures.removeLast();
+        while (track.measures.size() < measures.size())
+            track.measures.add(TabMeasure());
         
-        // Iteriere durch die Slots und fülle Lücken mit Pausen
-        int currentSlot = 0;
-        while (currentSlot < maxSlots)
-        {
-            auto it = noteGroups.find(currentSlot);
-            bool hasNotes = (it != noteGroups.end());
-            
-            TabBeat beat;
-            int durationInSlots = 0;
-            
-            if (hasNotes)
-            {
-                beat.isRest = false;
-                const auto& group = it->second;
-                
-                // Bestimme die Dauer basierend auf den Noten und dem nächsten Event
-                double minNoteLen = std::numeric_limits<double>::max();
-                for (const auto* note : group)
-                {
-                     double noteLen = note->endBeat - note->startBeat;
-                     if (noteLen < 0.001) noteLen = 0.001; // safety
-                     minNoteLen = std::min(minNoteLen, noteLen);
-                }
-                
-                int desiredSlots = (int)(minNoteLen / subdivision + 0.5);
-                if (desiredSlots < 1) desiredSlots = 1;
-                
-                // Finde nächstes Event (Note oder Taktende) um Überlappung zu vermeiden
-                int nextEventSlot = maxSlots;
-                auto nextIt = noteGroups.upper_bound(currentSlot);
-                if (nextIt != noteGroups.end())
-                    nextEventSlot = nextIt->first;
-                
-                // Duration limitieren auf Gap zum nächsten Event
-                durationInSlots = std::min(desiredSlots, nextEventSlot - currentSlot);
-                
-                // Snap to standard durations (prefer standard values)
-                // 32(1), 24(0.75), 16(0.5), 12(0.375), 8(0.25), 6, 4, 3, 2, 1
-                if (durationInSlots >= 32) durationInSlots = 32;      // Whole
-                else if (durationInSlots >= 24) durationInSlots = 24; // Dotted Half
-                else if (durationInSlots >= 16) durationInSlots = 16; // Half
-                else if (durationInSlots >= 12) durationInSlots = 12; // Dotted Quarter
-                else if (durationInSlots >= 8) durationInSlots = 8;   // Quarter
-                else if (durationInSlots >= 6) durationInSlots = 6;   // Dotted Eighth
-                else if (durationInSlots >= 4) durationInSlots = 4;   // Eighth
-                else if (durationInSlots >= 3) durationInSlots = 3;   // Dotted 16th
-                else if (durationInSlots >= 2) durationInSlots = 2;   // 16th
-                else durationInSlots = 1;                             // 32nd
-                
-                // Noten setzen
-                for (int s = 0; s < 6; ++s)
-                {
-                    TabNote emptyNote; emptyNote.string = s; emptyNote.fret = -1; beat.notes.add(emptyNote);
-                }
-                
-                // === Sicherheitsnetz: String-Konflikte auflösen ===
-                // Falls zwei Noten im gleichen Beat die gleiche Saite haben,
-                // versuche die zweite auf eine andere Saite umzulegen.
-                // Das passiert z.B. bei Oktav-Noten (C3+C4) die im reoptimize
-                // nicht korrekt gruppiert wurden.
-                {
-                    std::set<int> occupiedStrings;
-                    // Kopie der Noten, damit wir Konflikte auflösen können
-                    struct ResolvedNote {
-                        int midiNote;
-                        int string;
-                        int fret;
-                        int velocity;
-                        const RecordedNote* original;
-                    };
-                    std::vector<ResolvedNote> resolvedNotes;
-                    for (const auto* note : group)
-                    {
-                        resolvedNotes.push_back({note->midiNote, note->string, note->fret, note->velocity, note});
-                    }
-                    
-                    for (size_t ni = 0; ni < resolvedNotes.size(); ++ni)
-                    {
-                        auto& rn = resolvedNotes[ni];
-                        if (rn.string >= 0 && rn.string < 6 && occupiedStrings.count(rn.string) == 0)
-                        {
-                            occupiedStrings.insert(rn.string);
-                        }
-                        else if (rn.string >= 0 && rn.string < 6)
-                        {
-                            // Konflikt! Diese Saite ist bereits belegt.
-                            // Versuche alternative Saite zu finden
-                            bool found = false;
-                            int bestAltScore = -100000;
-                            int bestAltString = -1;
-                            int bestAltFret = -1;
-                            
-                            for (int s = 0; s < 6; ++s)
-                            {
-                                if (occupiedStrings.count(s) > 0) continue;
-                                int fret = rn.midiNote - standardTuning[s];
-                                if (fret >= 0 && fret <= 24)
-                                {
-                                    // Einfache Bewertung: bevorzuge Positionen nahe der aktuellen
-                                    int score = 100 - std::abs(fret - rn.fret) * 10;
-                                    // Check Fret-Spannweite mit bereits platzierten Noten
-                                    int minF = fret, maxF = fret;
-                                    for (size_t oi = 0; oi < ni; ++oi)
-                                    {
-                                        if (resolvedNotes[oi].fret > 0)
-                                        {
-                                            minF = std::min(minF, resolvedNotes[oi].fret);
-                                            maxF = std::max(maxF, resolvedNotes[oi].fret);
-                                        }
-                                    }
-                                    if (fret > 0) { minF = std::min(minF, fret); maxF = std::max(maxF, fret); }
-                                    if (minF <= maxF && maxF - minF > 3) 
-                                        score -= 500;  // Starke Strafe für > 3 Bünde Spannweite
-                                    
-                                    if (score > bestAltScore)
-                                    {
-                                        bestAltScore = score;
-                                        bestAltString = s;
-                                        bestAltFret = fret;
-                                    }
-                                }
-                            }
-                            
-                            if (bestAltString >= 0)
-                            {
-                                rn.string = bestAltString;
-                                rn.fret = bestAltFret;
-                                occupiedStrings.insert(bestAltString);
-                            }
-                            // Sonst: Note kann leider nicht platziert werden (alle Saiten belegt)
-                        }
-                    }
-                    
-                    // Jetzt die aufgelösten Noten in den Beat schreiben
-                    for (const auto& rn : resolvedNotes)
-                    {
-                        if (rn.string >= 0 && rn.string < 6)
-                        {
-                            beat.notes.getReference(rn.string).fret = rn.fret;
-                            beat.notes.getReference(rn.string).velocity = rn.velocity;
-                            
-                            // === Apply Finger Number ===
-                            if (rn.original->fingerNumber >= 0)
-                                beat.notes.getReference(rn.string).fingerNumber = rn.original->fingerNumber;
-                            
-                            // === Apply Recorded Effects ===
-                            auto& tabNote = beat.notes.getReference(rn.string);
-                            const auto* note = rn.original;
-                        
-                            // Vibrato
-                            if (note->hasVibrato)
-                                tabNote.effects.vibrato = true;
-                            
-                            // Bending - Threshold: 0.5 Halbtöne (50 cents)
-                            // MIDI Pitch Wheel Bends sind immer bewusst vom Spieler
-                            // (Audio-Transcription hat eigenen höheren Threshold)
-                            if (note->maxBendValue >= 0.5f)
-                            {
-                                tabNote.effects.bend = true;
-                                tabNote.effects.bendValue = note->maxBendValue;
-                                
-                                // Convert recorded raw events to GP5BendPoints (0-60 scale)
-                                if (!note->rawBendEvents.empty())
-                                {
-                                    double noteStart = note->startBeat;
-                                    double noteLen = note->endBeat - note->startBeat;
-                                    if (noteLen < 0.001) noteLen = 0.001; // Safety
-                                    
-                                    tabNote.effects.bendPoints.clear();
-                                    
-                                    // Always start with a 0-point if not present
-                                    if (note->rawBendEvents.front().beat > noteStart + 0.01)
-                                    {
-                                        TabBendPoint startPt;
-                                        startPt.position = 0;
-                                        startPt.value = 0;
-                                        tabNote.effects.bendPoints.push_back(startPt);
-                                    }
-                                    
-                                    for (const auto& ev : note->rawBendEvents)
-                                    {
-                                        double relPos = (ev.beat - noteStart) / noteLen;
-                                        if (relPos < 0.0) relPos = 0.0;
-                                        if (relPos > 1.0) relPos = 1.0;
-                                        
-                                        TabBendPoint bp;
-                                        bp.position = (int)(relPos * 60.0);
-                                        // Clamp small values to 0 - only show significant bends in curve
-                                        bp.value = (std::abs(ev.value) < 10) ? 0 : ev.value;
-                                        
-                                        // Filter too close points (GP5 restriction)
-                                        if (!tabNote.effects.bendPoints.empty())
-                                        {
-                                            if (bp.position == tabNote.effects.bendPoints.back().position)
-                                               tabNote.effects.bendPoints.back().value = bp.value; // Overwrite same pos
-                                            else
-                                               tabNote.effects.bendPoints.push_back(bp);
-                                        }
-                                        else
-                                            tabNote.effects.bendPoints.push_back(bp);
-                                    }
-                                    
-                                    // Ensure end point
-                                    if (tabNote.effects.bendPoints.empty() || tabNote.effects.bendPoints.back().position < 60)
-                                    {
-                                         TabBendPoint endPt;
-                                         endPt.position = 60;
-                                         // Hold last value
-                                         if (!tabNote.effects.bendPoints.empty())
-                                             endPt.value = tabNote.effects.bendPoints.back().value;
-                                         else
-                                             endPt.value = 0;
-                                         tabNote.effects.bendPoints.push_back(endPt);
-                                    }
-                                    
-                                    // Determine Bend Type based on curve shape
-                                    // 1=Bend, 2=Bend+Release, 3=Release, 4=PreBend, 5=PreBend+Release
-                                    bool startsZero = (tabNote.effects.bendPoints.front().value < 10);
-                                    bool endsLow = (tabNote.effects.bendPoints.back().value < 10);
-                                    
-                                    if (startsZero)
-                                    {
-                                        if (endsLow) tabNote.effects.bendType = 2; // Bend+Release
-                                        else tabNote.effects.bendType = 1; // Bend
-                                    }
-                                    else
-                                    {
-                                        if (endsLow) tabNote.effects.bendType = 3; // Release (PreBend+Release?)
-                                        else tabNote.effects.bendType = 4; // PreBend or Hold
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }  // Ende Sicherheitsnetz-Block
-            }
-            else
-            {
-                // Pause einfügen
-                beat.isRest = true;
-                
-                // Finde Länge bis zum nächsten Event
-                int nextEventSlot = maxSlots;
-                auto nextIt = noteGroups.upper_bound(currentSlot);
-                if (nextIt != noteGroups.end()) 
-                    nextEventSlot = nextIt->first;
-                
-                int gap = nextEventSlot - currentSlot;
-                
-                // Wähle größtmögliche Standarddauer
-                if (gap >= 32) durationInSlots = 32;
-                else if (gap >= 16) durationInSlots = 16;
-                else if (gap >= 8) durationInSlots = 8;
-                else if (gap >= 4) durationInSlots = 4;
-                else if (gap >= 2) durationInSlots = 2;
-                else durationInSlots = 1;
-                
-                // Leere Noten für GP5
-                for (int s = 0; s < 6; ++s) {
-                    TabNote emptyNote; emptyNote.string = s; emptyNote.fret = -1; beat.notes.add(emptyNote);
-                }
-            }
-            
-            // Setze Duration und Dotted Flags
-            beat.isDotted = false;
-            switch (durationInSlots)
-            {
-                case 32: beat.duration = NoteDuration::Whole; break;
-                case 24: beat.duration = NoteDuration::Half; beat.isDotted = true; break;
-                case 16: beat.duration = NoteDuration::Half; break;
-                case 12: beat.duration = NoteDuration::Quarter; beat.isDotted = true; break;
-                case 8:  beat.duration = NoteDuration::Quarter; break;
-                case 6:  beat.duration = NoteDuration::Eighth; beat.isDotted = true; break;
-                case 4:  beat.duration = NoteDuration::Eighth; break;
-                case 3:  beat.duration = NoteDuration::Sixteenth; beat.isDotted = true; break;
-                case 2:  beat.duration = NoteDuration::Sixteenth; break;
-                default: beat.duration = NoteDuration::ThirtySecond; break;
-            }
-            
-            measure.beats.add(beat);
-            currentSlot += durationInSlots;
-        }
+        for (int index : changedMeasures)
+            track.measures.getReference(index) = measures.getReference(index);
         
-        track.measures.add(measure);
+        knownRevision = revision;
+        return true;
     }
     
-    return track;
+    track = TabTrack();
+    track.name = "Recording";
+    applyInputTuning(track);
+    track.colour = juce::Colours::red;
+    track.measures = recordedTabBuilder.getMeasures();
+    
+    knownRevision = revision;
+    return true;
 }
 
 std::vector<TabTrack> NewProjectAudioProcessor::getRecordedTabTracks() const
@@ -4738,7 +3507,8 @@ std::vector<TabTrack> NewProjectAudioProcessor::getRecordedTabTracks() const
     double startBeatRef = 0.0;
     {
         std::lock_guard<std::mutex> lock(recordingMutex);
-        allNotes = recordedNotes;
+        syncRecordingCapture();
+        allNotes = recordedNotes.getNotes();
         startBeatRef = recordingStartBeat;
     }
     
@@ -4766,8 +3536,6 @@ std::vector<TabTrack> NewProjectAudioProcessor::getRecordedTabTracks() const
     }
     
     // Multiple channels - create a track for each
-    std::vector<TabTrack> tracks;
-    
     int numerator = hostTimeSigNumerator.load();
     int denominator = hostTimeSigDenominator.load();
     double beatsPerMeasure = numerator * (4.0 / denominator);
@@ -4781,211 +3549,251 @@ std::vector<TabTrack> NewProjectAudioProcessor::getRecordedTabTracks() const
     int lastMeasureNumber = (int)(maxBeat / beatsPerMeasure) + 1;
     int numMeasures = std::max(16, lastMeasureNumber + 2);
     
-    // Create a track for each channel
-    for (int channel : usedChannels)
+    // Kanäle sind unabhängig → parallel auf dem Worker-Pool aufbauen.
+    // Jeder Job schreibt nur seinen eigenen Slot, die Reihenfolge bleibt die der Kanäle.
+    const std::vector<int> channels(usedChannels.begin(), usedChannels.end());
+    std::vector<std::vector<RecordedNote>> channelNotes(channels.size());
+    for (const auto& note : allNotes)
+    {
+        const auto it = std::lower_bound(channels.begin(), channels.end(), note.midiChannel);
+        channelNotes[(size_t) std::distance(channels.begin(), it)].push_back(note);
+    }
+    
+    std::vector<TabTrack> tracks(channels.size());
+    channelWorkerPool.runAll((int) channels.size(), [&](int i)
+    {
+        tracks[(size_t) i] = buildChannelTabTrack(channels[(size_t) i], std::move(channelNotes[(size_t) i]),
+                                                  numMeasures, numerator, denominator);
+    });
+    
+    return tracks;
+}
+
+TabTrack NewProjectAudioProcessor::buildChannelTabTrack(int channel, std::vector<RecordedNote> channelNotes,
+                                                        int numMeasures, int numerator, int denominator) const
+{
+    const double beatsPerMeasure = numerator * (4.0 / denominator);
+    
+    TabTrack track;
+    int instrument = channelInstruments[channel - 1];
+    
+    // Channel 10 is the drum channel - use "Drums" as name
+    if (channel == 10)
+    {
+        track.name = "Drums";
+        instrument = 0;  // Standard Kit for drums
+    }
+    else
+    {
+        const char* instrumentName = (instrument >= 0 && instrument < 128) ? gmInstrumentNames[instrument] : "Unknown";
+        track.name = juce::String(instrumentName);
+    }
+    
+    applyInputTuning(track);
+    track.midiChannel = channel - 1;  // 0-based for GP5
+    track.midiInstrument = instrument;  // Use captured instrument
+    
+    // Assign different colors per channel
+    static const juce::Colour channelColors[] = {
+        juce::Colours::red, juce::Colours::blue, juce::Colours::green,
+        juce::Colours::orange, juce::Colours::purple, juce::Colours::cyan,
+        juce::Colours::yellow, juce::Colours::magenta
+    };
+    track.colour = channelColors[(channel - 1) % 8];
+    
+    // Sort notes by start time
+    std::sort(channelNotes.begin(), channelNotes.end(), 
+        [](const RecordedNote& a, const RecordedNote& b) { return a.startBeat < b.startBeat; });
+    
+    // Build measures for this channel (simplified version)
+    for (int barNum = 1; barNum <= numMeasures; ++barNum)
     {
-        // Filter notes for this channel
-        std::vector<RecordedNote> channelNotes;
-        for (const auto& note : allNotes)
+        TabMeasure measure;
+        measure.measureNumber = barNum;
+        measure.timeSignatureNumerator = numerator;
+        measure.timeSignatureDenominator = denominator;
+        
+        double measureStartBeat = (barNum - 1) * beatsPerMeasure;
+        
+        // Collect notes in this measure for this channel
+        std::vector<const RecordedNote*> notesInMeasure;
+        for (const auto& note : channelNotes)
         {
-            if (note.midiChannel == channel)
+            double roundedPPQ = std::round(note.startBeat * 1000.0) / 1000.0;
+            int noteBar = static_cast<int>(roundedPPQ / beatsPerMeasure) + 1;
+            if (noteBar == barNum)
             {
-                channelNotes.push_back(note);
+                notesInMeasure.push_back(&note);
             }
         }
         
-        TabTrack track;
-        int instrument = channelInstruments[channel - 1];
-        
-        // Channel 10 is the drum channel - use "Drums" as name
-        if (channel == 10)
+        if (notesInMeasure.empty())
         {
-            track.name = "Drums";
-            instrument = 0;  // Standard Kit for drums
+            // Empty measure - add whole rest
+            TabBeat beat;
+            beat.isRest = true;
+            beat.duration = NoteDuration::Whole;
+            for (int s = 0; s < track.stringCount; ++s)
+            {
+                TabNote emptyNote; emptyNote.string = s; emptyNote.fret = -1;
+                beat.notes.add(emptyNote);
+            }
+            measure.beats.add(beat);
         }
         else
         {
-            const char* instrumentName = (instrument >= 0 && instrument < 128) ? gmInstrumentNames[instrument] : "Unknown";
-            track.name = juce::String(instrumentName);
-        }
-        
-        track.stringCount = 6;
-        track.tuning = { 64, 59, 55, 50, 45, 40 };  // E-Standard
-        track.midiChannel = channel - 1;  // 0-based for GP5
-        track.midiInstrument = instrument;  // Use captured instrument
-        
-        // Assign different colors per channel
-        static const juce::Colour channelColors[] = {
-            juce::Colours::red, juce::Colours::blue, juce::Colours::green,
-            juce::Colours::orange, juce::Colours::purple, juce::Colours::cyan,
-            juce::Colours::yellow, juce::Colours::magenta
-        };
-        track.colour = channelColors[(channel - 1) % 8];
-        
-        // Sort notes by start time
-        std::sort(channelNotes.begin(), channelNotes.end(), 
-            [](const RecordedNote& a, const RecordedNote& b) { return a.startBeat < b.startBeat; });
-        
-        // Build measures for this channel (simplified version)
-        for (int barNum = 1; barNum <= numMeasures; ++barNum)
-        {
-            TabMeasure measure;
-            measure.measureNumber = barNum;
-            measure.timeSignatureNumerator = numerator;
-            measure.timeSignatureDenominator = denominator;
-            
-            double measureStartBeat = (barNum - 1) * beatsPerMeasure;
+            // Use 32nd note resolution
+            const double subdivision = 0.125;
+            const int maxSlots = (int)(beatsPerMeasure / subdivision + 0.5);
             
-            // Collect notes in this measure for this channel
-            std::vector<const RecordedNote*> notesInMeasure;
-            for (const auto& note : channelNotes)
+            // Map notes to slots
+            std::map<int, std::vector<const RecordedNote*>> noteGroups;
+            for (const auto* note : notesInMeasure)
             {
-                double roundedPPQ = std::round(note.startBeat * 1000.0) / 1000.0;
-                int noteBar = static_cast<int>(roundedPPQ / beatsPerMeasure) + 1;
-                if (noteBar == barNum)
-                {
-                    notesInMeasure.push_back(&note);
-                }
+                double posInMeasure = note->startBeat - measureStartBeat;
+                int slot = (int)(posInMeasure / subdivision + 0.5);
+                slot = juce::jlimit(0, maxSlots - 1, slot);
+                noteGroups[slot].push_back(note);
             }
             
-            if (notesInMeasure.empty())
+            int currentSlot = 0;
+            while (currentSlot < maxSlots)
             {
-                // Empty measure - add whole rest
-                TabBeat beat;
-                beat.isRest = true;
-                beat.duration = NoteDuration::Whole;
-                for (int s = 0; s < 6; ++s)
-                {
-                    TabNote emptyNote; emptyNote.string = s; emptyNote.fret = -1;
-                    beat.notes.add(emptyNote);
-                }
-                measure.beats.add(beat);
-            }
-            else
-            {
-                // Use 32nd note resolution
-                const double subdivision = 0.125;
-                const int maxSlots = (int)(beatsPerMeasure / subdivision + 0.5);
+                auto it = noteGroups.find(currentSlot);
+                bool hasNotes = (it != noteGroups.end());
                 
-                // Map notes to slots
-                std::map<int, std::vector<const RecordedNote*>> noteGroups;
-                for (const auto* note : notesInMeasure)
-                {
-                    double posInMeasure = note->startBeat - measureStartBeat;
-                    int slot = (int)(posInMeasure / subdivision + 0.5);
-                    slot = juce::jlimit(0, maxSlots - 1, slot);
-                    noteGroups[slot].push_back(note);
-                }
+                TabBeat beat;
+                int durationInSlots = 0;
                 
-                int currentSlot = 0;
-                while (currentSlot < maxSlots)
+                if (hasNotes)
                 {
-                    auto it = noteGroups.find(currentSlot);
-                    bool hasNotes = (it != noteGroups.end());
+                    beat.isRest = false;
+                    const auto& group = it->second;
+                    
+                    // Determine duration based on note length
+                    double minNoteLen = 999.0;
+                    for (const auto* note : group)
+                        minNoteLen = std::min(minNoteLen, note->endBeat - note->startBeat);
                     
-                    TabBeat beat;
-                    int durationInSlots = 0;
+                    int desiredSlots = (int)(minNoteLen / subdivision + 0.5);
+                    if (desiredSlots < 1) desiredSlots = 1;
                     
-                    if (hasNotes)
+                    // Find next event
+                    int nextEventSlot = maxSlots;
+                    auto nextIt = noteGroups.upper_bound(currentSlot);
+                    if (nextIt != noteGroups.end())
+                        nextEventSlot = nextIt->first;
+                    
+                    durationInSlots = std::min(desiredSlots, nextEventSlot - currentSlot);
+                    
+                    // Snap to standard durations
+                    if (durationInSlots >= 32) durationInSlots = 32;
+                    else if (durationInSlots >= 16) durationInSlots = 16;
+                    else if (durationInSlots >= 8) durationInSlots = 8;
+                    else if (durationInSlots >= 4) durationInSlots = 4;
+                    else if (durationInSlots >= 2) durationInSlots = 2;
+                    else durationInSlots = 1;
+                    
+                    // Initialize notes
+                    for (int s = 0; s < track.stringCount; ++s)
                     {
-                        beat.isRest = false;
-                        const auto& group = it->second;
-                        
-                        // Determine duration based on note length
-                        double minNoteLen = 999.0;
-                        for (const auto* note : group)
-                            minNoteLen = std::min(minNoteLen, note->endBeat - note->startBeat);
-                        
-                        int desiredSlots = (int)(minNoteLen / subdivision + 0.5);
-                        if (desiredSlots < 1) desiredSlots = 1;
-                        
-                        // Find next event
-                        int nextEventSlot = maxSlots;
-                        auto nextIt = noteGroups.upper_bound(currentSlot);
-                        if (nextIt != noteGroups.end())
-                            nextEventSlot = nextIt->first;
-                        
-                        durationInSlots = std::min(desiredSlots, nextEventSlot - currentSlot);
-                        
-                        // Snap to standard durations
-                        if (durationInSlots >= 32) durationInSlots = 32;
-                        else if (durationInSlots >= 16) durationInSlots = 16;
-                        else if (durationInSlots >= 8) durationInSlots = 8;
-                        else if (durationInSlots >= 4) durationInSlots = 4;
-                        else if (durationInSlots >= 2) durationInSlots = 2;
-                        else durationInSlots = 1;
-                        
-                        // Initialize notes
-                        for (int s = 0; s < 6; ++s)
-                        {
-                            TabNote emptyNote; emptyNote.string = s; emptyNote.fret = -1;
-                            beat.notes.add(emptyNote);
-                        }
-                        
-                        // Set notes
-                        for (const auto* note : group)
-                        {
-                            if (note->string >= 0 && note->string < 6)
-                            {
-                                beat.notes.getReference(note->string).fret = note->fret;
-                                beat.notes.getReference(note->string).velocity = note->velocity;
-                            }
-                        }
+                        TabNote emptyNote; emptyNote.string = s; emptyNote.fret = -1;
+                        beat.notes.add(emptyNote);
                     }
-                    else
+                    
+                    // Set notes
+                    for (const auto* note : group)
                     {
-                        // Rest
-                        beat.isRest = true;
-                        
-                        int nextEventSlot = maxSlots;
-                        auto nextIt = noteGroups.upper_bound(currentSlot);
-                        if (nextIt != noteGroups.end())
-                            nextEventSlot = nextIt->first;
-                        
-                        int gap = nextEventSlot - currentSlot;
-                        
-                        if (gap >= 32) durationInSlots = 32;
-                        else if (gap >= 16) durationInSlots = 16;
-                        else if (gap >= 8) durationInSlots = 8;
-                        else if (gap >= 4) durationInSlots = 4;
-                        else if (gap >= 2) durationInSlots = 2;
-                        else durationInSlots = 1;
-                        
-                        for (int s = 0; s < 6; ++s)
+                        if (note->string >= 0 && note->string < track.stringCount)
                         {
-                            TabNote emptyNote; emptyNote.string = s; emptyNote.fret = -1;
-                            beat.notes.add(emptyNote);
+                            beat.notes.getReference(note->string).fret = note->fret;
+                            beat.notes.getReference(note->string).velocity = note->velocity;
                         }
                     }
+                }
+                else
+                {
+                    // Rest
+                    beat.isRest = true;
+                    
+                    int nextEventSlot = maxSlots;
+                    auto nextIt = noteGroups.upper_bound(currentSlot);
+                    if (nextIt != noteGroups.end())
+                        nextEventSlot = nextIt->first;
+                    
+                    int gap = nextEventSlot - currentSlot;
                     
-                    // Set duration
-                    switch (durationInSlots)
+                    if (gap >= 32) durationInSlots = 32;
+                    else if (gap >= 16) durationInSlots = 16;
+                    else if (gap >= 8) durationInSlots = 8;
+                    else if (gap >= 4) durationInSlots = 4;
+                    else if (gap >= 2) durationInSlots = 2;
+                    else durationInSlots = 1;
+                    
+                    for (int s = 0; s < track.stringCount; ++s)
                     {
-                        case 32: beat.duration = NoteDuration::Whole; break;
-                        case 16: beat.duration = NoteDuration::Half; break;
-                        case 8:  beat.duration = NoteDuration::Quarter; break;
-                        case 4:  beat.duration = NoteDuration::Eighth; break;
-                        case 2:  beat.duration = NoteDuration::Sixteenth; break;
-                        default: beat.duration = NoteDuration::ThirtySecond; break;
+                        TabNote emptyNote; emptyNote.string = s; emptyNote.fret = -1;
+                        beat.notes.add(emptyNote);
                     }
-                    
-                    measure.beats.add(beat);
-                    currentSlot += durationInSlots;
                 }
+                
+                // Set duration
+                switch (durationInSlots)
+                {
+                    case 32: beat.duration = NoteDuration::Whole; break;
+                    case 16: beat.duration = NoteDuration::Half; break;
+                    case 8:  beat.duration = NoteDuration::Quarter; break;
+                    case 4:  beat.duration = NoteDuration::Eighth; break;
+                    case 2:  beat.duration = NoteDuration::Sixteenth; break;
+                    default: beat.duration = NoteDuration::ThirtySecond; break;
+                }
+                
+                measure.beats.add(beat);
+                currentSlot += durationInSlots;
             }
-            
-            track.measures.add(measure);
         }
         
-        tracks.push_back(track);
+        track.measures.add(measure);
     }
     
-    return tracks;
+    
+    return track;
+}
+
+//==============================================================================
+// MIDI Export Functionality
+//==============================================================================
+
+// Noten eines geladenen Tracks wie in der Wiedergabe: editierter Track falls vorhanden,
+// Effekte, Bends und Track-Lautstärke über den SongEventRenderer
+SongEventRenderer::RenderedTrack NewProjectAudioProcessor::renderLoadedTrack(int trackIndex, int midiChannel) const
+{
+    return renderLoadedTrack(trackIndex, midiChannel, *getEditedTracksSnapshot());
+}
+
+SongEventRenderer::RenderedTrack NewProjectAudioProcessor::renderLoadedTrack(int trackIndex, int midiChannel,
+                                                                             const EditedTracksSnapshot& edited) const
+{
+    const auto& measureHeaders = getActiveMeasureHeaders();
+    const int volumeScale = getTrackVolume(trackIndex);
+    
+    if (const auto* editedTrack = edited.find(trackIndex))
+        return SongEventRenderer::renderTrack(*editedTrack, measureHeaders, midiChannel, volumeScale, defaultGuitarTuning);
+    
+    return SongEventRenderer::renderTrack(getActiveTracks().getReference(trackIndex), measureHeaders, midiChannel, volumeScale, defaultGuitarTuning);
 }
 
-//==============================================================================
-// MIDI Export Functionality
-//==============================================================================
+// Aufgenommene Tracks (TabTrack-Format), mit Edits falls vorhanden
+std::vector<TabTrack> NewProjectAudioProcessor::getRecordedTracksForExport() const
+{
+    std::vector<TabTrack> tracks = getRecordedTabTracks();
+    for (int i = 0; i < (int)tracks.size(); ++i)
+    {
+        if (hasEditedTrack(i))
+            tracks[(size_t)i] = getEditedTrack(i);
+    }
+    return tracks;
+}
 
 bool NewProjectAudioProcessor::exportTrackToMidi(int trackIndex, const juce::File& outputFile)
 {
@@ -5031,128 +3839,27 @@ bool NewProjectAudioProcessor::exportTrackToMidi(int trackIndex, const juce::Fil
     int program = track.isPercussion ? 0 : 25;
     midiSequence.addEvent(juce::MidiMessage::programChange(midiChannel, program), 0.0);
     
-    // Berechne Zeitposition für jede Note
-    double currentTimeInBeats = 0.0;
-    
-    for (int measureIndex = 0; measureIndex < track.measures.size() && measureIndex < measureHeaders.size(); ++measureIndex)
-    {
-        const auto& measure = track.measures[measureIndex];
-        const auto& header = measureHeaders[measureIndex];
-        
-        double beatsPerMeasure = header.numerator * (4.0 / header.denominator);
-        double beatTimeInMeasure = 0.0;
-        
-        const auto& beats = measure.voice1;
-        
-        for (const auto& beat : beats)
-        {
-            // Berechne Notendauer in Beats
-            double beatDurationBeats = 4.0 / std::pow(2.0, beat.duration + 2);
-            if (beat.isDotted) beatDurationBeats *= 1.5;
-            if (beat.tupletN > 0)
-            {
-                int tupletDenom = (beat.tupletN == 3) ? 2 : (beat.tupletN == 5 || beat.tupletN == 6) ? 4 : beat.tupletN - 1;
-                beatDurationBeats = beatDurationBeats * tupletDenom / beat.tupletN;
-            }
-            
-            double noteStartTime = currentTimeInBeats + beatTimeInMeasure;
-            double noteEndTime = noteStartTime + beatDurationBeats;
-            
-            if (!beat.isRest)
-            {
-                for (auto it = beat.notes.begin(); it != beat.notes.end(); ++it)
-                {
-                    int stringIndex = it->first;
-                    const auto& gpNote = it->second;
-                    
-                    if (gpNote.isDead || gpNote.isTied)
-                        continue;
-                    
-                    // MIDI-Note berechnen
-                    int midiNote = 0;
-                    if (stringIndex < track.tuning.size())
-                    {
-                        midiNote = track.tuning[stringIndex] + gpNote.fret;
-                    }
-                    else if (stringIndex < 6)
-                    {
-                        const int defaultTuning[] = { 64, 59, 55, 50, 45, 40 };
-                        midiNote = defaultTuning[stringIndex] + gpNote.fret;
-                    }
-                    
-                    if (midiNote <= 0 || midiNote >= 128)
-                        continue;
-                    
-                    // Velocity
-                    int velocity = gpNote.velocity > 0 ? gpNote.velocity : 95;
-                    if (gpNote.isGhost) velocity = 50;
-                    if (gpNote.hasAccent) velocity = 115;
-                    if (gpNote.hasHeavyAccent) velocity = 127;
-                    velocity = juce::jlimit(1, 127, velocity);
-                    
-                    // Note-On und Note-Off Events (in Ticks, 480 Ticks pro Beat)
-                    double ticksPerBeat = 480.0;
-                    double noteOnTicks = noteStartTime * ticksPerBeat;
-                    double noteOffTicks = noteEndTime * ticksPerBeat;
-                    
-                    midiSequence.addEvent(juce::MidiMessage::noteOn(midiChannel, midiNote, (juce::uint8)velocity), noteOnTicks);
-                    midiSequence.addEvent(juce::MidiMessage::noteOff(midiChannel, midiNote), noteOffTicks);
-                }
-            }
-            
-            beatTimeInMeasure += beatDurationBeats;
-        }
-        
-        currentTimeInBeats += beatsPerMeasure;
-    }
+    // Noten, Controller und Bends (480 Ticks pro Viertel)
+    auto rendered = renderLoadedTrack(trackIndex, midiChannel);
+    SongEventRenderer::appendToSequence(rendered, midiSequence, 480.0);
     
     // End of Track Meta Event (FF 2F 00) - required for MIDI standard compliance
-    midiSequence.addEvent(juce::MidiMessage::endOfTrack(), currentTimeInBeats * 480.0);
+    midiSequence.addEvent(juce::MidiMessage::endOfTrack(), rendered.endBeat * 480.0);
     midiSequence.updateMatchedPairs();
     
-    // Erstelle MIDI-File im Format 0 (Single-Track)
-    // Format 0: Alle Daten in einem Track (Metadaten + Noten)
+    // MIDI-File im Format 0 (Single-Track): alle Daten in einem Track (Metadaten + Noten)
     juce::MidiFile midiFile;
     midiFile.setTicksPerQuarterNote(480);
     midiFile.addTrack(midiSequence);
     
-    // Speichere die Datei
-    outputFile.deleteFile();
-    
-    {
-        // Scope für FileOutputStream - muss geschlossen werden bevor wir die Datei erneut öffnen
-        juce::FileOutputStream outputStream(outputFile);
-        
-        if (!outputStream.openedOk())
-            return false;
-        
-        // JUCE's writeTo() schreibt leider Format 1 auch bei einem Track
-        if (!midiFile.writeTo(outputStream))
-            return false;
-        
-        outputStream.flush();
-    }  // outputStream wird hier geschlossen
-    
-    // Fix: JUCE schreibt Format 1 auch für Single-Track - korrigiere zu Format 0
-    fixMidiFileFormat(outputFile);
-    
-    return true;
+    return writeMidiFile(midiFile, outputFile);
 }
 
 // Hilfsfunktion: Exportiert einen einzelnen TabTrack als MIDI-Sequenz
 // Wird für Audio-to-Tab Modus verwendet, wo keine GP5-Daten vorliegen
 bool NewProjectAudioProcessor::exportRecordedTrackToMidi(int trackIndex, const juce::File& outputFile)
 {
-    // Hole aufgenommene Tracks (TabTrack-Format), mit Edits falls vorhanden
-    std::vector<TabTrack> tracks;
-    auto baseTracks = getRecordedTabTracks();
-    for (int i = 0; i < (int)baseTracks.size(); ++i)
-    {
-        if (hasEditedTrack(i))
-            tracks.push_back(getEditedTrack(i));
-        else
-            tracks.push_back(baseTracks[i]);
-    }
+    std::vector<TabTrack> tracks = getRecordedTracksForExport();
     
     if (trackIndex < 0 || trackIndex >= (int)tracks.size())
     {
@@ -5178,7 +3885,6 @@ bool NewProjectAudioProcessor::exportRecordedTrackToMidi(int trackIndex, const j
     midiSequence.addEvent(juce::MidiMessage::tempoMetaEvent(tempoMicrosecondsPerBeat), 0.0);
     
     // Time Signature vom ersten Takt
-    if (tabTrack.measures.size() > 0)
     {
         int num = tabTrack.measures[0].timeSignatureNumerator;
         int den = tabTrack.measures[0].timeSignatureDenominator;
@@ -5197,71 +3903,12 @@ bool NewProjectAudioProcessor::exportRecordedTrackToMidi(int trackIndex, const j
     int program = juce::jlimit(0, 127, tabTrack.midiInstrument);
     midiSequence.addEvent(juce::MidiMessage::programChange(midiChannel, program), 0.0);
     
-    // Berechne Zeitposition für jede Note
-    double currentTimeInBeats = 0.0;
-    const double ticksPerBeat = 480.0;
-    
-    for (int measureIndex = 0; measureIndex < tabTrack.measures.size(); ++measureIndex)
-    {
-        const auto& measure = tabTrack.measures[measureIndex];
-        double beatsPerMeasure = measure.timeSignatureNumerator * (4.0 / measure.timeSignatureDenominator);
-        double beatTimeInMeasure = 0.0;
-        
-        for (const auto& beat : measure.beats)
-        {
-            // Berechne Notendauer in Vierteln (Beats)
-            double beatDurationBeats = beat.getDurationInQuarters();
-            
-            double noteStartTime = currentTimeInBeats + beatTimeInMeasure;
-            double noteEndTime = noteStartTime + beatDurationBeats;
-            
-            if (!beat.isRest)
-            {
-                for (const auto& tabNote : beat.notes)
-                {
-                    if (tabNote.isTied || tabNote.effects.deadNote)
-                        continue;
-                    
-                    // MIDI-Note berechnen
-                    int midiNote = 0;
-                    if (tabNote.midiNote > 0)
-                    {
-                        // Verwende direkt gespeicherte MIDI-Note falls vorhanden
-                        midiNote = tabNote.midiNote;
-                    }
-                    else if (tabNote.string < tabTrack.tuning.size())
-                    {
-                        midiNote = tabTrack.tuning[tabNote.string] + tabNote.fret;
-                    }
-                    else if (tabNote.string < 6)
-                    {
-                        const int defaultTuning[] = { 64, 59, 55, 50, 45, 40 };
-                        midiNote = defaultTuning[tabNote.string] + tabNote.fret;
-                    }
-                    
-                    if (midiNote <= 0 || midiNote >= 128)
-                        continue;
-                    
-                    // Velocity
-                    int velocity = tabNote.velocity > 0 ? tabNote.velocity : 95;
-                    velocity = juce::jlimit(1, 127, velocity);
-                    
-                    double noteOnTicks = noteStartTime * ticksPerBeat;
-                    double noteOffTicks = noteEndTime * ticksPerBeat;
-                    
-                    midiSequence.addEvent(juce::MidiMessage::noteOn(midiChannel, midiNote, (juce::uint8)velocity), noteOnTicks);
-                    midiSequence.addEvent(juce::MidiMessage::noteOff(midiChannel, midiNote), noteOffTicks);
-                }
-            }
-            
-            beatTimeInMeasure += beatDurationBeats;
-        }
-        
-        currentTimeInBeats += beatsPerMeasure;
-    }
+    // Noten wie in der Editor-Wiedergabe
+    auto rendered = SongEventRenderer::renderTrack(tabTrack, midiChannel, 100, defaultGuitarTuning);
+    SongEventRenderer::appendToSequence(rendered, midiSequence, 480.0);
     
     // End of Track Meta Event
-    midiSequence.addEvent(juce::MidiMessage::endOfTrack(), currentTimeInBeats * ticksPerBeat);
+    midiSequence.addEvent(juce::MidiMessage::endOfTrack(), rendered.endBeat * 480.0);
     midiSequence.updateMatchedPairs();
     
     // Erstelle MIDI-File im Format 0 (Single-Track)
@@ -5269,22 +3916,8 @@ bool NewProjectAudioProcessor::exportRecordedTrackToMidi(int trackIndex, const j
     midiFile.setTicksPerQuarterNote(480);
     midiFile.addTrack(midiSequence);
     
-    // Speichere die Datei
-    outputFile.deleteFile();
-    
-    {
-        juce::FileOutputStream outputStream(outputFile);
-        
-        if (!outputStream.openedOk())
-            return false;
-        
-        if (!midiFile.writeTo(outputStream))
-            return false;
-        
-        outputStream.flush();
-    }
-    
-    fixMidiFileFormat(outputFile);
+    if (!writeMidiFile(midiFile, outputFile))
+        return false;
     
     DBG("MIDI exported from recorded notes: " << outputFile.getFullPathName());
     return true;
@@ -5344,143 +3977,55 @@ bool NewProjectAudioProcessor::exportAllTracksToMidi(const juce::File& outputFil
     double totalLength = 0.0;
     for (const auto& header : measureHeaders)
     {
-        totalLength += header.numerator * (4.0 / header.denominator);
+        totalLength += SongEventRenderer::measureLength(header.numerator, header.denominator);
     }
     
     // End of Track für Tempo-Track (FF 2F 00) - required for MIDI standard
     tempoTrack.addEvent(juce::MidiMessage::endOfTrack(), totalLength * 480.0);
     midiFile.addTrack(tempoTrack);
     
-    // Für jeden Track eine MIDI-Spur erstellen (Tracks 1+ in Format 1)
-    for (int trackIdx = 0; trackIdx < tracks.size() && trackIdx < 16; ++trackIdx)
+    // Tracks 1+ unabhängig voneinander rendern - parallel auf dem Worker-Pool
+    const int numTracks = juce::jmin((int)tracks.size(), 16);
+    std::vector<juce::MidiMessageSequence> sequences((size_t)numTracks);
+    
+    channelWorkerPool.runAll(numTracks, [&](int trackIdx)
     {
-        const auto& track = tracks[trackIdx];
-        juce::MidiMessageSequence midiSequence;
+        const auto& track = tracks.getReference(trackIdx);
+        auto& midiSequence = sequences[(size_t)trackIdx];
         
         // MIDI Channel (1-16, Track 10 für Drums vermeiden wenn nicht Percussion)
         int midiChannel = track.isPercussion ? 10 : ((trackIdx < 9) ? trackIdx + 1 : trackIdx + 2);
         if (midiChannel > 16) midiChannel = 16;
         
         // Track Name
-        juce::MidiMessage trackNameMsg = juce::MidiMessage::textMetaEvent(3, track.name);
-        midiSequence.addEvent(trackNameMsg, 0.0);
+        midiSequence.addEvent(juce::MidiMessage::textMetaEvent(3, track.name), 0.0);
         
         // Program Change (Instrument)
         int program = track.isPercussion ? 0 : 25;  // 25 = Acoustic Guitar (steel)
         midiSequence.addEvent(juce::MidiMessage::programChange(midiChannel, program), 0.0);
         
-        // Pan und Volume
-        midiSequence.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 7, track.volume), 0.0);  // Volume
-        midiSequence.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 10, track.pan), 0.0);   // Pan
+        // Volume neutral (Track-Lautstärke steckt wie in der Wiedergabe in den Velocities), Pan vom Mixer
+        midiSequence.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 7, 100), 0.0);
+        midiSequence.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 10, getTrackPan(trackIdx)), 0.0);
         
-        // Berechne Zeitposition für jede Note
-        double currentTimeInBeats = 0.0;
-        
-        for (int measureIndex = 0; measureIndex < track.measures.size() && measureIndex < measureHeaders.size(); ++measureIndex)
-        {
-            const auto& measure = track.measures[measureIndex];
-            const auto& header = measureHeaders[measureIndex];
-            
-            double beatsPerMeasure = header.numerator * (4.0 / header.denominator);
-            double beatTimeInMeasure = 0.0;
-            
-            const auto& beats = measure.voice1;
-            
-            for (const auto& beat : beats)
-            {
-                // Berechne Notendauer in Beats
-                double beatDurationBeats = 4.0 / std::pow(2.0, beat.duration + 2);
-                if (beat.isDotted) beatDurationBeats *= 1.5;
-                if (beat.tupletN > 0)
-                {
-                    int tupletDenom = (beat.tupletN == 3) ? 2 : (beat.tupletN == 5 || beat.tupletN == 6) ? 4 : beat.tupletN - 1;
-                    beatDurationBeats = beatDurationBeats * tupletDenom / beat.tupletN;
-                }
-                
-                double noteStartTime = currentTimeInBeats + beatTimeInMeasure;
-                double noteEndTime = noteStartTime + beatDurationBeats;
-                
-                if (!beat.isRest)
-                {
-                    for (auto it = beat.notes.begin(); it != beat.notes.end(); ++it)
-                    {
-                        int stringIndex = it->first;
-                        const auto& gpNote = it->second;
-                        
-                        if (gpNote.isDead || gpNote.isTied)
-                            continue;
-                        
-                        // MIDI-Note berechnen
-                        int midiNote = 0;
-                        if (stringIndex < track.tuning.size())
-                        {
-                            midiNote = track.tuning[stringIndex] + gpNote.fret;
-                        }
-                        else if (stringIndex < 6)
-                        {
-                            const int defaultTuning[] = { 64, 59, 55, 50, 45, 40 };
-                            midiNote = defaultTuning[stringIndex] + gpNote.fret;
-                        }
-                        
-                        if (midiNote <= 0 || midiNote >= 128)
-                            continue;
-                        
-                        // Velocity
-                        int velocity = gpNote.velocity > 0 ? gpNote.velocity : 95;
-                        if (gpNote.isGhost) velocity = 50;
-                        if (gpNote.hasAccent) velocity = 115;
-                        if (gpNote.hasHeavyAccent) velocity = 127;
-                        velocity = juce::jlimit(1, 127, velocity);
-                        
-                        // Note-On und Note-Off Events (in Ticks, 480 Ticks pro Beat)
-                        double ticksPerBeat = 480.0;
-                        double noteOnTicks = noteStartTime * ticksPerBeat;
-                        double noteOffTicks = noteEndTime * ticksPerBeat;
-                        
-                        midiSequence.addEvent(juce::MidiMessage::noteOn(midiChannel, midiNote, (juce::uint8)velocity), noteOnTicks);
-                        midiSequence.addEvent(juce::MidiMessage::noteOff(midiChannel, midiNote), noteOffTicks);
-                    }
-                }
-                
-                beatTimeInMeasure += beatDurationBeats;
-            }
-            
-            currentTimeInBeats += beatsPerMeasure;
-        }
+        SongEventRenderer::appendToSequence(renderLoadedTrack(trackIdx, midiChannel), midiSequence, 480.0);
         
         // End of Track (FF 2F 00) - required for MIDI standard compliance
         midiSequence.addEvent(juce::MidiMessage::endOfTrack(), totalLength * 480.0);
         midiSequence.updateMatchedPairs();
-        
-        midiFile.addTrack(midiSequence);
-    }
-    
-    // Speichere die Datei
-    // JUCE erkennt automatisch: >1 Track = Format 1
-    outputFile.deleteFile();
-    juce::FileOutputStream outputStream(outputFile);
+    });
     
-    if (!outputStream.openedOk())
-        return false;
+    for (const auto& sequence : sequences)
+        midiFile.addTrack(sequence);
     
-    // JUCE's writeTo() schreibt Format 1 bei mehreren Tracks
-    // und fügt das End-of-Track Event (FF 2F 00) korrekt für jeden Track ein
-    return midiFile.writeTo(outputStream);
+    // JUCE erkennt automatisch: >1 Track = Format 1
+    return writeMidiFile(midiFile, outputFile);
 }
 
 // Hilfsfunktion: Exportiert alle aufgenommenen TabTracks als Multi-Track MIDI
 bool NewProjectAudioProcessor::exportAllRecordedTracksToMidi(const juce::File& outputFile)
 {
-    // Hole aufgenommene Tracks mit Edits
-    std::vector<TabTrack> tracks;
-    auto baseTracks = getRecordedTabTracks();
-    for (int i = 0; i < (int)baseTracks.size(); ++i)
-    {
-        if (hasEditedTrack(i))
-            tracks.push_back(getEditedTrack(i));
-        else
-            tracks.push_back(baseTracks[i]);
-    }
+    std::vector<TabTrack> tracks = getRecordedTracksForExport();
     
     if (tracks.empty())
     {
@@ -5508,7 +4053,7 @@ bool NewProjectAudioProcessor::exportAllRecordedTracksToMidi(const juce::File& o
     tempoTrack.addEvent(juce::MidiMessage::tempoMetaEvent(tempoMicrosecondsPerBeat), 0.0);
     
     // Time Signature vom ersten Takt des ersten Tracks
-    if (!tracks.empty() && tracks[0].measures.size() > 0)
+    if (tracks[0].measures.size() > 0)
     {
         int num = tracks[0].measures[0].timeSignatureNumerator;
         int den = tracks[0].measures[0].timeSignatureDenominator;
@@ -5518,22 +4063,22 @@ bool NewProjectAudioProcessor::exportAllRecordedTracksToMidi(const juce::File& o
     
     // Berechne Gesamtlänge für End-of-Track
     double totalLength = 0.0;
-    if (!tracks.empty())
+    for (const auto& measure : tracks[0].measures)
     {
-        for (const auto& measure : tracks[0].measures)
-        {
-            totalLength += measure.timeSignatureNumerator * (4.0 / measure.timeSignatureDenominator);
-        }
+        totalLength += SongEventRenderer::measureLength(measure.timeSignatureNumerator, measure.timeSignatureDenominator);
     }
     
     tempoTrack.addEvent(juce::MidiMessage::endOfTrack(), totalLength * ticksPerBeat);
     midiFile.addTrack(tempoTrack);
     
-    // Für jeden Track eine MIDI-Spur erstellen
-    for (int trackIdx = 0; trackIdx < (int)tracks.size() && trackIdx < 16; ++trackIdx)
+    // Für jeden Track eine MIDI-Spur erstellen - parallel auf dem Worker-Pool
+    const int numTracks = juce::jmin((int)tracks.size(), 16);
+    std::vector<juce::MidiMessageSequence> sequences((size_t)numTracks);
+    
+    channelWorkerPool.runAll(numTracks, [&](int trackIdx)
     {
-        const auto& tabTrack = tracks[trackIdx];
-        juce::MidiMessageSequence midiSequence;
+        const auto& tabTrack = tracks[(size_t)trackIdx];
+        auto& midiSequence = sequences[(size_t)trackIdx];
         
         // MIDI Channel aus dem TabTrack verwenden (midiChannel ist 0-basiert, MIDI Messages sind 1-basiert)
         int midiChannel = juce::jlimit(1, 16, tabTrack.midiChannel + 1);
@@ -5550,80 +4095,22 @@ bool NewProjectAudioProcessor::exportAllRecordedTracksToMidi(const juce::File& o
         midiSequence.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 7, 100), 0.0);  // Volume
         midiSequence.addEvent(juce::MidiMessage::controllerEvent(midiChannel, 10, 64), 0.0);  // Pan center
         
-        // Noten-Events
-        double currentTimeInBeats = 0.0;
-        
-        for (int measureIndex = 0; measureIndex < tabTrack.measures.size(); ++measureIndex)
-        {
-            const auto& measure = tabTrack.measures[measureIndex];
-            double beatsPerMeasure = measure.timeSignatureNumerator * (4.0 / measure.timeSignatureDenominator);
-            double beatTimeInMeasure = 0.0;
-            
-            for (const auto& beat : measure.beats)
-            {
-                double beatDurationBeats = beat.getDurationInQuarters();
-                
-                double noteStartTime = currentTimeInBeats + beatTimeInMeasure;
-                double noteEndTime = noteStartTime + beatDurationBeats;
-                
-                if (!beat.isRest)
-                {
-                    for (const auto& tabNote : beat.notes)
-                    {
-                        if (tabNote.isTied || tabNote.effects.deadNote)
-                            continue;
-                        
-                        int midiNote = 0;
-                        if (tabNote.midiNote > 0)
-                        {
-                            midiNote = tabNote.midiNote;
-                        }
-                        else if (tabNote.string < tabTrack.tuning.size())
-                        {
-                            midiNote = tabTrack.tuning[tabNote.string] + tabNote.fret;
-                        }
-                        else if (tabNote.string < 6)
-                        {
-                            const int defaultTuning[] = { 64, 59, 55, 50, 45, 40 };
-                            midiNote = defaultTuning[tabNote.string] + tabNote.fret;
-                        }
-                        
-                        if (midiNote <= 0 || midiNote >= 128)
-                            continue;
-                        
-                        int velocity = tabNote.velocity > 0 ? tabNote.velocity : 95;
-                        velocity = juce::jlimit(1, 127, velocity);
-                        
-                        double noteOnTicks = noteStartTime * ticksPerBeat;
-                        double noteOffTicks = noteEndTime * ticksPerBeat;
-                        
-                        midiSequence.addEvent(juce::MidiMessage::noteOn(midiChannel, midiNote, (juce::uint8)velocity), noteOnTicks);
-                        midiSequence.addEvent(juce::MidiMessage::noteOff(midiChannel, midiNote), noteOffTicks);
-                    }
-                }
-                
-                beatTimeInMeasure += beatDurationBeats;
-            }
-            
-            currentTimeInBeats += beatsPerMeasure;
-        }
+        auto rendered = SongEventRenderer::renderTrack(tabTrack, midiChannel, 100, defaultGuitarTuning);
+        SongEventRenderer::appendToSequence(rendered, midiSequence, ticksPerBeat);
         
-        midiSequence.addEvent(juce::MidiMessage::endOfTrack(), totalLength * ticksPerBeat);
+        midiSequence.addEvent(juce::MidiMessage::endOfTrack(), juce::jmax(totalLength, rendered.endBeat) * ticksPerBeat);
         midiSequence.updateMatchedPairs();
-        
-        midiFile.addTrack(midiSequence);
-    }
+    });
     
-    // Speichere die Datei
-    outputFile.deleteFile();
-    juce::FileOutputStream outputStream(outputFile);
+    for (const auto& sequence : sequences)
+        midiFile.addTrack(sequence);
     
-    if (!outputStream.openedOk())
+    if (!writeMidiFile(midiFile, outputFile))
         return false;
     
     DBG("MIDI exported from recorded notes (all tracks): " << outputFile.getFullPathName()
         << " (" << tracks.size() << " tracks)");
-    return midiFile.writeTo(outputStream);
+    return true;
 }
 
 //==============================================================================
@@ -5633,12 +4120,14 @@ bool NewProjectAudioProcessor::exportAllRecordedTracksToMidi(const juce::File& o
 bool NewProjectAudioProcessor::hasRecordedNotes() const
 {
     std::lock_guard<std::mutex> lock(recordingMutex);
+    syncRecordingCapture();
     return !recordedNotes.empty();
 }
 
 int NewProjectAudioProcessor::getRecordedTrackMidiChannel(int trackIndex) const
 {
     std::lock_guard<std::mutex> lock(recordingMutex);
+    syncRecordingCapture();
     
     if (recordedNotes.empty())
         return -1;
@@ -5673,7 +4162,8 @@ juce::Array<GP5Track> NewProjectAudioProcessor::getDisplayTracks() const
     std::vector<RecordedNote> allNotes;
     {
         std::lock_guard<std::mutex> lock(recordingMutex);
-        allNotes = recordedNotes;
+        syncRecordingCapture();
+        allNotes = recordedNotes.getNotes();
     }
     
     if (allNotes.empty())
@@ -5708,20 +4198,13 @@ juce::Array<GP5Track> NewProjectAudioProcessor::getDisplayTracks() const
             track.isPercussion = false;
         }
         
-        track.stringCount = 6;
         track.midiChannel = channel;
         track.port = 0;
         track.volume = 100;
         track.pan = 64;
         
-        // Standard guitar tuning
-        track.tuning.clear();
-        track.tuning.add(64);  // E4
-        track.tuning.add(59);  // B3
-        track.tuning.add(55);  // G3
-        track.tuning.add(50);  // D3
-        track.tuning.add(45);  // A2
-        track.tuning.add(40);  // E2
+        // Stimmung der MIDI-Eingabe (Standard: 6-saitige E-Gitarre)
+        applyInputTuning(track);
         
         tracks.add(track);
     }
@@ -5740,6 +4223,7 @@ int NewProjectAudioProcessor::getDisplayTrackCount() const
     std::set<int> usedChannels;
     {
         std::lock_guard<std::mutex> lock(recordingMutex);
+        syncRecordingCapture();
         for (const auto& note : recordedNotes)
         {
             usedChannels.insert(note.midiChannel);
@@ -5770,78 +4254,41 @@ juce::String NewProjectAudioProcessor::getDisplayTrackName(int trackIndex) const
     return "Recording";
 }
 
-bool NewProjectAudioProcessor::exportRecordingToGP5(const juce::File& outputFile, const juce::String& title)
+GP5ExportJob::Request NewProjectAudioProcessor::makeGP5ExportRequest(const juce::File& outputFile,
+    const juce::String& title,
+    const std::vector<std::pair<juce::String, int>>& trackData) const
 {
-    std::vector<TabTrack> tracks;
-    
-    if (isFileLoaded())
-    {
-        // Use edited tracks if available, otherwise convert from active parser data
-        const auto& loadedTracks = getActiveTracks();
-        for (int i = 0; i < loadedTracks.size(); ++i)
-        {
-            if (hasEditedTrack(i))
-            {
-                tracks.push_back(getEditedTrack(i));
-                DBG("Track " << i << ": using edited version");
-            }
-            else if (usingPTBParser)
-            {
-                tracks.push_back(ptbParser.convertToTabTrack(i));
-                DBG("Track " << i << ": using PTB parser data");
-            }
-            else
-            {
-                tracks.push_back(gp5Parser.convertToTabTrack(i));
-                DBG("Track " << i << ": using original GP5 data");
-            }
-        }
-    }
-    else
-    {
-        // Get recorded tracks, but use edited versions where available
-        auto baseTracks = getRecordedTabTracks();
-        for (int i = 0; i < (int)baseTracks.size(); ++i)
-        {
-            if (hasEditedTrack(i))
-            {
-                tracks.push_back(getEditedTrack(i));
-                DBG("Recording Track " << i << ": using edited version");
-            }
-            else
-            {
-                tracks.push_back(baseTracks[i]);
-                DBG("Recording Track " << i << ": using generated version");
-            }
-        }
-    }
+    GP5ExportJob::Request request;
+    request.outputFile = outputFile;
+    request.title = title.isEmpty() ? "Untitled" : title;
+    request.artist = "GP5 VST Editor";
+    request.tempo = static_cast<int>(hostTempo.load());
+    request.trackData = trackData;
     
-    if (tracks.empty() || (tracks.size() == 1 && tracks[0].measures.isEmpty()))
+    // Editierte Tracks jetzt kopieren - der Export sieht einen festen Stand
     {
-        DBG("No notes to export");
-        return false;
+        std::lock_guard<std::mutex> lock(editedTracksMutex);
+        request.editedTracks = editedTracks;
     }
     
-    // Create GP5 writer
-    GP5Writer writer;
-    writer.setTitle(title.isEmpty() ? "Untitled" : title);
-    writer.setArtist("GP5 VST Editor");
-    writer.setTempo(static_cast<int>(hostTempo.load()));
-    
-    // Write to file (multi-track if multiple channels, single-track otherwise)
-    bool success = writer.writeToFile(tracks, outputFile);
-    
-    if (!success)
+    if (isFileLoaded())
     {
-        DBG("GP5 export failed: " << writer.getLastError());
+        // Geladene Datei: Tracks parallel aus dem aktiven Parser konvertieren
+        request.numTracks = getActiveTracks().size();
+        request.trackSource = [this](int trackIndex) { return convertLoadedTrack(trackIndex); };
     }
     else
     {
-        DBG("GP5 exported successfully to: " << outputFile.getFullPathName() 
-            << " (" << tracks.size() << " track(s))");
+        // Aufnahme: ein Track pro MIDI-Kanal (baut selbst parallel auf)
+        request.trackListSource = [this] { return getRecordedTabTracks(); };
     }
     
-    return success;
+    return request;
+}
+
+bool NewProjectAudioProcessor::exportRecordingToGP5(const juce::File& outputFile, const juce::String& title)
+{
+    return exportRecordingToGP5WithMetadata(outputFile, title, {});
 }
 
 bool NewProjectAudioProcessor::exportRecordingToGP5WithMetadata(
@@ -5849,88 +4296,26 @@ bool NewProjectAudioProcessor::exportRecordingToGP5WithMetadata(
     const juce::String& title,
     const std::vector<std::pair<juce::String, int>>& trackData)
 {
-    std::vector<TabTrack> tracks;
-    
-    if (isFileLoaded())
-    {
-        // Use edited tracks if available, otherwise convert from active parser data
-        const auto& loadedTracks = getActiveTracks();
-        for (int i = 0; i < loadedTracks.size(); ++i)
-        {
-            if (hasEditedTrack(i))
-            {
-                tracks.push_back(getEditedTrack(i));
-                DBG("Track " << i << ": using edited version");
-            }
-            else if (usingPTBParser)
-            {
-                tracks.push_back(ptbParser.convertToTabTrack(i));
-                DBG("Track " << i << ": using PTB parser data");
-            }
-            else
-            {
-                tracks.push_back(gp5Parser.convertToTabTrack(i));
-                DBG("Track " << i << ": using original GP5 data");
-            }
-        }
-        DBG("Exporting from loaded file: " << loadedTracks.size() << " tracks");
-    }
-    else
-    {
-        // Get recorded tracks, but use edited versions where available
-        auto baseTracks = getRecordedTabTracks();
-        for (int i = 0; i < (int)baseTracks.size(); ++i)
-        {
-            if (hasEditedTrack(i))
-            {
-                tracks.push_back(getEditedTrack(i));
-                DBG("Recording Track " << i << ": using edited version");
-            }
-            else
-            {
-                tracks.push_back(baseTracks[i]);
-                DBG("Recording Track " << i << ": using generated version");
-            }
-        }
-    }
-    
-    if (tracks.empty() || (tracks.size() == 1 && tracks[0].measures.isEmpty()))
-    {
-        DBG("No notes to export");
-        return false;
-    }
-    
-    // Apply user-defined metadata to tracks
-    for (size_t i = 0; i < tracks.size() && i < trackData.size(); ++i)
-    {
-        tracks[i].name = trackData[i].first;          // Track name
-        tracks[i].midiInstrument = trackData[i].second;  // GM instrument (0-127)
-        DBG("Track " << i << ": name=" << tracks[i].name 
-            << ", instrument=" << tracks[i].midiInstrument);
-    }
-    
-    // Create GP5 writer
-    GP5Writer writer;
-    writer.setTitle(title.isEmpty() ? "Untitled" : title);
-    writer.setArtist("GP5 VST Editor");
-    writer.setTempo(static_cast<int>(hostTempo.load()));
-    
-    // Write to file with user metadata
-    bool success = writer.writeToFile(tracks, outputFile);
+    juce::String message;
+    const bool success = GP5ExportJob::execute(makeGP5ExportRequest(outputFile, title, trackData), channelWorkerPool,
+                                               [] { return false; }, [](float) {}, message);
     
     if (!success)
-    {
-        DBG("GP5 export with metadata failed: " << writer.getLastError());
-    }
-    else
-    {
-        DBG("GP5 exported successfully with metadata to: " << outputFile.getFullPathName() 
-            << " (" << tracks.size() << " track(s))");
-    }
+        DBG("GP5 export failed: " << message);
     
     return success;
 }
 
+bool NewProjectAudioProcessor::startGP5Export(const juce::File& outputFile,
+    const juce::String& title,
+    const std::vector<std::pair<juce::String, int>>& trackData)
+{
+    if (gp5ExportJob.isExporting())
+        return false;
+    
+    return gp5ExportJob.start(makeGP5ExportRequest(outputFile, title, trackData));
+}
+
 //==============================================================================
 // This creates new instances of the plugin..
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
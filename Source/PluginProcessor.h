@@ -15,7 +15,25 @@
 #include "MidiImporter.h"
 #include "TabModels.h"
 #include "ChordMatcher.h"
+#include "ChordNaming.h"
 #include "ChordFingerDB.h"
+#include "PlayabilityCostModel.h"
+#include "FingeringOptimizer.h"
+#include "GuitarTuning.h"
+#include "LiveChordAnalyzer.h"
+#include "ChannelWorkerPool.h"
+#include "RecordedNoteStore.h"
+#include "RecordedTabBuilder.h"
+#include "RecordingCaptureBuffer.h"
+#include "PluginStateCodec.h"
+#include "TabEditJournal.h"
+#include "TabUndoHistory.h"
+#include "SongFingeringAnnotator.h"
+#include "GP5ExportJob.h"
+#include "SessionAutosave.h"
+#include "SongEventRenderer.h"
+#include "AudioThreadProfiler.h"
+#include "MemoryAccounting.h"
 #include "AudioToMidiProcessor.h"
 #include "AudioTranscriber.h"
 // MidiExpressionEngine deaktiviert - crasht bei erster Note
@@ -24,6 +42,7 @@
 #include <mutex>
 #include <set>
 #include <map>
+#include <memory>
 #include <array>
 #include <vector>
 #include <utility>
@@ -31,7 +50,8 @@
 //==============================================================================
 /**
 */
-class NewProjectAudioProcessor  : public juce::AudioProcessor
+class NewProjectAudioProcessor  : public juce::AudioProcessor,
+                                   private juce::Timer
 {
 public:
     //==============================================================================
@@ -40,6 +60,7 @@ public:
 
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void setNonRealtime (bool isNonRealtime) noexcept override;
     void releaseResources() override;
 
    #ifndef JucePlugin_PreferredChannelConfigurations
@@ -52,6 +73,10 @@ public:
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
+    // Message-Thread: vom Audio-Thread angeforderte Arbeit sofort erledigen (sonst der Timer).
+    // Für Hosts ohne laufende Message-Loop, z.B. den HostSimulator.
+    void dispatchPendingMessageThreadWork();
+
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -117,6 +142,16 @@ public:
     void unloadFile();
     bool isFileLoaded() const { return fileLoaded; }
     
+    // Track der geladenen Datei als TabTrack (direkt vom aktiven Parser, ohne Fingersatz)
+    TabTrack convertLoadedTrack(int trackIndex) const;
+    
+    // Wie convertLoadedTrack, aber mit Fingersatz/Akkordnamen sobald die
+    // Hintergrund-Annotation für diesen Track fertig ist
+    TabTrack getLoadedTabTrack(int trackIndex) const;
+    
+    // Zählt hoch, wenn weitere Tracks fertig annotiert sind (Editor aktualisiert dann die Ansicht)
+    uint32_t getSongAnnotationGeneration() const { return songAnnotator.getGeneration(); }
+    
     // Check if we have content to display (either loaded file or recorded notes)
     bool hasPlayableContent() const { return fileLoaded || hasRecordedNotes(); }
     
@@ -325,45 +360,14 @@ public:
     bool isAudioTranscribing() const { return audioTranscriber.isTranscribing(); }
     
     // Get live MIDI notes for display (thread-safe)
-    struct LiveMidiNote {
-        int midiNote = 0;
-        int velocity = 0;
-        int string = 0;    // Calculated string (0 = highest)
-        int fret = 0;      // Calculated fret
-        int fingerNumber = -1;  // Finger (0=open, 1-4=finger, -1=unassigned)
-    };
+    using LiveMidiNote = LiveChordAnalyzer::Note;
     
-    // Recorded note with timing information
-    struct RecordedNote {
-        int midiNote = 0;
-        int velocity = 0;
-        int string = 0;
-        int fret = 0;
-        double startBeat = 0.0;   // When note started (in beats)
-        double endBeat = 0.0;     // When note ended (in beats)
-        bool isActive = false;    // Still being held
-        
-        int midiChannel = 1;      // Source channel
-        int fingerNumber = -1;    // Finger (1-4), -1 = not assigned
-        
-        // Recorded Effects
-        float maxBendValue = 0.0f;           // Max deviation found
-        bool hasVibrato = false;             // Triggered by ModWheel
-        std::vector<GP5BendPoint> bendPoints; // Normalized usage for export
-        
-        // Temp recording data
-        struct RawBendEvent {
-            double beat;
-            int value; // 1/100 semitones
-        };
-        std::vector<RawBendEvent> rawBendEvents;
-    };
-    
-    // Get currently held notes for display
-    std::vector<LiveMidiNote> getLiveMidiNotes() const;
+    // Recorded note with timing information (siehe RecordedNoteStore.h)
+    using RecordedNote = ::RecordedNote;
     
-    // Get the detected chord name from last getLiveMidiNotes() call
-    juce::String getDetectedChordName() const { return detectedChordName; }
+    // Letztes Ergebnis der Live-Analyse (gehaltene Noten, Akkordname, gedämpfte Saiten)
+    // als ein Snapshot, damit alle Felder aus derselben Analyse stammen (nur Message-Thread)
+    LiveChordAnalyzer::Result getLiveAnalysis() const { return liveChordAnalyzer.getLatest(); }
     
     // Get empty tab track with DAW time signature for editor mode
     TabTrack getEmptyTabTrack() const;
@@ -371,8 +375,9 @@ public:
     // Check if we have live MIDI input
     bool hasLiveMidiInput() const { return !liveMidiNotes.empty(); }
     
-    // Get which strings should be muted (dead notes) for the current chord
-    std::array<bool, 6> getLiveMutedStrings() const { return liveMutedStrings; }
+    // Stimmung der MIDI-Eingabe (4-9 Saiten, z.B. 7/8-Saiter oder Bass)
+    void setInputTuning(const GuitarTuning& newTuning);
+    GuitarTuning getInputTuning() const;
     
     //==============================================================================
     // Recording functionality (Editor Mode)
@@ -386,6 +391,10 @@ public:
     void updateRecordedNotesFromLive(const std::vector<LiveMidiNote>& liveNotes);  // Update active recorded notes with live display values
     std::vector<RecordedNote> getRecordedNotes() const;
     TabTrack getRecordedTabTrack() const;  // Convert recorded notes to TabTrack for display (all channels merged)
+    // Wie getRecordedTabTrack, aktualisiert track aber nur, wenn sich die Aufnahme seit knownRevision
+    // geändert hat. track muss der Stand von knownRevision sein (0 = neu füllen): dann werden nur
+    // geänderte und neue Takte hineinkopiert, fertige Takte bleiben unangetastet.
+    bool updateRecordedTabTrack(TabTrack& track, uint32_t& knownRevision) const;
     std::vector<TabTrack> getRecordedTabTracks() const;  // Convert recorded notes to TabTracks (one per MIDI channel)
     
     // Update a specific note's position (from manual editing)
@@ -404,7 +413,19 @@ public:
     // Insert a new note at a rest position in recordedNotes
     void insertRecordedNote(int measureIndex, int beatIndex, int stringIndex, int fret, int midiNote);
     
-    // Speichere editierten Track (für Plugin-State)
+    // Edit-Befehle aus der TabView auf das Modell anwenden (editedTracks), protokollieren und
+    // mit recordedNotes abgleichen. baseTrack initialisiert den Track nur beim ersten Edit.
+    void applyTabEdits(int trackIndex, const std::vector<TabEdit>& edits, const TabTrack& baseTrack);
+    const TabEditJournal& getTabEditJournal() const { return tabEditJournal; }
+    
+    // Undo/Redo der Tab-Edits (ein Batch = ein Schritt). Setzt nur editedTracks zurück,
+    // recordedNotes bleiben unverändert. Die ersetzten Takte landen im TabEditJournal.
+    bool undoTabEdit(int trackIndex);
+    bool redoTabEdit(int trackIndex);
+    bool canUndoTabEdit(int trackIndex) const;
+    bool canRedoTabEdit(int trackIndex) const;
+    
+    // Speichere editierten Track komplett (für Plugin-State)
     void setEditedTrack(int trackIndex, const TabTrack& track);
     bool hasEditedTrack(int trackIndex) const { return editedTracks.count(trackIndex) > 0; }
     const TabTrack& getEditedTrack(int trackIndex) const { return editedTracks.at(trackIndex); }
@@ -436,6 +457,29 @@ public:
         const juce::String& title,
         const std::vector<std::pair<juce::String, int>>& trackData);
     
+    // Wie exportRecordingToGP5WithMetadata, aber im Hintergrund (false wenn schon einer läuft).
+    // Fortschritt/Ergebnis pollt der Editor; cancelGP5Export lässt die Zieldatei unverändert.
+    bool startGP5Export(const juce::File& outputFile,
+        const juce::String& title,
+        const std::vector<std::pair<juce::String, int>>& trackData);
+    bool isExportingGP5() const { return gp5ExportJob.isExporting(); }
+    float getGP5ExportProgress() const { return gp5ExportJob.getProgress(); }
+    GP5ExportJob::Status takeGP5ExportResult(juce::String& message) { return gp5ExportJob.takeResult(message); }
+    void cancelGP5Export() { gp5ExportJob.cancel(); }
+    
+    // Autosave-Wiederherstellung: nach einem Absturz liegt für die Session des Projekts
+    // ein Journal mit neueren Aufnahmen/Edits als der gespeicherte State
+    bool hasAutosaveRecovery() const { return sessionAutosave.hasRecovery(); }
+    bool recoverAutosave();
+    void discardAutosaveRecovery() { sessionAutosave.finishRecovery(); }
+    
+    // Laufzeitmessung von processBlock (Performance-HUD im Editor, Report für Dropout-Meldungen)
+    AudioThreadProfiler& getAudioThreadProfiler() { return audioThreadProfiler; }
+    
+    // Speicherbuchhaltung aller Processor-Subsysteme neu erfassen (Debug-Panel, Report;
+    // nimmt die Locks in der üblichen Reihenfolge, nur Message-Thread)
+    void updateMemoryAccounts();
+    
     // Check if there are recorded notes to export
     bool hasRecordedNotes() const;
     
@@ -473,15 +517,11 @@ private:
     // Active bend tracking for real-time pitch bend interpolation
     struct ActiveBend {
         int midiChannel = 0;
-        int midiNote = 0;
         double startBeat = 0.0;       // When the note started
         double durationBeats = 0.0;   // Total note duration in beats
-        int bendType = 0;             // 1=bend, 2=bend+release, 3=release, 4=pre-bend, 5=pre-bend+release
-        int maxBendValue = 0;         // Maximum bend value in 1/100 semitones
         
-        // Fixed size array for thread safety (no malloc in audio thread)
-        GP5BendPoint points[16];
-        int pointCount = 0;
+        // Bend type, max value and points (fixed size - no malloc in audio thread)
+        SongEventRenderer::Note note;
         
         int lastSentPitchBend = 8192; // Track last sent value to avoid redundant messages
     };
@@ -489,6 +529,14 @@ private:
     ActiveBend activeBends[maxActiveBends];
     int activeBendCount = 0;
     
+    // Bend-Kurven aller aktiven Bends fortschreiben (jeder processBlock)
+    void updateActiveBends(double currentBeat, juce::MidiBuffer& midi);
+    bool hasActiveBendOnChannel(int midiChannel) const;
+    
+    // Note-On inkl. Expression/Pitchbend über den SongEventRenderer, registriert den Bend
+    void startRenderedNote(const SongEventRenderer::Note& note, int midiChannel,
+                           double currentBeat, double beatDuration, juce::MidiBuffer& midi);
+    
     // MidiExpressionEngine deaktiviert - crasht bei erster Note
     // MidiExpressionEngine expressionEngines[maxTracks];
     
@@ -531,14 +579,122 @@ private:
     // Recording state (automatic based on DAW track record status OR manual toggle)
     std::atomic<bool> recordingEnabled { false };  // Manual record toggle
     mutable std::mutex recordingMutex;
-    std::vector<RecordedNote> recordedNotes;
-    std::map<int, size_t> activeRecordingNotes;  // midiNote -> index in recordedNotes
-    double recordingStartBeat = 0.0;  // PPQ position when first note was recorded (for bar sync)
-    bool recordingStartSet = false;   // Whether recordingStartBeat has been set
-    FretPosition recordingFretPosition = FretPosition::Low;  // Fret position at recording start
+    mutable RecordedNoteStore recordedNotes;  // mit Takt-Index für Edits und Tab-Aufbau
+    mutable RecordingCaptureBuffer recordingCapture;  // Audio-Thread schreibt hier, nicht in recordedNotes
+    // Der Audio-Thread setzt den Start ohne recordingMutex (Aufnahme läuft lockfrei über recordingCapture)
+    std::atomic<double> recordingStartBeat { 0.0 };  // PPQ position when first note was recorded (for bar sync)
+    std::atomic<bool> recordingStartSet { false };   // Whether recordingStartBeat has been set
+    std::atomic<FretPosition> recordingFretPosition { FretPosition::Low };  // Fret position at recording start
+    std::atomic<bool> recordingClearPending { false };  // Audio-Stopp: Aufnahme im Message-Thread leeren
+    
+    // Worker für unabhängige Arbeit pro MIDI-Kanal (Re-Optimierung, Track-Aufbau)
+    mutable ChannelWorkerPool channelWorkerPool;
+    
+    // Momentaufnahme einer aufgenommenen Note für die Re-Optimierung (index = Position in recordedNotes)
+    struct ReoptimizeNote
+    {
+        size_t index = 0;
+        int midiNote = 0;
+        double startBeat = 0.0;
+        double endBeat = 0.0;
+        int string = 0;
+        int fret = 0;
+        int fingerNumber = -1;
+    };
+    
+    // Re-Optimierung eines Kanals (läuft auf dem Worker-Pool, arbeitet nur auf der Momentaufnahme)
+    void reoptimizeChannelNotes(std::vector<ReoptimizeNote>& notes, const FingeringOptimizer& optimizer,
+                                const juce::String& detectedChordName) const;
     
-    // Editierte Tracks (speichert manuelle Änderungen pro Track-Index)
+    // TabTrack für einen Kanal einer Mehrkanal-Aufnahme (läuft auf dem Worker-Pool)
+    TabTrack buildChannelTabTrack(int channel, std::vector<RecordedNote> channelNotes,
+                                  int numMeasures, int numerator, int denominator) const;
+
+    // Taktzuordnung der Aufnahme (aktuelle Taktart + Takt-Quantisierung)
+    RecordedNoteStore::BarRule getRecordedBarRule() const;
+
+    // Capture-Puffer in recordedNotes übertragen (recordingMutex muss gehalten werden, nie im Audio-Thread)
+    void syncRecordingCapture() const;
+
+    // Message-Thread-Arbeit, die der Audio-Thread nur über ein Flag anfordert (Note-Off, knappe Reserve,
+    // Offline-Render). Kein triggerAsyncUpdate im Audio-Thread: das postet eine Message und kann blockieren.
+    std::atomic<bool> messageThreadWorkPending { false };
+    void requestMessageThreadWork() noexcept { messageThreadWorkPending.store(true, std::memory_order_release); }
+    void handleMessageThreadWork();
+    void timerCallback() override;
+
+    // Inkrementeller Aufbau von getRecordedTabTrack (nur geänderte Takte, Lock-Reihenfolge: vor recordingMutex)
+    mutable std::mutex recordedTabMutex;
+    mutable RecordedTabBuilder recordedTabBuilder;
+
+    // Editierte Tracks (speichert manuelle Änderungen pro Track-Index). Geschrieben wird nur
+    // im Message-Thread unter editedTracksMutex; Audio-Thread, Offline-Render und Autosave lesen
+    // stattdessen den veröffentlichten, unveränderlichen Stand (EditedTracksSnapshot).
     std::map<int, TabTrack> editedTracks;
+    mutable std::mutex editedTracksMutex;
+    
+    // Unveränderlicher Stand der editierten Tracks. Nach jeder Änderung baut publishEditedTracks
+    // (Message-Thread, ohne editedTracksMutex) einen neuen - unveränderte Tracks werden geteilt -
+    // und tauscht ihn per std::atomic_store aus. Leser holen ihn per std::atomic_load und warten
+    // nie auf den Message-Thread. Abgelöste Stände bleiben in retiredEditedTracks, bis kein Leser
+    // sie mehr hält, damit der Audio-Thread nie die letzte Referenz freigibt.
+    struct EditedTracksSnapshot
+    {
+        std::map<int, std::shared_ptr<const TabTrack>> tracks;
+        uint64_t autosaveSequence = 0;   // alle Autosave-Posts bis hierher sind enthalten
+        
+        const TabTrack* find(int trackIndex) const
+        {
+            auto it = tracks.find(trackIndex);
+            return it != tracks.end() ? it->second.get() : nullptr;
+        }
+    };
+    static constexpr int allEditedTracks = -1;
+    std::shared_ptr<const EditedTracksSnapshot> publishedEditedTracks;   // nur über std::atomic_load/store
+    std::vector<std::shared_ptr<const EditedTracksSnapshot>> retiredEditedTracks;   // unter publishMutex
+    std::mutex publishMutex;
+    void publishEditedTracks(int changedTrack, bool postTrackToAutosave = false);   // allEditedTracks: alle neu kopieren
+    void releaseRetiredEditedTracks();
+    std::shared_ptr<const EditedTracksSnapshot> getEditedTracksSnapshot() const
+    {
+        return std::atomic_load(&publishedEditedTracks);
+    }
+    TabEditJournal tabEditJournal;
+    std::map<int, TabUndoHistory> tabUndoHistories;   // unter editedTracksMutex
+    std::map<int, size_t> editedTrackHeapBytes;       // getHeapBytes pro Track, bei jeder Änderung nachgeführt
+    bool restoreTabEdit(int trackIndex, bool undo);   // gemeinsamer Teil von undo/redoTabEdit
+    
+    // recordedNotes der Takte eines Undo-Schritts vor und nach dem Batch. Ein Eintrag pro
+    // TabUndoHistory-Schritt; Undo/Redo setzt die Noten dieser Takte wie die Takte des Tracks zurück.
+    struct RecordedNotesStep
+    {
+        std::vector<int> measures;
+        std::vector<RecordedNote> before, after;
+        size_t heapBytes = 0;
+    };
+    std::map<int, std::vector<RecordedNotesStep>> recordedNotesUndo;   // unter editedTracksMutex
+    size_t recordedNotesUndoBytes = 0;                                 // Summe der heapBytes
+    void clearRecordedNotesUndo(int trackIndex);                       // editedTracksMutex gehalten
+    std::vector<RecordedNote> copyRecordedMeasureNotes(const std::vector<int>& measures) const;
+    void replaceRecordedMeasureNotes(const std::vector<int>& measures, const std::vector<RecordedNote>& notes);
+    
+    // Nur der Audio-Thread schreibt, der Editor liest (lock-frei)
+    AudioThreadProfiler audioThreadProfiler;
+    
+    // Speicherbuchhaltung (MemoryAccounting). Die account*-Funktionen erwarten den
+    // jeweiligen Lock der Daten; recordedNotes/recordedTab werden auch aus const-Pfaden gebucht.
+    MemoryAccount processorMemory { MemoryAccounting::processor };
+    MemoryAccount songModelMemory { MemoryAccounting::songModel };
+    mutable MemoryAccount recordedNotesMemory { MemoryAccounting::recordedNotes };
+    mutable MemoryAccount recordedTabMemory { MemoryAccounting::recordedTab };
+    MemoryAccount editedTracksMemory { MemoryAccounting::editedTracks };
+    void accountSongModel();
+    void accountRecordedNotes() const;   // recordingMutex gehalten
+    void accountRecordedTab() const;     // recordedTabMutex gehalten
+    void accountEditedTracks();          // editedTracksMutex gehalten
+    
+    // Noten und editierte Tracks aus einem Snapshot übernehmen (State-Laden, Wiederherstellung)
+    void restoreSnapshot(PluginStateCodec::Snapshot& snapshot);
     
     // Recording playback state (for MIDI-out of recorded notes)
     std::set<int> activePlaybackNotes;  // Currently playing recorded notes (MIDI note numbers)
@@ -571,12 +727,28 @@ private:
     bool wasRecordingAudio = false;         // Track REC+Play state for audio transcription
     double audioRecordingStartBeat = 0.0;   // Beat position when audio recording started
     bool audioRecordingStartSet = false;     // Whether audioRecordingStartBeat has been set
+    std::atomic<double> transcriptionStartBeat { 0.0 };  // Startbeat der Aufnahme in der Transkription
     
-    /** Convert BasicPitch transcription results into recordedNotes for tab display */
+    /** Convert BasicPitch transcription results into recordedNotes for tab display
+        (Message-Thread über handleMessageThreadWork, nie im Audio-Thread) */
     void insertTranscribedNotesIntoTab();
     
-    // Standard guitar tuning for MIDI to Tab conversion (E4, B3, G3, D3, A2, E2) - High to Low
-    const std::array<int, 6> standardTuning = { 64, 59, 55, 50, 45, 40 };
+    // Stimmung für MIDI -> Tab (Standard: E4, B3, G3, D3, A2, E2 - High to Low).
+    // Enthält die vorberechnete Noten->Positionen-Tabelle für Live-Mapping und Re-Optimierung.
+    GuitarTuning inputTuning;
+    
+    // Fallback für Tracks ohne eigene Stimmung
+    const GuitarTuning defaultGuitarTuning;
+    
+    /** Überträgt Saitenanzahl und Stimmung der MIDI-Eingabe auf einen Track (TabTrack/GP5Track). */
+    template <typename TrackType>
+    void applyInputTuning(TrackType& track) const
+    {
+        track.stringCount = inputTuning.getStringCount();
+        track.tuning.clearQuick();
+        for (int note : inputTuning.getOpenStrings())
+            track.tuning.add(note);
+    }
     
     // MIDI Instruments per channel (set by Program Change messages)
     // Default: 25 = Acoustic Guitar (Steel) for all channels
@@ -584,8 +756,6 @@ private:
     
     // Chord Matcher für Akkord-Erkennung und -Platzierung
     ChordMatcher chordMatcher;
-    mutable juce::String detectedChordName;  // Erkannter Akkordname aus letztem getLiveMidiNotes()
-    mutable std::array<bool, 6> liveMutedStrings = { false, false, false, false, false, false };  // Muted strings for current chord
     
     // Chord Finger Database (loaded from CSV)
     ChordFingerDB chordFingerDB;
@@ -606,10 +776,16 @@ private:
     };
     
     // Get all possible positions for a MIDI note
-    std::vector<GuitarPosition> getPossiblePositions(int midiNote) const;
+    const GuitarTuning::PositionList& getPossiblePositions(int midiNote) const;
+    
+    // Kostenmodell der aktuellen Fret-Position-Präferenz (vorab aufgelöst, kein switch pro Note)
+    const PlayabilityCostModel& getCostModel() const { return PlayabilityCostModel::forPreference(fretPosition.load()); }
+    
+    // Term 8 im Live-Modus: 0..1 aus der Zeit seit dem letzten Note-On
+    float getLiveFastPassageFactor() const;
     
-    // Calculate cost for a position change (lower is better)
-    float calculatePositionCost(const GuitarPosition& current, const GuitarPosition& previous) const;
+    // Viterbi optimizer configured with the current tuning and preferences
+    FingeringOptimizer createFingeringOptimizer() const;
     
     // Find best position using cost function
     GuitarPosition findBestPosition(int midiNote, int previousString, int previousFret) const;
@@ -617,5 +793,60 @@ private:
     // Convert MIDI note to string/fret (uses cost function)
     LiveMidiNote midiNoteToTab(int midiNote, int velocity) const;
     
+    // Live chord analysis (runs on the LiveChordAnalyzer thread, reads only)
+    LiveChordAnalyzer::Result analyseHeldNotes(const LiveChordAnalyzer::Input& held) const;
+    
+    // Snapshot der gehaltenen Noten an den Analyzer (Aufrufer hält liveMidiMutex)
+    void postHeldNotesToAnalyzer();
+    
+    // Fingersatz-Annotation geladener Songs im Hintergrund (liest Parser, DB und Worker-Pool)
+    SongFingeringAnnotator songAnnotator { chordFingerDB, channelWorkerPool };
+    void startSongAnnotation();
+    
+    // Offline-Bounce (isNonRealtime): Event-Strom aller hörbaren Tracks einmal außerhalb
+    // des Audio-Threads vorrendern (prepareOfflineRender), pro Block nur kopieren.
+    // pendingOfflineRender wird zu Beginn eines Bounces übernommen; alles andere nur Audio-Thread.
+    struct OfflineRender
+    {
+        std::vector<SongEventRenderer::Event> events;
+        std::array<bool, 17> channelsUsed {};
+    };
+    std::unique_ptr<OfflineRender> offlineRender;
+    std::unique_ptr<OfflineRender> pendingOfflineRender;   // unter offlineRenderMutex
+    std::mutex offlineRenderMutex;
+    std::atomic<bool> offlineRenderRequested { false };    // nach Bounce-Ende neu rendern (Message-Thread)
+    size_t offlineCursor = 0;
+    double offlineNextBeat = -1.0;  // erwartete Position des nächsten Blocks, < 0 = kein Bounce läuft
+    void prepareOfflineRender();
+    bool adoptOfflineRender();
+    void releaseOfflineRender(juce::MidiBuffer& midi);
+    bool renderOfflineBlock(int numSamples, juce::MidiBuffer& midi);
+    
+    // MIDI-Export: Noten über den SongEventRenderer (wie die Wiedergabe)
+    SongEventRenderer::RenderedTrack renderLoadedTrack(int trackIndex, int midiChannel) const;
+    SongEventRenderer::RenderedTrack renderLoadedTrack(int trackIndex, int midiChannel,
+                                                       const EditedTracksSnapshot& edited) const;
+    std::vector<TabTrack> getRecordedTracksForExport() const;
+    
+    // GP5-Export im Hintergrund (liest Parser bzw. Aufnahme, Worker-Pool)
+    GP5ExportJob gp5ExportJob { channelWorkerPool };
+    GP5ExportJob::Request makeGP5ExportRequest(const juce::File& outputFile,
+        const juce::String& title,
+        const std::vector<std::pair<juce::String, int>>& trackData) const;
+    
+    // Autosave-Journal (eigener Thread). Bis wohin recordedNotes schon im Journal stehen,
+    // merken autosaveNoteWatermark/-Revision (unter recordingMutex)
+    SessionAutosave sessionAutosave { [this](uint64_t& sequence) { return makeAutosaveSnapshot(sequence); },
+                                      [this](SessionAutosave::NotesDelta& delta) { return collectAutosaveNotes(delta); } };
+    size_t autosaveNoteWatermark = 0;
+    uint32_t autosaveNotesRevision = 0;
+    PluginStateCodec::Snapshot makeAutosaveSnapshot(uint64_t& sequence);
+    bool collectAutosaveNotes(SessionAutosave::NotesDelta& delta);
+    void markAutosaveNotesJournaled(size_t from);
+    void resumeAutosaveSession(const juce::ValueTree& state);
+    
+    // Zuletzt deklariert: wird zuerst zerstört und nutzt alle obigen Member
+    LiveChordAnalyzer liveChordAnalyzer { [this](const LiveChordAnalyzer::Input& held) { return analyseHeldNotes(held); } };
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NewProjectAudioProcessor)
 };
@@ -0,0 +1,757 @@
+/*
+  ==============================================================================
+
+    PluginStateCodec.h
+
+    Binäres, versioniertes Format für den Plugin-State (getStateInformation).
+
+    Aufbau:
+      "TBST" | Version (1 Byte) | Flags (1 Byte, Bit 0 = zlib) | Payload
+      Payload = Folge von Sektionen: Tag (varint) | Länge (varint) | Daten
+        1 = Einstellungen (kleiner ValueTree: Dateipfad, UI, Track-MIDI)
+        2 = aufgezeichnete Noten inkl. Bends, Vibrato, Fingernummern
+        3 = editierte TabTracks (vollständig, inkl. Effekte)
+      Unbekannte Sektionen werden übersprungen (ältere Builds lesen neuere States).
+
+    Ganzzahlen sind varints (negative Werte zigzag-kodiert). Beat-Positionen
+    werden als Tick-Deltas (960 pro Viertel) gespeichert, wenn das exakt ist,
+    sonst als rohe doubles - Restores sind damit bitgenau.
+
+    Ältere States (reiner ValueTree) erkennt isBinaryState() nicht; der
+    Aufrufer liest sie wie bisher.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "TabModels.h"
+#include "RecordedNoteStore.h"
+#include <cstring>
+#include <map>
+#include <vector>
+
+//==============================================================================
+/**
+ * PluginStateCodec
+ */
+class PluginStateCodec
+{
+public:
+    static constexpr int currentVersion = 1;
+
+    /** Payloads ab dieser Größe werden komprimiert (wenn es sich lohnt). */
+    static constexpr size_t compressionThreshold = 2048;
+
+    struct Snapshot
+    {
+        juce::MemoryBlock settings;   // serialisierter ValueTree (ohne Noten)
+        double recordingStartBeat = 0.0;
+        bool recordingStartSet = false;
+        std::vector<RecordedNote> recordedNotes;
+        std::map<int, TabTrack> editedTracks;
+    };
+
+    static bool isBinaryState(const void* data, size_t size)
+    {
+        return size >= headerSize && std::memcmp(data, magic, 4) == 0;
+    }
+
+    static void write(const Snapshot& snapshot, juce::MemoryBlock& dest, bool allowCompression = true)
+    {
+        Writer payload;
+
+        payload.writeSection(sectionSettings, [&](Writer& w)
+        {
+            w.writeBytes(snapshot.settings.getData(), snapshot.settings.getSize());
+        });
+
+        if (! snapshot.recordedNotes.empty() || snapshot.recordingStartSet)
+            payload.writeSection(sectionRecordedNotes, [&](Writer& w) { writeRecordedNotes(w, snapshot); });
+
+        if (! snapshot.editedTracks.empty())
+            payload.writeSection(sectionEditedTracks, [&](Writer& w) { writeEditedTracks(w, snapshot.editedTracks); });
+
+        uint8_t flags = 0;
+        juce::MemoryBlock compressed;
+        if (allowCompression && payload.bytes.size() >= compressionThreshold)
+        {
+            {
+                juce::MemoryOutputStream out(compressed, false);
+                juce::GZIPCompressorOutputStream zip(out, 6);
+                zip.write(payload.bytes.data(), payload.bytes.size());
+                zip.flush();
+            }
+            if (compressed.getSize() > 0 && compressed.getSize() < payload.bytes.size())
+                flags |= flagCompressed;
+        }
+
+        dest.reset();
+        dest.append(magic, 4);
+        const uint8_t header[2] = { (uint8_t) currentVersion, flags };
+        dest.append(header, 2);
+
+        if (flags & flagCompressed)
+            dest.append(compressed.getData(), compressed.getSize());
+        else
+            dest.append(payload.bytes.data(), payload.bytes.size());
+    }
+
+    /** Liest einen binären State; false bei unbekannter Version oder beschädigten Daten. */
+    static bool read(const void* data, size_t size, Snapshot& out)
+    {
+        if (! isBinaryState(data, size))
+            return false;
+
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        const int version = bytes[4];
+        const uint8_t flags = bytes[5];
+        if (version < 1 || version > currentVersion)
+        {
+            DBG("PluginStateCodec: unsupported state version " << version);
+            return false;
+        }
+
+        juce::MemoryBlock inflated;
+        const uint8_t* payload = bytes + headerSize;
+        size_t payloadSize = size - headerSize;
+
+        if (flags & flagCompressed)
+        {
+            juce::MemoryInputStream compressedIn(payload, payloadSize, false);
+            juce::GZIPDecompressorInputStream zip(compressedIn);
+            zip.readIntoMemoryBlock(inflated);
+            payload = static_cast<const uint8_t*>(inflated.getData());
+            payloadSize = inflated.getSize();
+        }
+
+        Reader reader(payload, payloadSize);
+        while (! reader.atEnd())
+        {
+            const auto tag = reader.readVarint();
+            const auto length = (size_t) reader.readVarint();
+            Reader section = reader.subReader(length);
+            if (! reader.ok())
+                return false;
+
+            switch (tag)
+            {
+                case sectionSettings:
+                    out.settings.reset();
+                    out.settings.append(section.current(), section.remaining());
+                    break;
+                case sectionRecordedNotes:  readRecordedNotes(section, out); break;
+                case sectionEditedTracks:   readEditedTracks(section, out.editedTracks); break;
+                default:                    break;   // neuere Sektion, überspringen
+            }
+
+            if (! section.ok())
+                return false;
+        }
+        return reader.ok();
+    }
+
+private:
+    static constexpr char magic[4] = { 'T', 'B', 'S', 'T' };
+    static constexpr size_t headerSize = 6;
+    static constexpr uint8_t flagCompressed = 1;
+    static constexpr double ticksPerBeat = 960.0;
+
+    enum : uint64_t { sectionSettings = 1, sectionRecordedNotes = 2, sectionEditedTracks = 3 };
+
+    //==========================================================================
+    struct Writer
+    {
+        std::vector<uint8_t> bytes;
+
+        void writeByte(uint8_t b) { bytes.push_back(b); }
+
+        void writeBytes(const void* data, size_t size)
+        {
+            const auto* p = static_cast<const uint8_t*>(data);
+            bytes.insert(bytes.end(), p, p + size);
+        }
+
+        void writeVarint(uint64_t v)
+        {
+            while (v >= 0x80)
+            {
+                bytes.push_back((uint8_t) (v | 0x80));
+                v >>= 7;
+            }
+            bytes.push_back((uint8_t) v);
+        }
+
+        void writeInt(int64_t v) { writeVarint(((uint64_t) v << 1) ^ (uint64_t) (v >> 63)); }
+
+        void writeFloat(float f)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &f, sizeof(bits));
+            for (int i = 0; i < 4; ++i)
+                writeByte((uint8_t) (bits >> (8 * i)));
+        }
+
+        void writeDouble(double d)
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            for (int i = 0; i < 8; ++i)
+                writeByte((uint8_t) (bits >> (8 * i)));
+        }
+
+        void writeString(const juce::String& s)
+        {
+            const auto size = s.getNumBytesAsUTF8();
+            writeVarint(size);
+            writeBytes(s.toRawUTF8(), size);
+        }
+
+        /** Beat als Tick-Delta zu reference (Bit 0 = 0) oder roh (Bit 0 = 1). */
+        void writeBeat(double beat, double reference)
+        {
+            const double ticks = std::round(beat * ticksPerBeat);
+            const double refTicks = std::round(reference * ticksPerBeat);
+            if (ticks / ticksPerBeat == beat && refTicks / ticksPerBeat == reference
+                && std::abs(ticks - refTicks) < 4.0e15)
+            {
+                const auto delta = (int64_t) ticks - (int64_t) refTicks;
+                writeVarint((((uint64_t) delta << 1) ^ (uint64_t) (delta >> 63)) << 1);
+            }
+            else
+            {
+                writeVarint(1);
+                writeDouble(beat);
+            }
+        }
+
+        template <typename Fn>
+        void writeSection(uint64_t tag, Fn&& fill)
+        {
+            Writer section;
+            fill(section);
+            writeVarint(tag);
+            writeVarint(section.bytes.size());
+            writeBytes(section.bytes.data(), section.bytes.size());
+        }
+    };
+
+    //==========================================================================
+    /** Bounds-geprüfter Leser; nach einem Fehler liefert er nur noch Nullen. */
+    struct Reader
+    {
+        Reader(const uint8_t* d, size_t n) : data(d), size(n) {}
+
+        bool ok() const noexcept             { return ! failed; }
+        bool atEnd() const noexcept          { return failed || pos >= size; }
+        size_t remaining() const noexcept    { return failed ? 0 : size - pos; }
+        const uint8_t* current() const       { return data + pos; }
+
+        uint8_t readByte()
+        {
+            if (failed || pos >= size) { failed = true; return 0; }
+            return data[pos++];
+        }
+
+        uint64_t readVarint()
+        {
+            uint64_t v = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                const uint8_t b = readByte();
+                v |= (uint64_t) (b & 0x7f) << shift;
+                if ((b & 0x80) == 0)
+                    return v;
+            }
+            failed = true;
+            return 0;
+        }
+
+        int64_t readInt()
+        {
+            const auto v = readVarint();
+            return (int64_t) (v >> 1) ^ -(int64_t) (v & 1);
+        }
+
+        int readSmallInt() { return (int) juce::jlimit<int64_t>(-0x7fffffff, 0x7fffffff, readInt()); }
+
+        float readFloat()
+        {
+            uint32_t bits = 0;
+            for (int i = 0; i < 4; ++i)
+                bits |= (uint32_t) readByte() << (8 * i);
+            float f;
+            std::memcpy(&f, &bits, sizeof(f));
+            return f;
+        }
+
+        double readDouble()
+        {
+            uint64_t bits = 0;
+            for (int i = 0; i < 8; ++i)
+                bits |= (uint64_t) readByte() << (8 * i);
+            double d;
+            std::memcpy(&d, &bits, sizeof(d));
+            return d;
+        }
+
+        juce::String readString()
+        {
+            const auto length = (size_t) readVarint();
+            if (failed || length > size - pos) { failed = true; return {}; }
+            const auto* start = reinterpret_cast<const char*>(data + pos);
+            pos += length;
+            return juce::String::fromUTF8(start, (int) length);
+        }
+
+        double readBeat(double reference)
+        {
+            const auto v = readVarint();
+            if (v & 1)
+                return readDouble();
+            const auto zigzag = v >> 1;
+            const auto delta = (int64_t) (zigzag >> 1) ^ -(int64_t) (zigzag & 1);
+            return (double) ((int64_t) std::round(reference * ticksPerBeat) + delta) / ticksPerBeat;
+        }
+
+        /** Anzahl für eine folgende Liste; mehr Elemente als Bytes übrig sind sicher kaputt. */
+        size_t readCount()
+        {
+            const auto n = readVarint();
+            if (n > remaining()) { failed = true; return 0; }
+            return (size_t) n;
+        }
+
+        Reader subReader(size_t length)
+        {
+            if (failed || length > size - pos) { failed = true; return { data, 0 }; }
+            Reader sub(data + pos, length);
+            pos += length;
+            return sub;
+        }
+
+    private:
+        const uint8_t* data;
+        size_t size;
+        size_t pos = 0;
+        bool failed = false;
+    };
+
+    //==========================================================================
+    // Aufgezeichnete Noten
+
+    enum : uint8_t { noteVibrato = 1, noteHasBend = 2, noteActive = 4 };
+
+    static void writeRecordedNotes(Writer& w, const Snapshot& snapshot)
+    {
+        w.writeByte(snapshot.recordingStartSet ? 1 : 0);
+        w.writeBeat(snapshot.recordingStartBeat, 0.0);
+        w.writeVarint(snapshot.recordedNotes.size());
+
+        double previousStart = 0.0;
+        for (const auto& note : snapshot.recordedNotes)
+        {
+            const bool hasBend = note.maxBendValue != 0.0f || ! note.rawBendEvents.empty() || ! note.bendPoints.empty();
+            w.writeByte((uint8_t) ((note.hasVibrato ? noteVibrato : 0) | (hasBend ? noteHasBend : 0)
+                                   | (note.isActive ? noteActive : 0)));
+            w.writeBeat(note.startBeat, previousStart);
+            w.writeBeat(note.endBeat, note.startBeat);
+            w.writeInt(note.midiNote);
+            w.writeInt(note.velocity);
+            w.writeInt(note.midiChannel);
+            w.writeInt(note.string);
+            w.writeInt(note.fret);
+            w.writeInt(note.fingerNumber);
+            previousStart = note.startBeat;
+
+            if (! hasBend)
+                continue;
+
+            w.writeFloat(note.maxBendValue);
+            w.writeVarint(note.rawBendEvents.size());
+            double previousBeat = note.startBeat;
+            for (const auto& event : note.rawBendEvents)
+            {
+                w.writeBeat(event.beat, previousBeat);
+                w.writeInt(event.value);
+                previousBeat = event.beat;
+            }
+            writeBendPoints(w, note.bendPoints);
+        }
+    }
+
+    static void readRecordedNotes(Reader& r, Snapshot& out)
+    {
+        out.recordingStartSet = r.readByte() != 0;
+        out.recordingStartBeat = r.readBeat(0.0);
+
+        const auto count = r.readCount();
+        out.recordedNotes.clear();
+        out.recordedNotes.reserve(count);
+
+        double previousStart = 0.0;
+        for (size_t i = 0; i < count && r.ok(); ++i)
+        {
+            RecordedNote note;
+            const uint8_t flags = r.readByte();
+            note.hasVibrato = (flags & noteVibrato) != 0;
+            note.isActive = (flags & noteActive) != 0;
+            note.startBeat = r.readBeat(previousStart);
+            note.endBeat = r.readBeat(note.startBeat);
+            note.midiNote = r.readSmallInt();
+            note.velocity = r.readSmallInt();
+            note.midiChannel = r.readSmallInt();
+            note.string = r.readSmallInt();
+            note.fret = r.readSmallInt();
+            note.fingerNumber = r.readSmallInt();
+            previousStart = note.startBeat;
+
+            if (flags & noteHasBend)
+            {
+                note.maxBendValue = r.readFloat();
+                const auto numEvents = r.readCount();
+                note.rawBendEvents.reserve(numEvents);
+                double previousBeat = note.startBeat;
+                for (size_t e = 0; e < numEvents && r.ok(); ++e)
+                {
+                    RecordedNote::RawBendEvent event;
+                    event.beat = r.readBeat(previousBeat);
+                    event.value = r.readSmallInt();
+                    note.rawBendEvents.push_back(event);
+                    previousBeat = event.beat;
+                }
+                readBendPoints(r, note.bendPoints);
+            }
+
+            out.recordedNotes.push_back(std::move(note));
+        }
+    }
+
+    template <typename Point>
+    static void writeBendPoints(Writer& w, const std::vector<Point>& points)
+    {
+        w.writeVarint(points.size());
+        for (const auto& p : points)
+        {
+            w.writeInt(p.position);
+            w.writeInt(p.value);
+            w.writeInt(p.vibrato);
+        }
+    }
+
+    template <typename Point>
+    static void readBendPoints(Reader& r, std::vector<Point>& points)
+    {
+        const auto count = r.readCount();
+        points.clear();
+        for (size_t i = 0; i < count && r.ok(); ++i)
+        {
+            Point p;
+            p.position = r.readSmallInt();
+            p.value = r.readSmallInt();
+            p.vibrato = r.readSmallInt();
+            points.push_back(p);
+        }
+    }
+
+    //==========================================================================
+    // Editierte Tracks
+
+    enum : uint32_t
+    {
+        measureTimeSigChanged = 1, measureNumberJump = 2, measureRepeatOpen = 4, measureRepeatClose = 8,
+        measureRepeatCount = 16, measureAlternate = 32, measureMarker = 64
+    };
+
+    enum : uint32_t
+    {
+        beatDotted = 1, beatDoubleDotted = 2, beatTuplet = 4, beatPalmMuted = 8, beatLetRing = 16,
+        beatDownstroke = 32, beatUpstroke = 64, beatText = 128, beatChordName = 256, beatRest = 512
+        // Bits 10-12: log2(Notenwert)
+    };
+
+    enum : uint32_t
+    {
+        noteTied = 1, noteManuallyEdited = 2, noteHasEffects = 4, noteHasMidi = 8, noteHasFinger = 16
+    };
+
+    enum : uint32_t
+    {
+        fxVibrato = 1, fxWideVibrato = 2, fxBend = 4, fxReleaseBend = 8, fxHammerOn = 16, fxPullOff = 32,
+        fxLetRing = 64, fxStaccato = 128, fxGhost = 256, fxAccent = 512, fxHeavyAccent = 1024,
+        fxDead = 2048, fxTapping = 4096, fxSlide = 8192, fxHarmonic = 16384, fxBendData = 32768
+    };
+
+    static int durationShift(NoteDuration d)
+    {
+        int shift = 0;
+        for (int v = static_cast<int>(d); v > 1; v >>= 1)
+            ++shift;
+        return shift;
+    }
+
+    static uint32_t effectFlags(const NoteEffects& fx)
+    {
+        uint32_t f = 0;
+        if (fx.vibrato) f |= fxVibrato;
+        if (fx.wideVibrato) f |= fxWideVibrato;
+        if (fx.bend) f |= fxBend;
+        if (fx.releaseBend) f |= fxReleaseBend;
+        if (fx.hammerOn) f |= fxHammerOn;
+        if (fx.pullOff) f |= fxPullOff;
+        if (fx.letRing) f |= fxLetRing;
+        if (fx.staccato) f |= fxStaccato;
+        if (fx.ghostNote) f |= fxGhost;
+        if (fx.accentuatedNote) f |= fxAccent;
+        if (fx.heavyAccentuatedNote) f |= fxHeavyAccent;
+        if (fx.deadNote) f |= fxDead;
+        if (fx.tapping) f |= fxTapping;
+        if (fx.slideType != SlideType::None) f |= fxSlide;
+        if (fx.harmonic != HarmonicType::None || fx.harmonicSemitone != 0 || fx.harmonicAccidental != 0
+            || fx.harmonicOctave != 0 || fx.harmonicFret != 0)
+            f |= fxHarmonic;
+        if (fx.bendValue != 0.0f || fx.bendType != 0 || ! fx.bendPoints.empty())
+            f |= fxBendData;
+        return f;
+    }
+
+    static void writeEffects(Writer& w, const NoteEffects& fx, uint32_t f)
+    {
+        w.writeVarint(f);
+        if (f & fxSlide)
+            w.writeVarint((uint64_t) fx.slideType);
+        if (f & fxHarmonic)
+        {
+            w.writeVarint((uint64_t) fx.harmonic);
+            w.writeInt(fx.harmonicSemitone);
+            w.writeInt(fx.harmonicAccidental);
+            w.writeInt(fx.harmonicOctave);
+            w.writeInt(fx.harmonicFret);
+        }
+        if (f & fxBendData)
+        {
+            w.writeFloat(fx.bendValue);
+            w.writeInt(fx.bendType);
+            writeBendPoints(w, fx.bendPoints);
+        }
+    }
+
+    static void readEffects(Reader& r, NoteEffects& fx)
+    {
+        const auto f = (uint32_t) r.readVarint();
+        fx.vibrato = (f & fxVibrato) != 0;
+        fx.wideVibrato = (f & fxWideVibrato) != 0;
+        fx.bend = (f & fxBend) != 0;
+        fx.releaseBend = (f & fxReleaseBend) != 0;
+        fx.hammerOn = (f & fxHammerOn) != 0;
+        fx.pullOff = (f & fxPullOff) != 0;
+        fx.letRing = (f & fxLetRing) != 0;
+        fx.staccato = (f & fxStaccato) != 0;
+        fx.ghostNote = (f & fxGhost) != 0;
+        fx.accentuatedNote = (f & fxAccent) != 0;
+        fx.heavyAccentuatedNote = (f & fxHeavyAccent) != 0;
+        fx.deadNote = (f & fxDead) != 0;
+        fx.tapping = (f & fxTapping) != 0;
+        if (f & fxSlide)
+            fx.slideType = static_cast<SlideType>(juce::jlimit(0, (int) SlideType::LegatoSlide, (int) r.readVarint()));
+        if (f & fxHarmonic)
+        {
+            fx.harmonic = static_cast<HarmonicType>(juce::jlimit(0, (int) HarmonicType::Semi, (int) r.readVarint()));
+            fx.harmonicSemitone = r.readSmallInt();
+            fx.harmonicAccidental = r.readSmallInt();
+            fx.harmonicOctave = r.readSmallInt();
+            fx.harmonicFret = r.readSmallInt();
+        }
+        if (f & fxBendData)
+        {
+            fx.bendValue = r.readFloat();
+            fx.bendType = r.readSmallInt();
+            readBendPoints(r, fx.bendPoints);
+        }
+    }
+
+    static void writeTrack(Writer& w, const TabTrack& track)
+    {
+        w.writeString(track.name);
+        w.writeInt(track.stringCount);
+        w.writeVarint((uint64_t) track.tuning.size());
+        for (int midi : track.tuning)
+            w.writeInt(midi);
+        w.writeInt(track.capo);
+        w.writeInt(track.midiChannel);
+        w.writeInt(track.midiInstrument);
+        w.writeVarint(track.colour.getARGB());
+
+        w.writeVarint((uint64_t) track.measures.size());
+        int previousNumber = 0, previousNum = 4, previousDen = 4;
+        for (const auto& measure : track.measures)
+        {
+            uint32_t f = 0;
+            if (measure.timeSignatureNumerator != previousNum || measure.timeSignatureDenominator != previousDen)
+                f |= measureTimeSigChanged;
+            if (measure.measureNumber != previousNumber + 1) f |= measureNumberJump;
+            if (measure.isRepeatOpen) f |= measureRepeatOpen;
+            if (measure.isRepeatClose) f |= measureRepeatClose;
+            if (measure.repeatCount != 0) f |= measureRepeatCount;
+            if (measure.alternateEnding != 0) f |= measureAlternate;
+            if (measure.marker.isNotEmpty()) f |= measureMarker;
+
+            w.writeVarint(f);
+            if (f & measureTimeSigChanged) { w.writeInt(measure.timeSignatureNumerator); w.writeInt(measure.timeSignatureDenominator); }
+            if (f & measureNumberJump)     w.writeInt(measure.measureNumber - previousNumber);
+            if (f & measureRepeatCount)    w.writeInt(measure.repeatCount);
+            if (f & measureAlternate)      w.writeInt(measure.alternateEnding);
+            if (f & measureMarker)         w.writeString(measure.marker);
+
+            previousNumber = measure.measureNumber;
+            previousNum = measure.timeSignatureNumerator;
+            previousDen = measure.timeSignatureDenominator;
+
+            w.writeVarint((uint64_t) measure.beats.size());
+            for (const auto& beat : measure.beats)
+                writeBeat(w, beat);
+        }
+    }
+
+    static void writeBeat(Writer& w, const TabBeat& beat)
+    {
+        uint32_t f = (uint32_t) durationShift(beat.duration) << 10;
+        if (beat.isDotted) f |= beatDotted;
+        if (beat.isDoubleDotted) f |= beatDoubleDotted;
+        if (beat.tupletNumerator != 1 || beat.tupletDenominator != 1) f |= beatTuplet;
+        if (beat.isPalmMuted) f |= beatPalmMuted;
+        if (beat.isLetRing) f |= beatLetRing;
+        if (beat.hasDownstroke) f |= beatDownstroke;
+        if (beat.hasUpstroke) f |= beatUpstroke;
+        if (beat.text.isNotEmpty()) f |= beatText;
+        if (beat.chordName.isNotEmpty()) f |= beatChordName;
+        if (beat.isRest) f |= beatRest;
+
+        w.writeVarint(f);
+        if (f & beatTuplet)    { w.writeInt(beat.tupletNumerator); w.writeInt(beat.tupletDenominator); }
+        if (f & beatText)      w.writeString(beat.text);
+        if (f & beatChordName) w.writeString(beat.chordName);
+
+        w.writeVarint((uint64_t) beat.notes.size());
+        for (const auto& note : beat.notes)
+        {
+            const auto fx = effectFlags(note.effects);
+            uint32_t nf = 0;
+            if (note.isTied) nf |= noteTied;
+            if (note.isManuallyEdited) nf |= noteManuallyEdited;
+            if (fx != 0) nf |= noteHasEffects;
+            if (note.midiNote != -1) nf |= noteHasMidi;
+            if (note.fingerNumber != -1) nf |= noteHasFinger;
+
+            w.writeVarint(nf);
+            w.writeInt(note.string);
+            w.writeInt(note.fret);
+            w.writeInt(note.velocity);
+            if (nf & noteHasMidi)    w.writeInt(note.midiNote);
+            if (nf & noteHasFinger)  w.writeInt(note.fingerNumber);
+            if (nf & noteHasEffects) writeEffects(w, note.effects, fx);
+        }
+    }
+
+    static void readTrack(Reader& r, TabTrack& track)
+    {
+        track.name = r.readString();
+        track.stringCount = r.readSmallInt();
+        track.tuning.clear();
+        const auto numStrings = r.readCount();
+        for (size_t i = 0; i < numStrings && r.ok(); ++i)
+            track.tuning.add(r.readSmallInt());
+        track.capo = r.readSmallInt();
+        track.midiChannel = r.readSmallInt();
+        track.midiInstrument = r.readSmallInt();
+        track.colour = juce::Colour((juce::uint32) r.readVarint());
+
+        track.measures.clear();
+        const auto numMeasures = r.readCount();
+        track.measures.ensureStorageAllocated((int) numMeasures);
+        int previousNumber = 0, previousNum = 4, previousDen = 4;
+        for (size_t m = 0; m < numMeasures && r.ok(); ++m)
+        {
+            TabMeasure measure;
+            const auto f = (uint32_t) r.readVarint();
+            measure.timeSignatureNumerator = previousNum;
+            measure.timeSignatureDenominator = previousDen;
+            if (f & measureTimeSigChanged) { measure.timeSignatureNumerator = r.readSmallInt(); measure.timeSignatureDenominator = r.readSmallInt(); }
+            measure.measureNumber = previousNumber + ((f & measureNumberJump) ? r.readSmallInt() : 1);
+            measure.isRepeatOpen = (f & measureRepeatOpen) != 0;
+            measure.isRepeatClose = (f & measureRepeatClose) != 0;
+            if (f & measureRepeatCount) measure.repeatCount = r.readSmallInt();
+            if (f & measureAlternate)   measure.alternateEnding = r.readSmallInt();
+            if (f & measureMarker)      measure.marker = r.readString();
+
+            previousNumber = measure.measureNumber;
+            previousNum = measure.timeSignatureNumerator;
+            previousDen = measure.timeSignatureDenominator;
+
+            const auto numBeats = r.readCount();
+            measure.beats.ensureStorageAllocated((int) numBeats);
+            for (size_t b = 0; b < numBeats && r.ok(); ++b)
+            {
+                TabBeat beat;
+                readBeat(r, beat);
+                measure.beats.add(beat);
+            }
+            track.measures.add(measure);
+        }
+    }
+
+    static void readBeat(Reader& r, TabBeat& beat)
+    {
+        const auto f = (uint32_t) r.readVarint();
+        beat.duration = static_cast<NoteDuration>(1 << juce::jlimit(0, 5, (int) ((f >> 10) & 7)));
+        beat.isDotted = (f & beatDotted) != 0;
+        beat.isDoubleDotted = (f & beatDoubleDotted) != 0;
+        beat.isPalmMuted = (f & beatPalmMuted) != 0;
+        beat.isLetRing = (f & beatLetRing) != 0;
+        beat.hasDownstroke = (f & beatDownstroke) != 0;
+        beat.hasUpstroke = (f & beatUpstroke) != 0;
+        beat.isRest = (f & beatRest) != 0;
+        if (f & beatTuplet)    { beat.tupletNumerator = r.readSmallInt(); beat.tupletDenominator = r.readSmallInt(); }
+        if (f & beatText)      beat.text = r.readString();
+        if (f & beatChordName) beat.chordName = r.readString();
+
+        const auto numNotes = r.readCount();
+        beat.notes.ensureStorageAllocated((int) numNotes);
+        for (size_t i = 0; i < numNotes && r.ok(); ++i)
+        {
+            TabNote note;
+            const auto nf = (uint32_t) r.readVarint();
+            note.isTied = (nf & noteTied) != 0;
+            note.isManuallyEdited = (nf & noteManuallyEdited) != 0;
+            note.string = r.readSmallInt();
+            note.fret = r.readSmallInt();
+            note.velocity = r.readSmallInt();
+            if (nf & noteHasMidi)    note.midiNote = r.readSmallInt();
+            if (nf & noteHasFinger)  note.fingerNumber = r.readSmallInt();
+            if (nf & noteHasEffects) readEffects(r, note.effects);
+            beat.notes.add(note);
+        }
+    }
+
+    static void writeEditedTracks(Writer& w, const std::map<int, TabTrack>& tracks)
+    {
+        w.writeVarint(tracks.size());
+        for (const auto& [index, track] : tracks)
+        {
+            w.writeInt(index);
+            writeTrack(w, track);
+        }
+    }
+
+    static void readEditedTracks(Reader& r, std::map<int, TabTrack>& tracks)
+    {
+        tracks.clear();
+        const auto count = r.readCount();
+        for (size_t i = 0; i < count && r.ok(); ++i)
+        {
+            const int index = r.readSmallInt();
+            readTrack(r, tracks[index]);
+        }
+    }
+};
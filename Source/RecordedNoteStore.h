@@ -0,0 +1,602 @@
+/*
+  ==============================================================================
+
+    RecordedNoteStore.h
+
+    Speicher für aufgenommene Noten mit Takt-Index.
+
+    Jede Note bekommt ihre Taktnummer genau einmal zugewiesen (beim Einfügen,
+    beim Ändern von Start/Ende oder wenn sich Taktart bzw. Takt-Quantisierung
+    ändern). Ein Index Takt -> Noten-Indizes erlaubt es, alle Noten eines
+    Taktes zu finden, ohne die komplette Aufnahme zu durchsuchen.
+
+    layoutBar() verteilt die Noten eines Taktes auf das 32tel-Raster und füllt
+    Lücken mit Pausen. Die Tab-Darstellung (getRecordedTabTrack) und die
+    Edit-Funktionen (Position/Dauer/Tonhöhe ändern, Löschen, Einfügen)
+    verwenden dasselbe Layout - beatIndex bedeutet überall dasselbe.
+
+    Jede Änderung erhöht die Revision und vermerkt den betroffenen Takt, so
+    dass der RecordedTabBuilder nur geänderte Takte neu aufbauen muss.
+
+    Nicht thread-safe: Aufrufer halten recordingMutex.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "GP5Parser.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
+//==============================================================================
+/** Eine aufgenommene Note (MIDI-Eingang oder Audio-Transkription). */
+struct RecordedNote
+{
+    int midiNote = 0;
+    int velocity = 0;
+    int string = 0;
+    int fret = 0;
+    double startBeat = 0.0;   // When note started (in beats)
+    double endBeat = 0.0;     // When note ended (in beats)
+    bool isActive = false;    // Still being held
+
+    int midiChannel = 1;      // Source channel
+    int fingerNumber = -1;    // Finger (1-4), -1 = not assigned
+
+    // Recorded Effects
+    float maxBendValue = 0.0f;           // Max deviation found
+    bool hasVibrato = false;             // Triggered by ModWheel
+    std::vector<GP5BendPoint> bendPoints; // Normalized usage for export
+
+    // Temp recording data
+    struct RawBendEvent {
+        double beat;
+        int value; // 1/100 semitones
+    };
+    std::vector<RawBendEvent> rawBendEvents;
+};
+
+//==============================================================================
+/**
+ * RecordedNoteStore
+ */
+class RecordedNoteStore
+{
+public:
+    /** Regeln für die Taktzuordnung; ändern sie sich, wird der Index neu aufgebaut. */
+    struct BarRule
+    {
+        double beatsPerMeasure = 4.0;
+        bool measureQuantization = true;
+
+        bool operator== (const BarRule& other) const
+        {
+            return beatsPerMeasure == other.beatsPerMeasure && measureQuantization == other.measureQuantization;
+        }
+        bool operator!= (const BarRule& other) const { return ! (*this == other); }
+    };
+
+    /** Ein Beat im Layout eines Taktes: Noten-Gruppe (Akkord) oder Pause. */
+    struct LayoutBeat
+    {
+        int slot = 0;                 // Startposition in 32teln ab Taktanfang
+        int durationInSlots = 1;      // 1, 2, 3, 4, 6, 8, 12, 16, 24, 32
+        bool isRest = true;
+        std::vector<size_t> notes;    // Indizes im Store, nach startBeat sortiert
+    };
+
+    /** Takte, deren Noten in das Layout eines Taktes eingeflossen sind (Legato über Taktgrenzen). */
+    struct BarRange
+    {
+        int first = 0;
+        int last = 0;
+
+        void include (int bar) { first = std::min (first, bar); last = std::max (last, bar); }
+    };
+
+    static constexpr double subdivision = 0.125;     // 32tel in Viertel-Beats
+    static constexpr double chordThreshold = 0.06;   // ca. 30ms bei 120bpm
+
+    //==========================================================================
+    // Lesender Zugriff wie auf einen std::vector
+
+    size_t size() const noexcept                     { return notes.size(); }
+    bool empty() const noexcept                      { return notes.empty(); }
+    const RecordedNote& operator[] (size_t i) const  { return notes[i]; }
+    std::vector<RecordedNote>::const_iterator begin() const noexcept { return notes.begin(); }
+    std::vector<RecordedNote>::const_iterator end() const noexcept   { return notes.end(); }
+    const std::vector<RecordedNote>& getNotes() const noexcept       { return notes; }
+
+    /** Geschätzter Heap-Speicher: Noten inkl. Bend-Daten, Takt-Index und Änderungsprotokoll. */
+    size_t getHeapBytes() const
+    {
+        size_t bytes = MemoryAccounting::bytesOf (notes) + MemoryAccounting::bytesOf (bars)
+                     + MemoryAccounting::bytesOf (touchLog) + MemoryAccounting::nodeBytesOf (notesByBar);
+        for (const auto& note : notes)
+            bytes += MemoryAccounting::bytesOf (note.bendPoints) + MemoryAccounting::bytesOf (note.rawBendEvents);
+        for (const auto& entry : notesByBar)
+            bytes += MemoryAccounting::bytesOf (entry.second);
+        return bytes;
+    }
+
+    /**
+     * Schreibzugriff für Felder ohne Einfluss auf die Taktzuordnung
+     * (Saite, Bund, Finger, Effekte) - markiert den Takt der Note als geändert.
+     * startBeat/endBeat nur über setEndBeat().
+     */
+    RecordedNote& modify (size_t i)
+    {
+        touchNote (i);
+        return notes[i];
+    }
+
+    //==========================================================================
+    /** Hängt eine Note an; der Index bleibt für alle anderen Noten gültig. */
+    size_t add (RecordedNote note)
+    {
+        notes.push_back (std::move (note));
+        const size_t index = notes.size() - 1;
+        maxEndBeat = std::max (maxEndBeat, notes[index].endBeat);
+
+        if (indexValid)
+        {
+            bars.push_back (barForNote (notes[index], indexedRule));
+            insertIntoBar (index);
+        }
+        touchNote (index);
+        return index;
+    }
+
+    /** Entfernt eine Note; nachfolgende Indizes rücken um eins nach vorne. */
+    void erase (size_t index)
+    {
+        if (index >= notes.size())
+            return;
+
+        touchNote (index);
+        if (notes[index].endBeat >= maxEndBeat)
+            maxEndBeatStale = true;
+
+        if (indexValid)
+        {
+            removeFromBar (index);
+            bars.erase (bars.begin() + (std::ptrdiff_t) index);
+
+            for (auto& [bar, indices] : notesByBar)
+                for (auto& i : indices)
+                    if (i > index)
+                        --i;
+        }
+
+        notes.erase (notes.begin() + (std::ptrdiff_t) index);
+    }
+
+    void clear()
+    {
+        notes.clear();
+        bars.clear();
+        notesByBar.clear();
+        indexValid = false;
+        maxEndBeat = 0.0;
+        maxEndBeatStale = false;
+        ++revision;
+        lowestChanged = 0;
+    }
+
+    /** Setzt das Notenende und ordnet die Note bei Bedarf einem anderen Takt zu. */
+    void setEndBeat (size_t index, double endBeat)
+    {
+        if (index >= notes.size())
+            return;
+
+        if (notes[index].endBeat >= maxEndBeat && endBeat < maxEndBeat)
+            maxEndBeatStale = true;
+        maxEndBeat = std::max (maxEndBeat, endBeat);
+
+        touchNote (index);
+        notes[index].endBeat = endBeat;
+
+        if (! indexValid)
+            return;
+
+        const int newBar = barForNote (notes[index], indexedRule);
+        if (newBar == bars[index])
+            return;
+
+        removeFromBar (index);
+        bars[index] = newBar;
+        insertIntoBar (index);
+        touchNote (index);
+    }
+
+    //==========================================================================
+    /** Zählt bei jeder Änderung hoch. */
+    uint32_t getRevision() const noexcept { return revision; }
+
+    /**
+     * Kleinster seit resetLowestChangedIndex() geänderte Index (auch durch
+     * Löschen/clear). Ab hier muss ein Journal die Noten neu schreiben;
+     * SIZE_MAX = unverändert.
+     */
+    size_t getLowestChangedIndex() const noexcept { return lowestChanged; }
+    void resetLowestChangedIndex() noexcept       { lowestChanged = SIZE_MAX; }
+
+    /** Revision des letzten Index-Neuaufbaus (Regeländerung); davor gebaute Takte sind ungültig. */
+    uint32_t getIndexRevision (const BarRule& rule) const
+    {
+        ensureIndex (rule);
+        return indexRevision;
+    }
+
+    /**
+     * Takte, die sich seit 'sinceRevision' geändert haben (mit Duplikaten).
+     * false, wenn das Änderungsprotokoll so weit nicht zurückreicht - dann
+     * muss der Aufrufer alles neu aufbauen.
+     */
+    bool getBarsTouchedSince (uint32_t sinceRevision, std::vector<int>& touchedBars) const
+    {
+        if (sinceRevision < touchLogStart)
+            return false;
+
+        for (auto it = touchLog.rbegin(); it != touchLog.rend() && it->first > sinceRevision; ++it)
+            touchedBars.push_back (it->second);
+        return true;
+    }
+
+    /** Größtes Notenende der Aufnahme (ohne Legato). */
+    double getMaxEndBeat() const
+    {
+        if (maxEndBeatStale)
+        {
+            maxEndBeat = 0.0;
+            for (const auto& note : notes)
+                maxEndBeat = std::max (maxEndBeat, note.endBeat);
+            maxEndBeatStale = false;
+        }
+        return maxEndBeat;
+    }
+
+    //==========================================================================
+    /**
+     * Taktnummer (1-basiert wie im DAW) einer Note.
+     * Takt-Quantisierung: Noten kurz vor dem Taktende, die dort zu kurz oder
+     * stark gekürzt dargestellt würden, gehören zum nächsten Takt.
+     */
+    static int barForNote (const RecordedNote& note, const BarRule& rule)
+    {
+        const double bpm = rule.beatsPerMeasure;
+        const double originalDuration = note.endBeat - note.startBeat;
+
+        int noteBar = static_cast<int> (note.startBeat / bpm) + 1;
+        const double positionInMeasure = note.startBeat - (noteBar - 1) * bpm;
+        const double distanceToNextBar = bpm - positionInMeasure;
+
+        if (rule.measureQuantization && distanceToNextBar < 0.5 && distanceToNextBar > 0.0001)
+        {
+            // Bedingung 1: Rest im Takt ist kürzer als eine 32tel
+            const bool tooShortInCurrentBar = distanceToNextBar < subdivision;
+
+            // Bedingung 2: Note würde auf weniger als 33% gekürzt und ist mindestens eine 32tel lang
+            const double truncationRatio = distanceToNextBar / std::max (0.001, originalDuration);
+            const bool severelyTruncated = truncationRatio < 0.33 && originalDuration >= subdivision;
+
+            if (tooShortInCurrentBar || severelyTruncated)
+                ++noteBar;
+        }
+
+        return noteBar;
+    }
+
+    /** Noten-Indizes eines Taktes, nach startBeat sortiert. */
+    const std::vector<size_t>& notesInBar (int barNum, const BarRule& rule) const
+    {
+        static const std::vector<size_t> none;
+
+        ensureIndex (rule);
+        const auto it = notesByBar.find (barNum);
+        return it != notesByBar.end() ? it->second : none;
+    }
+
+    /** Höchste belegte Taktnummer (0 wenn leer). */
+    int getLastBar (const BarRule& rule) const
+    {
+        ensureIndex (rule);
+        return notesByBar.empty() ? 0 : notesByBar.rbegin()->first;
+    }
+
+    //==========================================================================
+    /**
+     * Notenende nach Legato-Quantisierung: kleine Lücken zur nächsten Note auf
+     * derselben Saite (<= legatoThreshold) bzw. zum nächsten Event auf einer
+     * beliebigen Saite (<= legatoThreshold / 2) werden geschlossen.
+     * Durchsucht nur die Takte im Bereich der Lücke.
+     */
+    double effectiveEndBeat (size_t index, const BarRule& rule, double legatoThreshold,
+                             BarRange* barsRead = nullptr) const
+    {
+        const auto& note = notes[index];
+        double endBeat = note.endBeat;
+
+        if (legatoThreshold <= 0.001)
+            return endBeat;
+
+        ensureIndex (rule);
+
+        // 1. Nächste Note auf derselben Saite (Reihenfolge: startBeat, dann Index)
+        const RecordedNote* nextOnString = nullptr;
+        size_t nextOnStringIndex = 0;
+        forEachNoteStartingIn (note.startBeat, endBeat + legatoThreshold, rule, barsRead, [&] (size_t i)
+        {
+            const auto& other = notes[i];
+            if (i == index || other.string != note.string)
+                return;
+            if (other.startBeat < note.startBeat || (other.startBeat == note.startBeat && i < index))
+                return;
+            if (nextOnString == nullptr || other.startBeat < nextOnString->startBeat
+                || (other.startBeat == nextOnString->startBeat && i < nextOnStringIndex))
+            {
+                nextOnString = &other;
+                nextOnStringIndex = i;
+            }
+        });
+
+        if (nextOnString != nullptr)
+        {
+            const double gap = nextOnString->startBeat - endBeat;
+            if (gap > 0.0 && gap <= legatoThreshold)
+                endBeat = nextOnString->startBeat;
+        }
+
+        // 2. Nächstes Event auf einer beliebigen Saite (engere Schwelle)
+        const double crossStringThreshold = legatoThreshold * 0.5;
+        double nextEventStart = std::numeric_limits<double>::max();
+        forEachNoteStartingIn (endBeat, endBeat + crossStringThreshold, rule, barsRead, [&] (size_t i)
+        {
+            if (notes[i].startBeat > endBeat)
+                nextEventStart = std::min (nextEventStart, notes[i].startBeat);
+        });
+
+        if (nextEventStart < std::numeric_limits<double>::max())
+        {
+            const double gap = nextEventStart - endBeat;
+            if (gap > 0.0 && gap <= crossStringThreshold)
+                endBeat = nextEventStart;
+        }
+
+        return endBeat;
+    }
+
+    //==========================================================================
+    /**
+     * Verteilt die Noten eines Taktes auf das 32tel-Raster.
+     * Noten innerhalb von chordThreshold (zum Mittel des Events) bilden einen
+     * Akkord; aufeinanderfolgende Events landen immer in verschiedenen Slots.
+     * Notendauern werden auf Standardwerte (auch punktiert) gerundet, Lücken
+     * mit den größtmöglichen Pausen gefüllt.
+     * barsRead erhält alle Takte, von denen das Layout abhängt.
+     */
+    std::vector<LayoutBeat> layoutBar (int barNum, const BarRule& rule, double legatoThreshold,
+                                       BarRange* barsRead = nullptr) const
+    {
+        if (barsRead != nullptr)
+            *barsRead = { barNum, barNum };
+
+        const double measureStartBeat = (barNum - 1) * rule.beatsPerMeasure;
+        const int maxSlots = (int) (rule.beatsPerMeasure / subdivision + 0.5);
+        const auto& indices = notesInBar (barNum, rule);
+
+        // 1. Events clustern und auf Slots abbilden
+        struct Group { int slot; std::vector<size_t> notes; };
+        std::vector<Group> groups;
+        {
+            std::vector<size_t> eventNotes;
+            double eventStartSum = 0.0;
+            int lastOccupiedSlot = -1;
+
+            auto flushEvent = [&]
+            {
+                if (eventNotes.empty())
+                    return;
+
+                double posInMeasure = eventStartSum / (double) eventNotes.size() - measureStartBeat;
+                // Aus dem vorherigen Takt verschobene Noten beginnen bei Slot 0
+                if (posInMeasure < 0.0)
+                    posInMeasure = 0.0;
+
+                const int idealSlot = (int) (posInMeasure / subdivision + 0.5);
+                const int slot = std::clamp (std::max (idealSlot, lastOccupiedSlot + 1), 0, maxSlots - 1);
+
+                if (! groups.empty() && groups.back().slot == slot)
+                    groups.back().notes.insert (groups.back().notes.end(), eventNotes.begin(), eventNotes.end());
+                else
+                    groups.push_back ({ slot, eventNotes });
+
+                lastOccupiedSlot = std::max (lastOccupiedSlot, slot);
+                eventNotes.clear();
+                eventStartSum = 0.0;
+            };
+
+            for (size_t i : indices)
+            {
+                const double start = notes[i].startBeat;
+                if (! eventNotes.empty() && (start - eventStartSum / (double) eventNotes.size()) >= chordThreshold)
+                    flushEvent();
+
+                eventNotes.push_back (i);
+                eventStartSum += start;
+            }
+            flushEvent();
+        }
+
+        // 2. Slots durchlaufen, Lücken mit Pausen füllen
+        std::vector<LayoutBeat> beats;
+        size_t groupIdx = 0;
+        int currentSlot = 0;
+
+        while (currentSlot < maxSlots)
+        {
+            const int nextGroupSlot = groupIdx < groups.size() ? groups[groupIdx].slot : maxSlots;
+
+            LayoutBeat beat;
+            beat.slot = currentSlot;
+
+            if (nextGroupSlot == currentSlot)
+            {
+                beat.isRest = false;
+                beat.notes = std::move (groups[groupIdx].notes);
+                ++groupIdx;
+
+                double minNoteLen = std::numeric_limits<double>::max();
+                for (size_t i : beat.notes)
+                    minNoteLen = std::min (minNoteLen, std::max (0.001, effectiveEndBeat (i, rule, legatoThreshold, barsRead)
+                                                                        - notes[i].startBeat));
+
+                const int desiredSlots = std::max (1, (int) (minNoteLen / subdivision + 0.5));
+                const int nextEventSlot = groupIdx < groups.size() ? groups[groupIdx].slot : maxSlots;
+                beat.durationInSlots = snapNoteSlots (std::min (desiredSlots, nextEventSlot - currentSlot));
+            }
+            else
+            {
+                beat.durationInSlots = snapRestSlots (nextGroupSlot - currentSlot);
+            }
+
+            currentSlot += beat.durationInSlots;
+            beats.push_back (std::move (beat));
+        }
+
+        return beats;
+    }
+
+    /** Rundet auf Standard-Notenwerte: 32, 24, 16, 12, 8, 6, 4, 3, 2, 1 (32tel). */
+    static int snapNoteSlots (int slots)
+    {
+        for (int value : { 32, 24, 16, 12, 8, 6, 4, 3, 2 })
+            if (slots >= value)
+                return value;
+        return 1;
+    }
+
+    /** Größtmögliche unpunktierte Pause: 32, 16, 8, 4, 2, 1 (32tel). */
+    static int snapRestSlots (int slots)
+    {
+        for (int value : { 32, 16, 8, 4, 2 })
+            if (slots >= value)
+                return value;
+        return 1;
+    }
+
+private:
+    std::vector<RecordedNote> notes;
+
+    // Takt-Index (wird bei Regeländerung neu aufgebaut)
+    mutable std::vector<int> bars;                          // Taktnummer pro Note
+    mutable std::map<int, std::vector<size_t>> notesByBar;  // Takt -> Indizes (nach startBeat)
+    mutable BarRule indexedRule;
+    mutable bool indexValid = false;
+
+    // Änderungsverfolgung für den inkrementellen Tab-Aufbau
+    static constexpr size_t maxTouchLogSize = 4096;
+    mutable uint32_t revision = 0;
+    mutable uint32_t indexRevision = 0;
+    mutable uint32_t touchLogStart = 0;                     // älteste Revision im Protokoll
+    mutable std::vector<std::pair<uint32_t, int>> touchLog; // (Revision, Takt)
+
+    mutable double maxEndBeat = 0.0;
+    mutable bool maxEndBeatStale = false;
+
+    size_t lowestChanged = SIZE_MAX;
+
+    void touchNote (size_t index)
+    {
+        ++revision;
+        lowestChanged = std::min (lowestChanged, index);
+        if (! indexValid)
+            return;
+
+        if (touchLog.size() >= maxTouchLogSize)
+        {
+            const auto half = touchLog.begin() + (std::ptrdiff_t) (maxTouchLogSize / 2);
+            touchLogStart = half->first - 1;
+            touchLog.erase (touchLog.begin(), half);
+        }
+        touchLog.emplace_back (revision, bars[index]);
+    }
+
+    void ensureIndex (const BarRule& rule) const
+    {
+        if (indexValid && rule == indexedRule)
+            return;
+
+        indexedRule = rule;
+        indexRevision = ++revision;
+        touchLogStart = revision;
+        touchLog.clear();
+        bars.resize (notes.size());
+        notesByBar.clear();
+
+        for (size_t i = 0; i < notes.size(); ++i)
+        {
+            bars[i] = barForNote (notes[i], rule);
+            notesByBar[bars[i]].push_back (i);
+        }
+
+        for (auto& [bar, indices] : notesByBar)
+            std::sort (indices.begin(), indices.end(), [this] (size_t a, size_t b) { return startsBefore (a, b); });
+
+        indexValid = true;
+    }
+
+    bool startsBefore (size_t a, size_t b) const
+    {
+        return notes[a].startBeat < notes[b].startBeat
+            || (notes[a].startBeat == notes[b].startBeat && a < b);
+    }
+
+    void insertIntoBar (size_t index) const
+    {
+        auto& indices = notesByBar[bars[index]];
+        indices.insert (std::upper_bound (indices.begin(), indices.end(), index,
+                                          [this] (size_t a, size_t b) { return startsBefore (a, b); }),
+                        index);
+    }
+
+    void removeFromBar (size_t index) const
+    {
+        const auto it = notesByBar.find (bars[index]);
+        if (it == notesByBar.end())
+            return;
+
+        auto& indices = it->second;
+        indices.erase (std::remove (indices.begin(), indices.end(), index), indices.end());
+        if (indices.empty())
+            notesByBar.erase (it);
+    }
+
+    /**
+     * Ruft fn(index) für (mindestens) alle Noten mit startBeat in [from, to] auf.
+     * Eine Note liegt in ihrem natürlichen Takt oder wurde in den nächsten verschoben.
+     */
+    template <typename Fn>
+    void forEachNoteStartingIn (double from, double to, const BarRule& rule, BarRange* barsRead, Fn&& fn) const
+    {
+        const int firstBar = static_cast<int> (from / rule.beatsPerMeasure) + 1;
+        const int lastBar = std::max (firstBar, static_cast<int> (to / rule.beatsPerMeasure) + 2);
+
+        if (barsRead != nullptr)
+        {
+            barsRead->include (firstBar);
+            barsRead->include (lastBar);
+        }
+
+        for (auto it = notesByBar.lower_bound (firstBar); it != notesByBar.end() && it->first <= lastBar; ++it)
+            for (size_t i : it->second)
+                if (notes[i].startBeat >= from && notes[i].startBeat <= to)
+                    fn (i);
+    }
+};
@@ -0,0 +1,506 @@
+/*
+  ==============================================================================
+
+    RecordedTabBuilder.h
+
+    Inkrementeller Aufbau des Aufnahme-Tracks (getRecordedTabTrack).
+
+    Während der Aufnahme fragt der Editor 30x pro Sekunde den Track ab. Statt
+    jedes Mal alle Takte neu zu quantisieren und aufzubauen, merkt sich der
+    Builder die fertigen TabMeasures und baut nur Takte neu, die sich seit dem
+    letzten Aufruf geändert haben - den offenen Takt und Nachbarn, deren
+    Layout davon abhängt (Takt-Quantisierung, Legato über Taktgrenzen).
+
+    Zwei Phasen, damit der Audio-Thread nicht auf den Aufbau wartet:
+      1. collect() unter recordingMutex: geänderte Takte bestimmen, Layout
+         berechnen und deren Noten kopieren.
+      2. apply() ohne recordingMutex: TabBeats aufbauen und übernehmen.
+
+    Jeder Takt trägt die Revision seiner letzten Änderung; Leser, die schon
+    einen Stand haben, übernehmen über getMeasuresChangedSince() nur die
+    geänderten Takte statt den ganzen Track zu kopieren.
+
+    Nicht thread-safe: der Aufrufer serialisiert collect()/apply().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RecordedNoteStore.h"
+#include "TabModels.h"
+#include "GuitarTuning.h"
+#include <set>
+#include <vector>
+
+//==============================================================================
+/**
+ * RecordedTabBuilder
+ */
+class RecordedTabBuilder
+{
+public:
+    /** Alles, wovon das Ergebnis außer den Noten abhängt; bei Änderung wird alles neu gebaut. */
+    struct Settings
+    {
+        RecordedNoteStore::BarRule rule;
+        int numerator = 4;
+        int denominator = 4;
+        double legatoThreshold = 0.25;
+        GuitarTuning tuning;
+
+        bool operator== (const Settings& other) const
+        {
+            return rule == other.rule && numerator == other.numerator && denominator == other.denominator
+                && legatoThreshold == other.legatoThreshold && tuning == other.tuning;
+        }
+        bool operator!= (const Settings& other) const { return ! (*this == other); }
+    };
+
+    /** Ein neu aufzubauender Takt (Kopie der Noten, endBeat inkl. Legato). */
+    struct PendingBar
+    {
+        struct Beat
+        {
+            int durationInSlots = 1;
+            bool isRest = true;
+            std::vector<RecordedNote> notes;
+        };
+
+        int barNum = 0;
+        RecordedNoteStore::BarRange barsRead;
+        std::vector<Beat> beats;
+    };
+
+    /** Ergebnis von collect(), wird an apply() übergeben. */
+    struct Update
+    {
+        Settings settings;
+        uint32_t storeRevision = 0;
+        int numMeasures = 0;
+        bool rebuildAll = false;
+        bool noNotes = false;
+        std::vector<PendingBar> bars;
+    };
+
+    /** Mindestanzahl Takte der Anzeige. */
+    static constexpr int minMeasures = 16;
+
+    //==========================================================================
+    /** Phase 1 (recordingMutex halten): geänderte Takte bestimmen und ihre Noten kopieren. */
+    Update collect (const RecordedNoteStore& store, const Settings& settings) const
+    {
+        Update update;
+        update.settings = settings;
+
+        if (store.empty())
+        {
+            update.storeRevision = store.getRevision();
+            update.noNotes = true;
+            update.rebuildAll = ! builtWithoutNotes || settings != builtSettings;
+            update.numMeasures = minMeasures;
+            return update;
+        }
+
+        const auto& rule = settings.rule;
+        const uint32_t indexRevision = store.getIndexRevision (rule);   // baut den Index ggf. neu auf
+        update.storeRevision = store.getRevision();
+
+        // Anzahl der Takte: letzte Note + 2, mindestens 16
+        const int lastMeasureNumber = std::max ((int) (store.getMaxEndBeat() / rule.beatsPerMeasure) + 1,
+                                                store.getLastBar (rule));
+        update.numMeasures = std::max (minMeasures, lastMeasureNumber + 2);
+
+        std::vector<int> touchedBars;
+        update.rebuildAll = builtWithoutNotes || measures.isEmpty() || settings != builtSettings
+                            || indexRevision > builtRevision
+                            || ! store.getBarsTouchedSince (builtRevision, touchedBars);
+
+        std::set<int> dirtyBars;
+        if (update.rebuildAll)
+        {
+            for (int barNum = 1; barNum <= update.numMeasures; ++barNum)
+                dirtyBars.insert (barNum);
+        }
+        else
+        {
+            // Takte, deren Layout einen geänderten Takt gelesen hat
+            const int numBuilt = measures.size();
+            for (int touched : touchedBars)
+            {
+                const int from = std::max (1, touched - maxSpanAfter);
+                const int to = std::min (numBuilt, touched + maxSpanBefore);
+                for (int barNum = from; barNum <= to; ++barNum)
+                {
+                    const auto& range = barsRead[(size_t) (barNum - 1)];
+                    if (range.first <= touched && touched <= range.last)
+                        dirtyBars.insert (barNum);
+                }
+            }
+
+            // Neu hinzugekommene Takte
+            for (int barNum = numBuilt + 1; barNum <= update.numMeasures; ++barNum)
+                dirtyBars.insert (barNum);
+        }
+
+        for (int barNum : dirtyBars)
+        {
+            if (barNum > update.numMeasures)
+                break;
+
+            PendingBar bar;
+            bar.barNum = barNum;
+            for (const auto& layoutBeat : store.layoutBar (barNum, rule, settings.legatoThreshold, &bar.barsRead))
+            {
+                PendingBar::Beat beat;
+                beat.durationInSlots = layoutBeat.durationInSlots;
+                beat.isRest = layoutBeat.isRest;
+                for (size_t idx : layoutBeat.notes)
+                {
+                    beat.notes.push_back (store[idx]);
+                    beat.notes.back().endBeat = store.effectiveEndBeat (idx, rule, settings.legatoThreshold);
+                }
+                bar.beats.push_back (std::move (beat));
+            }
+            update.bars.push_back (std::move (bar));
+        }
+
+        return update;
+    }
+
+    /** Phase 2 (ohne recordingMutex): Takte aufbauen und in die fertigen Takte übernehmen. */
+    void apply (Update&& update)
+    {
+        const auto& settings = update.settings;
+
+        const bool changed = update.rebuildAll || ! update.bars.empty() || measures.size() != update.numMeasures;
+        const uint32_t newRevision = changed ? trackRevision + 1 : trackRevision;
+
+        if (update.rebuildAll)
+        {
+            measures.clearQuick();
+            barsRead.clear();
+            maxSpanBefore = maxSpanAfter = 0;
+            rebuildRevision = newRevision;
+        }
+
+        // Takte anlegen bzw. kürzen (z.B. nach dem Löschen der letzten Noten)
+        while (measures.size() > update.numMeasures)
+            measures.removeLast();
+        barsRead.resize ((size_t) update.numMeasures);
+        measureRevisions.resize ((size_t) update.numMeasures, newRevision);
+
+        while (measures.size() < update.numMeasures)
+        {
+            TabMeasure measure;
+            measure.measureNumber = measures.size() + 1;
+            measure.timeSignatureNumerator = settings.numerator;
+            measure.timeSignatureDenominator = settings.denominator;
+            measures.add (measure);
+            barsRead[(size_t) measures.size() - 1] = { measures.size(), measures.size() };
+            measureRevisions[(size_t) measures.size() - 1] = newRevision;
+        }
+
+        // Ohne Noten: leere Takte ohne Beats
+        if (! update.noNotes)
+        {
+            for (auto& bar : update.bars)
+            {
+                auto& measure = measures.getReference (bar.barNum - 1);
+                measure.beats.clearQuick();
+
+                for (const auto& recordedBeat : bar.beats)
+                {
+                    TabBeat beat;
+
+                    if (recordedBeat.isRest)
+                    {
+                        // Pause: leere Noten für GP5
+                        beat.isRest = true;
+                        for (int s = 0; s < settings.tuning.getStringCount(); ++s) {
+                            TabNote emptyNote; emptyNote.string = s; emptyNote.fret = -1; beat.notes.add(emptyNote);
+                        }
+                    }
+                    else
+                    {
+                        fillBeat (beat, recordedBeat.notes, settings.tuning);
+                    }
+
+                    setBeatDuration (beat, recordedBeat.durationInSlots);
+                    measure.beats.add (beat);
+                }
+
+                barsRead[(size_t) (bar.barNum - 1)] = bar.barsRead;
+                measureRevisions[(size_t) (bar.barNum - 1)] = newRevision;
+                maxSpanBefore = std::max (maxSpanBefore, bar.barNum - bar.barsRead.first);
+                maxSpanAfter = std::max (maxSpanAfter, bar.barsRead.last - bar.barNum);
+            }
+        }
+
+        builtSettings = settings;
+        builtRevision = update.storeRevision;
+        builtWithoutNotes = update.noNotes;
+
+        trackRevision = newRevision;
+    }
+
+    /** Die fertigen Takte (measureNumber = DAW-Taktnummer). */
+    const juce::Array<TabMeasure>& getMeasures() const noexcept { return measures; }
+
+    /** Zählt hoch, wenn sich getMeasures() geändert hat. */
+    uint32_t getTrackRevision() const noexcept { return trackRevision; }
+
+    /**
+     * Indizes der Takte, die sich nach revision geändert haben oder neu sind.
+     * false, wenn seitdem alles neu gebaut wurde (oder revision 0 ist) - dann
+     * muss der Leser alle Takte übernehmen.
+     */
+    bool getMeasuresChangedSince (uint32_t revision, std::vector<int>& indices) const
+    {
+        indices.clear();
+        if (revision == 0 || revision < rebuildRevision)
+            return false;
+
+        for (size_t i = 0; i < measureRevisions.size(); ++i)
+            if (measureRevisions[i] > revision)
+                indices.push_back ((int) i);
+        return true;
+    }
+
+    /** Geschätzter Heap-Speicher der gebauten Takte (für MemoryAccounting). */
+    size_t getHeapBytes() const
+    {
+        size_t bytes = MemoryAccounting::bytesOf (measures) + MemoryAccounting::bytesOf (barsRead)
+                     + MemoryAccounting::bytesOf (measureRevisions);
+        for (const auto& measure : measures)
+            bytes += ::getHeapBytes (measure);
+        return bytes;
+    }
+
+    //==========================================================================
+    /** Setzt Duration und Dotted-Flag aus einer Länge in 32teln. */
+    static void setBeatDuration (TabBeat& beat, int durationInSlots)
+    {
+        beat.isDotted = false;
+        switch (durationInSlots)
+        {
+            case 32: beat.duration = NoteDuration::Whole; break;
+            case 24: beat.duration = NoteDuration::Half; beat.isDotted = true; break;
+            case 16: beat.duration = NoteDuration::Half; break;
+            case 12: beat.duration = NoteDuration::Quarter; beat.isDotted = true; break;
+            case 8:  beat.duration = NoteDuration::Quarter; break;
+            case 6:  beat.duration = NoteDuration::Eighth; beat.isDotted = true; break;
+            case 4:  beat.duration = NoteDuration::Eighth; break;
+            case 3:  beat.duration = NoteDuration::Sixteenth; beat.isDotted = true; break;
+            case 2:  beat.duration = NoteDuration::Sixteenth; break;
+            default: beat.duration = NoteDuration::ThirtySecond; break;
+        }
+    }
+
+    /** Noten-Beat aufbauen: Saitenkonflikte auflösen, Finger und Effekte übernehmen. */
+    static void fillBeat (TabBeat& beat, const std::vector<RecordedNote>& group, const GuitarTuning& tuning)
+    {
+        const int numStrings = tuning.getStringCount();
+        beat.isRest = false;
+    
+        // Noten setzen
+        for (int s = 0; s < numStrings; ++s)
+        {
+            TabNote emptyNote; emptyNote.string = s; emptyNote.fret = -1; beat.notes.add(emptyNote);
+        }
+    
+        // === Sicherheitsnetz: String-Konflikte auflösen ===
+        // Falls zwei Noten im gleichen Beat die gleiche Saite haben,
+        // versuche die zweite auf eine andere Saite umzulegen.
+        // Das passiert z.B. bei Oktav-Noten (C3+C4) die im reoptimize
+        // nicht korrekt gruppiert wurden.
+        {
+            std::set<int> occupiedStrings;
+            // Kopie der Noten, damit wir Konflikte auflösen können
+            struct ResolvedNote {
+                int midiNote;
+                int string;
+                int fret;
+                int velocity;
+                const RecordedNote* original;
+            };
+            std::vector<ResolvedNote> resolvedNotes;
+            for (const auto& note : group)
+            {
+                resolvedNotes.push_back({note.midiNote, note.string, note.fret, note.velocity, &note});
+            }
+        
+            for (size_t ni = 0; ni < resolvedNotes.size(); ++ni)
+            {
+                auto& rn = resolvedNotes[ni];
+                if (rn.string >= 0 && rn.string < numStrings && occupiedStrings.count(rn.string) == 0)
+                {
+                    occupiedStrings.insert(rn.string);
+                }
+                else if (rn.string >= 0 && rn.string < numStrings)
+                {
+                    // Konflikt! Diese Saite ist bereits belegt.
+                    // Versuche alternative Saite zu finden
+                    bool found = false;
+                    int bestAltScore = -100000;
+                    int bestAltString = -1;
+                    int bestAltFret = -1;
+                
+                    for (int s = 0; s < numStrings; ++s)
+                    {
+                        if (occupiedStrings.count(s) > 0) continue;
+                        int fret = rn.midiNote - tuning.getOpenNote(s);
+                        if (fret >= 0 && fret <= tuning.getMaxFret())
+                        {
+                            // Einfache Bewertung: bevorzuge Positionen nahe der aktuellen
+                            int score = 100 - std::abs(fret - rn.fret) * 10;
+                            // Check Fret-Spannweite mit bereits platzierten Noten
+                            int minF = fret, maxF = fret;
+                            for (size_t oi = 0; oi < ni; ++oi)
+                            {
+                                if (resolvedNotes[oi].fret > 0)
+                                {
+                                    minF = std::min(minF, resolvedNotes[oi].fret);
+                                    maxF = std::max(maxF, resolvedNotes[oi].fret);
+                                }
+                            }
+                            if (fret > 0) { minF = std::min(minF, fret); maxF = std::max(maxF, fret); }
+                            if (minF <= maxF && maxF - minF > 3) 
+                                score -= 500;  // Starke Strafe für > 3 Bünde Spannweite
+                        
+                            if (score > bestAltScore)
+                            {
+                                bestAltScore = score;
+                                bestAltString = s;
+                                bestAltFret = fret;
+                            }
+                        }
+                    }
+                
+                    if (bestAltString >= 0)
+                    {
+                        rn.string = bestAltString;
+                        rn.fret = bestAltFret;
+                        occupiedStrings.insert(bestAltString);
+                    }
+                    // Sonst: Note kann leider nicht platziert werden (alle Saiten belegt)
+                }
+            }
+        
+            // Jetzt die aufgelösten Noten in den Beat schreiben
+            for (const auto& rn : resolvedNotes)
+            {
+                if (rn.string >= 0 && rn.string < numStrings)
+                {
+                    beat.notes.getReference(rn.string).fret = rn.fret;
+                    beat.notes.getReference(rn.string).velocity = rn.velocity;
+                
+                    // === Apply Finger Number ===
+                    if (rn.original->fingerNumber >= 0)
+                        beat.notes.getReference(rn.string).fingerNumber = rn.original->fingerNumber;
+                
+                    // === Apply Recorded Effects ===
+                    auto& tabNote = beat.notes.getReference(rn.string);
+                    const auto* note = rn.original;
+            
+                    // Vibrato
+                    if (note->hasVibrato)
+                        tabNote.effects.vibrato = true;
+                
+                    // Bending - Threshold: 0.5 Halbtöne (50 cents)
+                    // MIDI Pitch Wheel Bends sind immer bewusst vom Spieler
+                    // (Audio-Transcription hat eigenen höheren Threshold)
+                    if (note->maxBendValue >= 0.5f)
+                    {
+                        tabNote.effects.bend = true;
+                        tabNote.effects.bendValue = note->maxBendValue;
+                    
+                        // Convert recorded raw events to GP5BendPoints (0-60 scale)
+                        if (!note->rawBendEvents.empty())
+                        {
+                            double noteStart = note->startBeat;
+                            double noteLen = note->endBeat - note->startBeat;
+                            if (noteLen < 0.001) noteLen = 0.001; // Safety
+                        
+                            tabNote.effects.bendPoints.clear();
+                        
+                            // Always start with a 0-point if not present
+                            if (note->rawBendEvents.front().beat > noteStart + 0.01)
+                            {
+                                TabBendPoint startPt;
+                                startPt.position = 0;
+                                startPt.value = 0;
+                                tabNote.effects.bendPoints.push_back(startPt);
+                            }
+                        
+                            for (const auto& ev : note->rawBendEvents)
+                            {
+                                double relPos = (ev.beat - noteStart) / noteLen;
+                                if (relPos < 0.0) relPos = 0.0;
+                                if (relPos > 1.0) relPos = 1.0;
+                            
+                                TabBendPoint bp;
+                                bp.position = (int)(relPos * 60.0);
+                                // Clamp small values to 0 - only show significant bends in curve
+                                bp.value = (std::abs(ev.value) < 10) ? 0 : ev.value;
+                            
+                                // Filter too close points (GP5 restriction)
+                                if (!tabNote.effects.bendPoints.empty())
+                                {
+                                    if (bp.position == tabNote.effects.bendPoints.back().position)
+                                       tabNote.effects.bendPoints.back().value = bp.value; // Overwrite same pos
+                                    else
+                                       tabNote.effects.bendPoints.push_back(bp);
+                                }
+                                else
+                                    tabNote.effects.bendPoints.push_back(bp);
+                            }
+                        
+                            // Ensure end point
+                            if (tabNote.effects.bendPoints.empty() || tabNote.effects.bendPoints.back().position < 60)
+                            {
+                                 TabBendPoint endPt;
+                                 endPt.position = 60;
+                                 // Hold last value
+                                 if (!tabNote.effects.bendPoints.empty())
+                                     endPt.value = tabNote.effects.bendPoints.back().value;
+                                 else
+                                     endPt.value = 0;
+                                 tabNote.effects.bendPoints.push_back(endPt);
+                            }
+                        
+                            // Determine Bend Type based on curve shape
+                            // 1=Bend, 2=Bend+Release, 3=Release, 4=PreBend, 5=PreBend+Release
+                            bool startsZero = (tabNote.effects.bendPoints.front().value < 10);
+                            bool endsLow = (tabNote.effects.bendPoints.back().value < 10);
+                        
+                            if (startsZero)
+                            {
+                                if (endsLow) tabNote.effects.bendType = 2; // Bend+Release
+                                else tabNote.effects.bendType = 1; // Bend
+                            }
+                            else
+                            {
+                                if (endsLow) tabNote.effects.bendType = 3; // Release (PreBend+Release?)
+                                else tabNote.effects.bendType = 4; // PreBend or Hold
+                            }
+                        }
+                    }
+                }
+            }
+        }  // Ende Sicherheitsnetz-Block
+    }
+
+private:
+    juce::Array<TabMeasure> measures;
+    std::vector<RecordedNoteStore::BarRange> barsRead;  // pro Takt (Index barNum - 1)
+    int maxSpanBefore = 0;                              // max. barNum - barsRead.first
+    int maxSpanAfter = 0;                               // max. barsRead.last - barNum
+    std::vector<uint32_t> measureRevisions;             // trackRevision der letzten Änderung pro Takt
+    uint32_t rebuildRevision = 0;                       // trackRevision des letzten Komplett-Aufbaus
+
+    Settings builtSettings;
+    uint32_t builtRevision = 0;
+    bool builtWithoutNotes = false;
+    uint32_t trackRevision = 0;
+};
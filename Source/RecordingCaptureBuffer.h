@@ -0,0 +1,475 @@
+/*
+  ==============================================================================
+
+    RecordingCaptureBuffer.h
+
+    Allokations- und lockfreie Aufnahme von Noten und Pitch-Bends im Audio-Thread.
+
+    Der Audio-Thread (einziger Produzent) schreibt Note-On/Off, Bends und
+    Vibrato als Events fester Größe in einen vorab reservierten Ringpuffer
+    (juce::AbstractFifo, Single-Producer/Single-Consumer). Ist er voll, wird
+    verworfen statt allokiert oder gewartet.
+
+    Der Konsument (Message-Thread, unter recordingMutex) übernimmt die Events
+    in flushInto() in die spaltenweisen Slots der gehaltenen Noten - alle
+    Bend-Events in einer gemeinsamen Spalte, pro Note verkettet über
+    firstBend/nextBend - und überträgt sie in den RecordedNoteStore (erst dort
+    werden Bend-Kurven als Vektoren pro Note angelegt).
+
+    Audio-Thread: beginNote/endNote/endAllNotes/addBend/setVibrato/needsFlush.
+    Alles andere nur vom Konsumenten mit gehaltenem recordingMutex - der
+    Audio-Thread nimmt diesen Lock für die Aufnahme nie.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RecordedNoteStore.h"
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//==============================================================================
+/**
+ * RecordingCaptureBuffer
+ */
+class RecordingCaptureBuffer
+{
+public:
+    /** Events im Ringpuffer - reicht für viele Sekunden dichtes Spiel inkl. Pitch-Wheel. */
+    static constexpr int eventCapacity = 8192;
+
+    /** Slots, die der Konsument auf einmal anlegt, wenn die Spalten voll sind. */
+    static constexpr int noteHeadroom = 1024;
+    static constexpr int bendHeadroom = 16384;
+
+    RecordingCaptureBuffer()
+        : events ((size_t) eventCapacity)
+    {
+        activeSlotForNote.fill (-1);
+        reserveHeadroom();
+    }
+
+    //==========================================================================
+    // Audio-Thread (allokiert nie, blockiert nie)
+
+    /** Startet eine Note (nur die skalaren Felder werden übernommen); false wenn kein Platz. */
+    bool beginNote (const RecordedNote& note)
+    {
+        Event event;
+        event.type = Event::noteOn;
+        event.midiNote = note.midiNote;
+        event.velocity = note.velocity;
+        event.channel = note.midiChannel;
+        event.string = note.string;
+        event.fret = note.fret;
+        event.fingerNumber = note.fingerNumber;
+        event.beat = note.startBeat;
+        return push (event, droppedNotes);
+    }
+
+    /** Note-Off: beendet die aktive Note mit dieser Tonhöhe. */
+    void endNote (int note, double beat)
+    {
+        Event event;
+        event.type = Event::noteOff;
+        event.midiNote = note;
+        event.beat = beat;
+        push (event, droppedNotes);
+    }
+
+    /** All-Notes-Off: beendet alle aktiven Noten. */
+    void endAllNotes (double beat)
+    {
+        Event event;
+        event.type = Event::allNotesOff;
+        event.beat = beat;
+        push (event, droppedNotes);
+    }
+
+    /** Pitch-Wheel für alle aktiven Noten eines Kanals (value in 1/100 Halbtönen). */
+    void addBend (int channel, double beat, int value)
+    {
+        Event event;
+        event.type = Event::bend;
+        event.channel = channel;
+        event.beat = beat;
+        event.value = value;
+        push (event, droppedBends);
+    }
+
+    /** Modulation-Wheel: Vibrato für alle aktiven Noten eines Kanals. */
+    void setVibrato (int channel)
+    {
+        Event event;
+        event.type = Event::vibrato;
+        event.channel = channel;
+        push (event, droppedBends);
+    }
+
+    /** True wenn der Ringpuffer halb voll ist - dann sollte bald flushInto() laufen. */
+    bool needsFlush() const noexcept
+    {
+        return fifo.getNumReady() >= eventCapacity / 2;
+    }
+
+    //==========================================================================
+    // Konsument (recordingMutex halten, nie im Audio-Thread)
+
+    /** Saite/Bund einer gehaltenen Note aus der Live-Anzeige übernehmen. */
+    void setActiveNotePosition (int note, int newString, int newFret)
+    {
+        if (note < 0 || note >= 128)
+            return;
+
+        drainEvents();   // die Note kann noch im Ringpuffer stehen
+
+        const int slot = activeSlotForNote[(size_t) note];
+        if (slot < 0 || (string[(size_t) slot] == newString && fret[(size_t) slot] == newFret))
+            return;
+
+        string[(size_t) slot] = newString;
+        fret[(size_t) slot] = newFret;
+        dirty[(size_t) slot] |= dirtyPosition;
+    }
+
+    /** Wächst die Spalten so, dass wieder noteHeadroom/bendHeadroom frei sind (nur Konsument). */
+    void reserveHeadroom()
+    {
+        const auto notes = (size_t) (numNotes + noteHeadroom);
+        if (startBeat.size() < notes)
+        {
+            for (auto* column : { &midiNote, &velocity, &midiChannel, &string, &fret, &fingerNumber,
+                                  &firstBend, &lastBend, &bendCount })
+                column->resize (notes);
+            startBeat.resize (notes);
+            endBeat.resize (notes);
+            maxBendValue.resize (notes);
+            flags.resize (notes);
+            dirty.resize (notes);
+            storeIndex.resize (notes);
+        }
+
+        const auto bends = (size_t) (numBends + bendHeadroom);
+        if (bendBeat.size() < bends)
+        {
+            bendBeat.resize (bends);
+            bendValue.resize (bends);
+            nextBend.resize (bends);
+        }
+    }
+
+    /**
+     * Übernimmt die Events des Audio-Threads, überträgt neue Noten und Änderungen
+     * (Note-Off, Bends, Vibrato, Live-Position) in den Store, gibt beendete Slots
+     * und alle Bend-Events frei und stellt die Reserve wieder her.
+     */
+    void flushInto (RecordedNoteStore& store)
+    {
+        drainEvents();
+
+        for (int slot = 0; slot < numNotes; ++slot)
+        {
+            const auto s = (size_t) slot;
+
+            if (storeIndex[s] == notTransferred)
+            {
+                RecordedNote note;
+                note.midiNote = midiNote[s];
+                note.velocity = velocity[s];
+                note.midiChannel = midiChannel[s];
+                note.string = string[s];
+                note.fret = fret[s];
+                note.fingerNumber = fingerNumber[s];
+                note.startBeat = startBeat[s];
+                note.endBeat = endBeat[s];
+                note.isActive = (flags[s] & activeFlag) != 0;
+                note.hasVibrato = (flags[s] & vibratoFlag) != 0;
+                note.maxBendValue = maxBendValue[s];
+                appendBends (slot, note.rawBendEvents);
+
+                storeIndex[s] = (int64_t) store.add (std::move (note));
+            }
+            else if (storeIndex[s] >= 0 && dirty[s] != 0)
+            {
+                const auto index = (size_t) storeIndex[s];
+
+                if (dirty[s] & dirtyEnd)
+                    store.setEndBeat (index, endBeat[s]);
+
+                auto& note = store.modify (index);
+                note.isActive = (flags[s] & activeFlag) != 0;
+                note.hasVibrato = (flags[s] & vibratoFlag) != 0;
+                note.maxBendValue = maxBendValue[s];
+                if (dirty[s] & dirtyPosition)
+                {
+                    note.string = string[s];
+                    note.fret = fret[s];
+                }
+                appendBends (slot, note.rawBendEvents);
+            }
+
+            dirty[s] = 0;
+            firstBend[s] = lastBend[s] = -1;
+        }
+        numBends = 0;
+
+        compact();
+        reserveHeadroom();
+    }
+
+    /** Der Store hat eine Note gelöscht - Verweise der gehaltenen Noten nachziehen. */
+    void storeNoteErased (size_t index)
+    {
+        for (int slot = 0; slot < numNotes; ++slot)
+        {
+            auto& target = storeIndex[(size_t) slot];
+            if (target == (int64_t) index)
+                target = detached;
+            else if (target > (int64_t) index)
+                --target;
+        }
+    }
+
+    /** Verwirft alles (zusammen mit RecordedNoteStore::clear()); noch nicht übernommene Events auch. */
+    void clear()
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+        fifo.finishedRead (size1 + size2);
+
+        numNotes = 0;
+        numBends = 0;
+        activeSlotForNote.fill (-1);
+    }
+
+    bool isEmpty() const noexcept       { return numNotes == 0; }
+    int getDroppedNotes() const noexcept { return droppedNotes.load (std::memory_order_relaxed); }
+    int getDroppedBends() const noexcept { return droppedBends.load (std::memory_order_relaxed); }
+
+private:
+    enum : uint8_t { activeFlag = 1, vibratoFlag = 2 };
+    enum : uint8_t { dirtyEnd = 1, dirtyBends = 2, dirtyFlags = 4, dirtyPosition = 8 };
+
+    static constexpr int64_t notTransferred = -1;
+    static constexpr int64_t detached = -2;   // Note wurde im Store gelöscht
+
+    /** Ein Ereignis des Audio-Threads (feste Größe, keine Heap-Daten). */
+    struct Event
+    {
+        enum Type : uint8_t { noteOn, noteOff, allNotesOff, bend, vibrato };
+
+        Type type = noteOn;
+        int midiNote = -1, velocity = 0, channel = 0, string = -1, fret = -1, fingerNumber = -1;
+        int value = 0;
+        double beat = 0.0;
+    };
+
+    // Ringpuffer Audio-Thread -> Konsument
+    juce::AbstractFifo fifo { eventCapacity };
+    std::vector<Event> events;
+
+    // Noten-Spalten
+    std::vector<int> midiNote, velocity, midiChannel, string, fret, fingerNumber;
+    std::vector<double> startBeat, endBeat;
+    std::vector<float> maxBendValue;
+    std::vector<uint8_t> flags, dirty;
+    std::vector<int> firstBend, lastBend, bendCount;   // Kette der noch nicht übertragenen Bends
+    std::vector<int64_t> storeIndex;                   // Index im RecordedNoteStore
+    int numNotes = 0;
+
+    // Gemeinsame Bend-Spalte
+    std::vector<double> bendBeat;
+    std::vector<int> bendValue, nextBend;
+    int numBends = 0;
+
+    std::array<int, 128> activeSlotForNote {};   // MIDI-Note -> Slot der gehaltenen Note (Konsument)
+    std::atomic<int> droppedNotes { 0 };         // Ringpuffer voll (Audio-Thread zählt)
+    std::atomic<int> droppedBends { 0 };
+
+    bool push (const Event& event, std::atomic<int>& droppedCounter) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+        if (size1 + size2 == 0)
+        {
+            droppedCounter.fetch_add (1, std::memory_order_relaxed);
+            return false;
+        }
+
+        events[(size_t) (size1 > 0 ? start1 : start2)] = event;
+        fifo.finishedWrite (1);
+        return true;
+    }
+
+    /** Alle bereitstehenden Events in die Slots übernehmen. */
+    void drainEvents()
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i)
+            apply (events[(size_t) (start1 + i)]);
+        for (int i = 0; i < size2; ++i)
+            apply (events[(size_t) (start2 + i)]);
+
+        fifo.finishedRead (size1 + size2);
+    }
+
+    void apply (const Event& event)
+    {
+        switch (event.type)
+        {
+            case Event::noteOn:      applyNoteOn (event); break;
+            case Event::noteOff:     applyNoteOff (event.midiNote, event.beat); break;
+            case Event::allNotesOff: applyAllNotesOff (event.beat); break;
+            case Event::bend:        applyBend (event.channel, event.beat, event.value); break;
+            case Event::vibrato:     applyVibrato (event.channel); break;
+        }
+    }
+
+    void applyNoteOn (const Event& event)
+    {
+        if (numNotes >= (int) startBeat.size())
+            reserveHeadroom();
+
+        const int slot = numNotes++;
+        midiNote[(size_t) slot] = event.midiNote;
+        velocity[(size_t) slot] = event.velocity;
+        midiChannel[(size_t) slot] = event.channel;
+        string[(size_t) slot] = event.string;
+        fret[(size_t) slot] = event.fret;
+        fingerNumber[(size_t) slot] = event.fingerNumber;
+        startBeat[(size_t) slot] = event.beat;
+        endBeat[(size_t) slot] = event.beat;
+        maxBendValue[(size_t) slot] = 0.0f;
+        flags[(size_t) slot] = activeFlag;
+        dirty[(size_t) slot] = 0;
+        firstBend[(size_t) slot] = lastBend[(size_t) slot] = -1;
+        bendCount[(size_t) slot] = 0;
+        storeIndex[(size_t) slot] = notTransferred;
+
+        if (event.midiNote >= 0 && event.midiNote < 128)
+            activeSlotForNote[(size_t) event.midiNote] = slot;
+    }
+
+    void applyNoteOff (int note, double beat)
+    {
+        if (note < 0 || note >= 128)
+            return;
+
+        const int slot = activeSlotForNote[(size_t) note];
+        if (slot >= 0)
+            finishSlot (slot, beat);
+        activeSlotForNote[(size_t) note] = -1;
+    }
+
+    void applyAllNotesOff (double beat)
+    {
+        for (auto& slot : activeSlotForNote)
+        {
+            if (slot >= 0)
+                finishSlot (slot, beat);
+            slot = -1;
+        }
+    }
+
+    void applyBend (int channel, double beat, int value)
+    {
+        for (int slot : activeSlotForNote)
+        {
+            if (slot < 0 || midiChannel[(size_t) slot] != channel)
+                continue;
+
+            // Nur Bends != 0 speichern, damit die Kurve sauber bleibt (außer nach dem ersten Event)
+            if (value != 0 || bendCount[(size_t) slot] > 0)
+            {
+                if (numBends >= (int) bendBeat.size())
+                    reserveHeadroom();
+
+                const int event = numBends++;
+                bendBeat[(size_t) event] = beat;
+                bendValue[(size_t) event] = value;
+                nextBend[(size_t) event] = -1;
+
+                if (lastBend[(size_t) slot] >= 0)
+                    nextBend[(size_t) lastBend[(size_t) slot]] = event;
+                else
+                    firstBend[(size_t) slot] = event;
+                lastBend[(size_t) slot] = event;
+                ++bendCount[(size_t) slot];
+            }
+
+            const float semitones = std::abs (value) / 100.0f;
+            if (semitones > maxBendValue[(size_t) slot])
+                maxBendValue[(size_t) slot] = semitones;
+            dirty[(size_t) slot] |= dirtyBends;
+        }
+    }
+
+    void applyVibrato (int channel)
+    {
+        for (int slot : activeSlotForNote)
+        {
+            if (slot >= 0 && midiChannel[(size_t) slot] == channel)
+            {
+                flags[(size_t) slot] |= vibratoFlag;
+                dirty[(size_t) slot] |= dirtyFlags;
+            }
+        }
+    }
+
+    void finishSlot (int slot, double beat)
+    {
+        endBeat[(size_t) slot] = beat;
+        flags[(size_t) slot] &= (uint8_t) ~activeFlag;
+        dirty[(size_t) slot] |= dirtyEnd | dirtyFlags;
+    }
+
+    void appendBends (int slot, std::vector<RecordedNote::RawBendEvent>& events) const
+    {
+        for (int event = firstBend[(size_t) slot]; event >= 0; event = nextBend[(size_t) event])
+            events.push_back ({ bendBeat[(size_t) event], bendValue[(size_t) event] });
+    }
+
+    /** Beendete Slots entfernen; gehaltene Noten rücken nach vorne. */
+    void compact()
+    {
+        int kept = 0;
+        for (int slot = 0; slot < numNotes; ++slot)
+        {
+            if ((flags[(size_t) slot] & activeFlag) == 0)
+                continue;
+
+            if (kept != slot)
+            {
+                const auto from = (size_t) slot, to = (size_t) kept;
+                midiNote[to] = midiNote[from];
+                velocity[to] = velocity[from];
+                midiChannel[to] = midiChannel[from];
+                string[to] = string[from];
+                fret[to] = fret[from];
+                fingerNumber[to] = fingerNumber[from];
+                startBeat[to] = startBeat[from];
+                endBeat[to] = endBeat[from];
+                maxBendValue[to] = maxBendValue[from];
+                flags[to] = flags[from];
+                dirty[to] = dirty[from];
+                firstBend[to] = firstBend[from];
+                lastBend[to] = lastBend[from];
+                bendCount[to] = bendCount[from];
+                storeIndex[to] = storeIndex[from];
+
+                for (auto& active : activeSlotForNote)
+                    if (active == slot)
+                        active = kept;
+            }
+            ++kept;
+        }
+        numNotes = kept;
+    }
+};
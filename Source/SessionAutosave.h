@@ -0,0 +1,714 @@
+/*
+  ==============================================================================
+
+    SessionAutosave.h
+
+    Absturzsicherung für Aufnahmen und Tab-Edits.
+
+    Ein Hintergrund-Thread führt pro Plugin-Session (ID im Plugin-State) ein
+    Append-only-Journal im Benutzer-Datenverzeichnis:
+
+      "TBAJ" | Version (1 Byte) | Records
+      Record = Typ (1 Byte) | Sequenz (8) | Länge (4) | FNV-1a (4) | Daten
+        Base        vollständiger Stand (PluginStateCodec, ohne Einstellungen)
+        Notes       Noten ab Index "from" ersetzen (neu aufgenommene bzw. geänderte)
+        Track       editierter TabTrack komplett (erster Edit, setEditedTrack)
+        Edits       angewendeter Edit-Batch (TabEdit), wird per TabEditJournal::apply nachgespielt
+        ClearTracks editierte Tracks verworfen (Entladen, Aufnahme löschen)
+        Measures    einzelne Takte eines Tracks ersetzen (Undo/Redo)
+
+    Edits, Tracks und Takte werden vom Message-Thread nur in eine Warteschlange
+    gelegt (Tracks und Takte als unveränderliche shared_ptr, serialisiert wird
+    erst im Autosave-Thread); neue Noten holt der Thread selbst (kurz unter recordingMutex).
+    Alle paar Sekunden wird gebündelt geschrieben und einmal geflusht (fsync).
+    Überschreitet das Journal ein Vielfaches der Basis, wird es atomar auf eine
+    neue Basis verdichtet. Der Audio-Thread ist nicht beteiligt.
+
+    Jede laufende Instanz im Prozess hat eine eigene Session-ID: trägt ein
+    dupliziertes Plugin die ID einer lebenden Instanz, bekommt es eine neue
+    (das Journal wird zur Wiederherstellung mitkopiert) - sonst würde das
+    saubere Beenden der einen das Journal der anderen löschen.
+
+    Ein abgerissener letzter Record (Absturz beim Schreiben) wird beim Lesen an
+    der Prüfsumme erkannt und ignoriert. Beim normalen Beenden wird das Journal
+    gelöscht - es bleibt nur nach einem Absturz liegen.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "PluginStateCodec.h"
+#include "TabEditJournal.h"
+#include "TabUndoHistory.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <set>
+#include <vector>
+
+//==============================================================================
+/**
+ * SessionAutosave
+ */
+class SessionAutosave : private juce::Thread
+{
+public:
+    /** Geänderte Noten seit dem letzten Abruf: alles ab from wird ersetzt. */
+    struct NotesDelta
+    {
+        size_t from = 0;
+        std::vector<RecordedNote> notes;
+        double recordingStartBeat = 0.0;
+        bool recordingStartSet = false;
+    };
+
+    /**
+     * Aktueller Stand für eine neue Basis. sequence = höchste Post-Sequenz,
+     * deren Änderung im Stand enthalten ist (spätere Posts werden nachgespielt).
+     */
+    using SnapshotSource = std::function<PluginStateCodec::Snapshot(uint64_t& sequence)>;
+
+    /** Füllt delta und liefert true, wenn sich Noten geändert haben. */
+    using NotesSource = std::function<bool(NotesDelta& delta)>;
+
+    static constexpr int flushIntervalMs = 2000;
+    static constexpr juce::int64 minCompactBytes = 256 * 1024;
+    static constexpr int compactFactor = 4;          // verdichten ab Basis * Faktor
+    static constexpr int staleJournalDays = 14;      // liegengebliebene Journale anderer Sessions
+
+    SessionAutosave(SnapshotSource snapshot, NotesSource notes)
+        : juce::Thread("SessionAutosave"),
+          snapshotSource(std::move(snapshot)),
+          notesSource(std::move(notes))
+    {
+    }
+
+    ~SessionAutosave() override
+    {
+        stop(true);
+    }
+
+    static juce::String createSessionId() { return juce::Uuid().toString(); }
+
+    static juce::File getDirectory()
+    {
+        return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+            .getChildFile(JucePlugin_Manufacturer).getChildFile(JucePlugin_Name).getChildFile("Autosave");
+    }
+
+    static juce::File getJournalFile(const juce::String& sessionId)
+    {
+        return getDirectory().getChildFile(sessionId + ".tbj");
+    }
+
+    /**
+     * Startet das Journal einer Session (Message-Thread). Mit checkForRecovery
+     * wird ein vorhandenes Journal nachgespielt und - wenn es vom aktuellen
+     * Stand abweicht - als Wiederherstellung angeboten, sonst neu begonnen.
+     */
+    void start(const juce::String& newSessionId, bool checkForRecovery)
+    {
+        stop(false);
+
+        sessionId = newSessionId;
+        if (! claimSessionId(sessionId))
+        {
+            // Dupliziertes Plugin: die ID gehört einer laufenden Instanz - eigene Session,
+            // deren Journal als Ausgangspunkt für die Wiederherstellung mitnehmen
+            do
+                sessionId = createSessionId();
+            while (! claimSessionId(sessionId));
+
+            const auto sharedJournal = getJournalFile(newSessionId);
+            if (checkForRecovery && sharedJournal.existsAsFile())
+                sharedJournal.copyFileTo(getJournalFile(sessionId));
+
+            DBG("SessionAutosave: session " << newSessionId << " already in use, continuing as " << sessionId);
+        }
+
+        claimedSessionId = sessionId;
+        journalFile = getJournalFile(sessionId);
+        recoveryAvailable.store(false);
+        needsRecoveryCheck.store(checkForRecovery);
+        needsRebase.store(! checkForRecovery);
+
+        startThread(juce::Thread::Priority::low);
+    }
+
+    /** Beendet den Thread (schreibt Ausstehendes); deleteJournal beim normalen Beenden. */
+    void stop(bool deleteJournal)
+    {
+        stopThread(4000);
+        stream.reset();
+
+        {
+            const juce::ScopedLock sl(pendingLock);
+            pending.clear();
+        }
+
+        // Eine nicht beantwortete Wiederherstellung bleibt für den nächsten Start liegen
+        if (deleteJournal && journalFile != juce::File() && ! recoveryAvailable.load())
+            journalFile.deleteFile();
+
+        // Nur einmal freigeben - die ID kann danach schon einer anderen Instanz gehören
+        releaseSessionId(claimedSessionId);
+        claimedSessionId = {};
+    }
+
+    const juce::String& getSessionId() const noexcept { return sessionId; }
+
+    //==========================================================================
+    // Aufrufer: Message-Thread. Die Sequenz des Posts muss vor dem Stand vergeben
+    // sein, der ihn enthält (siehe SnapshotSource).
+
+    /** Track komplett; der Track ist unveränderlich und wird erst im Autosave-Thread serialisiert. */
+    void postTrack(int trackIndex, std::shared_ptr<const TabTrack> track)
+    {
+        Record record;
+        record.type = recordTrack;
+        record.trackIndex = trackIndex;
+        record.track = std::move(track);
+        post(std::move(record));
+    }
+
+    void postEdits(int trackIndex, const std::vector<TabEdit>& edits)
+    {
+        if (edits.empty())
+            return;
+
+        juce::MemoryOutputStream out;
+        out.writeCompressedInt(trackIndex);
+        out.writeCompressedInt((int) edits.size());
+        for (const auto& edit : edits)
+        {
+            out.writeCompressedInt((int) edit.type);
+            out.writeCompressedInt(edit.measureIndex);
+            out.writeCompressedInt(edit.beatIndex);
+            out.writeCompressedInt(edit.noteIndex);
+            out.writeCompressedInt(edit.string);
+            out.writeCompressedInt(edit.fret);
+            out.writeCompressedInt(edit.midiNote);
+            out.writeCompressedInt((int) edit.duration);
+            out.writeByte(edit.dotted ? 1 : 0);
+        }
+        post(recordEdits, out.getMemoryBlock());
+    }
+
+    void postClearTracks()
+    {
+        post(recordClearTracks, {});
+    }
+
+    /**
+     * Ersetzte Takte (Undo/Redo). Die Takte sind unveränderlich und werden erst
+     * im Autosave-Thread serialisiert. Ersetzen ist idempotent: landet der Stand
+     * zusätzlich in einer zwischenzeitlichen Basis, schadet das erneute Anwenden nicht.
+     */
+    void postMeasures(int trackIndex, int numMeasures, TabUndoHistory::MeasureList measures)
+    {
+        if (measures.empty())
+            return;
+
+        Record record;
+        record.type = recordMeasures;
+        record.trackIndex = trackIndex;
+        record.numMeasures = numMeasures;
+        record.measures = std::move(measures);
+        post(std::move(record));
+    }
+
+    /** Stand wurde ersetzt (State geladen) - Journal mit neuer Basis beginnen. */
+    void postRebase()
+    {
+        needsRebase.store(true);
+        notify();
+    }
+
+    uint64_t getPostedSequence() const noexcept { return postedSequence.load(); }
+
+    //==========================================================================
+    // Wiederherstellung (Message-Thread)
+
+    bool hasRecovery() const noexcept { return recoveryAvailable.load(); }
+
+    /** Nachgespielter Stand des Journals; das Journal bleibt bis finishRecovery() unverändert. */
+    bool getRecovery(PluginStateCodec::Snapshot& out) const
+    {
+        if (! recoveryAvailable.load())
+            return false;
+
+        const juce::ScopedLock sl(pendingLock);
+        out = recoveredState;
+        return true;
+    }
+
+    /** Wiederhergestellt oder verworfen: neue Basis aus dem aktuellen Stand, Journal läuft weiter. */
+    void finishRecovery()
+    {
+        {
+            const juce::ScopedLock sl(pendingLock);
+            recoveredState = PluginStateCodec::Snapshot();
+        }
+        needsRebase.store(true);
+        recoveryAvailable.store(false);
+        notify();
+    }
+
+    //==========================================================================
+    /** Spielt ein Journal nach; false wenn es fehlt oder keine gültige Basis hat. */
+    static bool replay(const juce::File& file, PluginStateCodec::Snapshot& state)
+    {
+        juce::MemoryBlock data;
+        if (! file.loadFileAsData(data) || data.getSize() < headerSize
+            || std::memcmp(data.getData(), magic, 4) != 0 || static_cast<const uint8_t*>(data.getData())[4] != version)
+            return false;
+
+        const auto* bytes = static_cast<const uint8_t*>(data.getData());
+        size_t pos = headerSize;
+        bool hasBase = false;
+
+        while (pos + recordHeaderSize <= data.getSize())
+        {
+            const uint8_t type = bytes[pos];
+            const uint32_t size = readUInt32(bytes + pos + 9);
+            const uint32_t checksum = readUInt32(bytes + pos + 13);
+            const uint8_t* payload = bytes + pos + recordHeaderSize;
+
+            if (pos + recordHeaderSize + size > data.getSize() || fnv1a(payload, size) != checksum)
+            {
+                DBG("SessionAutosave: torn record at " << (int) pos << " ignored");
+                break;
+            }
+
+            if (type == recordBase)
+                hasBase = PluginStateCodec::read(payload, size, state);
+            else if (hasBase)
+                applyRecord(type, payload, size, state);
+
+            pos += recordHeaderSize + size;
+        }
+
+        return hasBase;
+    }
+
+private:
+    enum : uint8_t { recordBase = 1, recordNotes = 2, recordTrack = 3, recordEdits = 4, recordClearTracks = 5,
+                       recordMeasures = 6 };
+
+    static constexpr char magic[4] = { 'T', 'B', 'A', 'J' };
+    static constexpr uint8_t version = 1;
+    static constexpr size_t headerSize = 5;
+    static constexpr size_t recordHeaderSize = 17;
+
+    struct Record
+    {
+        uint8_t type = 0;
+        uint64_t sequence = 0;
+        juce::MemoryBlock data;
+
+        // Track- und Takt-Records: unveränderliche Daten, encode() serialisiert im Autosave-Thread
+        int trackIndex = 0;
+        int numMeasures = 0;
+        std::shared_ptr<const TabTrack> track;
+        TabUndoHistory::MeasureList measures;
+    };
+
+    SnapshotSource snapshotSource;
+    NotesSource notesSource;
+
+    juce::String sessionId;
+    juce::String claimedSessionId;   // in getLiveSessions() eingetragen, bis stop()
+    juce::File journalFile;
+    std::unique_ptr<juce::FileOutputStream> stream;
+    juce::int64 baseSize = 0;
+
+    juce::CriticalSection pendingLock;
+    std::vector<Record> pending;
+    PluginStateCodec::Snapshot recoveredState;
+    std::atomic<uint64_t> postedSequence { 0 };
+
+    std::atomic<bool> needsRecoveryCheck { false };
+    std::atomic<bool> needsRebase { false };
+    std::atomic<bool> recoveryAvailable { false };
+
+    //==========================================================================
+    // Session-IDs der laufenden Instanzen im Prozess
+
+    struct LiveSessions
+    {
+        juce::CriticalSection lock;
+        std::set<juce::String> ids;
+    };
+
+    static LiveSessions& getLiveSessions()
+    {
+        static LiveSessions sessions;
+        return sessions;
+    }
+
+    static bool claimSessionId(const juce::String& id)
+    {
+        auto& sessions = getLiveSessions();
+        const juce::ScopedLock sl(sessions.lock);
+        return sessions.ids.insert(id).second;
+    }
+
+    static void releaseSessionId(const juce::String& id)
+    {
+        if (id.isEmpty())
+            return;
+
+        auto& sessions = getLiveSessions();
+        const juce::ScopedLock sl(sessions.lock);
+        sessions.ids.erase(id);
+    }
+
+    void post(uint8_t type, juce::MemoryBlock data)
+    {
+        Record record;
+        record.type = type;
+        record.data = std::move(data);
+        post(std::move(record));
+    }
+
+    void post(Record record)
+    {
+        const juce::ScopedLock sl(pendingLock);
+        record.sequence = ++postedSequence;
+        pending.push_back(std::move(record));
+    }
+
+    /** Serialisiert Track- und Takt-Records (Autosave-Thread, ohne Sperre des Aufrufers). */
+    static void encode(Record& record)
+    {
+        if (record.type == recordTrack && record.track != nullptr)
+        {
+            PluginStateCodec::Snapshot snapshot;
+            snapshot.editedTracks[record.trackIndex] = *record.track;
+            PluginStateCodec::write(snapshot, record.data, false);
+            record.track.reset();
+        }
+        else if (record.type == recordMeasures && ! record.measures.empty())
+        {
+            PluginStateCodec::Snapshot snapshot;
+            auto& track = snapshot.editedTracks[record.trackIndex];
+            track.measures.ensureStorageAllocated((int) record.measures.size());
+
+            juce::MemoryOutputStream out;
+            out.writeCompressedInt(record.trackIndex);
+            out.writeCompressedInt(record.numMeasures);
+            out.writeCompressedInt((int) record.measures.size());
+            for (const auto& [index, measure] : record.measures)
+            {
+                out.writeCompressedInt(index);
+                track.measures.add(*measure);
+            }
+
+            juce::MemoryBlock data;
+            PluginStateCodec::write(snapshot, data, false);
+            out.write(data.getData(), data.getSize());
+            record.data = out.getMemoryBlock();
+            record.measures.clear();
+        }
+    }
+
+    void run() override
+    {
+        removeStaleJournals();
+
+        while (! threadShouldExit())
+        {
+            if (needsRecoveryCheck.exchange(false))
+                checkForRecovery();
+
+            if (! recoveryAvailable.load())
+            {
+                if (needsRebase.exchange(false))
+                    rebase();
+                else
+                    appendPending();
+            }
+
+            wait(flushIntervalMs);
+        }
+
+        // Beim Beenden Ausstehendes noch sichern
+        if (! recoveryAvailable.load() && ! needsRebase.load())
+            appendPending();
+    }
+
+    void checkForRecovery()
+    {
+        PluginStateCodec::Snapshot recovered;
+        if (! replay(journalFile, recovered))
+        {
+            rebase();
+            return;
+        }
+
+        uint64_t sequence = 0;
+        juce::MemoryBlock journalData, currentData;
+        PluginStateCodec::write(recovered, journalData, false);
+        PluginStateCodec::write(snapshotSource(sequence), currentData, false);
+
+        if (journalData == currentData)
+        {
+            rebase();
+            return;
+        }
+
+        {
+            const juce::ScopedLock sl(pendingLock);
+            recoveredState = std::move(recovered);
+        }
+        recoveryAvailable.store(true);
+        DBG("SessionAutosave: unsaved changes found in " << journalFile.getFullPathName());
+    }
+
+    /** Neue Basis aus dem aktuellen Stand, atomar über eine temporäre Datei. */
+    void rebase()
+    {
+        stream.reset();
+
+        uint64_t sequence = 0;
+        juce::MemoryBlock base;
+        PluginStateCodec::write(snapshotSource(sequence), base, true);
+
+        // Alles bis sequence steckt bereits in der Basis
+        {
+            const juce::ScopedLock sl(pendingLock);
+            pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                         [sequence](const Record& r) { return r.sequence <= sequence; }),
+                          pending.end());
+        }
+
+        if (! journalFile.getParentDirectory().createDirectory())
+        {
+            DBG("SessionAutosave: cannot create " << journalFile.getParentDirectory().getFullPathName());
+            return;
+        }
+
+        juce::TemporaryFile temp(journalFile);
+        {
+            juce::FileOutputStream out(temp.getFile());
+            if (! out.openedOk())
+                return;
+
+            out.write(magic, 4);
+            out.writeByte((char) version);
+            Record record;
+            record.type = recordBase;
+            record.sequence = sequence;
+            record.data = std::move(base);
+            writeRecord(out, record);
+            out.flush();
+        }
+
+        if (! temp.overwriteTargetFileWithTemporary())
+        {
+            DBG("SessionAutosave: rebase failed for " << journalFile.getFullPathName());
+            return;
+        }
+
+        baseSize = journalFile.getSize();
+        if (openForAppend())
+            appendPending();
+    }
+
+    void appendPending()
+    {
+        std::vector<Record> records;
+        {
+            const juce::ScopedLock sl(pendingLock);
+            records.swap(pending);
+        }
+
+        NotesDelta delta;
+        if (notesSource(delta))
+        {
+            PluginStateCodec::Snapshot snapshot;
+            snapshot.recordedNotes = std::move(delta.notes);
+            snapshot.recordingStartBeat = delta.recordingStartBeat;
+            snapshot.recordingStartSet = delta.recordingStartSet;
+
+            juce::MemoryOutputStream out;
+            out.writeInt64((juce::int64) delta.from);
+            juce::MemoryBlock notes;
+            PluginStateCodec::write(snapshot, notes, true);
+            out.write(notes.getData(), notes.getSize());
+            Record record;
+            record.type = recordNotes;
+            record.sequence = postedSequence.load();
+            record.data = out.getMemoryBlock();
+            records.push_back(std::move(record));
+        }
+
+        if (records.empty())
+            return;
+
+        if (stream == nullptr && ! openForAppend())
+        {
+            // Journal fehlt (gelöscht, Verzeichnis neu) - die Basis enthält alles
+            rebase();
+            return;
+        }
+
+        for (auto& record : records)
+        {
+            encode(record);
+            writeRecord(*stream, record);
+        }
+        stream->flush();
+
+        if (stream->getPosition() > juce::jmax(minCompactBytes, baseSize * compactFactor))
+            rebase();
+    }
+
+    bool openForAppend()
+    {
+        if (! journalFile.existsAsFile())
+            return false;
+
+        stream = std::make_unique<juce::FileOutputStream>(journalFile);
+        if (! stream->openedOk())
+        {
+            stream.reset();
+            return false;
+        }
+        return true;
+    }
+
+    void removeStaleJournals()
+    {
+        const auto cutoff = juce::Time::getCurrentTime() - juce::RelativeTime::days(staleJournalDays);
+        for (const auto& file : getDirectory().findChildFiles(juce::File::findFiles, false, "*.tbj"))
+            if (file != journalFile && file.getLastModificationTime() < cutoff)
+                file.deleteFile();
+    }
+
+    //==========================================================================
+    static void writeRecord(juce::OutputStream& out, const Record& record)
+    {
+        const auto* payload = static_cast<const uint8_t*>(record.data.getData());
+        const auto size = (uint32_t) record.data.getSize();
+
+        out.writeByte((char) record.type);
+        out.writeInt64((juce::int64) record.sequence);
+        out.writeInt((int) size);
+        out.writeInt((int) fnv1a(payload, size));
+        if (size > 0)
+            out.write(payload, size);
+    }
+
+    static void applyRecord(uint8_t type, const uint8_t* payload, size_t size, PluginStateCodec::Snapshot& state)
+    {
+        switch (type)
+        {
+            case recordNotes:
+            {
+                if (size < 8)
+                    return;
+
+                juce::MemoryInputStream in(payload, size, false);
+                const auto from = (size_t) juce::jmax((juce::int64) 0, in.readInt64());
+
+                PluginStateCodec::Snapshot notes;
+                if (! PluginStateCodec::read(payload + 8, size - 8, notes))
+                    return;
+
+                state.recordedNotes.resize(juce::jmin(from, state.recordedNotes.size()));
+                for (auto& note : notes.recordedNotes)
+                    state.recordedNotes.push_back(std::move(note));
+                state.recordingStartBeat = notes.recordingStartBeat;
+                state.recordingStartSet = notes.recordingStartSet;
+                return;
+            }
+
+            case recordTrack:
+            {
+                PluginStateCodec::Snapshot track;
+                if (PluginStateCodec::read(payload, size, track))
+                    for (auto& [index, tabTrack] : track.editedTracks)
+                        state.editedTracks[index] = std::move(tabTrack);
+                return;
+            }
+
+            case recordEdits:
+            {
+                juce::MemoryInputStream in(payload, size, false);
+                const int trackIndex = in.readCompressedInt();
+                const int count = in.readCompressedInt();
+
+                auto track = state.editedTracks.find(trackIndex);
+                for (int i = 0; i < count && ! in.isExhausted(); ++i)
+                {
+                    TabEdit edit;
+                    edit.type = (TabEdit::Type) in.readCompressedInt();
+                    edit.measureIndex = in.readCompressedInt();
+                    edit.beatIndex = in.readCompressedInt();
+                    edit.noteIndex = in.readCompressedInt();
+                    edit.string = in.readCompressedInt();
+                    edit.fret = in.readCompressedInt();
+                    edit.midiNote = in.readCompressedInt();
+                    edit.duration = (NoteDuration) in.readCompressedInt();
+                    edit.dotted = in.readByte() != 0;
+
+                    if (track != state.editedTracks.end())
+                        TabEditJournal::apply(track->second, edit);
+                }
+                return;
+            }
+
+            case recordClearTracks:
+                state.editedTracks.clear();
+                return;
+
+            case recordMeasures:
+            {
+                juce::MemoryInputStream in(payload, size, false);
+                const int trackIndex = in.readCompressedInt();
+                const int numMeasures = in.readCompressedInt();
+                const int count = in.readCompressedInt();
+
+                std::vector<int> indices;
+                for (int i = 0; i < count && ! in.isExhausted(); ++i)
+                    indices.push_back(in.readCompressedInt());
+
+                const auto offset = (size_t) in.getPosition();
+                PluginStateCodec::Snapshot measures;
+                auto track = state.editedTracks.find(trackIndex);
+                if (track == state.editedTracks.end() || track->second.measures.size() != numMeasures
+                    || offset > size || ! PluginStateCodec::read(payload + offset, size - offset, measures))
+                    return;
+
+                const auto& replaced = measures.editedTracks[trackIndex].measures;
+                for (int i = 0; i < juce::jmin((int) indices.size(), replaced.size()); ++i)
+                    if (indices[(size_t) i] >= 0 && indices[(size_t) i] < numMeasures)
+                        track->second.measures.getReference(indices[(size_t) i]) = replaced.getReference(i);
+                return;
+            }
+
+            default:
+                return;   // unbekannt (neuerer Build) - überspringen
+        }
+    }
+
+    static uint32_t readUInt32(const uint8_t* p)
+    {
+        return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+    }
+
+    static uint32_t fnv1a(const uint8_t* data, size_t size)
+    {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ data[i]) * 16777619u;
+        return hash;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SessionAutosave)
+};
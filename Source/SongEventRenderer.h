@@ -0,0 +1,523 @@
+/*
+  ==============================================================================
+
+    SongEventRenderer.h
+
+    Gemeinsame Umsetzung von Tabs (GP5Track oder TabTrack) in MIDI für die
+    Echtzeit-Wiedergabe und den MIDI-Export.
+
+    Eine einzige Stelle für Beat-Dauern (inkl. Tuplets), Beat-Suche im Takt,
+    Tonhöhe aus Saite/Bund, Velocity mit Effekten und Track-Lautstärke,
+    Expression-Controller und Bend-Verläufe.
+
+    - processBlock rendert den Beat an der Host-Position (der Host kann
+      jederzeit springen) über forEachNote() / emitNoteStart() / bendValueAt().
+    - Der Export rendert einen Track in einem linearen Durchlauf zu einem
+      zeitlich sortierten Event-Strom (renderTrack) - mit denselben Regeln,
+      wann Noten enden (beim nächsten gespielten Beat) und welche Beats im
+      Takt überhaupt erreicht werden. Damit klingt die Datei wie die
+      Wiedergabe.
+
+    Alle Funktionen sind zustandslos und thread-safe (Tracks nur lesend).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "GP5Parser.h"
+#include "TabModels.h"
+#include "GuitarTuning.h"
+#include <cmath>
+#include <vector>
+
+//==============================================================================
+/**
+ * SongEventRenderer
+ */
+class SongEventRenderer
+{
+public:
+    static constexpr int maxBendPoints = 16;
+    static constexpr int centrePitchWheel = 8192;
+
+    /** Eine gespielte Note eines Beats (Velocity bereits mit Effekten und Lautstärke). */
+    struct Note
+    {
+        int midiNote = 0;
+        int velocity = 95;
+        bool vibrato = false;
+        bool hammerOn = false;
+        bool slide = false;
+
+        bool bend = false;
+        int bendType = 0;      // wie GP5Note::bendType (1=Bend, 2=Bend+Release, 3=Release, 4=Pre-Bend, 5=Pre-Bend+Release)
+        int bendValue = 0;     // Maximum in 1/100 Halbtönen
+        int pointCount = 0;
+        GP5BendPoint points[maxBendPoints];
+
+        bool hasMovingBend() const noexcept { return bend && bendType != 4; }   // 4 = statischer Pre-Bend
+    };
+
+    /** Ein Event des Export-Stroms; beat in Vierteln ab Songbeginn. */
+    struct Event
+    {
+        double beat = 0.0;
+        juce::MidiMessage message;
+    };
+
+    struct RenderedTrack
+    {
+        std::vector<Event> events;   // zeitlich sortiert
+        double endBeat = 0.0;        // Ende des letzten Takts
+    };
+
+    //==========================================================================
+    // Timing
+
+    /** Dauer eines GP5-Beats in Vierteln (Punktierung, Tuplets N in 2/4/8). */
+    static double beatDuration(const GP5Beat& beat)
+    {
+        // GP5 duration: -2=whole, -1=half, 0=quarter, 1=eighth, 2=sixteenth, 3=32nd
+        double duration = 4.0 / std::pow(2.0, beat.duration + 2);
+
+        if (beat.isDotted)
+            duration *= 1.5;
+
+        switch (beat.tupletN)
+        {
+            case 3:  duration *= (2.0 / 3.0); break;  // Triole: 3 in 2
+            case 5:  duration *= (4.0 / 5.0); break;  // Quintole: 5 in 4
+            case 6:  duration *= (4.0 / 6.0); break;  // Sextole: 6 in 4
+            case 7:  duration *= (4.0 / 7.0); break;  // Septole: 7 in 4
+            case 9:  duration *= (8.0 / 9.0); break;
+            case 10: duration *= (8.0 / 10.0); break;
+            case 11: duration *= (8.0 / 11.0); break;
+            case 12: duration *= (8.0 / 12.0); break;
+            case 13: duration *= (8.0 / 13.0); break;
+            default: break;
+        }
+        return duration;
+    }
+
+    static double beatDuration(const TabBeat& beat) { return beat.getDurationInQuarters(); }
+
+    static double measureLength(int numerator, int denominator)
+    {
+        return numerator * (4.0 / (denominator > 0 ? denominator : 4));
+    }
+
+    /**
+     * Index des Beats, der bei beatInMeasure klingt. Hinter dem letzten Beat
+     * bleibt der letzte aktiv (unvollständige Takte). beatStart = Start im Takt.
+     */
+    template <typename BeatArray>
+    static int findBeatAt(const BeatArray& beats, double beatInMeasure, double& beatStart)
+    {
+        double start = 0.0;
+        for (int i = 0; i < beats.size(); ++i)
+        {
+            const double duration = beatDuration(beats.getReference(i));
+            if (beatInMeasure < start + duration)
+            {
+                beatStart = start;
+                return i;
+            }
+            start += duration;
+        }
+
+        if (beats.size() > 0)
+        {
+            beatStart = start - beatDuration(beats.getReference(beats.size() - 1));
+            return beats.size() - 1;
+        }
+
+        beatStart = 0.0;
+        return 0;
+    }
+
+    //==========================================================================
+    // Noten eines Beats
+
+    static int applyVelocityEffects(int velocity, bool ghost, bool accent, bool heavyAccent,
+                                    bool hammerOn, int volumeScale)
+    {
+        if (velocity <= 0) velocity = 95;
+        if (ghost) velocity = 50;
+        if (accent) velocity = 115;
+        if (heavyAccent) velocity = 127;
+        if (hammerOn) velocity = juce::jmax(50, velocity - 15);
+        velocity = (velocity * volumeScale) / 100;
+        return juce::jlimit(1, 127, velocity);
+    }
+
+    /** Ruft fn(const Note&) für jede gespielte Note eines GP5-Beats auf (tote/gehaltene übersprungen). */
+    template <typename Fn>
+    static void forEachNote(const GP5Track& track, const GP5Beat& beat, int volumeScale,
+                            const GuitarTuning& fallbackTuning, Fn&& fn)
+    {
+        if (beat.isRest)
+            return;
+
+        for (const auto& [stringIndex, gpNote] : beat.notes)
+        {
+            if (gpNote.isDead || gpNote.isTied || stringIndex < 0 || stringIndex >= 12)
+                continue;
+
+            int midiNote = 0;
+            if (stringIndex < track.tuning.size())
+                midiNote = track.tuning[stringIndex] + gpNote.fret;
+            else if (stringIndex < fallbackTuning.getStringCount())
+                midiNote = fallbackTuning.getMidiNote(stringIndex, gpNote.fret);
+
+            if (midiNote <= 0 || midiNote >= 128)
+                continue;
+
+            Note note;
+            note.midiNote = midiNote;
+            note.velocity = applyVelocityEffects(gpNote.velocity, gpNote.isGhost, gpNote.hasAccent,
+                                                 gpNote.hasHeavyAccent, gpNote.hasHammerOn, volumeScale);
+            note.vibrato = gpNote.hasVibrato;
+            note.hammerOn = gpNote.hasHammerOn;
+            note.slide = gpNote.hasSlide;
+
+            if (gpNote.hasBend && gpNote.bendValue != 0)
+            {
+                note.bend = true;
+                note.bendType = gpNote.bendType;
+                note.bendValue = gpNote.bendValue;
+                note.pointCount = juce::jmin((int) gpNote.bendPoints.size(), maxBendPoints);
+                for (int i = 0; i < note.pointCount; ++i)
+                    note.points[i] = gpNote.bendPoints[(size_t) i];
+            }
+
+            fn(note);
+        }
+    }
+
+    /** Wie oben für TabTrack-Beats (editierte und aufgenommene Tracks), tote Noten übersprungen. */
+    template <typename Fn>
+    static void forEachNote(const TabTrack& track, const TabBeat& beat, int volumeScale,
+                            const GuitarTuning& fallbackTuning, Fn&& fn)
+    {
+        if (beat.isRest)
+            return;
+
+        for (const auto& tabNote : beat.notes)
+        {
+            if (tabNote.fret < 0 || tabNote.isTied || tabNote.effects.deadNote)
+                continue;
+
+            int midiNote = 0;
+            if (tabNote.midiNote > 0)
+                midiNote = tabNote.midiNote;
+            else if (tabNote.string >= 0 && tabNote.string < track.tuning.size())
+                midiNote = track.tuning[tabNote.string] + tabNote.fret;
+            else if (tabNote.string >= 0 && tabNote.string < fallbackTuning.getStringCount())
+                midiNote = fallbackTuning.getMidiNote(tabNote.string, tabNote.fret);
+
+            if (midiNote <= 0 || midiNote >= 128)
+                continue;
+
+            const auto& effects = tabNote.effects;
+            Note note;
+            note.midiNote = midiNote;
+            note.velocity = applyVelocityEffects(tabNote.velocity, effects.ghostNote, effects.accentuatedNote,
+                                                 effects.heavyAccentuatedNote, effects.hammerOn, volumeScale);
+            note.vibrato = effects.vibrato || effects.wideVibrato;
+            note.hammerOn = effects.hammerOn;
+            note.slide = effects.slideType != SlideType::None;
+
+            if (effects.bend && effects.bendValue != 0.0f)
+            {
+                note.bend = true;
+                note.bendType = effects.bendType;
+                note.bendValue = (int) (effects.bendValue * 100.0f);
+                note.pointCount = juce::jmin((int) effects.bendPoints.size(), maxBendPoints);
+                for (int i = 0; i < note.pointCount; ++i)
+                {
+                    const auto& point = effects.bendPoints[(size_t) i];
+                    note.points[i] = { point.position, point.value, point.vibrato };
+                }
+            }
+
+            fn(note);
+        }
+    }
+
+    //==========================================================================
+    // MIDI
+
+    /** ±2 Halbtöne Pitch-Wheel-Bereich. */
+    static int toPitchWheel(int bendValue)
+    {
+        constexpr double unitsPerSemitone = 8192.0 / 2.0;
+        return juce::jlimit(0, 16383, centrePitchWheel + (int) ((bendValue / 100.0) * unitsPerSemitone));
+    }
+
+    /** Pitch-Wheel beim Anschlag: Release/Pre-Bend starten gebogen. */
+    static int initialPitchWheel(const Note& note)
+    {
+        switch (note.bendType)
+        {
+            case 3: case 4: case 5: return toPitchWheel(note.bendValue);
+            default:                return centrePitchWheel;
+        }
+    }
+
+    /**
+     * Expression-Controller, Start-Pitchbend und Note-On einer Note in der
+     * Reihenfolge der Wiedergabe. add(const juce::MidiMessage&).
+     */
+    template <typename Fn>
+    static void emitNoteStart(const Note& note, int midiChannel, Fn&& add)
+    {
+        if (note.vibrato)
+            add(juce::MidiMessage::controllerEvent(midiChannel, 1, 80));
+        if (note.hammerOn)
+            add(juce::MidiMessage::controllerEvent(midiChannel, 68, 127));
+        if (note.slide)
+        {
+            add(juce::MidiMessage::controllerEvent(midiChannel, 65, 127));
+            add(juce::MidiMessage::controllerEvent(midiChannel, 5, 64));
+        }
+        if (note.bend)
+            add(juce::MidiMessage::pitchWheel(midiChannel, initialPitchWheel(note)));
+
+        add(juce::MidiMessage::noteOn(midiChannel, note.midiNote, (juce::uint8) note.velocity));
+    }
+
+    /**
+     * Bend-Wert (1/100 Halbtöne) bei progress 0..1 der Notendauer, inkl. Vibrato
+     * der Bend-Punkte. beat ist die Songposition (Vibrato-Phase).
+     */
+    static int bendValueAt(int bendType, int maxBendValue, const GP5BendPoint* points, int pointCount,
+                           double progress, double beat)
+    {
+        progress = juce::jlimit(0.0, 1.0, progress);
+        const int positionInBend = (int) (progress * 60.0);   // GP5-Skala 0..60
+
+        int value = 0;
+        int vibrato = 0;   // 0=keins, 1=schnell, 2=mittel, 3=langsam/weit
+
+        // Einzelner Punkt oder keine Punkte: Verlauf aus dem Bend-Typ
+        auto shaped = [bendType, progress](int target)
+        {
+            if (bendType == 1)
+                return (int) (target * progress);
+            if (bendType == 2)
+                return (int) (target * (progress < 0.5 ? progress * 2.0 : (1.0 - progress) * 2.0));
+            if (bendType == 3 || bendType == 5)
+                return (int) (target * (1.0 - progress));
+            return target;
+        };
+
+        if (pointCount >= 2)
+        {
+            int prevIdx = 0;
+            int nextIdx = pointCount - 1;
+            for (int i = 0; i < pointCount; ++i)
+                if (points[i].position <= positionInBend)
+                    prevIdx = i;
+            for (int i = pointCount - 1; i >= 0; --i)
+                if (points[i].position >= positionInBend)
+                    nextIdx = i;
+            if (nextIdx < prevIdx)
+                nextIdx = prevIdx;
+
+            const auto& prev = points[prevIdx];
+            const auto& next = points[nextIdx];
+            vibrato = prev.vibrato;
+
+            if (prev.position == next.position)
+            {
+                value = prev.value;
+            }
+            else
+            {
+                const double t = juce::jlimit(0.0, 1.0, (double) (positionInBend - prev.position)
+                                                        / (double) (next.position - prev.position));
+                value = (int) (prev.value + t * (next.value - prev.value));
+            }
+        }
+        else if (pointCount == 1)
+        {
+            vibrato = points[0].vibrato;
+            value = shaped(points[0].value);
+        }
+        else
+        {
+            value = shaped(maxBendValue);
+        }
+
+        if (vibrato > 0)
+        {
+            const double depth = vibrato == 1 ? 25.0 : vibrato == 2 ? 50.0 : 100.0;
+            value += (int) (std::sin(beat * 30.0) * depth);   // ~5 Hz bei 120 BPM
+        }
+        return value;
+    }
+
+    //==========================================================================
+    // Export-Strom
+
+    /** Schrittweite der Bend-Kurve im Export und Schwelle wie in der Wiedergabe. */
+    static constexpr double bendStepBeats = 1.0 / 32.0;
+    static constexpr int pitchWheelThreshold = 50;
+
+    /** GP5-Track mit Taktlängen aus den Measure-Headern (geladene Dateien). */
+    static RenderedTrack renderTrack(const GP5Track& track, const juce::Array<GP5MeasureHeader>& headers,
+                                     int midiChannel, int volumeScale, const GuitarTuning& fallbackTuning)
+    {
+        const int numMeasures = juce::jmin(track.measures.size(), headers.size());
+        return render(numMeasures,
+                      [&](int m) { return measureLength(headers.getReference(m).numerator, headers.getReference(m).denominator); },
+                      [&](int m) -> const juce::Array<GP5Beat>& { return track.measures.getReference(m).voice1; },
+                      [&](const GP5Beat& beat, auto&& fn) { forEachNote(track, beat, volumeScale, fallbackTuning, fn); },
+                      midiChannel);
+    }
+
+    /** Editierter Track einer geladenen Datei: Takte wie die Header, Beats aus dem TabTrack. */
+    static RenderedTrack renderTrack(const TabTrack& track, const juce::Array<GP5MeasureHeader>& headers,
+                                     int midiChannel, int volumeScale, const GuitarTuning& fallbackTuning)
+    {
+        const int numMeasures = juce::jmin(track.measures.size(), headers.size());
+        return render(numMeasures,
+                      [&](int m) { return measureLength(headers.getReference(m).numerator, headers.getReference(m).denominator); },
+                      [&](int m) -> const juce::Array<TabBeat>& { return track.measures.getReference(m).beats; },
+                      [&](const TabBeat& beat, auto&& fn) { forEachNote(track, beat, volumeScale, fallbackTuning, fn); },
+                      midiChannel);
+    }
+
+    /** TabTrack mit eigener Taktart pro Takt (Aufnahme). */
+    static RenderedTrack renderTrack(const TabTrack& track, int midiChannel, int volumeScale,
+                                     const GuitarTuning& fallbackTuning)
+    {
+        return render(track.measures.size(),
+                      [&](int m) { const auto& measure = track.measures.getReference(m);
+                                   return measureLength(measure.timeSignatureNumerator, measure.timeSignatureDenominator); },
+                      [&](int m) -> const juce::Array<TabBeat>& { return track.measures.getReference(m).beats; },
+                      [&](const TabBeat& beat, auto&& fn) { forEachNote(track, beat, volumeScale, fallbackTuning, fn); },
+                      midiChannel);
+    }
+
+    /** Hängt einen Strom an eine Sequenz an (Zeitstempel in Ticks). */
+    static void appendToSequence(const RenderedTrack& rendered, juce::MidiMessageSequence& sequence, double ticksPerQuarter)
+    {
+        for (const auto& event : rendered.events)
+            sequence.addEvent(event.message, event.beat * ticksPerQuarter);
+    }
+
+private:
+    /**
+     * Linearer Durchlauf wie die Wiedergabe: Ein Beat beginnt, wenn die Position
+     * ihn erreicht (Beats hinter dem Taktende werden nie gespielt), und beendet
+     * die Noten des vorherigen gespielten Beats. Bends laufen über die Beat-Dauer.
+     */
+    template <typename LengthFn, typename BeatsFn, typename NotesFn>
+    static RenderedTrack render(int numMeasures, LengthFn&& lengthOf, BeatsFn&& beatsOf, NotesFn&& notesOf, int midiChannel)
+    {
+        RenderedTrack result;
+        auto& events = result.events;
+
+        std::vector<int> sounding;
+        int currentPitch = centrePitchWheel;
+
+        // Laufende Bend-Kurve (nur eine pro Kanal, wie ein Pitch-Wheel)
+        Note bend;
+        double bendStart = 0.0, bendDuration = 0.0, bendCursor = 0.0;
+        bool bendActive = false;
+
+        auto add = [&](double beat, const juce::MidiMessage& message) { events.push_back({ beat, message }); };
+
+        auto setPitch = [&](double beat, int pitch)
+        {
+            if (pitch != currentPitch)
+                add(beat, juce::MidiMessage::pitchWheel(midiChannel, pitch));
+            currentPitch = pitch;
+        };
+
+        // Bend-Kurve bis (ausschließlich) time ausgeben
+        auto advanceBendTo = [&](double time)
+        {
+            if (!bendActive)
+                return;
+
+            const double bendEnd = bendStart + bendDuration;
+            for (; bendCursor < juce::jmin(time, bendEnd); bendCursor += bendStepBeats)
+            {
+                const int value = bendValueAt(bend.bendType, bend.bendValue, bend.points, bend.pointCount,
+                                              (bendCursor - bendStart) / bendDuration, bendCursor);
+                const int pitch = toPitchWheel(value);
+                if (std::abs(pitch - currentPitch) > pitchWheelThreshold)
+                    setPitch(bendCursor, pitch);
+            }
+
+            if (bendEnd <= time)
+            {
+                setPitch(bendEnd, centrePitchWheel);
+                bendActive = false;
+            }
+        };
+
+        double measureStart = 0.0;
+        for (int m = 0; m < numMeasures; ++m)
+        {
+            const double length = lengthOf(m);
+            const auto& beats = beatsOf(m);
+
+            double beatStart = measureStart;
+            for (int b = 0; b < beats.size(); ++b)
+            {
+                // Die Wiedergabe erreicht nur Beats, die vor dem Taktende beginnen
+                if (b > 0 && beatStart >= measureStart + length)
+                    break;
+
+                const auto& beat = beats.getReference(b);
+                const double duration = beatDuration(beat);
+
+                advanceBendTo(beatStart);
+
+                for (int noteNumber : sounding)
+                    add(beatStart, juce::MidiMessage::noteOff(midiChannel, noteNumber));
+                sounding.clear();
+
+                if (!bendActive)
+                    setPitch(beatStart, centrePitchWheel);
+
+                notesOf(beat, [&](const Note& note)
+                {
+                    emitNoteStart(note, midiChannel, [&](const juce::MidiMessage& message)
+                    {
+                        if (message.isPitchWheel())
+                            setPitch(beatStart, message.getPitchWheelValue());
+                        else
+                            add(beatStart, message);
+                    });
+                    sounding.push_back(note.midiNote);
+
+                    if (note.hasMovingBend() && !bendActive && duration > 0.0)
+                    {
+                        bend = note;
+                        bendStart = bendCursor = beatStart;
+                        bendDuration = duration;
+                        bendActive = true;
+                    }
+                });
+
+                beatStart += duration;
+            }
+
+            measureStart += length;
+        }
+
+        result.endBeat = measureStart;
+        advanceBendTo(result.endBeat);
+        for (int noteNumber : sounding)
+            add(result.endBeat, juce::MidiMessage::noteOff(midiChannel, noteNumber));
+        setPitch(result.endBeat, centrePitchWheel);
+
+        return result;
+    }
+};
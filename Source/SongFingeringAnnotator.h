@@ -0,0 +1,263 @@
+/*
+  ==============================================================================
+
+    SongFingeringAnnotator.h
+
+    Hintergrund-Annotation geladener Songs (GP/PTB/MIDI) mit Fingernummern
+    und Akkordnamen.
+
+    Nach dem Laden einer Datei konvertiert ein eigener Thread alle Tracks in
+    TabTracks und annotiert sie - die Tracks parallel auf dem Worker-Pool.
+    Fertige Tracks landen in einem Cache und werden über getTrack() an die
+    UI ausgeliefert; der Message-Thread wartet nie auf die Analyse.
+
+    - Akkorde (2+ gegriffene Noten in einem Beat): ChordFingerDB (Griffe für
+      die sechs hohen Saiten), sonst algorithmisch (calculateFingersForChord,
+      bis GuitarTuning::maxStrings Saiten - 7/8-Saiter und Bass). Fehlt ein Akkordname und
+      sind es mindestens 3 Noten, wird er über ChordNaming ergänzt.
+    - Einzelnoten: Distance/String-Change/Little-Finger-Regeln
+      (calculateFingerForNote) mit dem vorherigen Griff als Kontext.
+    - Vorhandene Fingersätze aus der Datei bleiben unverändert.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "TabModels.h"
+#include "ChordFingerDB.h"
+#include "ChordNaming.h"
+#include "ChannelWorkerPool.h"
+#include "GuitarTuning.h"
+#include <atomic>
+#include <functional>
+#include <vector>
+
+//==============================================================================
+/**
+ * SongFingeringAnnotator
+ */
+class SongFingeringAnnotator : private juce::Thread
+{
+public:
+    /** Liefert den (nicht annotierten) TabTrack für einen Track-Index. */
+    using TrackSource = std::function<TabTrack(int trackIndex)>;
+
+    /** Drum-Tracks (MIDI-Kanal 10) werden nicht annotiert. */
+    static constexpr int drumChannel = 9;
+
+    SongFingeringAnnotator(const ChordFingerDB& fingerDB, ChannelWorkerPool& workerPool)
+        : juce::Thread("SongFingeringAnnotator"),
+          chordFingerDB(fingerDB),
+          pool(workerPool)
+    {
+    }
+
+    ~SongFingeringAnnotator() override
+    {
+        cancel();
+    }
+
+    /**
+     * Startet die Annotation eines neu geladenen Songs. Ein laufender Durchlauf
+     * wird vorher abgebrochen. source wird im Hintergrund aufgerufen und darf
+     * nur lesen; der Aufrufer muss cancel() aufrufen, bevor sich die Quelle
+     * ändert (neue Datei, Entladen).
+     */
+    void start(int numTracks, TrackSource source)
+    {
+        cancel();
+        cancelRequested.store(false, std::memory_order_release);
+
+        {
+            const juce::ScopedLock sl(cacheLock);
+            cachedTracks.assign((size_t) juce::jmax(0, numTracks), TabTrack());
+            trackReady.assign((size_t) juce::jmax(0, numTracks), false);
+            cachedBytes = MemoryAccounting::bytesOf(cachedTracks);
+            cacheMemory.setBytes(cachedBytes);
+        }
+
+        trackSource = std::move(source);
+        if (numTracks > 0)
+            startThread(juce::Thread::Priority::low);
+    }
+
+    /**
+     * Bricht die Annotation ab und leert den Cache. Wartet ohne Timeout, bis der
+     * Thread und alle seine Pool-Jobs fertig sind - danach ruft niemand mehr die
+     * Quelle auf und der Aufrufer darf die Parser neu befüllen. Wartende Jobs
+     * starten nicht mehr, laufende enden nach ihrem aktuellen Track.
+     */
+    void cancel()
+    {
+        cancelRequested.store(true, std::memory_order_release);
+        stopThread(-1);
+        trackSource = nullptr;
+
+        const juce::ScopedLock sl(cacheLock);
+        cachedTracks.clear();
+        trackReady.clear();
+        cachedBytes = 0;
+        cacheMemory.setBytes(0);
+    }
+
+    /** Annotierten Track aus dem Cache holen; false solange er noch nicht fertig ist. */
+    bool getTrack(int trackIndex, TabTrack& out) const
+    {
+        const juce::ScopedLock sl(cacheLock);
+        if (trackIndex < 0 || trackIndex >= (int) trackReady.size() || ! trackReady[(size_t) trackIndex])
+            return false;
+
+        out = cachedTracks[(size_t) trackIndex];
+        return true;
+    }
+
+    /** Zählt bei jedem fertig annotierten Track hoch (UI-Refresh). */
+    uint32_t getGeneration() const { return generation.load(std::memory_order_acquire); }
+
+    //==========================================================================
+    /** Annotiert einen Track in-place (reine Funktion, auch ohne Thread nutzbar). */
+    static void annotateTrack(TabTrack& track, const ChordFingerDB& fingerDB)
+    {
+        if (track.midiChannel == drumChannel)
+            return;
+
+        // Kontext für Einzelnoten über Beat- und Taktgrenzen hinweg
+        int previousFret = -1, previousFinger = -1, previousString = -1;
+
+        const int numStrings = juce::jlimit(1, GuitarTuning::maxStrings,
+                                            track.tuning.isEmpty() ? 6 : track.tuning.size());
+
+        std::vector<int> midiNotes;
+        for (auto& measure : track.measures)
+        {
+            for (auto& beat : measure.beats)
+            {
+                if (beat.isRest)
+                    continue;
+
+                std::array<int, GuitarTuning::maxStrings> chordFrets;
+                chordFrets.fill(-1);
+                int numFretted = 0;
+                int singleIndex = -1;
+                midiNotes.clear();
+
+                for (int i = 0; i < beat.notes.size(); ++i)
+                {
+                    const auto& note = beat.notes.getReference(i);
+                    if (note.fret < 0 || note.effects.deadNote)
+                        continue;
+
+                    ++numFretted;
+                    singleIndex = i;
+                    if (note.string >= 0 && note.string < numStrings)
+                        chordFrets[(size_t) note.string] = note.fret;
+
+                    const int midiNote = midiNoteFor(track, note);
+                    if (midiNote >= 0)
+                        midiNotes.push_back(midiNote);
+                }
+
+                if (numFretted == 0)
+                    continue;
+
+                if (numFretted == 1)
+                {
+                    auto& note = beat.notes.getReference(singleIndex);
+                    // Gehaltene Noten (Tie) übernehmen den Finger des Anschlags
+                    if (note.fingerNumber < 0)
+                        note.fingerNumber = note.isTied ? ((note.fret == 0) ? 0 : previousFinger)
+                                                        : ChordFingerDB::calculateFingerForNote(note.fret, note.string,
+                                                                                                previousFret, previousFinger,
+                                                                                                previousString);
+
+                    previousFret = note.fret;
+                    previousFinger = note.fingerNumber;
+                    previousString = note.string;
+                    continue;
+                }
+
+                // Akkord: fehlenden Namen ergänzen, dann Fingersatz aus DB oder algorithmisch
+                if (beat.chordName.isEmpty() && midiNotes.size() >= 3)
+                    beat.chordName = ChordNaming::nameFor(midiNotes);
+
+                const auto fingers = fingerDB.findOrCalculateFingers(beat.chordName, chordFrets, numStrings);
+
+                for (auto& note : beat.notes)
+                {
+                    if (note.fingerNumber < 0 && note.fret >= 0 && note.string >= 0 && note.string < numStrings)
+                        note.fingerNumber = (note.fret == 0) ? 0 : fingers[(size_t) note.string];
+                }
+
+                // Nach einem Akkord gibt es keinen sinnvollen Einzelnoten-Kontext
+                previousFret = previousFinger = previousString = -1;
+            }
+        }
+    }
+
+private:
+    const ChordFingerDB& chordFingerDB;
+    ChannelWorkerPool& pool;
+    TrackSource trackSource;
+
+    juce::CriticalSection cacheLock;
+    std::vector<TabTrack> cachedTracks;
+    std::vector<bool> trackReady;
+    std::atomic<uint32_t> generation { 0 };
+    std::atomic<bool> cancelRequested { false };   // für runAll: wartende Jobs überspringen
+
+    size_t cachedBytes = 0;   // unter cacheLock
+    MemoryAccount cacheMemory { MemoryAccounting::annotatedTracks };
+
+    static int midiNoteFor(const TabTrack& track, const TabNote& note)
+    {
+        if (note.midiNote >= 0)
+            return note.midiNote;
+        if (note.string < 0 || note.string >= track.tuning.size())
+            return -1;
+        // Bünde sind absolut (wie bei der Wiedergabe), Capo nicht addieren
+        return track.tuning[note.string] + note.fret;
+    }
+
+    void run() override
+    {
+        int numTracks = 0;
+        {
+            const juce::ScopedLock sl(cacheLock);
+            numTracks = (int) cachedTracks.size();
+        }
+
+        const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+        pool.runAll(numTracks, [this](int trackIndex)
+        {
+            if (threadShouldExit())
+                return;
+
+            TabTrack track = trackSource(trackIndex);
+            annotateTrack(track, chordFingerDB);
+
+            if (threadShouldExit())
+                return;
+
+            const auto trackBytes = getHeapBytes(track);
+            {
+                const juce::ScopedLock sl(cacheLock);
+                if (trackIndex < (int) cachedTracks.size())
+                {
+                    cachedTracks[(size_t) trackIndex] = std::move(track);
+                    trackReady[(size_t) trackIndex] = true;
+                    cachedBytes += trackBytes;
+                    cacheMemory.setBytes(cachedBytes);
+                }
+            }
+            generation.fetch_add(1, std::memory_order_acq_rel);
+        }, &cancelRequested);
+
+        DBG("SongFingeringAnnotator: " << numTracks << " tracks annotated in "
+            << juce::String(juce::Time::getMillisecondCounterHiRes() - startMs, 1) << " ms");
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SongFingeringAnnotator)
+};
@@ -0,0 +1,463 @@
+/*
+  ==============================================================================
+
+    TabEditJournal.h
+
+    Typisierte Edit-Befehle für TabTracks (Bund/Saite, Tonhöhe, Dauer,
+    Löschen, Einfügen) und ein Journal der angewendeten Befehle.
+
+    Die TabView erzeugt nur noch Befehle. Der Processor wendet sie auf sein
+    autoritatives Modell (editedTracks) an und protokolliert sie. Views
+    spielen das Journal danach nach (replaySince). Ein Edit kostet damit einen
+    Takt statt einer kompletten Track-Kopie, und Gruppen-Edits gehen als ein
+    Batch über die Thread-Grenze. Undo/Redo landen als ersetzte Takte
+    (ReplaceMeasure) im selben Journal.
+
+    apply() ist deterministisch: derselbe Befehl auf demselben Track liefert
+    überall dasselbe Ergebnis (Modell, Views, Wiedergabe).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "TabModels.h"
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+//==============================================================================
+/** Ein einzelner Edit an einem Beat bzw. einer Note eines TabTracks. */
+struct TabEdit
+{
+    enum class Type
+    {
+        SetPosition,      // Note auf andere Saite/Bund (gleiche Tonhöhe)
+        SetPitch,         // Neue Tonhöhe, Saite/Bund bereits aufgelöst
+        ChangeDuration,   // Beat- oder Pausendauer, füllt/kürzt den Takt
+        DeleteNote,       // Note entfernen (leerer Beat wird Pause)
+        DeleteRest,       // Pause entfernen, Nachbar-Beat verlängern
+        InsertNote,       // Note in eine Pause einfügen
+        ReplaceMeasure    // Takt komplett ersetzen (Undo/Redo), nur vom Modell erzeugt
+    };
+
+    Type type = Type::SetPosition;
+    int measureIndex = -1;
+    int beatIndex = -1;
+    int noteIndex = -1;
+    int string = -1;
+    int fret = -1;
+    int midiNote = -1;
+    NoteDuration duration = NoteDuration::Quarter;
+    bool dotted = false;
+
+    // Von apply() gesetzt: Saite der Note vor dem Edit (für den Abgleich mit recordedNotes)
+    int oldString = -1;
+
+    // ReplaceMeasure: unveränderlicher Stand aus TabUndoHistory, von allen Views geteilt
+    std::shared_ptr<const TabMeasure> measure;
+
+    static TabEdit setPosition(int measure, int beat, int note, int newString, int newFret, int midi)
+    {
+        TabEdit e; e.type = Type::SetPosition;
+        e.measureIndex = measure; e.beatIndex = beat; e.noteIndex = note;
+        e.string = newString; e.fret = newFret; e.midiNote = midi;
+        return e;
+    }
+
+    static TabEdit setPitch(int measure, int beat, int note, int newMidiNote, int newString, int newFret)
+    {
+        TabEdit e; e.type = Type::SetPitch;
+        e.measureIndex = measure; e.beatIndex = beat; e.noteIndex = note;
+        e.string = newString; e.fret = newFret; e.midiNote = newMidiNote;
+        return e;
+    }
+
+    static TabEdit changeDuration(int measure, int beat, NoteDuration newDuration, bool isDotted)
+    {
+        TabEdit e; e.type = Type::ChangeDuration;
+        e.measureIndex = measure; e.beatIndex = beat;
+        e.duration = newDuration; e.dotted = isDotted;
+        return e;
+    }
+
+    static TabEdit deleteNote(int measure, int beat, int note)
+    {
+        TabEdit e; e.type = Type::DeleteNote;
+        e.measureIndex = measure; e.beatIndex = beat; e.noteIndex = note;
+        return e;
+    }
+
+    static TabEdit deleteRest(int measure, int beat)
+    {
+        TabEdit e; e.type = Type::DeleteRest;
+        e.measureIndex = measure; e.beatIndex = beat;
+        return e;
+    }
+
+    static TabEdit insertNote(int measure, int beat, int newString, int newFret, int midi, NoteDuration preferred)
+    {
+        TabEdit e; e.type = Type::InsertNote;
+        e.measureIndex = measure; e.beatIndex = beat;
+        e.string = newString; e.fret = newFret; e.midiNote = midi; e.duration = preferred;
+        return e;
+    }
+
+    static TabEdit replaceMeasure(int measure, std::shared_ptr<const TabMeasure> newMeasure)
+    {
+        TabEdit e; e.type = Type::ReplaceMeasure;
+        e.measureIndex = measure; e.measure = std::move(newMeasure);
+        return e;
+    }
+};
+
+//==============================================================================
+/**
+ * TabEditJournal
+ */
+class TabEditJournal
+{
+public:
+    /** Ältere Einträge werden verworfen; Views, die so weit zurückliegen, laden den Track neu. */
+    static constexpr size_t maxEntries = 4096;
+
+    struct Entry
+    {
+        uint64_t sequence = 0;
+        int trackIndex = -1;
+        TabEdit edit;
+    };
+
+    /** Protokolliert einen (bereits angewendeten) Edit und liefert seine Sequenznummer. */
+    uint64_t record(int trackIndex, const TabEdit& edit)
+    {
+        entries.push_back({ nextSequence, trackIndex, edit });
+        if (entries.size() > maxEntries)
+        {
+            entries.pop_front();
+            firstSequence = entries.front().sequence;
+        }
+        return nextSequence++;
+    }
+
+    /** Sequenznummer des letzten Eintrags (0 = leer). */
+    uint64_t getLastSequence() const noexcept { return nextSequence - 1; }
+
+    /**
+     * Spielt alle Edits eines Tracks nach sequence ab. false wenn die Lücke nicht
+     * mehr im Journal liegt (verworfen oder clear()) - dann den Track neu laden.
+     */
+    template <typename Fn>
+    bool replaySince(int trackIndex, uint64_t sequence, Fn&& fn) const
+    {
+        if (sequence + 1 < firstSequence)
+            return false;
+
+        for (const auto& entry : entries)
+            if (entry.sequence > sequence && entry.trackIndex == trackIndex)
+                fn(entry.edit);
+        return true;
+    }
+
+    /** Modell wurde ersetzt (neue Datei, State geladen) - ältere Stände sind ungültig. */
+    void clear()
+    {
+        entries.clear();
+        firstSequence = nextSequence;
+    }
+
+    //==========================================================================
+    /** Wendet einen Edit an; false wenn er ungültig ist oder den Takt sprengen würde. */
+    static bool apply(TabTrack& track, TabEdit& edit)
+    {
+        if (edit.measureIndex < 0 || edit.measureIndex >= track.measures.size())
+            return false;
+        auto& measure = track.measures.getReference(edit.measureIndex);
+        if (edit.type == TabEdit::Type::ReplaceMeasure)
+        {
+            if (edit.measure == nullptr)
+                return false;
+            measure = *edit.measure;
+            return true;
+        }
+        if (edit.beatIndex < 0 || edit.beatIndex >= measure.beats.size())
+            return false;
+
+        switch (edit.type)
+        {
+            case TabEdit::Type::SetPosition:
+            case TabEdit::Type::SetPitch:
+            {
+                auto& beat = measure.beats.getReference(edit.beatIndex);
+                if (edit.noteIndex < 0 || edit.noteIndex >= beat.notes.size())
+                    return false;
+
+                auto& note = beat.notes.getReference(edit.noteIndex);
+                edit.oldString = note.string;
+                note.string = edit.string;
+                note.fret = edit.fret;
+                note.isManuallyEdited = true;
+                if (edit.type == TabEdit::Type::SetPitch || note.midiNote < 0)
+                    note.midiNote = edit.midiNote;
+                return true;
+            }
+
+            case TabEdit::Type::DeleteNote:
+            {
+                auto& beat = measure.beats.getReference(edit.beatIndex);
+                if (edit.noteIndex < 0 || edit.noteIndex >= beat.notes.size())
+                    return false;
+
+                edit.oldString = beat.notes[edit.noteIndex].string;
+                beat.notes.remove(edit.noteIndex);
+
+                // Ohne Noten wird der Beat zur Pause
+                if (beat.notes.isEmpty())
+                    beat.isRest = true;
+                return true;
+            }
+
+            case TabEdit::Type::ChangeDuration:  return changeDuration(measure, edit);
+            case TabEdit::Type::DeleteRest:      return deleteRest(measure, edit.beatIndex);
+            case TabEdit::Type::InsertNote:      return insertNote(measure, edit);
+            case TabEdit::Type::ReplaceMeasure:  break;
+        }
+        return false;
+    }
+
+    /** Nächstkleinere (oder gleiche) Standarddauer zu einer Länge in Vierteln. */
+    static std::pair<NoteDuration, bool> findClosestDuration(float quarters)
+    {
+        // Duration table: { quarters, duration, dotted }
+        struct DurEntry { float q; NoteDuration d; bool dot; };
+        static constexpr DurEntry table[] = {
+            { 4.0f,   NoteDuration::Whole, false },
+            { 3.0f,   NoteDuration::Half, true },
+            { 2.0f,   NoteDuration::Half, false },
+            { 1.5f,   NoteDuration::Quarter, true },
+            { 1.0f,   NoteDuration::Quarter, false },
+            { 0.75f,  NoteDuration::Eighth, true },
+            { 0.5f,   NoteDuration::Eighth, false },
+            { 0.375f, NoteDuration::Sixteenth, true },
+            { 0.25f,  NoteDuration::Sixteenth, false },
+            { 0.125f, NoteDuration::ThirtySecond, false }
+        };
+
+        float bestDiff = 999.0f;
+        int bestIdx = 4;  // Default to quarter
+        for (int i = 0; i < 10; ++i)
+        {
+            if (table[i].q <= quarters + 0.001f)
+            {
+                float diff = quarters - table[i].q;
+                if (diff < bestDiff)
+                {
+                    bestDiff = diff;
+                    bestIdx = i;
+                }
+            }
+        }
+        return { table[bestIdx].d, table[bestIdx].dot };
+    }
+
+private:
+    std::deque<Entry> entries;
+    uint64_t nextSequence = 1;
+    uint64_t firstSequence = 1;
+
+    static float durationInQuarters(std::pair<NoteDuration, bool> d)
+    {
+        float q = 4.0f / static_cast<float>(d.first);
+        return d.second ? q * 1.5f : q;
+    }
+
+    static float totalDuration(const TabMeasure& measure)
+    {
+        float total = 0.0f;
+        for (const auto& b : measure.beats)
+            total += b.getDurationInQuarters();
+        return total;
+    }
+
+    static TabBeat makeRest(std::pair<NoteDuration, bool> d)
+    {
+        TabBeat rest;
+        rest.isRest = true;
+        rest.duration = d.first;
+        rest.isDotted = d.second;
+        return rest;
+    }
+
+    /** Neue Dauer setzen; Überhang nimmt Zeit von den Folge-Beats, Lücken werden mit Pausen gefüllt. */
+    static bool changeDuration(TabMeasure& measure, const TabEdit& edit)
+    {
+        auto& beat = measure.beats.getReference(edit.beatIndex);
+        const NoteDuration oldDur = beat.duration;
+        const bool oldDotted = beat.isDotted;
+        const bool oldDoubleDotted = beat.isDoubleDotted;
+
+        beat.duration = edit.duration;
+        beat.isDotted = edit.dotted;
+        beat.isDoubleDotted = false;
+
+        const float measureCapacity = (float) measure.timeSignatureNumerator * (4.0f / (float) measure.timeSignatureDenominator);
+        float total = totalDuration(measure);
+
+        if (total > measureCapacity + 0.001f)
+        {
+            // Zeit von den Beats nach dem aktuellen nehmen
+            float excess = total - measureCapacity;
+            auto candidate = measure.beats;
+            for (int b = edit.beatIndex + 1; b < candidate.size() && excess > 0.001f; )
+            {
+                auto& nextBeat = candidate.getReference(b);
+                float nextDur = nextBeat.getDurationInQuarters();
+
+                if (nextDur <= excess + 0.001f)
+                {
+                    excess -= nextDur;
+                    candidate.remove(b);
+                }
+                else
+                {
+                    auto shorterDur = findClosestDuration(nextDur - excess);
+                    nextBeat.duration = shorterDur.first;
+                    nextBeat.isDotted = shorterDur.second;
+                    nextBeat.isDoubleDotted = false;
+                    excess = 0.0f;
+                    ++b;
+                }
+            }
+
+            // Passt es immer noch nicht, bleibt der Takt unverändert
+            float candidateTotal = 0.0f;
+            for (const auto& b : candidate)
+                candidateTotal += b.getDurationInQuarters();
+            if (candidateTotal > measureCapacity + 0.01f)
+            {
+                beat.duration = oldDur;
+                beat.isDotted = oldDotted;
+                beat.isDoubleDotted = oldDoubleDotted;
+                return false;
+            }
+            measure.beats.swapWith(candidate);
+        }
+        else if (total < measureCapacity - 0.001f)
+        {
+            // Lücke nach dem aktuellen Beat mit Pause(n) füllen
+            float gap = measureCapacity - total;
+            while (gap > 0.01f)
+            {
+                auto restBeat = makeRest(findClosestDuration(gap));
+                gap -= restBeat.getDurationInQuarters();
+                int insertPos = juce::jmin(edit.beatIndex + 1, measure.beats.size());
+                measure.beats.insert(insertPos, restBeat);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Pause löschen und Nachbarn anpassen:
+     *  - Beat davor vorhanden -> um die Pausendauer verlängern
+     *  - Pause am Taktanfang -> nächsten Beat verlängern
+     *  - Einzige Pause im Takt -> nicht löschen
+     */
+    static bool deleteRest(TabMeasure& measure, int beatIndex)
+    {
+        if (! measure.beats[beatIndex].isRest)
+            return false;
+
+        int neighbourIndex = -1;
+        if (beatIndex > 0)
+            neighbourIndex = beatIndex - 1;
+        else if (measure.beats.size() > 1)
+            neighbourIndex = 1;
+        else
+        {
+            DBG("Cannot delete the only rest in measure " << measure.measureNumber);
+            return false;
+        }
+
+        const float restDuration = measure.beats[beatIndex].getDurationInQuarters();
+        auto& neighbour = measure.beats.getReference(neighbourIndex);
+        const float neighbourDuration = neighbour.getDurationInQuarters();
+        const float combinedDuration = neighbourDuration + restDuration;
+
+        const auto bestFit = findClosestDuration(combinedDuration);
+        const float bestFitQ = durationInQuarters(bestFit);
+
+        neighbour.duration = bestFit.first;
+        neighbour.isDotted = bestFit.second;
+        neighbour.isDoubleDotted = false;
+
+        // Nicht exakt passend: Rest bleibt als kleinere Pause stehen
+        if (std::abs(bestFitQ - combinedDuration) >= 0.06f
+            && bestFitQ <= combinedDuration + 0.001f && bestFitQ > neighbourDuration + 0.001f)
+        {
+            const float leftover = combinedDuration - bestFitQ;
+            if (leftover > 0.06f)
+            {
+                auto leftoverDur = findClosestDuration(leftover);
+                auto& rest = measure.beats.getReference(beatIndex);
+                rest.duration = leftoverDur.first;
+                rest.isDotted = leftoverDur.second;
+                return true;
+            }
+        }
+
+        measure.beats.remove(beatIndex);
+        return true;
+    }
+
+    /** Pause in Note + Rest-Pause(n) aufteilen; die Note ist höchstens so lang wie die Pause. */
+    static bool insertNote(TabMeasure& measure, const TabEdit& edit)
+    {
+        auto& beat = measure.beats.getReference(edit.beatIndex);
+        if (! beat.isRest)
+            return false;
+
+        const float restDurationQ = beat.getDurationInQuarters();
+
+        NoteDuration noteDur = edit.duration;
+        bool noteDotted = false;
+        float noteDurQ = 4.0f / static_cast<float>(noteDur);
+
+        if (noteDurQ > restDurationQ + 0.001f)
+        {
+            noteDur = beat.duration;
+            noteDotted = beat.isDotted;
+            noteDurQ = restDurationQ;
+        }
+
+        TabNote newNote;
+        newNote.string = edit.string;
+        newNote.fret = edit.fret;
+        newNote.midiNote = edit.midiNote;
+        newNote.velocity = 100;
+        newNote.isManuallyEdited = true;
+
+        beat.isRest = false;
+        beat.notes.clear();
+        beat.notes.add(newNote);
+        beat.duration = noteDur;
+        beat.isDotted = noteDotted;
+        beat.isDoubleDotted = false;
+
+        // Restzeit hinter der Note mit Pause(n) auffüllen
+        float remaining = restDurationQ - noteDurQ;
+        int insertPos = edit.beatIndex + 1;
+        while (remaining > 0.01f)
+        {
+            auto restBeat = makeRest(findClosestDuration(remaining));
+            remaining -= restBeat.getDurationInQuarters();
+            insertPos = juce::jmin(insertPos, measure.beats.size());
+            measure.beats.insert(insertPos, restBeat);
+            ++insertPos;
+        }
+        return true;
+    }
+};
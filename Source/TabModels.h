@@ -13,6 +13,7 @@
 
 #include <juce_core/juce_core.h>
 #include <juce_graphics/juce_graphics.h>
+#include "MemoryAccounting.h"
 
 //==============================================================================
 // Notenwert / Dauer
@@ -238,6 +239,30 @@ struct TabTrack
     }
 };
 
+/** Geschätzter Heap-Speicher eines Takts ohne das TabMeasure selbst (für MemoryAccounting). */
+inline size_t getHeapBytes(const TabMeasure& measure)
+{
+    size_t bytes = MemoryAccounting::bytesOf(measure.beats) + MemoryAccounting::bytesOf(measure.marker);
+    for (const auto& beat : measure.beats)
+    {
+        bytes += MemoryAccounting::bytesOf(beat.notes) + MemoryAccounting::bytesOf(beat.text)
+               + MemoryAccounting::bytesOf(beat.chordName);
+        for (const auto& note : beat.notes)
+            bytes += MemoryAccounting::bytesOf(note.effects.bendPoints);
+    }
+    return bytes;
+}
+
+/** Geschätzter Heap-Speicher eines Tracks ohne das TabTrack selbst. */
+inline size_t getHeapBytes(const TabTrack& track)
+{
+    size_t bytes = MemoryAccounting::bytesOf(track.name) + MemoryAccounting::bytesOf(track.tuning)
+                 + MemoryAccounting::bytesOf(track.measures);
+    for (const auto& measure : track.measures)
+        bytes += getHeapBytes(measure);
+    return bytes;
+}
+
 //==============================================================================
 // Der komplette Song
 //==============================================================================
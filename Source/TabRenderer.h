@@ -13,6 +13,7 @@
 
 #include "TabModels.h"
 #include "TabLayoutEngine.h"
+#include "TraceRecorder.h"
 #include <juce_graphics/juce_graphics.h>
 
 //==============================================================================
@@ -87,6 +88,8 @@ public:
                 float scrollOffset = 0.0f,
                 int highlightMeasure = -1)
     {
+        TraceScope trace("TabRenderer::render", "ui");
+        
         if (track.measures.isEmpty())
             return;
         
@@ -359,6 +362,11 @@ public:
             if (measure.repeatCount > 0)
                 drawRepeatClose(g, measureEndX, firstStringY, stringCount, measure.repeatCount);
         }
+        
+        // Trefferlisten wachsen mit der sichtbaren Notendichte
+        renderMemory.setBytes(MemoryAccounting::bytesOf(renderedNotes) + MemoryAccounting::bytesOf(renderedChords)
+                              + MemoryAccounting::bytesOf(renderedRests) + MemoryAccounting::bytesOf(currentTrackTuning)
+                              + MemoryAccounting::bytesOf(hiddenNotes));
     }
 
 private:
@@ -372,6 +380,7 @@ private:
     int currentBeatIndex = 0;
     int currentNoteIndex = 0;
     std::vector<std::tuple<int, int, int>> hiddenNotes;  // Notes to hide for ghost preview
+    MemoryAccount renderMemory { MemoryAccounting::renderer };
     
     bool isNoteHidden(int measureIdx, int beatIdx, int noteIdx) const
     {
@@ -0,0 +1,345 @@
+/*
+  ==============================================================================
+
+    TabUndoHistory.h
+
+    Undo/Redo für Tab-Edits (Popups und Tastatur) über persistente Stände.
+
+    Ein Stand ist ein unveränderlicher 32-fach verzweigter Baum über die
+    Takte eines TabTracks. Ein Edit kopiert nur den Pfad zum betroffenen Takt
+    (log32 n Knoten + der Takt selbst), alle anderen Takte und Teilbäume
+    teilen sich die Stände. Damit kostet ein Undo-Schritt bei 1000 Takten
+    ~2 Knoten statt einer Track-Kopie, und die Historie kann unbegrenzt
+    wachsen.
+
+    Beim Zurückspringen werden nur Takte kopiert, deren Zeiger sich zwischen
+    den beiden Ständen unterscheiden; gemeinsame Teilbäume werden übersprungen.
+
+    Der Heap-Speicher wird beim Anlegen jedes Stands mitgezählt (nur der neu
+    kopierte Pfad), getHeapBytes() läuft daher nie über die Historie.
+
+    Nicht thread-safe: Aufrufer halten editedTracksMutex.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "TabModels.h"
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+//==============================================================================
+/**
+ * Unveränderlicher Vektor von Takten mit Structural Sharing.
+ */
+class PersistentMeasureVector
+{
+public:
+    using MeasurePtr = std::shared_ptr<const TabMeasure>;
+
+    static constexpr int branchBits = 5;
+    static constexpr int branching = 1 << branchBits;
+
+    PersistentMeasureVector() = default;
+
+    /** heapBytes (optional) erhält den Heap-Speicher aller angelegten Knoten und Takte. */
+    explicit PersistentMeasureVector(const juce::Array<TabMeasure>& measures, size_t* heapBytes = nullptr)
+        : count(measures.size())
+    {
+        size_t bytes = 0;
+
+        // Blätter bauen, dann Ebene für Ebene zusammenfassen
+        std::vector<NodePtr> level;
+        for (int start = 0; start < count; start += branching)
+        {
+            auto leaf = std::make_shared<Node>();
+            for (int i = start; i < juce::jmin(start + branching, count); ++i)
+            {
+                leaf->measures.push_back(std::make_shared<const TabMeasure>(measures.getReference(i)));
+                bytes += measureBytes(*leaf->measures.back());
+            }
+            bytes += nodeBytes(*leaf);
+            level.push_back(std::move(leaf));
+        }
+
+        while (level.size() > 1)
+        {
+            std::vector<NodePtr> parents;
+            for (size_t start = 0; start < level.size(); start += branching)
+            {
+                auto parent = std::make_shared<Node>();
+                for (size_t i = start; i < std::min(start + (size_t) branching, level.size()); ++i)
+                    parent->children.push_back(level[i]);
+                bytes += nodeBytes(*parent);
+                parents.push_back(std::move(parent));
+            }
+            level = std::move(parents);
+            shift += branchBits;
+        }
+
+        if (!level.empty())
+            root = level.front();
+
+        if (heapBytes != nullptr)
+            *heapBytes = bytes;
+    }
+
+    int size() const noexcept { return count; }
+
+    const TabMeasure& get(int index) const { return *leafFor(index)->measures[slot(index, 0)]; }
+
+    /** Neuer Stand mit ersetztem Takt; kopiert nur den Pfad von der Wurzel zum Blatt. */
+    PersistentMeasureVector with(int index, const TabMeasure& measure) const
+    {
+        jassert(index >= 0 && index < count);
+
+        PersistentMeasureVector result(*this);
+        result.root = replace(root, shift, index, std::make_shared<const TabMeasure>(measure));
+        return result;
+    }
+
+    /**
+     * Ruft fn(index, measurePtr) für jeden Takt auf, der sich von other unterscheidet.
+     * Gemeinsame Teilbäume werden übersprungen. Beide Stände müssen gleich lang sein.
+     */
+    template <typename Fn>
+    void forEachDifference(const PersistentMeasureVector& other, Fn&& fn) const
+    {
+        jassert(count == other.count && shift == other.shift);
+        diff(root, other.root, shift, 0, fn);
+    }
+
+    /**
+     * Heap-Speicher der Knoten und Takte, die dieser Stand nicht mit base teilt.
+     * Läuft nur über die abweichenden Pfade; base muss gleich lang sein.
+     */
+    size_t getHeapBytesNotIn(const PersistentMeasureVector& base) const
+    {
+        jassert(count == base.count && shift == base.shift);
+        return countNotShared(root, base.root, shift);
+    }
+
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Node
+    {
+        std::vector<NodePtr> children;       // innere Knoten
+        std::vector<MeasurePtr> measures;    // Blätter
+    };
+
+    NodePtr root;
+    int count = 0;
+    int shift = 0;   // branchBits * (Tiefe - 1), 0 = Wurzel ist Blatt
+
+    static size_t slot(int index, int levelShift) noexcept
+    {
+        return (size_t) ((index >> levelShift) & (branching - 1));
+    }
+
+    const Node* leafFor(int index) const
+    {
+        jassert(index >= 0 && index < count);
+
+        const Node* node = root.get();
+        for (int level = shift; level > 0; level -= branchBits)
+            node = node->children[slot(index, level)].get();
+        return node;
+    }
+
+    static NodePtr replace(const NodePtr& node, int levelShift, int index, MeasurePtr measure)
+    {
+        auto copy = std::make_shared<Node>(*node);
+        if (levelShift == 0)
+            copy->measures[slot(index, 0)] = std::move(measure);
+        else
+            copy->children[slot(index, levelShift)] = replace(node->children[slot(index, levelShift)],
+                                                              levelShift - branchBits, index, std::move(measure));
+        return copy;
+    }
+
+    // make_shared: Objekt und Kontrollblock in einer Allokation
+    static size_t nodeBytes(const Node& node)
+    {
+        return sizeof(Node) + 2 * sizeof(void*)
+             + MemoryAccounting::bytesOf(node.children) + MemoryAccounting::bytesOf(node.measures);
+    }
+
+    static size_t measureBytes(const TabMeasure& measure)
+    {
+        return sizeof(TabMeasure) + 2 * sizeof(void*) + getHeapBytes(measure);
+    }
+
+    static size_t countNotShared(const NodePtr& node, const NodePtr& base, int levelShift)
+    {
+        if (node == base || node == nullptr)
+            return 0;
+
+        size_t bytes = nodeBytes(*node);
+        if (levelShift == 0)
+        {
+            for (size_t i = 0; i < node->measures.size(); ++i)
+                if (base == nullptr || node->measures[i] != base->measures[i])
+                    bytes += measureBytes(*node->measures[i]);
+            return bytes;
+        }
+
+        for (size_t i = 0; i < node->children.size(); ++i)
+            bytes += countNotShared(node->children[i], base != nullptr ? base->children[i] : nullptr,
+                                    levelShift - branchBits);
+        return bytes;
+    }
+
+    template <typename Fn>
+    static void diff(const NodePtr& a, const NodePtr& b, int levelShift, int firstIndex, Fn& fn)
+    {
+        if (a == b || a == nullptr)
+            return;
+
+        if (levelShift == 0)
+        {
+            for (size_t i = 0; i < a->measures.size(); ++i)
+                if (a->measures[i] != b->measures[i])
+                    fn(firstIndex + (int) i, a->measures[i]);
+            return;
+        }
+
+        for (size_t i = 0; i < a->children.size(); ++i)
+            diff(a->children[i], b->children[i], levelShift - branchBits,
+                 firstIndex + ((int) i << levelShift), fn);
+    }
+};
+
+//==============================================================================
+/**
+ * TabUndoHistory - Folge persistenter Stände eines Tracks plus Cursor.
+ */
+class TabUndoHistory
+{
+public:
+    /** Ersetzte Takte; unveränderlich, dürfen ohne Sperre gelesen werden. */
+    using MeasureList = std::vector<std::pair<int, PersistentMeasureVector::MeasurePtr>>;
+
+    /** Ergebnis von undo/redo (für Autosave, Views und die Speicherbuchhaltung des Tracks). */
+    struct Restored
+    {
+        MeasureList measures;             // leer: Taktanzahl wich ab, Track komplett neu
+        std::ptrdiff_t trackHeapDelta = 0;
+    };
+
+    bool isInitialised() const noexcept { return !versions.empty(); }
+
+    /** Ausgangsstand setzen (erster Edit auf diesem Track); verwirft die Historie. */
+    void reset(const TabTrack& track)
+    {
+        size_t bytes = 0;
+        versions.clear();
+        versions.emplace_back(track.measures, &bytes);
+        versionBytes.assign(1, bytes);
+        heapBytes = bytes;
+        current = 0;
+    }
+
+    /**
+     * Neuen Schritt aus den geänderten Takten des Tracks anlegen (ein Batch = ein
+     * Schritt). Verwirft Redo-Stände.
+     */
+    void commit(const TabTrack& track, const std::vector<int>& touchedMeasures)
+    {
+        jassert(isInitialised());
+
+        auto next = versions[current];
+        if (next.size() != track.measures.size())
+        {
+            // Taktanzahl geändert (sollte durch Edits nicht passieren) - neu aufsetzen
+            reset(track);
+            return;
+        }
+
+        for (int index : touchedMeasures)
+            if (index >= 0 && index < next.size())
+                next = next.with(index, track.measures.getReference(index));
+
+        // Redo-Stände freigeben: ihre Knoten teilt kein früherer Stand
+        for (size_t i = current + 1; i < versions.size(); ++i)
+            heapBytes -= versionBytes[i];
+        versions.resize(current + 1);
+        versionBytes.resize(current + 1);
+
+        // Nur der neu kopierte Pfad kommt hinzu (Zwischenstände des Batches sind schon frei)
+        const auto added = next.getHeapBytesNotIn(versions[current]);
+        versions.push_back(std::move(next));
+        versionBytes.push_back(added);
+        heapBytes += added;
+        ++current;
+    }
+
+    bool canUndo() const noexcept { return current > 0; }
+    bool canRedo() const noexcept { return current + 1 < versions.size(); }
+    size_t getNumSteps() const noexcept { return versions.empty() ? 0 : versions.size() - 1; }
+
+    /** Anzahl der angewendeten Schritte (Cursor); Schritt i führt von Stand i zu Stand i + 1. */
+    size_t getCurrentStep() const noexcept { return current; }
+
+    /** Heap-Speicher aller Stände (mitgezählt, gemeinsam genutzte Takte und Knoten einmal). */
+    size_t getHeapBytes() const noexcept
+    {
+        return heapBytes + MemoryAccounting::bytesOf(versions) + MemoryAccounting::bytesOf(versionBytes);
+    }
+
+    /** Track auf den vorherigen Stand zurücksetzen; false wenn es keinen gibt. */
+    bool undo(TabTrack& track, Restored& restored)
+    {
+        if (!canUndo())
+            return false;
+        restore(track, versions[current], versions[current - 1], restored);
+        --current;
+        return true;
+    }
+
+    /** Rückgängig gemachten Schritt wiederherstellen. */
+    bool redo(TabTrack& track, Restored& restored)
+    {
+        if (!canRedo())
+            return false;
+        restore(track, versions[current], versions[current + 1], restored);
+        ++current;
+        return true;
+    }
+
+private:
+    std::vector<PersistentMeasureVector> versions;
+    std::vector<size_t> versionBytes;   // von jedem Stand neu angelegte Knoten und Takte
+    size_t heapBytes = 0;
+    size_t current = 0;
+
+    /** Kopiert nur die Takte, die sich zwischen from und to unterscheiden. */
+    static void restore(TabTrack& track, const PersistentMeasureVector& from, const PersistentMeasureVector& to,
+                        Restored& restored)
+    {
+        restored.measures.clear();
+        restored.trackHeapDelta = 0;
+
+        if (track.measures.size() != to.size())
+        {
+            // Taktanzahl weicht ab - measures bleibt leer, Aufrufer laden den Track komplett
+            const auto before = (std::ptrdiff_t) ::getHeapBytes(track);
+            track.measures.clearQuick();
+            for (int i = 0; i < to.size(); ++i)
+                track.measures.add(to.get(i));
+            restored.trackHeapDelta = (std::ptrdiff_t) ::getHeapBytes(track) - before;
+            return;
+        }
+
+        to.forEachDifference(from, [&track, &restored](int index, const PersistentMeasureVector::MeasurePtr& measure) {
+            auto& target = track.measures.getReference(index);
+            restored.trackHeapDelta += (std::ptrdiff_t) ::getHeapBytes(*measure) - (std::ptrdiff_t) ::getHeapBytes(target);
+            target = *measure;
+            restored.measures.emplace_back(index, measure);
+        });
+    }
+};
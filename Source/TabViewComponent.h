@@ -16,6 +16,7 @@
 #include "TabLayoutEngine.h"
 #include "FretPositionCalculator.h"
 #include "NoteEditComponent.h"
+#include "TabEditJournal.h"
 #include <juce_gui_basics/juce_gui_basics.h>
 
 //==============================================================================
@@ -68,6 +69,18 @@ public:
     void setTrack(const TabTrack& newTrack)
     {
         track = newTrack;
+        ++trackGeneration;
+        trackChanged();
+    }
+    
+    /** Zählt bei jedem setTrack() hoch - wer den Track über getTrackForEditing()
+        schrittweise pflegt, erkennt daran, dass inzwischen ein anderer angezeigt wird. */
+    uint32_t getTrackGeneration() const { return trackGeneration; }
+    
+    /** Nach Änderungen über getTrackForEditing(): Layout neu berechnen und neu zeichnen. */
+    void trackChanged()
+    {
+        trackMemory.setBytes(getHeapBytes(track));
         recalculateLayout();
         repaint();
     }
@@ -82,7 +95,7 @@ public:
     }
     
     // Set which strings are muted (dead notes) in the current chord
-    void setLiveMutedStrings(const std::array<bool, 6>& muted)
+    void setLiveMutedStrings(const std::array<bool, GuitarTuning::maxStrings>& muted)
     {
         liveMutedStrings = muted;
     }
@@ -631,7 +644,7 @@ public:
             }
             
             // Draw muted string indicators (X) for dead notes
-            for (int s = 0; s < 6; ++s)
+            for (int s = 0; s < juce::jmin(track.stringCount, (int) liveMutedStrings.size()); ++s)
             {
                 if (liveMutedStrings[s])
                 {
@@ -1009,6 +1022,22 @@ public:
         if (noteEditPopup.isShowing() || groupEditPopup.isShowing() || restEditPopup.isShowing() || fretInputPopup.isShowing())
             return false;
         
+        // Undo/Redo (Strg+Z, Strg+Y / Strg+Umschalt+Z) - auch ohne Auswahl
+        if (key.getModifiers().isCommandDown())
+        {
+            const int code = key.getKeyCode();
+            if ((code == 'Z' || code == 'z') && !key.getModifiers().isShiftDown())
+            {
+                if (onUndoRequested) onUndoRequested();
+                return true;
+            }
+            if (code == 'Y' || code == 'y' || code == 'Z' || code == 'z')
+            {
+                if (onRedoRequested) onRedoRequested();
+                return true;
+            }
+        }
+        
         // Keyboard shortcuts only work when we have a lastSelectedNote
         if (!lastSelectedNote.valid) return false;
         
@@ -1159,20 +1188,31 @@ public:
     
     bool isNoteEditingEnabled() const { return noteEditingEnabled; }
     
-    /** Callback wenn eine Note-Position geändert wird: measureIdx, beatIdx, oldString, newString, newFret */
-    std::function<void(int, int, int, int, int)> onNotePositionChanged;
-    
-    /** Callback wenn eine Note gelöscht wird: measureIdx, beatIdx, stringIndex */
-    std::function<void(int, int, int)> onNoteDeleted;
-    
-    /** Callback wenn eine Beat-Dauer geändert wird: measureIdx, beatIdx, newDuration(int), isDotted */
-    std::function<void(int, int, int, bool)> onBeatDurationChanged;
+    /**
+     * Edit-Befehle (Bund/Saite, Tonhöhe, Dauer, Löschen, Einfügen) an den Besitzer
+     * des Modells. Er spielt sie über applyEdits() zurück in die View; ohne
+     * Listener wendet die View sie direkt an. Gruppen-Edits kommen als ein Batch.
+     */
+    std::function<void(const std::vector<TabEdit>&)> onTabEdits;
     
-    /** Callback wenn die Tonhöhe geändert wird: measureIdx, beatIdx, stringIndex, newMidiNote, newFret */
-    std::function<void(int, int, int, int, int)> onNotePitchChanged;
+    /** Strg+Z / Strg+Y - der Besitzer spielt die ersetzten Takte über applyEdits() zurück. */
+    std::function<void()> onUndoRequested;
+    std::function<void()> onRedoRequested;
     
-    /** Callback wenn eine Note in eine Pause eingefügt wird: measureIdx, beatIdx, stringIndex, fret, midiNote */
-    std::function<void(int, int, int, int, int)> onNoteInserted;
+    /** Wendet bestätigte Edits auf den angezeigten Track an (ungültige werden übersprungen). */
+    void applyEdits(const std::vector<TabEdit>& edits)
+    {
+        bool changed = false;
+        for (auto edit : edits)
+            changed |= TabEditJournal::apply(track, edit);
+        
+        if (changed)
+        {
+            trackMemory.setBytes(getHeapBytes(track));
+            recalculateLayout();
+        }
+        repaint();
+    }
     
     TabTrack& getTrackForEditing() { return track; }
     
@@ -1272,6 +1312,8 @@ public:
     
 private:
     TabTrack track;
+    uint32_t trackGeneration = 0;
+    MemoryAccount trackMemory { MemoryAccounting::tabView };
     TabRenderer renderer;
     mutable TabLayoutEngine layoutEngine;
     TabLayoutConfig config;
@@ -1292,7 +1334,7 @@ private:
     // Editor mode (live MIDI input display)
     bool editorMode = false;
     std::vector<LiveNote> liveNotes;
-    std::array<bool, 6> liveMutedStrings = { false, false, false, false, false, false };
+    std::array<bool, GuitarTuning::maxStrings> liveMutedStrings {};
     juce::String liveChordName;
     juce::String overlayMessage;  // Overlay-Nachricht (z.B. "Audio-to-MIDI recording...")
     
@@ -1465,114 +1507,17 @@ private:
     void changeRestDuration(int measureIndex, int beatIndex, NoteDuration newDuration, bool isDotted)
     {
         if (measureIndex < 0 || measureIndex >= track.measures.size()) return;
-        auto& measure = track.measures.getReference(measureIndex);
+        const auto& measure = track.measures.getReference(measureIndex);
         if (beatIndex < 0 || beatIndex >= measure.beats.size()) return;
+        if (!measure.beats[beatIndex].isRest) return;
         
-        auto& beat = measure.beats.getReference(beatIndex);
-        if (!beat.isRest) return;
-        
-        float oldDurQ = beat.getDurationInQuarters();
-        
-        // Apply new duration
-        beat.duration = newDuration;
-        beat.isDotted = isDotted;
-        beat.isDoubleDotted = false;
-        
-        float newDurQ = beat.getDurationInQuarters();
-        float diff = newDurQ - oldDurQ;
-        
-        float measureCapacity = (float)measure.timeSignatureNumerator * (4.0f / (float)measure.timeSignatureDenominator);
-        
-        // Calculate total duration of all beats
-        float totalDuration = 0.0f;
-        for (const auto& b : measure.beats)
-            totalDuration += b.getDurationInQuarters();
-        
-        if (totalDuration > measureCapacity + 0.001f)
-        {
-            // Need to shrink subsequent beats/rests
-            float excess = totalDuration - measureCapacity;
-            for (int b = beatIndex + 1; b < measure.beats.size() && excess > 0.001f; )
-            {
-                auto& nextBeat = measure.beats.getReference(b);
-                float nextDur = nextBeat.getDurationInQuarters();
-                
-                if (nextDur <= excess + 0.001f)
-                {
-                    excess -= nextDur;
-                    measure.beats.remove(b);
-                }
-                else
-                {
-                    auto shorterDur = findClosestDuration(nextDur - excess);
-                    nextBeat.duration = shorterDur.first;
-                    nextBeat.isDotted = shorterDur.second;
-                    nextBeat.isDoubleDotted = false;
-                    excess = 0.0f;
-                    ++b;
-                }
-            }
-            
-            // Verify - if still overflowing, revert
-            totalDuration = 0.0f;
-            for (const auto& b : measure.beats)
-                totalDuration += b.getDurationInQuarters();
-            if (totalDuration > measureCapacity + 0.01f)
-            {
-                // Revert
-                beat.duration = findClosestDuration(oldDurQ).first;
-                beat.isDotted = findClosestDuration(oldDurQ).second;
-                repaint();
-                return;
-            }
-        }
-        else if (totalDuration < measureCapacity - 0.001f)
-        {
-            // Fill gap with rest(s) after current beat
-            float gap = measureCapacity - totalDuration;
-            while (gap > 0.01f)
-            {
-                auto restDur = findClosestDuration(gap);
-                TabBeat restBeat;
-                restBeat.isRest = true;
-                restBeat.duration = restDur.first;
-                restBeat.isDotted = restDur.second;
-                float restLen = restBeat.getDurationInQuarters();
-                gap -= restLen;
-                int insertPos = beatIndex + 1;
-                if (insertPos > measure.beats.size()) insertPos = measure.beats.size();
-                measure.beats.insert(insertPos, restBeat);
-            }
-        }
-        
-        // Notify processor
-        if (onBeatDurationChanged)
-            onBeatDurationChanged(measureIndex, beatIndex, static_cast<int>(newDuration), isDotted);
-        
-        recalculateLayout();
-        repaint();
+        submitEdits({ TabEdit::changeDuration(measureIndex, beatIndex, newDuration, isDotted) });
     }
     
     void applyNotePositionChange(const NoteHitInfo& info, const AlternatePosition& newPos)
     {
-        if (info.measureIndex < 0 || info.measureIndex >= track.measures.size()) return;
-        auto& measure = track.measures.getReference(info.measureIndex);
-        if (info.beatIndex < 0 || info.beatIndex >= measure.beats.size()) return;
-        auto& beat = measure.beats.getReference(info.beatIndex);
-        if (info.noteIndex < 0 || info.noteIndex >= beat.notes.size()) return;
-        
-        auto& note = beat.notes.getReference(info.noteIndex);
-        int oldString = note.string;  // Speichere alte Position VOR der Änderung
-        note.string = newPos.string;
-        note.fret = newPos.fret;
-        note.isManuallyEdited = true;
-        if (note.midiNote < 0) note.midiNote = info.midiNote;
-        
-        // Übergebe oldString statt noteIndex, damit recordedNotes die Note finden kann
-        if (onNotePositionChanged)
-            onNotePositionChanged(info.measureIndex, info.beatIndex, oldString, newPos.string, newPos.fret);
-        
-        repaint();
+        submitEdits({ TabEdit::setPosition(info.measureIndex, info.beatIndex, info.noteIndex,
+                                           newPos.string, newPos.fret, info.midiNote) });
     }
     
     void showGroupEditPopup()
@@ -1641,31 +1586,20 @@ private:
     {
         if (notes.size() != alt.positions.size()) return;
         
+        // Ein Batch für die ganze Gruppe
+        std::vector<TabEdit> edits;
+        edits.reserve((size_t) notes.size());
         for (int i = 0; i < notes.size(); ++i)
         {
             const auto& info = notes[i];
             const auto& newPos = alt.positions[i];
-            
-            if (info.measureIndex < 0 || info.measureIndex >= track.measures.size()) continue;
-            auto& measure = track.measures.getReference(info.measureIndex);
-            if (info.beatIndex < 0 || info.beatIndex >= measure.beats.size()) continue;
-            auto& beat = measure.beats.getReference(info.beatIndex);
-            if (info.noteIndex < 0 || info.noteIndex >= beat.notes.size()) continue;
-            
-            auto& note = beat.notes.getReference(info.noteIndex);
-            int oldString = note.string;
-            note.string = newPos.string;
-            note.fret = newPos.fret;
-            note.isManuallyEdited = true;
-            if (note.midiNote < 0) note.midiNote = info.midiNote;
-            
-            if (onNotePositionChanged)
-                onNotePositionChanged(info.measureIndex, info.beatIndex, oldString, newPos.string, newPos.fret);
+            edits.push_back(TabEdit::setPosition(info.measureIndex, info.beatIndex, info.noteIndex,
+                                                 newPos.string, newPos.fret, info.midiNote));
         }
         
         selectedNotes.clear();
         groupGhostPreview.active = false;
-        repaint();
+        submitEdits(edits);
     }
     
     //==========================================================================
@@ -1674,30 +1608,10 @@ private:
     
     void deleteNoteAtSelection(const NoteHitInfo& info)
     {
-        if (info.measureIndex < 0 || info.measureIndex >= track.measures.size()) return;
-        auto& measure = track.measures.getReference(info.measureIndex);
-        if (info.beatIndex < 0 || info.beatIndex >= measure.beats.size()) return;
-        auto& beat = measure.beats.getReference(info.beatIndex);
-        if (info.noteIndex < 0 || info.noteIndex >= beat.notes.size()) return;
-        
-        int stringIndex = beat.notes[info.noteIndex].string;
-        
-        // Remove the note from the beat
-        beat.notes.remove(info.noteIndex);
-        
-        // If beat has no more notes, make it a rest
-        if (beat.notes.isEmpty())
-            beat.isRest = true;
-        
         // Clear selection
         lastSelectedNote = NoteHitInfo();
         
-        // Notify processor
-        if (onNoteDeleted)
-            onNoteDeleted(info.measureIndex, info.beatIndex, stringIndex);
-        
-        recalculateLayout();
-        repaint();
+        submitEdits({ TabEdit::deleteNote(info.measureIndex, info.beatIndex, info.noteIndex) });
     }
     
     /** Lösche eine Pause und passe die benachbarten Beats an.
@@ -1707,245 +1621,15 @@ private:
      */
     void deleteRestAndAdjust(int measureIndex, int beatIndex)
     {
-        if (measureIndex < 0 || measureIndex >= track.measures.size()) return;
-        auto& measure = track.measures.getReference(measureIndex);
-        if (beatIndex < 0 || beatIndex >= measure.beats.size()) return;
-        auto& restBeat = measure.beats[beatIndex];
-        if (!restBeat.isRest) return;  // Nur Pausen löschen
-        
-        float restDuration = restBeat.getDurationInQuarters();
-        
-        // Strategie 1: Beat davor verlängern (wenn vorhanden und kein Rest)
-        if (beatIndex > 0)
-        {
-            auto& prevBeat = measure.beats.getReference(beatIndex - 1);
-            float prevDuration = prevBeat.getDurationInQuarters();
-            float combinedDuration = prevDuration + restDuration;
-            
-            // Finde die passende Standarddauer
-            auto newDur = findClosestDuration(combinedDuration);
-            float newDurQ = 4.0f / static_cast<float>(newDur.first);
-            if (newDur.second) newDurQ *= 1.5f;
-            
-            // Prüfe ob die neue Dauer passt (Differenz < kleinstes Quantum)
-            if (std::abs(newDurQ - combinedDuration) < 0.06f)
-            {
-                // Perfekte oder nahe Passung - verlängere den vorherigen Beat
-                prevBeat.duration = newDur.first;
-                prevBeat.isDotted = newDur.second;
-                prevBeat.isDoubleDotted = false;
-                measure.beats.remove(beatIndex);
-            }
-            else
-            {
-                // Nicht exakt passend - verlängere so weit wie möglich, 
-                // Rest bleibt als kleinere Pause
-                auto bestFit = findClosestDuration(combinedDuration);
-                float bestFitQ = 4.0f / static_cast<float>(bestFit.first);
-                if (bestFit.second) bestFitQ *= 1.5f;
-                
-                if (bestFitQ <= combinedDuration + 0.001f && bestFitQ > prevDuration + 0.001f)
-                {
-                    prevBeat.duration = bestFit.first;
-                    prevBeat.isDotted = bestFit.second;
-                    prevBeat.isDoubleDotted = false;
-                    
-                    float leftover = combinedDuration - bestFitQ;
-                    if (leftover > 0.06f)
-                    {
-                        // Schrumpfe die Pause auf den Rest
-                        auto leftoverDur = findClosestDuration(leftover);
-                        auto& rest = measure.beats.getReference(beatIndex);
-                        rest.duration = leftoverDur.first;
-                        rest.isDotted = leftoverDur.second;
-                    }
-                    else
-                    {
-                        measure.beats.remove(beatIndex);
-                    }
-                }
-                else
-                {
-                    // Kann nicht sinnvoll zusammengefügt werden - einfach entfernen
-                    // und vorherigen Beat verlängern
-                    prevBeat.duration = bestFit.first;
-                    prevBeat.isDotted = bestFit.second;
-                    prevBeat.isDoubleDotted = false;
-                    measure.beats.remove(beatIndex);
-                }
-            }
-        }
-        // Strategie 2: Pause am Anfang - nächsten Beat verlängern
-        else if (beatIndex == 0 && measure.beats.size() > 1)
-        {
-            auto& nextBeat = measure.beats.getReference(1);
-            float nextDuration = nextBeat.getDurationInQuarters();
-            float combinedDuration = nextDuration + restDuration;
-            
-            auto newDur = findClosestDuration(combinedDuration);
-            float newDurQ = 4.0f / static_cast<float>(newDur.first);
-            if (newDur.second) newDurQ *= 1.5f;
-            
-            if (std::abs(newDurQ - combinedDuration) < 0.06f)
-            {
-                nextBeat.duration = newDur.first;
-                nextBeat.isDotted = newDur.second;
-                nextBeat.isDoubleDotted = false;
-                measure.beats.remove(0); // Entferne die Pause am Anfang
-            }
-            else
-            {
-                // Nicht exakt passend - verlängere den nächsten Beat so weit wie möglich
-                auto bestFit = findClosestDuration(combinedDuration);
-                float bestFitQ = 4.0f / static_cast<float>(bestFit.first);
-                if (bestFit.second) bestFitQ *= 1.5f;
-                
-                if (bestFitQ <= combinedDuration + 0.001f && bestFitQ > nextDuration + 0.001f)
-                {
-                    nextBeat.duration = bestFit.first;
-                    nextBeat.isDotted = bestFit.second;
-                    nextBeat.isDoubleDotted = false;
-                    
-                    float leftover = combinedDuration - bestFitQ;
-                    if (leftover > 0.06f)
-                    {
-                        auto leftoverDur = findClosestDuration(leftover);
-                        auto& rest = measure.beats.getReference(0);
-                        rest.duration = leftoverDur.first;
-                        rest.isDotted = leftoverDur.second;
-                    }
-                    else
-                    {
-                        measure.beats.remove(0);
-                    }
-                }
-                else
-                {
-                    nextBeat.duration = bestFit.first;
-                    nextBeat.isDotted = bestFit.second;
-                    nextBeat.isDoubleDotted = false;
-                    measure.beats.remove(0);
-                }
-            }
-        }
-        // Strategie 3: Einziger Beat im Takt - nicht löschen (Takt braucht mindestens eine Pause)
-        else
-        {
-            DBG("Cannot delete the only rest in measure " << (measureIndex + 1));
-            return;
-        }
-        
         // Clear hover state
         hoveredRestInfo = RenderedRestInfo();
         
-        // Speichere editierten Track
-        if (onBeatDurationChanged)
-            onBeatDurationChanged(measureIndex, -1, 0, false);  // beatIndex -1 = rest deletion
-        
-        recalculateLayout();
-        repaint();
+        submitEdits({ TabEdit::deleteRest(measureIndex, beatIndex) });
     }
     
     void changeBeatDuration(const NoteHitInfo& info, NoteDuration newDuration, bool isDotted)
     {
-        if (info.measureIndex < 0 || info.measureIndex >= track.measures.size()) return;
-        auto& measure = track.measures.getReference(info.measureIndex);
-        if (info.beatIndex < 0 || info.beatIndex >= measure.beats.size()) return;
-        
-        auto& beat = measure.beats.getReference(info.beatIndex);
-        float oldDurationInQuarters = beat.getDurationInQuarters();
-        
-        // Apply new duration
-        NoteDuration oldDur = beat.duration;
-        bool oldDotted = beat.isDotted;
-        beat.duration = newDuration;
-        beat.isDotted = isDotted;
-        beat.isDoubleDotted = false;
-        
-        float newDurationInQuarters = beat.getDurationInQuarters();
-        float diff = newDurationInQuarters - oldDurationInQuarters;
-        
-        // Calculate total measure duration capacity
-        float measureCapacity = (float)measure.timeSignatureNumerator * (4.0f / (float)measure.timeSignatureDenominator);
-        
-        // Calculate current total duration of all beats
-        float totalDuration = 0.0f;
-        for (const auto& b : measure.beats)
-            totalDuration += b.getDurationInQuarters();
-        
-        // Check if the new total exceeds measure capacity
-        if (totalDuration > measureCapacity + 0.001f)
-        {
-            // Need to shrink subsequent beats or add rests
-            float excess = totalDuration - measureCapacity;
-            
-            // Try to take time from beats after the current one
-            for (int b = info.beatIndex + 1; b < measure.beats.size() && excess > 0.001f; )
-            {
-                auto& nextBeat = measure.beats.getReference(b);
-                float nextDur = nextBeat.getDurationInQuarters();
-                
-                if (nextDur <= excess + 0.001f)
-                {
-                    // Remove this beat entirely
-                    excess -= nextDur;
-                    measure.beats.remove(b);
-                    // Don't increment b since we removed
-                }
-                else
-                {
-                    // Shrink this beat
-                    auto shorterDur = findClosestDuration(nextDur - excess);
-                    nextBeat.duration = shorterDur.first;
-                    nextBeat.isDotted = shorterDur.second;
-                    nextBeat.isDoubleDotted = false;
-                    excess = 0.0f;
-                    ++b;
-                }
-            }
-            
-            // If there's still excess (can't fit), revert
-            totalDuration = 0.0f;
-            for (const auto& b : measure.beats)
-                totalDuration += b.getDurationInQuarters();
-            if (totalDuration > measureCapacity + 0.01f)
-            {
-                beat.duration = oldDur;
-                beat.isDotted = oldDotted;
-                repaint();
-                return;
-            }
-        }
-        else if (totalDuration < measureCapacity - 0.001f)
-        {
-            // Need to fill gap with a rest
-            float gap = measureCapacity - totalDuration;
-            
-            // Insert rest beat(s) after current beat to fill the gap
-            while (gap > 0.01f)
-            {
-                auto restDur = findClosestDuration(gap);
-                TabBeat restBeat;
-                restBeat.isRest = true;
-                restBeat.duration = restDur.first;
-                restBeat.isDotted = restDur.second;
-                
-                float restLen = restBeat.getDurationInQuarters();
-                gap -= restLen;
-                
-                // Insert after current beat
-                int insertPos = info.beatIndex + 1;
-                if (insertPos > measure.beats.size()) insertPos = measure.beats.size();
-                measure.beats.insert(insertPos, restBeat);
-            }
-        }
-        
-        // Notify processor
-        if (onBeatDurationChanged)
-            onBeatDurationChanged(info.measureIndex, info.beatIndex, static_cast<int>(newDuration), isDotted);
-        
-        recalculateLayout();
-        repaint();
+        submitEdits({ TabEdit::changeDuration(info.measureIndex, info.beatIndex, newDuration, isDotted) });
     }
     
     void changeNotePitch(const NoteHitInfo& info, int newMidiNote)
@@ -2003,23 +1687,13 @@ private:
             if (newFret < 0) return;  // No valid position found
         }
         
-        int oldString = note.string;
-        note.midiNote = newMidiNote;
-        note.string = targetString;
-        note.fret = newFret;
-        note.isManuallyEdited = true;
-        
         // Update lastSelectedNote to reflect the new state
         lastSelectedNote.midiNote = newMidiNote;
         lastSelectedNote.stringIndex = targetString;
         lastSelectedNote.fret = newFret;
         
-        // Notify processor
-        if (onNotePitchChanged)
-            onNotePitchChanged(info.measureIndex, info.beatIndex, oldString, newMidiNote, newFret);
-        
-        recalculateLayout();
-        repaint();
+        submitEdits({ TabEdit::setPitch(info.measureIndex, info.beatIndex, info.noteIndex,
+                                        newMidiNote, targetString, newFret) });
     }
     
     void moveNoteToAdjacentString(const NoteHitInfo& info, int direction)
@@ -2064,39 +1738,13 @@ private:
         lastSelectedNote.fret = targetFret;
     }
     
-    // Helper: find the closest standard duration to a given quarter-note length
-    static std::pair<NoteDuration, bool> findClosestDuration(float quarters)
+    // Edits an den Modell-Besitzer schicken (oder ohne Listener direkt anwenden)
+    void submitEdits(const std::vector<TabEdit>& edits)
     {
-        // Duration table: { quarters, duration, dotted }
-        struct DurEntry { float q; NoteDuration d; bool dot; };
-        DurEntry table[] = {
-            { 4.0f,   NoteDuration::Whole, false },
-            { 3.0f,   NoteDuration::Half, true },
-            { 2.0f,   NoteDuration::Half, false },
-            { 1.5f,   NoteDuration::Quarter, true },
-            { 1.0f,   NoteDuration::Quarter, false },
-            { 0.75f,  NoteDuration::Eighth, true },
-            { 0.5f,   NoteDuration::Eighth, false },
-            { 0.375f, NoteDuration::Sixteenth, true },
-            { 0.25f,  NoteDuration::Sixteenth, false },
-            { 0.125f, NoteDuration::ThirtySecond, false }
-        };
-        
-        float bestDiff = 999.0f;
-        int bestIdx = 4;  // Default to quarter
-        for (int i = 0; i < 10; ++i)
-        {
-            if (table[i].q <= quarters + 0.001f)
-            {
-                float diff = quarters - table[i].q;
-                if (diff < bestDiff)
-                {
-                    bestDiff = diff;
-                    bestIdx = i;
-                }
-            }
-        }
-        return { table[bestIdx].d, table[bestIdx].dot };
+        if (onTabEdits)
+            onTabEdits(edits);
+        else
+            applyEdits(edits);
     }
     
     static NoteDuration getNextLongerDuration(NoteDuration d)
@@ -2304,65 +1952,9 @@ private:
     void insertNoteAtRest(int measureIndex, int beatIndex, int stringIndex, int fret, int midiNote)
     {
         if (measureIndex < 0 || measureIndex >= track.measures.size()) return;
-        auto& measure = track.measures.getReference(measureIndex);
+        const auto& measure = track.measures.getReference(measureIndex);
         if (beatIndex < 0 || beatIndex >= measure.beats.size()) return;
-        auto& beat = measure.beats.getReference(beatIndex);
-        if (!beat.isRest) return;  // Can only insert into rests
-        
-        float restDurationQ = beat.getDurationInQuarters();
-        
-        // Determine the note duration: use insertDuration if it fits, otherwise use rest duration
-        NoteDuration noteDur = insertDuration;
-        bool noteDotted = false;
-        
-        // Calculate chosen duration in quarters
-        float noteDurQ = 4.0f / static_cast<float>(noteDur);
-        if (noteDotted) noteDurQ *= 1.5f;
-        
-        // If chosen duration is longer than the rest, use the rest's duration
-        if (noteDurQ > restDurationQ + 0.001f)
-        {
-            noteDur = beat.duration;
-            noteDotted = beat.isDotted;
-            noteDurQ = restDurationQ;
-        }
-        
-        // Create the new note
-        TabNote newNote;
-        newNote.string = stringIndex;
-        newNote.fret = fret;
-        newNote.midiNote = midiNote;
-        newNote.velocity = 100;
-        newNote.isManuallyEdited = true;
-        
-        // Convert the rest beat into a note beat
-        beat.isRest = false;
-        beat.notes.clear();
-        beat.notes.add(newNote);
-        beat.duration = noteDur;
-        beat.isDotted = noteDotted;
-        beat.isDoubleDotted = false;
-        
-        // If there is remaining time, insert a rest after this beat
-        float remaining = restDurationQ - noteDurQ;
-        if (remaining > 0.01f)
-        {
-            // Fill remaining time with rest(s)
-            int insertPos = beatIndex + 1;
-            while (remaining > 0.01f)
-            {
-                auto restDur = findClosestDuration(remaining);
-                TabBeat restBeat;
-                restBeat.isRest = true;
-                restBeat.duration = restDur.first;
-                restBeat.isDotted = restDur.second;
-                float restLen = restBeat.getDurationInQuarters();
-                remaining -= restLen;
-                if (insertPos > measure.beats.size()) insertPos = measure.beats.size();
-                measure.beats.insert(insertPos, restBeat);
-                insertPos++;
-            }
-        }
+        if (!measure.beats[beatIndex].isRest) return;  // Can only insert into rests
         
         // Update lastSelectedNote to point to the new note
         lastSelectedNote.valid = true;
@@ -2373,12 +1965,7 @@ private:
         lastSelectedNote.fret = fret;
         lastSelectedNote.midiNote = midiNote;
         
-        // Notify processor
-        if (onNoteInserted)
-            onNoteInserted(measureIndex, beatIndex, stringIndex, fret, midiNote);
-        
-        recalculateLayout();
-        repaint();
+        submitEdits({ TabEdit::insertNote(measureIndex, beatIndex, stringIndex, fret, midiNote, insertDuration) });
     }
     
     /** Navigiere zum nächsten/vorherigen Beat */
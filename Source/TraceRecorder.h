@@ -0,0 +1,268 @@
+/*
+  ==============================================================================
+
+    TraceRecorder.h
+
+    Leichtgewichtige Trace-Marker für die ganze Pipeline (Audio-Thread,
+    BasicPitch-Transkription, Editor-Timer, Parser im Message-Thread),
+    exportierbar als Chrome-Trace-JSON (chrome://tracing, ui.perfetto.dev).
+
+    Jeder Thread schreibt in einen eigenen Ringpuffer (ein Schreiber, kein
+    Lock, keine Allokation nach dem ersten Einschalten). Die Puffer werden
+    beim Einschalten einmal angelegt und bis zum Programmende behalten,
+    damit Schreiber nie auf freigegebenen Speicher treffen. Ausgeschaltet
+    kostet ein Marker eine atomare Abfrage.
+
+    Endet ein Thread, gibt er seinen Puffer frei (thread_local SlotOwner);
+    der nächste neue Thread schreibt dort weiter. Jedes Event trägt die
+    Trace-ID und den Namen seines Threads, ältere Events im Ring bleiben
+    so ihrem ursprünglichen Thread zugeordnet.
+
+    Namen und Kategorien müssen String-Literale sein (nur Zeiger werden
+    gespeichert).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+class TraceRecorder
+{
+public:
+    static constexpr int maxThreads = 16;
+    static constexpr uint64_t eventsPerThread = 8192;   // ~384 KB pro Thread
+
+    static TraceRecorder& getInstance()
+    {
+        static TraceRecorder instance;
+        return instance;
+    }
+
+    static bool isEnabled() noexcept { return getInstance().enabled.load(std::memory_order_relaxed); }
+
+    /** Message-Thread. Puffer werden beim ersten Einschalten angelegt, alte Events bleiben erhalten. */
+    void setEnabled(bool shouldBeEnabled)
+    {
+        if (shouldBeEnabled)
+        {
+            for (auto& slot : slots)
+                if (slot.events == nullptr)
+                    slot.events.reset(new Event[eventsPerThread]);
+        }
+        enabled.store(shouldBeEnabled, std::memory_order_release);
+    }
+
+    /** Anzeigename des aufrufenden Threads im Trace (Literal, z.B. "audio"). */
+    static void nameCurrentThread(const char* name) noexcept
+    {
+        owner.name = name;
+    }
+
+    /** Abgeschlossenes Intervall (Ticks von juce::Time::getHighResolutionTicks). */
+    void addComplete(const char* name, const char* category, juce::int64 startTicks, juce::int64 durationTicks) noexcept
+    {
+        if (!enabled.load(std::memory_order_acquire))
+            return;
+
+        auto* slot = getSlotForCurrentThread();
+        if (slot == nullptr)
+            return;
+
+        const auto index = slot->written.load(std::memory_order_relaxed);
+        auto& event = slot->events[index % eventsPerThread];
+        event.name = name;
+        event.category = category;
+        event.threadName = owner.name;
+        event.tid = owner.tid;
+        event.startTicks = startTicks;
+        event.durationTicks = durationTicks;
+        slot->written.store(index + 1, std::memory_order_release);
+    }
+
+    /** Verworfene Events (mehr als maxThreads gleichzeitig lebende Threads). */
+    uint64_t getDroppedEventCount() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+    /** Message-Thread: alle noch in den Ringpuffern liegenden Events als Chrome-Trace-JSON. */
+    bool writeChromeTrace(const juce::File& file) const
+    {
+        juce::TemporaryFile temp(file);
+        {
+            juce::FileOutputStream out(temp.getFile());
+            if (out.failedToOpen())
+                return false;
+            writeChromeTrace(out);
+            out.flush();
+            if (out.getStatus().failed())
+                return false;
+        }
+        return temp.overwriteTargetFileWithTemporary();
+    }
+
+    void writeChromeTrace(juce::OutputStream& out) const
+    {
+        std::vector<Event> collected;
+        std::vector<std::pair<int, const char*>> threadNames;
+        juce::int64 originTicks = std::numeric_limits<juce::int64>::max();
+
+        for (const auto& slot : slots)
+        {
+            if (slot.events == nullptr)
+                continue;
+
+            // Kopieren, danach alles verwerfen, was der Schreiber inzwischen überschrieben haben kann
+            const auto end = slot.written.load(std::memory_order_acquire);
+            const auto begin = end > eventsPerThread ? end - eventsPerThread : 0;
+            const auto firstCollected = collected.size();
+            for (auto i = begin; i < end; ++i)
+                collected.push_back(slot.events[i % eventsPerThread]);
+
+            const auto endAfterCopy = slot.written.load(std::memory_order_acquire);
+            const auto firstValid = endAfterCopy >= eventsPerThread ? endAfterCopy - eventsPerThread + 1 : 0;
+            if (firstValid > begin)
+            {
+                const auto stale = (size_t) std::min(firstValid - begin, end - begin);
+                collected.erase(collected.begin() + (std::ptrdiff_t) firstCollected,
+                                collected.begin() + (std::ptrdiff_t) (firstCollected + stale));
+            }
+        }
+
+        // Ein Puffer kann nacheinander mehreren Threads gehört haben - Namen pro Trace-ID
+        for (const auto& event : collected)
+        {
+            originTicks = std::min(originTicks, event.startTicks);
+
+            auto known = std::find_if(threadNames.begin(), threadNames.end(),
+                                      [&event](const auto& entry) { return entry.first == event.tid; });
+            if (known == threadNames.end())
+                threadNames.push_back({ event.tid, event.threadName });
+            else if (event.threadName != nullptr)
+                known->second = event.threadName;
+        }
+
+        const double microsPerTick = 1.0e6 / (double) juce::Time::getHighResolutionTicksPerSecond();
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        for (const auto& [tid, name] : threadNames)
+        {
+            out << (first ? "" : ",\n")
+                << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+                << ",\"args\":{\"name\":\"" << (name != nullptr ? juce::String(name) : "thread " + juce::String(tid)) << "\"}}";
+            first = false;
+        }
+        for (const auto& event : collected)
+        {
+            out << (first ? "" : ",\n")
+                << "{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.tid
+                << ",\"ts\":" << juce::String((double) (event.startTicks - originTicks) * microsPerTick, 3)
+                << ",\"dur\":" << juce::String((double) event.durationTicks * microsPerTick, 3) << "}";
+            first = false;
+        }
+        out << "\n]}\n";
+    }
+
+private:
+    struct Event
+    {
+        const char* name = "";
+        const char* category = "";
+        const char* threadName = nullptr;
+        int tid = 0;
+        juce::int64 startTicks = 0;
+        juce::int64 durationTicks = 0;
+    };
+
+    struct ThreadBuffer
+    {
+        std::unique_ptr<Event[]> events;
+        std::atomic<uint64_t> written { 0 };
+        std::atomic<bool> inUse { false };
+    };
+
+    /** Puffer und Trace-ID des Threads; gibt den Puffer beim Thread-Ende frei. */
+    struct SlotOwner
+    {
+        int slot;
+        int tid;
+        const char* name;
+
+        SlotOwner() noexcept : slot(-1), tid(0), name(nullptr) {}
+
+        ~SlotOwner()
+        {
+            if (slot >= 0)
+                getInstance().slots[(size_t) slot].inUse.store(false, std::memory_order_release);
+        }
+    };
+
+    TraceRecorder() = default;
+
+    ThreadBuffer* getSlotForCurrentThread() noexcept
+    {
+        if (owner.slot < 0)
+        {
+            // Freien Puffer suchen (auch von beendeten Threads); sonst verwerfen und beim
+            // nächsten Marker erneut versuchen
+            for (int s = 0; s < maxThreads && owner.slot < 0; ++s)
+            {
+                bool expected = false;
+                if (slots[(size_t) s].inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+                {
+                    owner.slot = s;
+                    owner.tid = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            if (owner.slot < 0)
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        return &slots[(size_t) owner.slot];
+    }
+
+    static inline thread_local SlotOwner owner;
+
+    std::array<ThreadBuffer, maxThreads> slots;
+    std::atomic<int> nextThreadId { 1 };
+    std::atomic<uint64_t> dropped { 0 };
+    std::atomic<bool> enabled { false };
+
+    JUCE_DECLARE_NON_COPYABLE (TraceRecorder)
+};
+
+//==============================================================================
+/** Misst den umschließenden Block als Trace-Intervall (nur wenn das Tracing läuft). */
+class TraceScope
+{
+public:
+    TraceScope(const char* scopeName, const char* scopeCategory) noexcept
+        : name(scopeName), category(scopeCategory),
+          startTicks(TraceRecorder::isEnabled() ? juce::Time::getHighResolutionTicks() : 0)
+    {
+    }
+
+    ~TraceScope() noexcept
+    {
+        if (startTicks != 0)
+            TraceRecorder::getInstance().addComplete(name, category, startTicks,
+                                                     juce::Time::getHighResolutionTicks() - startTicks);
+    }
+
+private:
+    const char* name;
+    const char* category;
+    const juce::int64 startTicks;
+
+    JUCE_DECLARE_NON_COPYABLE (TraceScope)
+};